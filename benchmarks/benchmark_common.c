@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file benchmark_common.c
+// \brief Implements helpers shared by the benchmark programs
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "string_utils.h"
+#include "type_conversion.h"
+
+#include <stdlib.h>
+
+#include "benchmark_common.h"
+
+#define BENCHMARK_WARMUP_DIVISOR UINT32_C(100) // warm up with 1% of the iterations
+#define BENCHMARK_MIN_WARMUP     UINT32_C(10)
+
+#if defined(BENCHMARK_COUNT_ALLOCATIONS)
+// Linked with -Wl,--wrap for each of these so every call from the library lands here first
+static uint64_t benchmarkAllocations = UINT64_C(0);
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+int   __real_posix_memalign(void** ptr, size_t alignment, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+int   __wrap_posix_memalign(void** ptr, size_t alignment, size_t size);
+void* __wrap_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    ++benchmarkAllocations;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    ++benchmarkAllocations;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    ++benchmarkAllocations;
+    return __real_realloc(ptr, size);
+}
+
+int __wrap_posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    ++benchmarkAllocations;
+    return __real_posix_memalign(ptr, alignment, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size)
+{
+    ++benchmarkAllocations;
+    return __real_aligned_alloc(alignment, size);
+}
+
+bool get_Benchmark_Allocation_Count(uint64_t* count)
+{
+    *count = benchmarkAllocations;
+    return true;
+}
+#else
+bool get_Benchmark_Allocation_Count(uint64_t* count)
+{
+    *count = UINT64_C(0);
+    return false;
+}
+#endif // BENCHMARK_COUNT_ALLOCATIONS
+
+uint32_t get_Benchmark_Iterations(int argc, char* argv[], uint32_t defaultIterations)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (strcmp(argv[iter], "--iterations") == 0)
+        {
+            char*         end   = M_NULLPTR;
+            unsigned long value = strtoul(argv[iter + 1], &end, 10);
+            if (end != argv[iter + 1] && *end == '\0' && value > 0UL && value <= UINT32_MAX)
+            {
+                return C_CAST(uint32_t, value);
+            }
+            fprintf(stderr, "Invalid iteration count: %s. Using %" PRIu32 "\n", argv[iter + 1], defaultIterations);
+        }
+    }
+    return defaultIterations;
+}
+
+const char* get_Emulated_Target_Name(eEmulatedTargetType type)
+{
+    switch (type)
+    {
+    case EMULATED_TARGET_SAS_DISK:
+        return "sas";
+    case EMULATED_TARGET_SATA_DISK:
+        return "sata";
+    case EMULATED_TARGET_NVME_CONTROLLER:
+        return "nvme";
+    }
+    return "unknown";
+}
+
+eReturnValues open_Benchmark_Device(eEmulatedTargetType type, tDevice** device)
+{
+    eReturnValues        ret = SUCCESS;
+    emulatedTargetConfig config;
+    *device = M_REINTERPRET_CAST(tDevice*, safe_calloc(1, sizeof(tDevice)));
+    if (*device == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    (*device)->sanity.size    = sizeof(tDevice);
+    (*device)->sanity.version = DEVICE_BLOCK_VERSION;
+    (*device)->deviceVerbosity = VERBOSITY_QUIET;
+    get_Default_Emulated_Target_Config(&config, type);
+    ret = open_Emulated_Device(*device, &config);
+    if (ret != SUCCESS)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, device));
+    }
+    return ret;
+}
+
+void close_Benchmark_Device(tDevice** device)
+{
+    if (*device != M_NULLPTR)
+    {
+        close_Emulated_Device(*device);
+        safe_free_core(M_REINTERPRET_CAST(void**, device));
+    }
+}
+
+void run_Benchmark(tDevice* device, benchmarkFunc func, void* context, uint32_t iterations, benchmarkResult* result)
+{
+    uint32_t warmup         = M_Max(iterations / BENCHMARK_WARMUP_DIVISOR, BENCHMARK_MIN_WARMUP);
+    uint64_t commandsBefore = UINT64_C(0);
+    uint64_t targetNSBefore = UINT64_C(0);
+    uint64_t commandsAfter  = UINT64_C(0);
+    uint64_t targetNSAfter  = UINT64_C(0);
+    uint64_t allocsBefore   = UINT64_C(0);
+    uint64_t allocsAfter    = UINT64_C(0);
+    DECLARE_SEATIMER(benchmarkTimer);
+    result->iterations  = iterations;
+    result->totalNS     = UINT64_C(0);
+    result->targetNS    = UINT64_C(0);
+    result->commands    = UINT64_C(0);
+    result->allocations = UINT64_C(0);
+    result->result      = SUCCESS;
+    for (uint32_t iter = UINT32_C(0); iter < warmup && result->result == SUCCESS; ++iter)
+    {
+        result->result = func(device, context);
+    }
+    if (result->result != SUCCESS)
+    {
+        return;
+    }
+    get_Emulated_Device_Command_Totals(device, &commandsBefore, &targetNSBefore);
+    get_Benchmark_Allocation_Count(&allocsBefore);
+    start_Timer(&benchmarkTimer);
+    for (uint32_t iter = UINT32_C(0); iter < iterations; ++iter)
+    {
+        result->result = func(device, context);
+        if (result->result != SUCCESS)
+        {
+            result->iterations = iter;
+            break;
+        }
+    }
+    stop_Timer(&benchmarkTimer);
+    result->allocationsValid = get_Benchmark_Allocation_Count(&allocsAfter);
+    get_Emulated_Device_Command_Totals(device, &commandsAfter, &targetNSAfter);
+    result->totalNS     = get_Nano_Seconds(benchmarkTimer);
+    result->targetNS    = targetNSAfter - targetNSBefore;
+    result->commands    = commandsAfter - commandsBefore;
+    result->allocations = allocsAfter - allocsBefore;
+}
+
+void print_Benchmark_Result(const benchmarkResult* result)
+{
+    uint64_t hostNS     = result->totalNS > result->targetNS ? result->totalNS - result->targetNS : UINT64_C(0);
+    double   iterations = result->iterations > 0 ? C_CAST(double, result->iterations) : 1.0;
+    double   commands   = result->commands > 0 ? C_CAST(double, result->commands) : 1.0;
+    double   perSecond  = hostNS > 0 ? (C_CAST(double, result->iterations) * 1.0e9) / C_CAST(double, hostNS) : 0.0;
+    printf("{\"suite\":\"%s\",\"benchmark\":\"%s\",\"target\":\"%s\",\"result\":%d,\"iterations\":%" PRIu32
+           ",\"commands_per_call\":%.2f,\"host_ns_per_call\":%.1f,\"host_ns_per_command\":%.1f"
+           ",\"host_calls_per_second\":%.0f,\"target_ns_per_call\":%.1f",
+           result->suite, result->name, result->target, C_CAST(int, result->result), result->iterations,
+           C_CAST(double, result->commands) / iterations, C_CAST(double, hostNS) / iterations,
+           C_CAST(double, hostNS) / commands, perSecond, C_CAST(double, result->targetNS) / iterations);
+    if (result->allocationsValid)
+    {
+        printf(",\"allocations_per_call\":%.2f}\n", C_CAST(double, result->allocations) / iterations);
+    }
+    else
+    {
+        printf(",\"allocations_per_call\":null}\n");
+    }
+    flush_stdout();
+}
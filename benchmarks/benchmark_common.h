@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file benchmark_common.h
+//! \brief Defines helpers shared by the benchmark programs: emulated devices to run against, timing, and output
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "emulated_target.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // Benchmarks run against in-memory emulated targets with no added latency. The time spent inside the target is
+    // measured by the target itself and subtracted, so results are the time spent in the library only.
+    //
+    // Each result is printed to stdout as one JSON object per line so results can be collected by scripts and
+    // compared between releases. Anything else a benchmark prints goes to stderr.
+
+#define BENCHMARK_DEFAULT_ITERATIONS UINT32_C(10000)
+
+    typedef eReturnValues (*benchmarkFunc)(tDevice* M_NONNULL device, void* M_NULLABLE context);
+
+    typedef struct s_benchmarkResult
+    {
+        const char*   suite;
+        const char*   name;
+        const char*   target;
+        uint32_t      iterations;
+        uint64_t      totalNS;          // all iterations, including time in the target
+        uint64_t      targetNS;         // time spent inside the emulated target
+        uint64_t      commands;         // commands completed by the target
+        uint64_t      allocations;      // heap allocations made during all iterations
+        bool          allocationsValid; // false when allocations could not be counted
+        eReturnValues result;           // SUCCESS, or the first failure, which stops the benchmark
+    } benchmarkResult;
+
+    // Parses "--iterations N" from the command line. Returns defaultIterations when not given.
+    uint32_t get_Benchmark_Iterations(int argc, char* M_NONNULL argv[], uint32_t defaultIterations);
+
+    const char* get_Emulated_Target_Name(eEmulatedTargetType type);
+
+    // Allocates and opens an emulated device with the default configuration for the type. Close with
+    // close_Benchmark_Device.
+    eReturnValues open_Benchmark_Device(eEmulatedTargetType type, tDevice* M_NULLABLE* M_NONNULL device);
+
+    void close_Benchmark_Device(tDevice* M_NULLABLE* M_NONNULL device);
+
+    // Runs func iterations times after a short warm up and fills in result. result->suite, name, and target must be
+    // set by the caller.
+    void run_Benchmark(tDevice* M_NONNULL         device,
+                       benchmarkFunc              func,
+                       void* M_NULLABLE           context,
+                       uint32_t                   iterations,
+                       benchmarkResult* M_NONNULL result);
+
+    // Prints result as a single JSON object on one line
+    void print_Benchmark_Result(const benchmarkResult* M_NONNULL result);
+
+    // Gets the number of heap allocations made by this process so far. Returns false when allocations cannot be counted
+    // with this toolchain. Counting wraps malloc and friends at link time (BENCHMARK_COUNT_ALLOCATIONS), so only
+    // allocations made by the library and its dependencies are seen, not ones made inside the C library itself.
+    bool get_Benchmark_Allocation_Count(uint64_t* M_NONNULL count);
+
+#if defined(__cplusplus)
+}
+#endif
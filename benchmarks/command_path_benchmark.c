@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file command_path_benchmark.c
+// \brief Measures the time the library spends on each command from the public command functions down to issue_io,
+// with the time spent in the device excluded.
+//
+// Usage: command_path_benchmark [--iterations N]
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "ata_helper_func.h"
+#include "benchmark_common.h"
+#include "cmds.h"
+#include "nvme_helper.h"
+#include "nvme_helper_func.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+
+#define COMMAND_PATH_SUITE         "command_path"
+#define COMMAND_PATH_TRANSFER_SIZE UINT32_C(4096)
+
+typedef struct s_transferContext
+{
+    uint8_t* buffer;
+    uint32_t size;
+} transferContext;
+
+static eReturnValues benchmark_SCSI_Send_Cdb(tDevice* device, void* context)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, cdb, CDB_LEN_6);
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, SPC3_SENSE_LEN);
+    M_USE_UNUSED(context);
+    cdb[OPERATION_CODE] = TEST_UNIT_READY_CMD;
+    return scsi_Send_Cdb(device, cdb, CDB_LEN_6, M_NULLPTR, 0, XFER_NO_DATA, senseData, SPC3_SENSE_LEN, 15);
+}
+
+static eReturnValues benchmark_ATA_Passthrough_Command(tDevice* device, void* context)
+{
+    ataPassthroughCommand ataCommand =
+        create_ata_nondata_cmd(device, ATA_CHECK_POWER_MODE_CMD, ATA_CMD_TYPE_TASKFILE, true);
+    M_USE_UNUSED(context);
+    return ata_Passthrough_Command(device, &ataCommand);
+}
+
+static eReturnValues benchmark_NVMe_Cmd(tDevice* device, void* context)
+{
+    nvmeCmdCtx getFeatures;
+    M_USE_UNUSED(context);
+    M_INITIALIZE_STRUCTURE(&getFeatures, sizeof(nvmeCmdCtx));
+    getFeatures.commandType         = NVM_ADMIN_CMD;
+    getFeatures.cmd.adminCmd.opcode = NVME_ADMIN_CMD_GET_FEATURES;
+    getFeatures.cmd.adminCmd.cdw10  = NVME_FEAT_NUM_QUEUES_;
+    getFeatures.commandDirection    = XFER_NO_DATA;
+    getFeatures.timeout             = DEFAULT_COMMAND_TIMEOUT;
+    return nvme_Cmd(device, &getFeatures);
+}
+
+static eReturnValues benchmark_Read_LBA(tDevice* device, void* context)
+{
+    transferContext* transfer = M_REINTERPRET_CAST(transferContext*, context);
+    return read_LBA(device, 0, false, transfer->buffer, transfer->size);
+}
+
+static eReturnValues benchmark_Write_LBA(tDevice* device, void* context)
+{
+    transferContext* transfer = M_REINTERPRET_CAST(transferContext*, context);
+    return write_LBA(device, 0, false, transfer->buffer, transfer->size);
+}
+
+static eReturnValues benchmark_Fill_Drive_Info_Data(tDevice* device, void* context)
+{
+    M_USE_UNUSED(context);
+    return fill_Drive_Info_Data(device);
+}
+
+typedef struct s_commandPathBenchmark
+{
+    const char*   name;
+    benchmarkFunc func;
+    bool          targets[3]; // indexed by eEmulatedTargetType
+} commandPathBenchmark;
+
+static const commandPathBenchmark commandPathBenchmarks[] = {
+    {"scsi_Send_Cdb",           benchmark_SCSI_Send_Cdb,           {true, true, true}  },
+    {"ata_Passthrough_Command", benchmark_ATA_Passthrough_Command, {false, true, false}},
+    {"nvme_Cmd",                benchmark_NVMe_Cmd,                {false, false, true}},
+    {"read_LBA",                benchmark_Read_LBA,                {true, true, true}  },
+    {"write_LBA",               benchmark_Write_LBA,               {true, true, true}  },
+    {"fill_Drive_Info_Data",    benchmark_Fill_Drive_Info_Data,    {true, true, true}  },
+};
+
+static eReturnValues run_Command_Path_Benchmarks(eEmulatedTargetType type, uint32_t iterations)
+{
+    eReturnValues   ret      = SUCCESS;
+    tDevice*        device   = M_NULLPTR;
+    transferContext transfer = {M_NULLPTR, COMMAND_PATH_TRANSFER_SIZE};
+    ret                      = open_Benchmark_Device(type, &device);
+    if (ret != SUCCESS)
+    {
+        fprintf(stderr, "Unable to open the emulated %s device: %d\n", get_Emulated_Target_Name(type),
+                C_CAST(int, ret));
+        return ret;
+    }
+    transfer.buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(transfer.size, sizeof(uint8_t), device->os_info.minimumAlignment));
+    if (transfer.buffer == M_NULLPTR)
+    {
+        close_Benchmark_Device(&device);
+        return MEMORY_FAILURE;
+    }
+    for (size_t iter = SIZE_T_C(0); iter < SIZE_OF_STACK_ARRAY(commandPathBenchmarks); ++iter)
+    {
+        benchmarkResult result;
+        if (!commandPathBenchmarks[iter].targets[type])
+        {
+            continue;
+        }
+        safe_memset(&result, sizeof(benchmarkResult), 0, sizeof(benchmarkResult));
+        result.suite  = COMMAND_PATH_SUITE;
+        result.name   = commandPathBenchmarks[iter].name;
+        result.target = get_Emulated_Target_Name(type);
+        run_Benchmark(device, commandPathBenchmarks[iter].func, &transfer, iterations, &result);
+        print_Benchmark_Result(&result);
+        if (result.result != SUCCESS)
+        {
+            ret = result.result;
+        }
+    }
+    safe_free_aligned(&transfer.buffer);
+    close_Benchmark_Device(&device);
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int      exitCode   = EXIT_SUCCESS;
+    uint32_t iterations = get_Benchmark_Iterations(argc, argv, BENCHMARK_DEFAULT_ITERATIONS);
+    if (SUCCESS != run_Command_Path_Benchmarks(EMULATED_TARGET_SAS_DISK, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    if (SUCCESS != run_Command_Path_Benchmarks(EMULATED_TARGET_SATA_DISK, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    if (SUCCESS != run_Command_Path_Benchmarks(EMULATED_TARGET_NVME_CONTROLLER, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    return exitCode;
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file discovery_benchmark.c
+// \brief Measures Linux device discovery (get_Device_Count and get_Device_List) against a generated /dev and /sys
+// tree with SAS, SATA, USB, and NVMe devices served by emulated targets. Reports scans per second and heap
+// allocations per scan so scaling to large device counts can be tracked between releases.
+//
+// Usage: discovery_benchmark [--devices N] [--iterations N]
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "string_utils.h"
+#include "type_conversion.h"
+
+#include <stdlib.h>
+
+#include "benchmark_common.h"
+#include "fake_device_tree.h"
+#include "sg_helper.h"
+
+#define DISCOVERY_SUITE              "discovery"
+#define DISCOVERY_DEFAULT_DEVICES    UINT32_C(256)
+#define DISCOVERY_DEFAULT_ITERATIONS UINT32_C(5)
+#define DISCOVERY_DEVICE_TYPES       UINT32_C(4) // SAS, SATA, USB, NVMe
+
+// Parses "--devices N" from the command line. Returns defaultDevices when not given.
+static uint32_t get_Discovery_Device_Count(int argc, char* argv[], uint32_t defaultDevices)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (strcmp(argv[iter], "--devices") == 0)
+        {
+            char*         end   = M_NULLPTR;
+            unsigned long value = strtoul(argv[iter + 1], &end, 10);
+            if (end != argv[iter + 1] && *end == '\0' && value > 0UL && value <= MAX_DEVICES_TO_SCAN)
+            {
+                return C_CAST(uint32_t, value);
+            }
+            fprintf(stderr, "Invalid device count: %s. Using %" PRIu32 "\n", argv[iter + 1], defaultDevices);
+        }
+    }
+    return defaultDevices;
+}
+
+// Splits the devices evenly between the types, giving any remainder to SAS
+static void get_Discovery_Tree_Config(uint32_t devices, fakeDeviceTreeConfig* config)
+{
+    uint32_t perType    = devices / DISCOVERY_DEVICE_TYPES;
+    config->sasDevices  = perType + (devices % DISCOVERY_DEVICE_TYPES);
+    config->sataDevices = perType;
+    config->usbDevices  = perType;
+    config->nvmeDevices = perType;
+}
+
+static eReturnValues discover_Count(uint32_t* count)
+{
+    return get_Device_Count(count, 0);
+}
+
+// Gets the full device list, which opens and identifies every device, then closes them all again.
+static eReturnValues discover_List(uint32_t count, uint64_t* commands, uint64_t* targetNS)
+{
+    eReturnValues ret     = SUCCESS;
+    tDevice*      devices = M_NULLPTR;
+    versionBlock  version;
+    if (count == UINT32_C(0))
+    {
+        return NOT_SUPPORTED;
+    }
+    devices = M_REINTERPRET_CAST(tDevice*, safe_calloc(count, sizeof(tDevice)));
+    if (devices == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    M_INITIALIZE_STRUCTURE(&version, sizeof(versionBlock));
+    version.size    = sizeof(tDevice);
+    version.version = DEVICE_BLOCK_VERSION;
+    for (uint32_t iter = UINT32_C(0); iter < count; ++iter)
+    {
+        devices[iter].deviceVerbosity = VERBOSITY_QUIET;
+    }
+    ret = get_Device_List(devices, count * C_CAST(uint32_t, sizeof(tDevice)), version, 0);
+    for (uint32_t iter = UINT32_C(0); iter < count; ++iter)
+    {
+        uint64_t deviceCommands = UINT64_C(0);
+        uint64_t deviceNS       = UINT64_C(0);
+        if (SUCCESS == get_Emulated_Device_Command_Totals(&devices[iter], &deviceCommands, &deviceNS))
+        {
+            *commands += deviceCommands;
+            *targetNS += deviceNS;
+            close_Device(&devices[iter]);
+        }
+    }
+    safe_free_core(M_REINTERPRET_CAST(void**, &devices));
+    return ret;
+}
+
+static eReturnValues run_Discovery_Benchmark(bool        listDevices,
+                                             uint32_t    expected,
+                                             uint32_t    iterations,
+                                             const char* target)
+{
+    uint64_t        allocsBefore = UINT64_C(0);
+    uint64_t        allocsAfter  = UINT64_C(0);
+    benchmarkResult result;
+    DECLARE_SEATIMER(discoveryTimer);
+    M_INITIALIZE_STRUCTURE(&result, sizeof(benchmarkResult));
+    result.suite      = DISCOVERY_SUITE;
+    result.name       = listDevices ? "get_Device_List" : "get_Device_Count";
+    result.target     = target;
+    result.iterations = iterations;
+    result.result     = SUCCESS;
+    get_Benchmark_Allocation_Count(&allocsBefore);
+    for (uint32_t iter = UINT32_C(0); iter < iterations && result.result == SUCCESS; ++iter)
+    {
+        uint32_t count = UINT32_C(0);
+        start_Timer(&discoveryTimer);
+        result.result = discover_Count(&count);
+        if (result.result == SUCCESS && listDevices)
+        {
+            result.result = discover_List(count, &result.commands, &result.targetNS);
+        }
+        stop_Timer(&discoveryTimer);
+        result.totalNS += get_Nano_Seconds(discoveryTimer);
+        if (result.result == SUCCESS && count != expected)
+        {
+            fprintf(stderr, "Found %" PRIu32 " devices, expected %" PRIu32 "\n", count, expected);
+            result.result = FAILURE;
+        }
+        if (result.result != SUCCESS)
+        {
+            result.iterations = iter;
+        }
+    }
+    result.allocationsValid = get_Benchmark_Allocation_Count(&allocsAfter);
+    result.allocations      = allocsAfter - allocsBefore;
+    print_Benchmark_Result(&result);
+    return result.result;
+}
+
+int main(int argc, char* argv[])
+{
+    int                  exitCode   = EXIT_SUCCESS;
+    uint32_t             devices    = get_Discovery_Device_Count(argc, argv, DISCOVERY_DEFAULT_DEVICES);
+    uint32_t             iterations = get_Benchmark_Iterations(argc, argv, DISCOVERY_DEFAULT_ITERATIONS);
+    fakeDeviceTreeConfig config;
+    DECLARE_ZERO_INIT_ARRAY(char, root, 64);
+    DECLARE_ZERO_INIT_ARRAY(char, target, 32);
+    get_Discovery_Tree_Config(devices, &config);
+    safe_strcpy(root, SIZE_OF_STACK_ARRAY(root), "/tmp/opensea-discovery-XXXXXX");
+    if (mkdtemp(root) == M_NULLPTR)
+    {
+        fprintf(stderr, "Unable to create a directory for the device tree\n");
+        return EXIT_FAILURE;
+    }
+    if (SUCCESS != create_Fake_Device_Tree(root, &config) || SUCCESS != set_Linux_Device_Root(root))
+    {
+        fprintf(stderr, "Unable to create a device tree in %s\n", root);
+        exitCode = EXIT_FAILURE;
+    }
+    else
+    {
+        snprintf_err_handle(target, SIZE_OF_STACK_ARRAY(target), "%" PRIu32 " devices", devices);
+        if (SUCCESS != run_Discovery_Benchmark(false, devices, iterations, target))
+        {
+            exitCode = EXIT_FAILURE;
+        }
+        if (SUCCESS != run_Discovery_Benchmark(true, devices, iterations, target))
+        {
+            exitCode = EXIT_FAILURE;
+        }
+    }
+    set_Linux_Device_Root(M_NULLPTR);
+    if (SUCCESS != remove_Fake_Device_Tree(root))
+    {
+        fprintf(stderr, "Unable to remove %s\n", root);
+    }
+    return exitCode;
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file error_path_benchmark.c
+// \brief Measures the time the library spends handling failed commands. Faults are injected in place of the OS on
+// emulated targets and read_LBA is timed until it returns the failure, including any retries, fallbacks, and
+// workaround commands the library sends along the way.
+//
+// Usage: error_path_benchmark [--iterations N]
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "benchmark_common.h"
+#include "cmds.h"
+#include "fault_injection.h"
+#include "scsi_helper.h"
+
+#define ERROR_PATH_SUITE         "error_path"
+#define ERROR_PATH_TRANSFER_SIZE UINT32_C(4096)
+#define ERROR_PATH_BENCHMARKS    (4)
+
+typedef struct s_errorPathContext
+{
+    uint8_t* buffer;
+    uint32_t size;
+} errorPathContext;
+
+// Succeeds when read_LBA fails, since that means the injected fault was seen and handled
+static eReturnValues benchmark_Failed_Read_LBA(tDevice* device, void* context)
+{
+    errorPathContext* transfer = M_REINTERPRET_CAST(errorPathContext*, context);
+    if (SUCCESS == read_LBA(device, 0, false, transfer->buffer, transfer->size))
+    {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+typedef struct s_errorPathBenchmark
+{
+    const char*        name;
+    bool               targets[3]; // indexed by eEmulatedTargetType
+    faultInjectionRule rule;
+} errorPathBenchmark;
+
+static void get_Error_Path_Benchmarks(errorPathBenchmark* benchmarks, size_t count)
+{
+    safe_memset(benchmarks, count * sizeof(errorPathBenchmark), 0, count * sizeof(errorPathBenchmark));
+    // SAS: medium error on the read
+    benchmarks[0].name             = "read_LBA medium error sense";
+    benchmarks[0].targets[0]       = true;
+    benchmarks[0].rule.commandType = FAULT_INJECTION_SCSI;
+    benchmarks[0].rule.matchLBA    = true;
+    benchmarks[0].rule.action      = FAULT_INJECTION_SENSE_DATA;
+    benchmarks[0].rule.senseKey    = SENSE_KEY_MEDIUM_ERROR;
+    benchmarks[0].rule.asc         = UINT8_C(0x11); // unrecovered read error
+    // SATA: uncorrectable error in the ATA registers
+    benchmarks[1].name             = "read_LBA ATA uncorrectable";
+    benchmarks[1].targets[1]       = true;
+    benchmarks[1].rule.commandType = FAULT_INJECTION_ATA;
+    benchmarks[1].rule.matchLBA    = true;
+    benchmarks[1].rule.action      = FAULT_INJECTION_ATA_STATUS;
+    benchmarks[1].rule.ataStatus   = UINT8_C(0x51);
+    benchmarks[1].rule.ataError    = UINT8_C(0x40);
+    // NVMe: unrecovered read error status
+    benchmarks[2].name                    = "read_LBA NVMe unrecovered read";
+    benchmarks[2].targets[2]              = true;
+    benchmarks[2].rule.commandType        = FAULT_INJECTION_NVME_NVM;
+    benchmarks[2].rule.matchLBA           = true;
+    benchmarks[2].rule.action             = FAULT_INJECTION_NVME_STATUS;
+    benchmarks[2].rule.nvmeStatusCodeType = UINT8_C(2); // media and data integrity errors
+    benchmarks[2].rule.nvmeStatusCode     = UINT8_C(0x81);
+    // Every target: the OS fails every command before it reaches the device
+    benchmarks[3].name                = "read_LBA transport error";
+    benchmarks[3].targets[0]          = true;
+    benchmarks[3].targets[1]          = true;
+    benchmarks[3].targets[2]          = true;
+    benchmarks[3].rule.commandType    = FAULT_INJECTION_ANY_COMMAND;
+    benchmarks[3].rule.action         = FAULT_INJECTION_TRANSPORT_ERROR;
+    benchmarks[3].rule.transportError = OS_PASSTHROUGH_FAILURE;
+}
+
+static eReturnValues run_Error_Path_Benchmarks(eEmulatedTargetType type, uint32_t iterations)
+{
+    eReturnValues      ret      = SUCCESS;
+    tDevice*           device   = M_NULLPTR;
+    errorPathContext   transfer = {M_NULLPTR, ERROR_PATH_TRANSFER_SIZE};
+    errorPathBenchmark benchmarks[ERROR_PATH_BENCHMARKS];
+    get_Error_Path_Benchmarks(benchmarks, ERROR_PATH_BENCHMARKS);
+    ret = open_Benchmark_Device(type, &device);
+    if (ret != SUCCESS)
+    {
+        fprintf(stderr, "Unable to open the emulated %s device: %d\n", get_Emulated_Target_Name(type),
+                C_CAST(int, ret));
+        return ret;
+    }
+    transfer.buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(transfer.size, sizeof(uint8_t), device->os_info.minimumAlignment));
+    if (transfer.buffer == M_NULLPTR)
+    {
+        close_Benchmark_Device(&device);
+        return MEMORY_FAILURE;
+    }
+    for (size_t iter = SIZE_T_C(0); iter < ERROR_PATH_BENCHMARKS; ++iter)
+    {
+        benchmarkResult result;
+        if (!benchmarks[iter].targets[type])
+        {
+            continue;
+        }
+        safe_memset(&result, sizeof(benchmarkResult), 0, sizeof(benchmarkResult));
+        result.suite  = ERROR_PATH_SUITE;
+        result.name   = benchmarks[iter].name;
+        result.target = get_Emulated_Target_Name(type);
+        result.result = start_Fault_Injection(device, 0);
+        if (result.result == SUCCESS)
+        {
+            result.result = add_Fault_Injection_Rule(device, &benchmarks[iter].rule);
+        }
+        if (result.result == SUCCESS)
+        {
+            run_Benchmark(device, benchmark_Failed_Read_LBA, &transfer, iterations, &result);
+        }
+        stop_Fault_Injection(device);
+        print_Benchmark_Result(&result);
+        if (result.result != SUCCESS)
+        {
+            ret = result.result;
+        }
+    }
+    safe_free_aligned(&transfer.buffer);
+    close_Benchmark_Device(&device);
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int      exitCode   = EXIT_SUCCESS;
+    uint32_t iterations = get_Benchmark_Iterations(argc, argv, BENCHMARK_DEFAULT_ITERATIONS);
+    if (SUCCESS != run_Error_Path_Benchmarks(EMULATED_TARGET_SAS_DISK, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    if (SUCCESS != run_Error_Path_Benchmarks(EMULATED_TARGET_SATA_DISK, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    if (SUCCESS != run_Error_Path_Benchmarks(EMULATED_TARGET_NVME_CONTROLLER, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    return exitCode;
+}
@@ -0,0 +1,475 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fake_device_tree.c
+// \brief Implements a generator for fake Linux /dev and /sys trees to run device discovery against
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "io_utils.h"
+#include "memory_safety.h"
+#include "secure_file.h"
+#include "string_utils.h"
+#include "type_conversion.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fake_device_tree.h"
+
+// Adapters each kind of device is attached to, relative to /sys/devices
+#define FAKE_TREE_SAS_ADAPTER  "pci0000:00/0000:00:01.0/0000:01:00.0"
+#define FAKE_TREE_SATA_ADAPTER "pci0000:00/0000:00:1f.2"
+#define FAKE_TREE_USB_ADAPTER  "pci0000:00/0000:00:14.0"
+
+// Creates each missing directory in path, like mkdir -p
+static eReturnValues make_Fake_Directory(const char* path)
+{
+    size_t length = safe_strlen(path);
+    DECLARE_ZERO_INIT_ARRAY(char, partial, PATH_MAX);
+    if (length == SIZE_T_C(0) || length >= PATH_MAX)
+    {
+        return BAD_PARAMETER;
+    }
+    for (size_t offset = SIZE_T_C(1); offset <= length; ++offset)
+    {
+        if (path[offset] == '/' || path[offset] == '\0')
+        {
+            safe_memcpy(partial, PATH_MAX, path, offset);
+            partial[offset] = '\0';
+            if (mkdir(partial, 0755) != 0 && errno != EEXIST)
+            {
+                return FAILURE;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+static eReturnValues write_Fake_File(const char* directory, const char* name, const char* contents)
+{
+    FILE* file    = M_NULLPTR;
+    bool  written = false;
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    if (snprintf_err_handle(path, PATH_MAX, "%s/%s", directory, name) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    if (0 != safe_fopen(&file, path, "w") || file == M_NULLPTR)
+    {
+        return FILE_OPEN_ERROR;
+    }
+    written = fputs(contents, file) >= 0;
+    if (fclose(file) != 0)
+    {
+        written = false;
+    }
+    return written ? SUCCESS : FAILURE;
+}
+
+static eReturnValues link_Fake_File(const char* directory, const char* name, const char* target)
+{
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    if (snprintf_err_handle(path, PATH_MAX, "%s/%s", directory, name) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    if (symlink(target, path) != 0 && errno != EEXIST)
+    {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+// Sets driverLink to the relative path from a directory under /sys/devices to /sys/bus/<bus>/drivers/<driver>
+static eReturnValues get_Fake_Driver_Link(const char* devicePath,
+                                          const char* bus,
+                                          const char* driver,
+                                          char*       driverLink,
+                                          size_t      driverLinkLen)
+{
+    // one ../ for devices and one for each directory below it
+    size_t depth = SIZE_T_C(2);
+    DECLARE_ZERO_INIT_ARRAY(char, parents, PATH_MAX);
+    for (const char* iter = devicePath; *iter != '\0'; ++iter)
+    {
+        if (*iter == '/')
+        {
+            ++depth;
+        }
+    }
+    for (size_t iter = SIZE_T_C(0); iter < depth; ++iter)
+    {
+        if (0 != safe_strcat(parents, PATH_MAX, "../"))
+        {
+            return BAD_PARAMETER;
+        }
+    }
+    if (snprintf_err_handle(driverLink, driverLinkLen, "%sbus/%s/drivers/%s", parents, bus, driver) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    return SUCCESS;
+}
+
+// Creates the driver directory with a module version file and links the device to it
+static eReturnValues create_Fake_Driver(const char* root, const char* devicePath, const char* bus, const char* driver)
+{
+    eReturnValues ret = SUCCESS;
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, driverLink, PATH_MAX);
+    if (snprintf_err_handle(path, PATH_MAX, "%s/sys/bus/%s/drivers/%s/module", root, bus, driver) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    ret = make_Fake_Directory(path);
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "version", "3.0.0.0\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = get_Fake_Driver_Link(devicePath, bus, driver, driverLink, PATH_MAX);
+    }
+    if (ret == SUCCESS && snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s", root, devicePath) < 0)
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = link_Fake_File(path, "driver", driverLink);
+    }
+    return ret;
+}
+
+static eReturnValues create_Fake_PCI_Adapter(const char* root,
+                                             const char* adapterPath,
+                                             const char* vendorID,
+                                             const char* deviceID,
+                                             const char* driver)
+{
+    eReturnValues ret = SUCCESS;
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    if (snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s", root, adapterPath) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    ret = make_Fake_Directory(path);
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "vendor", vendorID);
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "device", deviceID);
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "revision", "0x02\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = create_Fake_Driver(root, adapterPath, "pci", driver);
+    }
+    return ret;
+}
+
+// USB bridges are identified from the USB device two levels above the SCSI host
+static eReturnValues create_Fake_USB_Device(const char* root, uint32_t port)
+{
+    eReturnValues ret = SUCCESS;
+    DECLARE_ZERO_INIT_ARRAY(char, devicePath, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    if (snprintf_err_handle(devicePath, PATH_MAX, FAKE_TREE_USB_ADAPTER "/usb1/1-%" PRIu32, port) < 0 ||
+        snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s", root, devicePath) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    ret = make_Fake_Directory(path);
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "idVendor", "0bc2\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "idProduct", "ab38\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "bcdDevice", "0100\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = create_Fake_Driver(root, devicePath, "usb", "usb");
+    }
+    return ret;
+}
+
+// Block device names go sda...sdz, sdaa...sdzz, sdaaa, the same as the sd driver
+static eReturnValues get_Fake_Block_Name(uint32_t index, char* name, size_t nameLen)
+{
+    DECLARE_ZERO_INIT_ARRAY(char, suffix, 8);
+    size_t  offset = SIZE_OF_STACK_ARRAY(suffix) - 1;
+    int64_t value  = C_CAST(int64_t, index);
+    do
+    {
+        --offset;
+        suffix[offset] = C_CAST(char, 'a' + (value % 26));
+        value          = (value / 26) - 1;
+    } while (value >= 0 && offset > 0);
+    if (snprintf_err_handle(name, nameLen, "sd%s", &suffix[offset]) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    return SUCCESS;
+}
+
+// Creates one SCSI device with sg and sd handles. hostPath is the directory holding the SCSI target, relative to
+// /sys/devices, and emulatedTarget is written to the /dev entries.
+static eReturnValues create_Fake_SCSI_Device(const char* root,
+                                             const char* hostPath,
+                                             uint32_t    host,
+                                             uint32_t    target,
+                                             uint32_t    handleIndex,
+                                             const char* emulatedTarget)
+{
+    eReturnValues ret = SUCCESS;
+    DECLARE_ZERO_INIT_ARRAY(char, devicePath, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, classLink, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, sgName, 16);
+    DECLARE_ZERO_INIT_ARRAY(char, sdName, 16);
+    if (snprintf_err_handle(devicePath, PATH_MAX, "%s/target%" PRIu32 ":0:%" PRIu32 "/%" PRIu32 ":0:%" PRIu32 ":0",
+                            hostPath, host, target, host, target) < 0 ||
+        snprintf_err_handle(sgName, 16, "sg%" PRIu32, handleIndex) < 0 ||
+        SUCCESS != get_Fake_Block_Name(handleIndex, sdName, 16))
+    {
+        return BAD_PARAMETER;
+    }
+    // the SCSI device with its type and queue depth
+    if (snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s", root, devicePath) < 0)
+    {
+        return BAD_PARAMETER;
+    }
+    ret = make_Fake_Directory(path);
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "type", "0\n");
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, "queue_depth", "32\n");
+    }
+    // the scsi_generic and block class devices under it, each with a device link back up to it
+    if (ret == SUCCESS && snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s/scsi_generic/%s", root, devicePath,
+                                              sgName) < 0)
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = make_Fake_Directory(path);
+    }
+    if (ret == SUCCESS)
+    {
+        ret = link_Fake_File(path, "device", "../..");
+    }
+    if (ret == SUCCESS &&
+        snprintf_err_handle(path, PATH_MAX, "%s/sys/devices/%s/block/%s", root, devicePath, sdName) < 0)
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = make_Fake_Directory(path);
+    }
+    if (ret == SUCCESS)
+    {
+        ret = link_Fake_File(path, "device", "../..");
+    }
+    // class links, which is where discovery starts from a handle
+    if (ret == SUCCESS && (snprintf_err_handle(path, PATH_MAX, "%s/sys/class/scsi_generic", root) < 0 ||
+                           snprintf_err_handle(classLink, PATH_MAX, "../../devices/%s/scsi_generic/%s", devicePath,
+                                               sgName) < 0))
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = link_Fake_File(path, sgName, classLink);
+    }
+    if (ret == SUCCESS &&
+        (snprintf_err_handle(path, PATH_MAX, "%s/sys/class/block", root) < 0 ||
+         snprintf_err_handle(classLink, PATH_MAX, "../../devices/%s/block/%s", devicePath, sdName) < 0))
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = link_Fake_File(path, sdName, classLink);
+    }
+    // handles
+    if (ret == SUCCESS && snprintf_err_handle(path, PATH_MAX, "%s/dev", root) < 0)
+    {
+        ret = BAD_PARAMETER;
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, sgName, emulatedTarget);
+    }
+    if (ret == SUCCESS)
+    {
+        ret = write_Fake_File(path, sdName, emulatedTarget);
+    }
+    return ret;
+}
+
+static eReturnValues create_Fake_Tree_Directories(const char* root)
+{
+    static const char* const directories[] = {"/dev", "/sys/class/scsi_generic", "/sys/class/block",
+                                              "/sys/class/scsi_host", "/sys/devices"};
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    for (size_t iter = SIZE_T_C(0); iter < SIZE_OF_STACK_ARRAY(directories); ++iter)
+    {
+        eReturnValues ret = SUCCESS;
+        if (snprintf_err_handle(path, PATH_MAX, "%s%s", root, directories[iter]) < 0)
+        {
+            return BAD_PARAMETER;
+        }
+        ret = make_Fake_Directory(path);
+        if (ret != SUCCESS)
+        {
+            return ret;
+        }
+    }
+    return SUCCESS;
+}
+
+eReturnValues create_Fake_Device_Tree(const char* root, const fakeDeviceTreeConfig* config)
+{
+    eReturnValues ret         = create_Fake_Tree_Directories(root);
+    uint32_t      handleIndex = UINT32_C(0);
+    uint32_t      host        = UINT32_C(0);
+    DECLARE_ZERO_INIT_ARRAY(char, hostPath, PATH_MAX);
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    // SAS: every device on one HBA behind its own expander phy
+    if (ret == SUCCESS && config->sasDevices > UINT32_C(0))
+    {
+        ret = create_Fake_PCI_Adapter(root, FAKE_TREE_SAS_ADAPTER, "0x1000\n", "0x00c4\n", "mpt3sas");
+        for (uint32_t iter = UINT32_C(0); ret == SUCCESS && iter < config->sasDevices; ++iter, ++handleIndex)
+        {
+            if (snprintf_err_handle(hostPath, PATH_MAX,
+                                    FAKE_TREE_SAS_ADAPTER "/host%" PRIu32 "/port-%" PRIu32 ":%" PRIu32
+                                                          "/end_device-%" PRIu32 ":%" PRIu32,
+                                    host, host, iter, host, iter) < 0)
+            {
+                ret = BAD_PARAMETER;
+                break;
+            }
+            ret = create_Fake_SCSI_Device(root, hostPath, host, iter, handleIndex, "emulated:sas\n");
+        }
+        ++host;
+    }
+    // SATA: libata gives each port its own SCSI host
+    if (ret == SUCCESS && config->sataDevices > UINT32_C(0))
+    {
+        ret = create_Fake_PCI_Adapter(root, FAKE_TREE_SATA_ADAPTER, "0x8086\n", "0xa352\n", "ahci");
+        for (uint32_t iter = UINT32_C(0); ret == SUCCESS && iter < config->sataDevices;
+             ++iter, ++handleIndex, ++host)
+        {
+            if (snprintf_err_handle(hostPath, PATH_MAX, FAKE_TREE_SATA_ADAPTER "/ata%" PRIu32 "/host%" PRIu32,
+                                    iter + 1, host) < 0)
+            {
+                ret = BAD_PARAMETER;
+                break;
+            }
+            ret = create_Fake_SCSI_Device(root, hostPath, host, 0, handleIndex, "emulated:sata\n");
+        }
+    }
+    // USB: one bridge per port, each with its own SCSI host
+    if (ret == SUCCESS && config->usbDevices > UINT32_C(0))
+    {
+        ret = create_Fake_PCI_Adapter(root, FAKE_TREE_USB_ADAPTER, "0x8086\n", "0xa36d\n", "xhci_hcd");
+        for (uint32_t iter = UINT32_C(0); ret == SUCCESS && iter < config->usbDevices; ++iter, ++handleIndex, ++host)
+        {
+            ret = create_Fake_USB_Device(root, iter + 1);
+            if (ret == SUCCESS &&
+                snprintf_err_handle(hostPath, PATH_MAX,
+                                    FAKE_TREE_USB_ADAPTER "/usb1/1-%" PRIu32 "/1-%" PRIu32 ":1.0/host%" PRIu32,
+                                    iter + 1, iter + 1, host) < 0)
+            {
+                ret = BAD_PARAMETER;
+            }
+            if (ret == SUCCESS)
+            {
+                ret = create_Fake_SCSI_Device(root, hostPath, host, 0, handleIndex, "emulated:sata\n");
+            }
+        }
+    }
+    // NVMe: one namespace per controller
+    if (ret == SUCCESS && snprintf_err_handle(path, PATH_MAX, "%s/dev", root) < 0)
+    {
+        ret = BAD_PARAMETER;
+    }
+    for (uint32_t iter = UINT32_C(0); ret == SUCCESS && iter < config->nvmeDevices; ++iter)
+    {
+        DECLARE_ZERO_INIT_ARRAY(char, nvmeName, 24);
+        if (snprintf_err_handle(nvmeName, 24, "nvme%" PRIu32 "n1", iter) < 0)
+        {
+            ret = BAD_PARAMETER;
+            break;
+        }
+        ret = write_Fake_File(path, nvmeName, "emulated:nvme\n");
+    }
+    return ret;
+}
+
+eReturnValues remove_Fake_Device_Tree(const char* root)
+{
+    eReturnValues  ret       = SUCCESS;
+    DIR*           directory = opendir(root);
+    struct dirent* entry     = M_NULLPTR;
+    DECLARE_ZERO_INIT_ARRAY(char, path, PATH_MAX);
+    if (directory == M_NULLPTR)
+    {
+        return FAILURE;
+    }
+    while (ret == SUCCESS && (entry = readdir(directory)) != M_NULLPTR)
+    {
+        struct stat entryStat;
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+        if (snprintf_err_handle(path, PATH_MAX, "%s/%s", root, entry->d_name) < 0 || lstat(path, &entryStat) != 0)
+        {
+            ret = FAILURE;
+        }
+        else if (S_ISDIR(entryStat.st_mode))
+        {
+            ret = remove_Fake_Device_Tree(path);
+        }
+        else if (unlink(path) != 0)
+        {
+            ret = FAILURE;
+        }
+    }
+    M_STATIC_CAST(void, closedir(directory));
+    if (ret == SUCCESS && rmdir(root) != 0)
+    {
+        ret = FAILURE;
+    }
+    return ret;
+}
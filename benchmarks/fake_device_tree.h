@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file fake_device_tree.h
+//! \brief Defines a generator for fake Linux /dev and /sys trees to run device discovery against
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The tree has the same layout the kernel creates for each kind of device: sg and sd class links into
+    // /sys/devices under a SAS HBA, an AHCI controller, or a USB port, adapter vendor/device/driver files, and the
+    // device type and queue depth. NVMe namespaces only get a /dev entry since discovery does not read sysfs for
+    // them.
+    //
+    // Each /dev entry is a regular file holding the name of the emulated target that serves it. Pass the root to
+    // set_Linux_Device_Root and get_Device_Count, get_Device_List, and get_Device work on it as they would on a real
+    // system. USB devices are served by an emulated SATA disk, as behind a SAT capable bridge.
+
+    typedef struct s_fakeDeviceTreeConfig
+    {
+        uint32_t sasDevices;
+        uint32_t sataDevices;
+        uint32_t usbDevices;
+        uint32_t nvmeDevices;
+    } fakeDeviceTreeConfig;
+
+    // Creates the tree in root, which must exist and should be empty
+    eReturnValues create_Fake_Device_Tree(const char* M_NONNULL root, const fakeDeviceTreeConfig* M_NONNULL config);
+
+    // Removes root and everything under it
+    eReturnValues remove_Fake_Device_Tree(const char* M_NONNULL root);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file translator_benchmark.c
+// \brief Measures the software SCSI to ATA (SATL) and SCSI to NVMe (SNTL) translators by calling them directly with a
+// mix of CDBs against emulated SATA and NVMe targets. Reports translations per second and heap allocations per
+// translation for each CDB and for the whole mix.
+//
+// The translators are not exported from a shared library, so this is only built with default_library=static.
+//
+// Usage: translator_benchmark [--iterations N]
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "benchmark_common.h"
+#include "sat_helper_func.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "sntl_helper.h"
+
+#define TRANSLATOR_SUITE           "translator"
+#define TRANSLATOR_BUFFER_SIZE     UINT32_C(65536)
+#define TRANSLATOR_UNMAP_LIST_LEN  UINT16_C(24) // 8 byte header + one 16 byte block descriptor
+#define TRANSLATOR_TRANSFER_BLOCKS UINT32_C(8)
+
+typedef enum eTranslatorTypeEnum
+{
+    TRANSLATOR_SATL,
+    TRANSLATOR_SNTL,
+} eTranslatorType;
+
+typedef struct s_translatorCdb
+{
+    const char*            name;
+    uint8_t                cdb[CDB_LEN_16];
+    uint8_t                cdbLength;
+    eDataTransferDirection direction;
+    uint32_t               blocks;         // when non-zero, the transfer length is this many logical blocks
+    uint32_t               dataLength;     // otherwise, the allocation or parameter list length in bytes
+    bool                   parameterList;  // data out is the UNMAP parameter list rather than the data buffer
+    uint8_t                senseKey;       // expected sense key. SENSE_KEY_NO_ERROR when the CDB must succeed.
+    uint8_t                asc;            // expected additional sense code for the error injected cases
+    bool                   translators[2]; // indexed by eTranslatorType
+} translatorCdb;
+
+// clang-format off
+static const translatorCdb translatorCdbs[] = {
+    {"read16",                  {READ16, 0, 0, 0, 0, 0, 0, 0, 0, 0x10, 0, 0, 0, TRANSLATOR_TRANSFER_BLOCKS, 0, 0},
+     CDB_LEN_16, XFER_DATA_IN, TRANSLATOR_TRANSFER_BLOCKS, 0, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"write16",                 {WRITE16, 0, 0, 0, 0, 0, 0, 0, 0, 0x10, 0, 0, 0, TRANSLATOR_TRANSFER_BLOCKS, 0, 0},
+     CDB_LEN_16, XFER_DATA_OUT, TRANSLATOR_TRANSFER_BLOCKS, 0, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry",                 {INQUIRY_CMD, 0, 0, 0, 96, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 96, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry_vpd_supported",   {INQUIRY_CMD, 1, SUPPORTED_VPD_PAGES, 0, 0xFF, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 255, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry_vpd_serial",      {INQUIRY_CMD, 1, UNIT_SERIAL_NUMBER, 0, 0xFF, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 255, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry_vpd_device_id",   {INQUIRY_CMD, 1, DEVICE_IDENTIFICATION, 0, 0xFF, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 255, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry_vpd_ata_info",    {INQUIRY_CMD, 1, ATA_INFORMATION, 0x02, 0x3C, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, VPD_ATA_INFORMATION_LEN, false, SENSE_KEY_NO_ERROR, 0, {true, false}},
+    {"inquiry_vpd_block_limits", {INQUIRY_CMD, 1, BLOCK_LIMITS, 0, VPD_BLOCK_LIMITS_LEN, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, VPD_BLOCK_LIMITS_LEN, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"inquiry_vpd_block_char",  {INQUIRY_CMD, 1, BLOCK_DEVICE_CHARACTERISTICS, 0, 64, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, VPD_BLOCK_DEVICE_CHARACTERISTICS_LEN, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"log_sense_supported",     {LOG_SENSE_CMD, 0, 0x40 | LP_SUPPORTED_LOG_PAGES, 0, 0, 0, 0, 0x02, 0, 0},
+     CDB_LEN_10, XFER_DATA_IN, 0, 512, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"log_sense_temperature",   {LOG_SENSE_CMD, 0, 0x40 | LP_TEMPERATURE, 0, 0, 0, 0, 0x02, 0, 0},
+     CDB_LEN_10, XFER_DATA_IN, 0, 512, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"log_sense_info_exceptions", {LOG_SENSE_CMD, 0, 0x40 | LP_INFORMATION_EXCEPTIONS, 0, 0, 0, 0, 0x02, 0, 0},
+     CDB_LEN_10, XFER_DATA_IN, 0, 512, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"mode_sense10_all",        {MODE_SENSE10, 0, 0x3F, 0, 0, 0, 0, 0x10, 0, 0},
+     CDB_LEN_10, XFER_DATA_IN, 0, 4096, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"mode_sense6_caching",     {MODE_SENSE_6_CMD, 0, MP_CACHING, 0, 0xFF, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 255, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"unmap",                   {UNMAP_CMD, 0, 0, 0, 0, 0, 0, 0, TRANSLATOR_UNMAP_LIST_LEN, 0},
+     CDB_LEN_10, XFER_DATA_OUT, 0, TRANSLATOR_UNMAP_LIST_LEN, true, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"report_supported_opcodes", {REPORT_SUPPORTED_OPERATION_CODES_CMD, 0x0C, 0, 0, 0, 0, 0, 0x01, 0, 0, 0, 0},
+     CDB_LEN_12, XFER_DATA_IN, 0, 65536, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    {"read_capacity16",         {READ_CAPACITY_16, 0x10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, READ_CAPACITY_16_LEN, 0, 0},
+     CDB_LEN_16, XFER_DATA_IN, 0, READ_CAPACITY_16_LEN, false, SENSE_KEY_NO_ERROR, 0, {true, true}},
+    // error injected cases. Each of these must be rejected with the sense key and additional sense code given.
+    // LBA out of range
+    {"error_read16_past_capacity", {READ16, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0, 0, 0, 0, 1, 0, 0},
+     CDB_LEN_16, XFER_DATA_IN, 1, 0, false, SENSE_KEY_ILLEGAL_REQUEST, 0x21, {true, true}},
+    // invalid command operation code
+    {"error_invalid_opcode",    {0xFF, 0, 0, 0, 0, 0},
+     CDB_LEN_6, XFER_NO_DATA, 0, 0, false, SENSE_KEY_ILLEGAL_REQUEST, 0x20, {true, true}},
+    // invalid field in CDB
+    {"error_inquiry_page_no_evpd", {INQUIRY_CMD, 0, UNIT_SERIAL_NUMBER, 0, 0xFF, 0},
+     CDB_LEN_6, XFER_DATA_IN, 0, 255, false, SENSE_KEY_ILLEGAL_REQUEST, 0x24, {true, true}},
+    {"error_naca_set",          {INQUIRY_CMD, 0, 0, 0, 96, 0x04},
+     CDB_LEN_6, XFER_DATA_IN, 0, 96, false, SENSE_KEY_ILLEGAL_REQUEST, 0x24, {true, true}},
+};
+// clang-format on
+
+typedef struct s_translatorContext
+{
+    eTranslatorType      translator;
+    const translatorCdb* cdb;     // M_NULLPTR to run the whole mix round robin
+    size_t               nextCdb; // next entry of the mix
+    uint8_t*             buffer;
+    uint8_t*             unmapList;
+    eReturnValues        firstFailure; // first CDB that did not translate or was not rejected as expected
+} translatorContext;
+
+static eReturnValues translate_One_CDB(tDevice* device, translatorContext* context, const translatorCdb* entry)
+{
+    eReturnValues ret = SUCCESS;
+    ScsiIoCtx     scsiIoCtx;
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, SPC3_SENSE_LEN);
+    M_INITIALIZE_STRUCTURE(&scsiIoCtx, sizeof(ScsiIoCtx));
+    safe_memcpy(scsiIoCtx.cdb, SCSI_IO_CTX_MAX_CDB_LEN, entry->cdb, entry->cdbLength);
+    scsiIoCtx.device        = device;
+    scsiIoCtx.cdbLength     = entry->cdbLength;
+    scsiIoCtx.direction     = entry->direction;
+    scsiIoCtx.psense        = senseData;
+    scsiIoCtx.senseDataSize = SPC3_SENSE_LEN;
+    scsiIoCtx.timeout       = DEFAULT_COMMAND_TIMEOUT;
+    if (entry->direction != XFER_NO_DATA)
+    {
+        scsiIoCtx.pdata      = entry->parameterList ? context->unmapList : context->buffer;
+        scsiIoCtx.dataLength = entry->blocks > 0 ? entry->blocks * device->drive_info.deviceBlockSize
+                                                 : entry->dataLength;
+    }
+    if (context->translator == TRANSLATOR_SATL)
+    {
+        ret = translate_SCSI_Command(device, &scsiIoCtx);
+    }
+    else
+    {
+        ret = sntl_Translate_SCSI_Command(device, &scsiIoCtx);
+    }
+    if (context->firstFailure == SUCCESS)
+    {
+        if (entry->senseKey == SENSE_KEY_NO_ERROR)
+        {
+            if (ret != SUCCESS)
+            {
+                fprintf(stderr, "%s failed to translate: %d\n", entry->name, C_CAST(int, ret));
+                context->firstFailure = ret;
+            }
+        }
+        else
+        {
+            uint8_t senseKey = UINT8_C(0);
+            uint8_t asc      = UINT8_C(0);
+            uint8_t ascq     = UINT8_C(0);
+            uint8_t fru      = UINT8_C(0);
+            get_Sense_Key_ASC_ASCQ_FRU(senseData, SPC3_SENSE_LEN, &senseKey, &asc, &ascq, &fru);
+            if (senseKey != entry->senseKey || asc != entry->asc)
+            {
+                fprintf(stderr, "%s expected sense %02" PRIX8 "h/%02" PRIX8 "h, got %02" PRIX8 "h/%02" PRIX8 "h\n",
+                        entry->name, entry->senseKey, entry->asc, senseKey, asc);
+                context->firstFailure = FAILURE;
+            }
+        }
+    }
+    // Translation results are reported through firstFailure so that error injected cases keep running
+    return SUCCESS;
+}
+
+static eReturnValues benchmark_Translate_CDB(tDevice* device, void* context)
+{
+    translatorContext* translator = M_REINTERPRET_CAST(translatorContext*, context);
+    return translate_One_CDB(device, translator, translator->cdb);
+}
+
+static eReturnValues benchmark_Translate_Mix(tDevice* device, void* context)
+{
+    translatorContext*   translator = M_REINTERPRET_CAST(translatorContext*, context);
+    const translatorCdb* entry      = M_NULLPTR;
+    // Skip entries this translator does not support. At least one always is, so this terminates.
+    while (!translatorCdbs[translator->nextCdb].translators[translator->translator])
+    {
+        translator->nextCdb = (translator->nextCdb + 1) % SIZE_OF_STACK_ARRAY(translatorCdbs);
+    }
+    entry               = &translatorCdbs[translator->nextCdb];
+    translator->nextCdb = (translator->nextCdb + 1) % SIZE_OF_STACK_ARRAY(translatorCdbs);
+    return translate_One_CDB(device, translator, entry);
+}
+
+static void fill_Unmap_Parameter_List(uint8_t* unmapList)
+{
+    safe_memset(unmapList, TRANSLATOR_UNMAP_LIST_LEN, 0, TRANSLATOR_UNMAP_LIST_LEN);
+    // unmap data length and block descriptor data length
+    unmapList[1] = TRANSLATOR_UNMAP_LIST_LEN - 2;
+    unmapList[3] = TRANSLATOR_UNMAP_LIST_LEN - 8;
+    // one descriptor: LBA 0x1000 for 0x800 blocks
+    unmapList[8 + 6]  = 0x10;
+    unmapList[8 + 10] = 0x08;
+}
+
+static eReturnValues run_One_Translator_Benchmark(tDevice*           device,
+                                                  translatorContext* context,
+                                                  const char*        name,
+                                                  benchmarkFunc      func,
+                                                  uint32_t           iterations)
+{
+    benchmarkResult result;
+    safe_memset(&result, sizeof(benchmarkResult), 0, sizeof(benchmarkResult));
+    result.suite          = TRANSLATOR_SUITE;
+    result.name           = name;
+    result.target         = context->translator == TRANSLATOR_SATL ? "satl" : "sntl";
+    context->firstFailure = SUCCESS;
+    context->nextCdb      = SIZE_T_C(0);
+    run_Benchmark(device, func, context, iterations, &result);
+    if (result.result == SUCCESS)
+    {
+        result.result = context->firstFailure;
+    }
+    print_Benchmark_Result(&result);
+    return result.result;
+}
+
+static eReturnValues run_Translator_Benchmarks(eTranslatorType translator, uint32_t iterations)
+{
+    eReturnValues       ret    = SUCCESS;
+    tDevice*            device = M_NULLPTR;
+    translatorContext   context;
+    eEmulatedTargetType type = translator == TRANSLATOR_SATL ? EMULATED_TARGET_SATA_DISK
+                                                             : EMULATED_TARGET_NVME_CONTROLLER;
+    safe_memset(&context, sizeof(translatorContext), 0, sizeof(translatorContext));
+    context.translator = translator;
+    ret                = open_Benchmark_Device(type, &device);
+    if (ret != SUCCESS)
+    {
+        fprintf(stderr, "Unable to open the emulated %s device: %d\n", get_Emulated_Target_Name(type),
+                C_CAST(int, ret));
+        return ret;
+    }
+    context.buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(TRANSLATOR_BUFFER_SIZE, sizeof(uint8_t), device->os_info.minimumAlignment));
+    context.unmapList = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(TRANSLATOR_UNMAP_LIST_LEN, sizeof(uint8_t), device->os_info.minimumAlignment));
+    if (context.buffer == M_NULLPTR || context.unmapList == M_NULLPTR)
+    {
+        safe_free_aligned(&context.buffer);
+        safe_free_aligned(&context.unmapList);
+        close_Benchmark_Device(&device);
+        return MEMORY_FAILURE;
+    }
+    fill_Unmap_Parameter_List(context.unmapList);
+    for (size_t iter = SIZE_T_C(0); iter < SIZE_OF_STACK_ARRAY(translatorCdbs); ++iter)
+    {
+        eReturnValues cdbResult = SUCCESS;
+        if (!translatorCdbs[iter].translators[translator])
+        {
+            continue;
+        }
+        context.cdb = &translatorCdbs[iter];
+        cdbResult   = run_One_Translator_Benchmark(device, &context, translatorCdbs[iter].name,
+                                                   benchmark_Translate_CDB, iterations);
+        if (cdbResult != SUCCESS)
+        {
+            ret = cdbResult;
+        }
+    }
+    context.cdb = M_NULLPTR;
+    if (SUCCESS != run_One_Translator_Benchmark(device, &context, "mix", benchmark_Translate_Mix, iterations))
+    {
+        ret = FAILURE;
+    }
+    safe_free_aligned(&context.buffer);
+    safe_free_aligned(&context.unmapList);
+    close_Benchmark_Device(&device);
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int      exitCode   = EXIT_SUCCESS;
+    uint32_t iterations = get_Benchmark_Iterations(argc, argv, BENCHMARK_DEFAULT_ITERATIONS);
+    if (SUCCESS != run_Translator_Benchmarks(TRANSLATOR_SATL, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    if (SUCCESS != run_Translator_Benchmarks(TRANSLATOR_SNTL, iterations))
+    {
+        exitCode = EXIT_FAILURE;
+    }
+    return exitCode;
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_ata_identify.c
+// \brief Fuzzes ATA device discovery (fill_In_ATA_Drive_Info), which parses identify device data and the identify
+// device data and other logs, through SAT ATA pass-through with every response taken from the input.
+
+#include "code_attributes.h"
+#include "common_types.h"
+
+#include "ata_helper_func.h"
+#include "fuzz_common.h"
+
+const char* fuzzHarnessName = "ata_identify";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    tDevice* device = start_Fuzz_Input(EMULATED_TARGET_SATA_DISK, data, size);
+    if (device != M_NULLPTR)
+    {
+        fill_In_ATA_Drive_Info(device);
+        finish_Fuzz_Input(device);
+    }
+    return 0;
+}
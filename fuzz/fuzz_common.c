@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_common.c
+// \brief Implements the fuzzing backend shared by the fuzz harnesses
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "fuzz_common.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+
+#define FUZZ_TARGET_TYPES (3) // indexed by eEmulatedTargetType
+
+typedef struct s_fuzzDevice
+{
+    tDevice*      device;
+    driveInfo     openedDriveInfo; // drive_info right after opening, restored before each input
+    issue_io_func emulatedIO;      // put back before closing so the device is still seen as emulated
+    issue_io_func emulatedNVMeIO;
+} fuzzDevice;
+
+// Harnesses are single threaded and only fuzz one input at a time, so the input being answered from is kept here
+typedef struct s_fuzzInput
+{
+    const uint8_t* data;
+    size_t         size;
+    size_t         offset;
+} fuzzInput;
+
+static fuzzDevice fuzzDevices[FUZZ_TARGET_TYPES];
+static fuzzInput  currentInput;
+
+static bool has_Fuzz_Input(void)
+{
+    return currentInput.data != M_NULLPTR && currentInput.offset < currentInput.size;
+}
+
+// Copies up to length bytes from the input into buffer and returns how many were copied. Anything past the end of the
+// input is left zero.
+static size_t take_Fuzz_Bytes(uint8_t* buffer, size_t length)
+{
+    size_t available = has_Fuzz_Input() ? M_Min(length, currentInput.size - currentInput.offset) : SIZE_T_C(0);
+    safe_memset(buffer, length, 0, length);
+    if (available > SIZE_T_C(0))
+    {
+        safe_memcpy(buffer, length, &currentInput.data[currentInput.offset], available);
+        currentInput.offset += available;
+    }
+    return available;
+}
+
+static uint8_t take_Fuzz_Byte(void)
+{
+    uint8_t value = UINT8_C(0);
+    take_Fuzz_Bytes(&value, 1);
+    return value;
+}
+
+static uint16_t take_Fuzz_Length(void)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, length, 2);
+    take_Fuzz_Bytes(length, 2);
+    return M_BytesTo2ByteValue(length[0], length[1]);
+}
+
+// Reads length bytes of the input into buffer, clipped to bufferSize. Anything that does not fit is skipped so the
+// next response still starts where the input says it does.
+static void take_Fuzz_Data(uint8_t* buffer, uint32_t bufferSize, size_t length)
+{
+    size_t copied = M_Min(length, C_CAST(size_t, bufferSize));
+    if (buffer != M_NULLPTR && copied > SIZE_T_C(0))
+    {
+        take_Fuzz_Bytes(buffer, copied);
+    }
+    else
+    {
+        copied = SIZE_T_C(0);
+    }
+    if (has_Fuzz_Input())
+    {
+        currentInput.offset += M_Min(length - copied, currentInput.size - currentInput.offset);
+    }
+}
+
+static eReturnValues fuzz_Issue_IO(void* ioCtx)
+{
+    ScsiIoCtx* scsiIoCtx = M_REINTERPRET_CAST(ScsiIoCtx*, ioCtx);
+    set_tDevice_Last_Command_Completion_Time_NS(scsiIoCtx->device, UINT64_C(0));
+    safe_memset(&scsiIoCtx->returnStatus, sizeof(scsiStatus), 0, sizeof(scsiStatus));
+    scsiIoCtx->returnStatus.format = 0xFF;
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+    {
+        safe_memset(scsiIoCtx->psense, scsiIoCtx->senseDataSize, 0, scsiIoCtx->senseDataSize);
+    }
+    if (!has_Fuzz_Input())
+    {
+        return OS_PASSTHROUGH_FAILURE;
+    }
+    switch (take_Fuzz_Byte() % FUZZ_RESPONSE_TYPES)
+    {
+    case FUZZ_RESPONSE_GOOD:
+    {
+        uint16_t length = take_Fuzz_Length();
+        if (scsiIoCtx->direction == XFER_DATA_IN)
+        {
+            take_Fuzz_Data(scsiIoCtx->pdata, scsiIoCtx->dataLength, length);
+        }
+        else
+        {
+            take_Fuzz_Data(M_NULLPTR, UINT32_C(0), length);
+        }
+    }
+    break;
+    case FUZZ_RESPONSE_ERROR:
+    {
+        uint8_t length = take_Fuzz_Byte();
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, SPC3_SENSE_LEN);
+        take_Fuzz_Data(senseData, SPC3_SENSE_LEN, length);
+        if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+        {
+            safe_memcpy(scsiIoCtx->psense, scsiIoCtx->senseDataSize, senseData,
+                        M_Min(scsiIoCtx->senseDataSize, SPC3_SENSE_LEN));
+        }
+        safe_memcpy(scsiIoCtx->device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN, senseData, SPC3_SENSE_LEN);
+        scsiIoCtx->returnStatus.format = senseData[0];
+        get_Sense_Key_ASC_ASCQ_FRU(senseData, SPC3_SENSE_LEN, &scsiIoCtx->returnStatus.senseKey,
+                                   &scsiIoCtx->returnStatus.asc, &scsiIoCtx->returnStatus.ascq,
+                                   &scsiIoCtx->returnStatus.fru);
+    }
+    break;
+    default:
+        return OS_PASSTHROUGH_FAILURE;
+    }
+    return SUCCESS;
+}
+
+static eReturnValues fuzz_Issue_NVMe_IO(void* ioCtx)
+{
+    nvmeCmdCtx* cmdCtx       = M_REINTERPRET_CAST(nvmeCmdCtx*, ioCtx);
+    uint8_t     responseType = UINT8_C(0);
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, dword0, 4);
+    set_tDevice_Last_Command_Completion_Time_NS(cmdCtx->device, UINT64_C(0));
+    safe_memset(&cmdCtx->commandCompletionData, sizeof(completionQueueEntry), 0, sizeof(completionQueueEntry));
+    if (!has_Fuzz_Input())
+    {
+        return OS_PASSTHROUGH_FAILURE;
+    }
+    responseType = take_Fuzz_Byte() % FUZZ_RESPONSE_TYPES;
+    if (responseType == FUZZ_RESPONSE_TRANSPORT_ERROR)
+    {
+        return OS_PASSTHROUGH_FAILURE;
+    }
+    take_Fuzz_Bytes(dword0, 4);
+    cmdCtx->commandCompletionData.dw0 = M_BytesTo4ByteValue(dword0[3], dword0[2], dword0[1], dword0[0]);
+    if (responseType == FUZZ_RESPONSE_ERROR)
+    {
+        cmdCtx->commandCompletionData.dw3 = C_CAST(uint32_t, take_Fuzz_Length() & UINT16_C(0xFFFE)) << 16;
+    }
+    if (cmdCtx->commandDirection == XFER_DATA_IN)
+    {
+        take_Fuzz_Data(cmdCtx->ptrData, cmdCtx->dataSize, take_Fuzz_Length());
+    }
+    else
+    {
+        take_Fuzz_Data(M_NULLPTR, UINT32_C(0), take_Fuzz_Length());
+    }
+    cmdCtx->commandCompletionData.dw0Valid = true;
+    cmdCtx->commandCompletionData.dw3Valid = true;
+    return SUCCESS;
+}
+
+static void free_Fuzz_Translator_Caches(tDevice* device)
+{
+    safe_free_sat_translator_cache(&device->drive_info.satCache);
+    safe_free_sntl_translator_cache(&device->drive_info.sntlCache);
+}
+
+static eReturnValues open_Fuzz_Device(eEmulatedTargetType type, fuzzDevice* fuzzDev)
+{
+    eReturnValues        ret    = SUCCESS;
+    tDevice*             device = M_NULLPTR;
+    emulatedTargetConfig config;
+    device = M_REINTERPRET_CAST(tDevice*, safe_calloc(1, sizeof(tDevice)));
+    if (device == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    device->sanity.size     = sizeof(tDevice);
+    device->sanity.version  = DEVICE_BLOCK_VERSION;
+    device->deviceVerbosity = VERBOSITY_QUIET;
+    get_Default_Emulated_Target_Config(&config, type);
+    ret = open_Emulated_Device(device, &config);
+    if (ret != SUCCESS)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, &device));
+        return ret;
+    }
+    // The caches are owned by whichever input allocates them, so the saved state must not point at one
+    free_Fuzz_Translator_Caches(device);
+    safe_memcpy(&fuzzDev->openedDriveInfo, sizeof(driveInfo), &device->drive_info, sizeof(driveInfo));
+    fuzzDev->emulatedIO     = device->issue_io;
+    fuzzDev->emulatedNVMeIO = device->issue_nvme_io;
+    fuzzDev->device         = device;
+    return SUCCESS;
+}
+
+tDevice* start_Fuzz_Input(eEmulatedTargetType type, const uint8_t* data, size_t size)
+{
+    fuzzDevice* fuzzDev = M_NULLPTR;
+    tDevice*    device  = M_NULLPTR;
+    if (C_CAST(int, type) < 0 || C_CAST(int, type) >= FUZZ_TARGET_TYPES)
+    {
+        return M_NULLPTR;
+    }
+    fuzzDev = &fuzzDevices[type];
+    if (fuzzDev->device == M_NULLPTR && SUCCESS != open_Fuzz_Device(type, fuzzDev))
+    {
+        return M_NULLPTR;
+    }
+    device = fuzzDev->device;
+    free_Fuzz_Translator_Caches(device);
+    safe_memcpy(&device->drive_info, sizeof(driveInfo), &fuzzDev->openedDriveInfo, sizeof(driveInfo));
+    device->issue_io = fuzz_Issue_IO;
+    if (fuzzDev->emulatedNVMeIO != M_NULLPTR)
+    {
+        device->issue_nvme_io = fuzz_Issue_NVMe_IO;
+    }
+    currentInput.data   = data;
+    currentInput.size   = data != M_NULLPTR ? size : SIZE_T_C(0);
+    currentInput.offset = SIZE_T_C(0);
+    return device;
+}
+
+void finish_Fuzz_Input(tDevice* device)
+{
+    currentInput.data   = M_NULLPTR;
+    currentInput.size   = SIZE_T_C(0);
+    currentInput.offset = SIZE_T_C(0);
+    free_Fuzz_Translator_Caches(device);
+    for (size_t iter = SIZE_T_C(0); iter < FUZZ_TARGET_TYPES; ++iter)
+    {
+        if (fuzzDevices[iter].device == device)
+        {
+            device->issue_io      = fuzzDevices[iter].emulatedIO;
+            device->issue_nvme_io = fuzzDevices[iter].emulatedNVMeIO;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_common.h
+// \brief Defines the fuzzing backend shared by the fuzz harnesses
+
+#pragma once
+
+#include "common_public.h"
+#include "emulated_target.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The harnesses use emulated targets with the OS layer replaced, so every command the library sends is completed
+    // with a response taken from the fuzz input instead. The input is read as a sequence of responses, one for each
+    // command, in the order the commands are sent:
+    //
+    // SCSI:  1 byte response type (taken modulo FUZZ_RESPONSE_TYPES), then
+    //        good:            2 byte big endian length, then that many bytes of data in
+    //        check condition: 1 byte length, then that many bytes of sense data
+    //        transport error: nothing. The OS layer returns OS_PASSTHROUGH_FAILURE.
+    // NVMe:  1 byte response type, then
+    //        good:            4 byte little endian dword 0, 2 byte big endian length, then data in
+    //        error status:    4 byte little endian dword 0, 2 byte big endian upper half of completion dword 3
+    //                         (the status field. The phase tag bit is ignored), 2 byte big endian length, then data in
+    //        transport error: nothing
+    //
+    // Lengths are clipped to the command's buffer and to what is left of the input. Once the input runs out, every
+    // command fails with OS_PASSTHROUGH_FAILURE, the same as a device that stopped responding.
+    //
+    // Between inputs the device is put back as it was right after it was opened, so each input starts from the same
+    // state and a crash can be reproduced from the input alone.
+
+#define FUZZ_MAX_INPUT_SIZE (1048576)
+
+    typedef enum eFuzzResponseTypeEnum
+    {
+        FUZZ_RESPONSE_GOOD,
+        FUZZ_RESPONSE_ERROR, // check condition for SCSI, error status for NVMe
+        FUZZ_RESPONSE_TRANSPORT_ERROR,
+        FUZZ_RESPONSE_TYPES
+    } eFuzzResponseType;
+
+    // Each harness defines this. It is called by libFuzzer or by fuzz_driver.c with one input at a time.
+    int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+    // The name printed with the throughput by fuzz_driver.c. Each harness defines this.
+    extern const char* fuzzHarnessName;
+
+    // Gets the device for the type, opening it the first time, and starts answering its commands from data. The
+    // device is reset to the state it was opened in. Returns M_NULLPTR if the device could not be opened.
+    tDevice* M_NULLABLE start_Fuzz_Input(eEmulatedTargetType type, const uint8_t* M_NULLABLE data, size_t size);
+
+    // Stops answering commands from the input given to start_Fuzz_Input. Commands sent after this fail.
+    void finish_Fuzz_Input(tDevice* M_NONNULL device);
+
+#if defined(__cplusplus)
+}
+#endif
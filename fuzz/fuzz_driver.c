@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_driver.c
+// \brief main() for the fuzz harnesses when they are not built with libFuzzer. Runs each file given on the command
+// line through the harness once, which is how AFL runs them (with @@) and how a crash is reproduced. With no files,
+// one input is read from stdin. "--iterations N" runs N pseudo random inputs instead, as a smoke test, and prints the
+// throughput as one JSON object on stdout in the same form as the benchmarks.
+//
+// Usage: fuzz_<harness> [--iterations N] [--max-size N] [--seed N] [file ...]
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "string_utils.h"
+#include "type_conversion.h"
+
+#include <stdlib.h>
+
+#include "fuzz_common.h"
+
+#define FUZZ_DEFAULT_MAX_SIZE UINT32_C(4096)
+#define FUZZ_DEFAULT_SEED     UINT64_C(0x9E3779B97F4A7C15)
+
+typedef struct s_fuzzDriverOptions
+{
+    uint32_t iterations; // 0 = run files or stdin
+    uint32_t maxSize;
+    uint64_t seed;
+    int      firstFile; // index in argv of the first file, or argc when there are none
+} fuzzDriverOptions;
+
+typedef struct s_fuzzDriverTotals
+{
+    uint64_t inputs;
+    uint64_t bytes;
+    uint64_t totalNS;
+} fuzzDriverTotals;
+
+static bool get_Fuzz_Driver_Number(const char* arg, uint64_t maximum, uint64_t* value)
+{
+    char*              end    = M_NULLPTR;
+    unsigned long long parsed = strtoull(arg, &end, 0);
+    if (end == arg || *end != '\0' || parsed == 0ULL || parsed > maximum)
+    {
+        fprintf(stderr, "Invalid number: %s\n", arg);
+        return false;
+    }
+    *value = C_CAST(uint64_t, parsed);
+    return true;
+}
+
+static bool get_Fuzz_Driver_Options(int argc, char* argv[], fuzzDriverOptions* options)
+{
+    options->iterations = UINT32_C(0);
+    options->maxSize    = FUZZ_DEFAULT_MAX_SIZE;
+    options->seed       = FUZZ_DEFAULT_SEED;
+    options->firstFile  = argc;
+    for (int iter = 1; iter < argc; ++iter)
+    {
+        uint64_t value = UINT64_C(0);
+        if (iter + 1 < argc && strcmp(argv[iter], "--iterations") == 0)
+        {
+            if (!get_Fuzz_Driver_Number(argv[++iter], UINT32_MAX, &value))
+            {
+                return false;
+            }
+            options->iterations = C_CAST(uint32_t, value);
+        }
+        else if (iter + 1 < argc && strcmp(argv[iter], "--max-size") == 0)
+        {
+            if (!get_Fuzz_Driver_Number(argv[++iter], FUZZ_MAX_INPUT_SIZE, &value))
+            {
+                return false;
+            }
+            options->maxSize = C_CAST(uint32_t, value);
+        }
+        else if (iter + 1 < argc && strcmp(argv[iter], "--seed") == 0)
+        {
+            if (!get_Fuzz_Driver_Number(argv[++iter], UINT64_MAX, &value))
+            {
+                return false;
+            }
+            options->seed = value;
+        }
+        else
+        {
+            options->firstFile = iter;
+            break;
+        }
+    }
+    return true;
+}
+
+static void run_Fuzz_Input(const uint8_t* data, size_t size, fuzzDriverTotals* totals)
+{
+    DECLARE_SEATIMER(inputTimer);
+    start_Timer(&inputTimer);
+    LLVMFuzzerTestOneInput(data, size);
+    stop_Timer(&inputTimer);
+    totals->totalNS += get_Nano_Seconds(inputTimer);
+    totals->bytes += size;
+    ++totals->inputs;
+}
+
+// Reads a whole file, or stdin when file is M_NULLPTR, up to FUZZ_MAX_INPUT_SIZE bytes
+static eReturnValues read_Fuzz_Input(const char* fileName, uint8_t* buffer, size_t* size)
+{
+    FILE* input = stdin;
+    *size       = SIZE_T_C(0);
+    if (fileName != M_NULLPTR)
+    {
+        errno_t fileopenerr = safe_fopen(&input, fileName, "rb");
+        if (fileopenerr != 0 || input == M_NULLPTR)
+        {
+            fprintf(stderr, "Unable to open %s\n", fileName);
+            return FILE_OPEN_ERROR;
+        }
+    }
+    while (*size < FUZZ_MAX_INPUT_SIZE && !feof(input) && !ferror(input))
+    {
+        *size += fread(&buffer[*size], sizeof(uint8_t), FUZZ_MAX_INPUT_SIZE - *size, input);
+    }
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+    return SUCCESS;
+}
+
+// xorshift64*. Only needs to be fast and repeatable for a given seed.
+static uint64_t next_Fuzz_Random(uint64_t* state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+static void run_Random_Fuzz_Inputs(const fuzzDriverOptions* options, uint8_t* buffer, fuzzDriverTotals* totals)
+{
+    uint64_t state = options->seed;
+    for (uint32_t iter = UINT32_C(0); iter < options->iterations; ++iter)
+    {
+        size_t size = C_CAST(size_t, next_Fuzz_Random(&state) % (C_CAST(uint64_t, options->maxSize) + UINT64_C(1)));
+        for (size_t offset = SIZE_T_C(0); offset < size; offset += sizeof(uint64_t))
+        {
+            uint64_t value = next_Fuzz_Random(&state);
+            safe_memcpy(&buffer[offset], FUZZ_MAX_INPUT_SIZE - offset, &value, M_Min(sizeof(uint64_t), size - offset));
+        }
+        run_Fuzz_Input(buffer, size, totals);
+    }
+}
+
+static void print_Fuzz_Throughput(const fuzzDriverTotals* totals)
+{
+    double seconds = totals->totalNS > 0 ? C_CAST(double, totals->totalNS) / 1.0e9 : 1.0;
+    printf("{\"suite\":\"fuzz\",\"harness\":\"%s\",\"inputs\":%" PRIu64 ",\"bytes\":%" PRIu64
+           ",\"total_ns\":%" PRIu64 ",\"execs_per_second\":%.0f,\"megabytes_per_second\":%.2f}\n",
+           fuzzHarnessName, totals->inputs, totals->bytes, totals->totalNS, C_CAST(double, totals->inputs) / seconds,
+           (C_CAST(double, totals->bytes) / 1048576.0) / seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    int               exitCode = EXIT_SUCCESS;
+    fuzzDriverOptions options;
+    fuzzDriverTotals  totals;
+    uint8_t*          buffer = M_NULLPTR;
+    M_INITIALIZE_STRUCTURE(&totals, sizeof(fuzzDriverTotals));
+    if (!get_Fuzz_Driver_Options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    buffer = M_REINTERPRET_CAST(uint8_t*, safe_calloc(FUZZ_MAX_INPUT_SIZE, sizeof(uint8_t)));
+    if (buffer == M_NULLPTR)
+    {
+        return EXIT_FAILURE;
+    }
+    for (int iter = options.firstFile; iter < argc; ++iter)
+    {
+        size_t size = SIZE_T_C(0);
+        if (SUCCESS != read_Fuzz_Input(argv[iter], buffer, &size))
+        {
+            exitCode = EXIT_FAILURE;
+            continue;
+        }
+        run_Fuzz_Input(buffer, size, &totals);
+    }
+    if (options.iterations > UINT32_C(0))
+    {
+        run_Random_Fuzz_Inputs(&options, buffer, &totals);
+        print_Fuzz_Throughput(&totals);
+    }
+    else if (options.firstFile == argc)
+    {
+        size_t size = SIZE_T_C(0);
+        if (SUCCESS == read_Fuzz_Input(M_NULLPTR, buffer, &size))
+        {
+            run_Fuzz_Input(buffer, size, &totals);
+        }
+    }
+    safe_free(&buffer);
+    return exitCode;
+}
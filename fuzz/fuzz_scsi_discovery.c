@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_scsi_discovery.c
+// \brief Fuzzes SCSI device discovery (fill_In_Device_Info), which parses standard inquiry, the VPD pages, read
+// capacity, and mode pages, with every response taken from the input.
+
+#include "code_attributes.h"
+#include "common_types.h"
+
+#include "fuzz_common.h"
+#include "scsi_helper_func.h"
+
+const char* fuzzHarnessName = "scsi_discovery";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    tDevice* device = start_Fuzz_Input(EMULATED_TARGET_SAS_DISK, data, size);
+    if (device != M_NULLPTR)
+    {
+        fill_In_Device_Info(device);
+        finish_Fuzz_Input(device);
+    }
+    return 0;
+}
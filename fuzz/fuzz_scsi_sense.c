@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_scsi_sense.c
+// \brief Fuzzes the sense data parsers with the input as the sense data, and the version descriptor decoder with each
+// pair of bytes in the input. These are called directly since they do not send commands.
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "fuzz_common.h"
+#include "scsi_helper_func.h"
+
+const char* fuzzHarnessName = "scsi_sense";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static tDevice  device; // only the verbosity is used when checking sense data
+    uint32_t        senseLength = C_CAST(uint32_t, M_Min(size, UINT32_MAX));
+    uint8_t         senseKey    = UINT8_C(0);
+    uint8_t         asc         = UINT8_C(0);
+    uint8_t         ascq        = UINT8_C(0);
+    uint8_t         fru         = UINT8_C(0);
+    senseDataFields senseFields;
+    DECLARE_ZERO_INIT_ARRAY(char, versionString, MAX_VERSION_DESCRIPTOR_STRING_LENGTH);
+    if (data == M_NULLPTR || size == SIZE_T_C(0))
+    {
+        return 0;
+    }
+    device.deviceVerbosity = VERBOSITY_QUIET;
+    safe_memset(&senseFields, sizeof(senseDataFields), 0, sizeof(senseDataFields));
+    get_Sense_Data_Fields(data, senseLength, &senseFields);
+    check_Sense_Key_ASC_ASCQ_And_FRU(&device, senseFields.scsiStatusCodes.senseKey, senseFields.scsiStatusCodes.asc,
+                                     senseFields.scsiStatusCodes.ascq, senseFields.scsiStatusCodes.fru);
+    get_Sense_Key_ASC_ASCQ_FRU(data, senseLength, &senseKey, &asc, &ascq, &fru);
+    check_Sense_Key_ASC_ASCQ_And_FRU(&device, senseKey, asc, ascq, fru);
+    for (size_t offset = SIZE_T_C(0); offset + SIZE_T_C(1) < size; offset += SIZE_T_C(2))
+    {
+        decypher_SCSI_Version_Descriptors_Len(M_BytesTo2ByteValue(data[offset], data[offset + 1]), versionString,
+                                              MAX_VERSION_DESCRIPTOR_STRING_LENGTH);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fuzz_translators.c
+// \brief Fuzzes the software SCSI to ATA (SATL) and SCSI to NVMe (SNTL) translators. The start of the input is the
+// SCSI command given to the translator, so the CDB and parameter list parsing are fuzzed, and the rest is the
+// responses to the ATA or NVMe commands it is translated into, so the parsing of identify data, logs, and status is
+// fuzzed too.
+//
+// Input: 1 byte translator (bit 0: 0 = SATL, 1 = SNTL), 1 byte transfer direction, 2 byte big endian transfer length,
+// 16 bytes CDB (its length comes from the operation code group), then for data out the transfer length of parameter
+// data, then the responses as described in fuzz_common.h.
+//
+// The translators are not exported from a shared library, so this is only built with default_library=static.
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "fuzz_common.h"
+#include "sat_helper_func.h"
+#include "scsi_helper.h"
+#include "sntl_helper.h"
+
+#define TRANSLATOR_FUZZ_HEADER_LEN  (SIZE_T_C(4) + CDB_LEN_16)
+#define TRANSLATOR_FUZZ_BUFFER_SIZE UINT32_C(65536)
+
+const char* fuzzHarnessName = "translators";
+
+static uint8_t get_Fuzz_CDB_Length(uint8_t operationCode)
+{
+    switch (M_Nibble1(operationCode) >> 1)
+    {
+    case 0:
+        return CDB_LEN_6;
+    case 1:
+    case 2:
+        return CDB_LEN_10;
+    case 5:
+        return CDB_LEN_12;
+    default:
+        return CDB_LEN_16;
+    }
+}
+
+static eDataTransferDirection get_Fuzz_Direction(uint8_t value)
+{
+    switch (value % 3)
+    {
+    case 0:
+        return XFER_NO_DATA;
+    case 1:
+        return XFER_DATA_IN;
+    default:
+        return XFER_DATA_OUT;
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static uint8_t* buffer    = M_NULLPTR;
+    bool            useSNTL   = false;
+    tDevice*        device    = M_NULLPTR;
+    size_t          offset    = TRANSLATOR_FUZZ_HEADER_LEN;
+    ScsiIoCtx       scsiIoCtx;
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, SPC3_SENSE_LEN);
+    if (data == M_NULLPTR || size < TRANSLATOR_FUZZ_HEADER_LEN)
+    {
+        return 0;
+    }
+    if (buffer == M_NULLPTR)
+    {
+        // kept for the life of the process, since the harness is called for every input
+        buffer = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(TRANSLATOR_FUZZ_BUFFER_SIZE, sizeof(uint8_t), 4096));
+        if (buffer == M_NULLPTR)
+        {
+            return 0;
+        }
+    }
+    safe_memset(buffer, TRANSLATOR_FUZZ_BUFFER_SIZE, 0, TRANSLATOR_FUZZ_BUFFER_SIZE);
+    M_INITIALIZE_STRUCTURE(&scsiIoCtx, sizeof(ScsiIoCtx));
+    useSNTL                 = (data[0] & BIT0) > 0;
+    scsiIoCtx.direction     = get_Fuzz_Direction(data[1]);
+    scsiIoCtx.cdbLength     = get_Fuzz_CDB_Length(data[4]);
+    scsiIoCtx.psense        = senseData;
+    scsiIoCtx.senseDataSize = SPC3_SENSE_LEN;
+    scsiIoCtx.timeout       = DEFAULT_COMMAND_TIMEOUT;
+    safe_memcpy(scsiIoCtx.cdb, SCSI_IO_CTX_MAX_CDB_LEN, &data[4], scsiIoCtx.cdbLength);
+    if (scsiIoCtx.direction != XFER_NO_DATA)
+    {
+        scsiIoCtx.pdata      = buffer;
+        scsiIoCtx.dataLength = M_Min(C_CAST(uint32_t, M_BytesTo2ByteValue(data[2], data[3])),
+                                     TRANSLATOR_FUZZ_BUFFER_SIZE);
+    }
+    if (scsiIoCtx.direction == XFER_DATA_OUT)
+    {
+        size_t parameterLength = M_Min(C_CAST(size_t, scsiIoCtx.dataLength), size - offset);
+        safe_memcpy(buffer, TRANSLATOR_FUZZ_BUFFER_SIZE, &data[offset], parameterLength);
+        offset += parameterLength;
+    }
+    device = start_Fuzz_Input(useSNTL ? EMULATED_TARGET_NVME_CONTROLLER : EMULATED_TARGET_SATA_DISK, &data[offset],
+                              size - offset);
+    if (device != M_NULLPTR)
+    {
+        scsiIoCtx.device = device;
+        if (useSNTL)
+        {
+            sntl_Translate_SCSI_Command(device, &scsiIoCtx);
+        }
+        else
+        {
+            translate_SCSI_Command(device, &scsiIoCtx);
+        }
+        finish_Fuzz_Input(device);
+    }
+    return 0;
+}
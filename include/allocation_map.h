@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file allocation_map.h
+//! \brief Defines reading the logical block provisioning status of a range of LBAs into a compact list of mapped,
+//! deallocated and anchored extents
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The map is read with SCSI GET LBA STATUS, each command using the largest buffer the device and the passthrough
+    // accept so a thin provisioned device is described in as few commands as possible. Neighbouring descriptors with
+    // the same status are merged into one extent.
+    //
+    // Status the device reports as unknown is listed as mapped, so a scan that skips deallocated and anchored extents
+    // never skips data. The same goes for the rest of the range when the device stops returning descriptors partway.
+    // ATA and NVMe have no command that reports the provisioning status of an LBA range (NVMe Get LBA Status reports
+    // potentially unrecoverable LBAs instead), so only SCSI devices, including ATA devices behind a SATL that
+    // translates GET LBA STATUS, are supported.
+
+    typedef enum eAllocationStateEnum
+    {
+        ALLOCATION_MAPPED,      // mapped, or the device does not know
+        ALLOCATION_DEALLOCATED, // no storage is used. Reads return the device's deallocated data pattern.
+        ALLOCATION_ANCHORED,    // storage is reserved but nothing has been written since it was deallocated
+    } eAllocationState;
+
+    typedef struct s_allocationExtent
+    {
+        uint64_t         startLBA;
+        uint64_t         length; // number of logical blocks
+        eAllocationState state;
+    } allocationExtent;
+
+    typedef struct s_allocationMap
+    {
+        uint32_t                     numberOfExtents;
+        allocationExtent* M_NULLABLE extents; // in LBA order, covering the whole range that was read
+        uint64_t                     mappedBlocks;
+        uint64_t                     deallocatedBlocks;
+        uint64_t                     anchoredBlocks;
+        uint32_t                     commands; // GET LBA STATUS commands sent
+    } allocationMap;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Allocation_Map(tDevice *device, uint64_t startLBA, uint64_t length, allocationMap *map)
+    //
+    //! \brief   Description:  Reads the provisioning status of a range of LBAs into a list of extents.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] startLBA = first LBA to read the status of
+    //!   \param[in] length = number of logical blocks. 0 reads to the end of the device.
+    //!   \param[out] map = filled in with the extents. Free it with free_Allocation_Map.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = map filled in, NOT_SUPPORTED = not a SCSI device or GET LBA STATUS is not supported,
+    //!   BAD_PARAMETER = the range is past the end of the device, MEMORY_FAILURE = unable to allocate the map,
+    //!   anything else = the error from GET LBA STATUS. The map is empty on error.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(4)
+    OPENSEA_TRANSPORT_API eReturnValues get_Allocation_Map(const tDevice* M_NONNULL device,
+                                                           uint64_t                 startLBA,
+                                                           uint64_t                 length,
+                                                           allocationMap* M_NONNULL map);
+
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void free_Allocation_Map(allocationMap* M_NULLABLE map);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Allocation_Map_Mapped_Ranges(allocationMap *map, lbaRange *ranges, uint32_t maxRanges)
+    //
+    //! \brief   Description:  Lists the mapped extents of a map as LBA ranges, the ranges a scan or an image needs to
+    //!          read.
+    //
+    //  Entry:
+    //!   \param[in] map = map from get_Allocation_Map
+    //!   \param[out] ranges = optional. Filled in with up to maxRanges ranges.
+    //!   \param[in] maxRanges = number of entries in ranges
+    //!
+    //  Exit:
+    //!   \return number of mapped extents in the map, which may be more than maxRanges
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO_SIZE(2, 3)
+    OPENSEA_TRANSPORT_API uint32_t get_Allocation_Map_Mapped_Ranges(const allocationMap* M_NONNULL map,
+                                                                    lbaRange* M_NULLABLE           ranges,
+                                                                    uint32_t                       maxRanges);
+
+#if defined(__cplusplus)
+}
+#endif
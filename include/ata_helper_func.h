@@ -3400,6 +3400,57 @@ extern "C"
                                                 uint32_t                 lbaToReturn,
                                                 ataReturnTFRs* M_NONNULL returnTFRs);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  fill_ATA_DSM_Trim_Buffer()
+    //
+    //! \brief   Description:  Fills a data set management buffer with TRIM range entries from a list of LBA ranges,
+    //!                        splitting ranges that are longer than a single entry allows. Start with rangeIndex and
+    //!                        rangeOffset set to zero and call again with the same values until rangeIndex reaches
+    //!                        numberOfRanges to build each command that is needed.
+    //!                        Ranges should already be run through coalesce_LBA_Ranges to use the fewest entries.
+    //
+    //  Entry:
+    //!   \param[in] ranges = list of LBA ranges to deallocate
+    //!   \param[in] numberOfRanges = number of entries in ranges
+    //!   \param[in,out] rangeIndex = index of the range to continue from
+    //!   \param[in,out] rangeOffset = number of blocks of the current range already placed in a previous buffer
+    //!   \param[out] buffer = buffer to fill. Cleared before filling so unused entries are zero.
+    //!   \param[in] bufferSize = size of buffer. Must be a multiple of 512 and no more than identify word 105 allows
+    //!   \param[in] xl = set to build entries for data set management XL
+    //!
+    //  Exit:
+    //!   \return number of range entries placed in buffer.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO_SIZE(1, 2)
+    M_PARAM_RW(3)
+    M_PARAM_RW(4)
+    M_PARAM_WO_SIZE(5, 6)
+    OPENSEA_TRANSPORT_API uint32_t fill_ATA_DSM_Trim_Buffer(const lbaRange* M_NONNULL ranges,
+                                                            uint32_t                  numberOfRanges,
+                                                            uint32_t* M_NONNULL       rangeIndex,
+                                                            uint64_t* M_NONNULL       rangeOffset,
+                                                            uint8_t* M_NONNULL        buffer,
+                                                            uint32_t                  bufferSize,
+                                                            bool                      xl);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  is_ATA_NCQ_Trim_Supported()
+    //
+    //! \brief   Description:  Checks if data set management with TRIM can be issued as a queued command with SEND FPDMA
+    //!                        QUEUED. This reads the NCQ send and receive log, so callers should save the result.
+    //
+    //  Entry:
+    //!   \param[in] device = device struct that holds device information.
+    //!
+    //  Exit:
+    //!   \return true = queued TRIM is supported, false = not supported or unable to tell.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1) OPENSEA_TRANSPORT_API bool is_ATA_NCQ_Trim_Supported(const tDevice* M_NONNULL device);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file ata_log_reader.h
+//! \brief Defines reading large ATA general purpose logs, such as the device internal status logs, in the largest
+//! chunks the device and the bridge accept, handing each chunk to a callback as it arrives
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // Each chunk is as large as the largest read the device, the passthrough and a SAT bridge accept
+    // (get_Surface_Scan_Blocks_Per_Command), up to the 65535 pages one READ LOG EXT can return. Only one chunk is
+    // held in memory.
+    //
+    // The command used for each chunk is, in order of preference:
+    //  1. READ LOG DMA EXT queued through RECEIVE FPDMA QUEUED, when the device supports NCQ send and receive
+    //     (identify word 77 bit 6) and the options allow it. It is dropped for the rest of the log the first time it
+    //     fails, and that chunk is read again with the next command.
+    //  2. send_ATA_Read_Log_Ext_Cmd: READ LOG DMA EXT when the identify data says it works, otherwise READ LOG EXT.
+
+    // Called with each chunk, in order. firstPage is the log page the chunk starts with. Return false to stop reading.
+    typedef bool (*ataLogChunkCallback)(const uint8_t* M_NONNULL data,
+                                        uint32_t                 dataLength,
+                                        uint16_t                 firstPage,
+                                        void* M_NULLABLE         context);
+
+    typedef struct s_ataLogReaderOptions
+    {
+        uint8_t                        logAddress;
+        uint16_t                       featureRegister; // 0 unless the log requires something specific
+        uint32_t                       logPages;        // 512 byte pages. 0 uses the size in the log directory.
+        uint16_t                       chunkPages;      // 0 uses the largest chunk the device and the bridge accept
+        bool                           noQueuedReads;   // never use RECEIVE FPDMA QUEUED
+        ataLogChunkCallback M_NULLABLE chunkCallback;
+        void* M_NULLABLE               callbackContext;
+    } ataLogReaderOptions;
+
+    typedef struct s_ataLogReaderResults
+    {
+        uint32_t logPages; // pages in the log, as given or read from the log directory
+        uint32_t pagesRead;
+        uint16_t chunkPages; // chunk size used
+        uint32_t commands;   // including queued reads that failed and were sent again
+        bool     queued;     // the last chunk was read with RECEIVE FPDMA QUEUED
+    } ataLogReaderResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  ata_Read_Log_Stream(tDevice *device, ataLogReaderOptions *options, ataLogReaderResults *results)
+    //
+    //! \brief   Description:  Reads an ATA general purpose log in chunks and hands each one to the options' chunk
+    //!          callback.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. Must be an ATA device.
+    //!   \param[in] options = log to read. chunkCallback must be set.
+    //!   \param[out] results = optional. Filled in with how the log was read, including when it fails.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = whole log read, NOT_SUPPORTED = not an ATA device, general purpose logging is not
+    //!   supported, or the log is empty in the log directory, BAD_PARAMETER = no callback or the log is larger than
+    //!   65536 pages, ABORTED = stopped by the callback, MEMORY_FAILURE = unable to allocate the chunk buffer,
+    //!   anything else = the error from the read log command
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RO(2)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues ata_Read_Log_Stream(const tDevice* M_NONNULL             device,
+                                                            const ataLogReaderOptions* M_NONNULL options,
+                                                            ataLogReaderResults* M_NULLABLE      results);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -338,6 +338,31 @@ extern "C"
                                                    uint64_t                 numberOfLogicalBlocks,
                                                    uint8_t* M_NULLABLE      pattern);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  deallocate_Ranges()
+    //
+    //! \brief   Description:  Deallocates (TRIM, UNMAP, or NVMe dataset management deallocate) a list of LBA ranges.
+    //!          The ranges are coalesced, then split into as few commands as the device's limits allow: identify word
+    //!          105 for ATA, the block limits VPD page for SCSI, DMRL and DMRSL for NVMe. ATA drives use queued TRIM
+    //!          when the drive supports it and fall back to DATA SET MANAGEMENT if the passthrough cannot issue it.
+    //  Entry:
+    //!   \param device - pointer to the device structure
+    //!   \param ranges - list of ranges to deallocate. The list is coalesced in place, so its order and contents
+    //!   change.
+    //!   \param numberOfRanges - number of entries in ranges
+    //!
+    //  Exit:
+    //!   \return SUCCESS = pass, NOT_SUPPORTED = the device does not support deallocation, BAD_PARAMETER = a range is
+    //!   past the end of the device, !SUCCESS = something when wrong
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RW_SIZE(2, 3)
+    OPENSEA_TRANSPORT_API eReturnValues deallocate_Ranges(const tDevice* M_NONNULL device,
+                                                          lbaRange* M_NONNULL      ranges,
+                                                          uint32_t                 numberOfRanges);
+
     M_PARAM_RO(1) OPENSEA_TRANSPORT_API bool is_Write_Psuedo_Uncorrectable_Supported(const tDevice* M_NONNULL device);
     //-----------------------------------------------------------------------------
     //
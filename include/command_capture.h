@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file command_capture.h
+//! \brief Defines capture of the commands sent to a device to a file, and replay of a capture in place of the OS
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // A capture file is a commandCaptureHeader followed by one record per command in the order the commands
+    // completed. Each record is a commandCaptureRecord followed by dataOutLength bytes of data sent to the device,
+    // dataInLength bytes of data returned by the device, senseLength bytes of sense data, then zero padding to the next
+    // 8 byte boundary. recordSize includes all of this. Everything is in the byte order of the capturing host.
+    //
+    // Only commands handed to the OS are recorded. When a SCSI command is translated in software (SNTL, etc), the
+    // commands it was translated into are recorded instead of the SCSI command, so replaying the capture runs the
+    // translator again. Do not reorder or resize these structures without changing COMMAND_CAPTURE_VERSION.
+
+#define COMMAND_CAPTURE_SIGNATURE      "SEACAPTR" // 8 characters. Not NULL terminated in the file header
+#define COMMAND_CAPTURE_VERSION        (1)
+#define COMMAND_CAPTURE_BYTE_ORDER     UINT32_C(0x01020304)
+#define COMMAND_CAPTURE_COMMAND_LENGTH (64) // large enough for any CDB the library sends and a full NVMe SQE
+
+    typedef enum eCommandCaptureTypeEnum
+    {
+        COMMAND_CAPTURE_SCSI       = 1, // command is a CDB. ATA commands appear as ATA passthrough CDBs.
+        COMMAND_CAPTURE_NVME_ADMIN = 2, // command is a 64 byte submission queue entry
+        COMMAND_CAPTURE_NVME_NVM   = 3, // command is a 64 byte submission queue entry
+    } eCommandCaptureType;
+
+    typedef struct s_commandCaptureHeader
+    {
+        char     signature[8];     // COMMAND_CAPTURE_SIGNATURE
+        uint32_t byteOrder;        // COMMAND_CAPTURE_BYTE_ORDER
+        uint32_t version;          // COMMAND_CAPTURE_VERSION
+        uint32_t headerSize;       // sizeof(commandCaptureHeader)
+        uint32_t recordHeaderSize; // sizeof(commandCaptureRecord)
+        int32_t  interfaceType;    // eInterfaceType of the captured device
+        int32_t  driveType;        // eDriveType of the captured device
+        int32_t  passthroughType;  // ePassthroughType of the captured device
+        uint32_t namespaceID;      // NVMe namespace ID of the captured device
+    } commandCaptureHeader;
+
+    typedef struct s_commandCaptureRecord
+    {
+        uint32_t recordSize;        // this structure, all data following it, and padding
+        uint8_t  commandType;       // eCommandCaptureType
+        uint8_t  direction;         // eDataTransferDirection
+        uint8_t  commandLength;     // valid bytes in command
+        uint8_t  senseLength;       // bytes of sense data following the data in
+        uint32_t transferLength;    // data length the command was issued with
+        uint32_t dataOutLength;     // bytes of data out following this structure
+        uint32_t dataInLength;      // bytes of data in following the data out
+        int32_t  result;            // eReturnValues from the OS layer
+        uint64_t commandTimeNS;     // command time as measured by the OS layer
+        uint32_t timeoutSeconds;    // timeout the command was issued with
+        uint8_t  completionValid;   // NVMe only: bits 3:0 are dw3Valid, dw2Valid, dw1Valid, dw0Valid
+        uint8_t  rtfrValid;         // SCSI only: 1 when ataReturnTFRs holds the RTFRs from an ATA passthrough command
+        uint8_t  scsiStatus[5];     // SCSI only: format, sense key, asc, ascq, fru as set by the OS layer
+        uint8_t  reserved[3];
+        uint32_t completion[4];     // NVMe only: completion queue entry dwords 0 - 3
+        uint8_t  ataReturnTFRs[16]; // ataReturnTFRs as set by the OS layer
+        uint8_t  command[COMMAND_CAPTURE_COMMAND_LENGTH];
+    } commandCaptureRecord;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  start_Command_Capture(tDevice *device, const char *fileName)
+    //
+    //! \brief   Description:  Starts writing every command this device sends to the OS, including all data sent and
+    //!          returned, sense data, completion status, and command time, to a new capture file. The file can be
+    //!          replayed with start_Command_Replay to run the translation and discovery code without the hardware.
+    //!          Capture continues until stop_Command_Capture_Or_Replay or the device is closed.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure to capture commands for.
+    //!   \param[in] fileName = name of the capture file to create. An existing file is overwritten.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = capturing, FILE_OPEN_ERROR = unable to create the file, ERROR_WRITING_FILE = unable to
+    //!   write the file header, MEMORY_FAILURE = unable to allocate memory, BAD_PARAMETER = a capture or replay is
+    //!   already active on this device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_NULL_TERM_STRING(2)
+    M_PARAM_RO(2)
+    OPENSEA_TRANSPORT_API eReturnValues start_Command_Capture(tDevice* M_NONNULL    device,
+                                                              const char* M_NONNULL fileName);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  start_Command_Replay(tDevice *device, const uint8_t *captureData, size_t captureDataSize)
+    //
+    //! \brief   Description:  Replays a capture in place of the OS. Each command sent to the device is matched against
+    //!          the next record in the capture, and the recorded data, sense data, status, and command time are
+    //!          returned instead of sending it. The interface, drive type, passthrough type, and namespace ID from
+    //!          the capture are set in the device so the same translation paths are taken. Any other OS specific
+    //!          discovery done when opening a device is not captured.
+    //!          When a command does not match the next record, or the capture has run out, the command fails with
+    //!          OS_PASSTHROUGH_FAILURE and replay reports the divergence when stopped.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure to replay commands to.
+    //!   \param[in] captureData = contents of a capture file. This is copied, so it can be freed after this returns.
+    //!   \param[in] captureDataSize = size of captureData in bytes.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = replaying, VALIDATION_FAILURE = not a capture file, NOT_SUPPORTED = capture is a newer
+    //!   version or from a host with a different byte order, MEMORY_FAILURE = unable to allocate memory,
+    //!   BAD_PARAMETER = a capture or replay is already active on this device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_RO_SIZE(2, 3)
+    OPENSEA_TRANSPORT_API eReturnValues start_Command_Replay(tDevice* M_NONNULL       device,
+                                                             const uint8_t* M_NONNULL captureData,
+                                                             size_t                   captureDataSize);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  stop_Command_Capture_Or_Replay(tDevice *device)
+    //
+    //! \brief   Description:  Stops a capture and closes its file, or stops a replay. Called by
+    //!          release_Device_Resources, so any capture still running when the device is closed is completed.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = stopped cleanly or nothing was active, FAILURE = writing the capture failed or replay
+    //!   diverged from the capture
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues stop_Command_Capture_Or_Replay(tDevice* M_NONNULL device);
+
+    // The functions below are used by scsi_cmds.c and nvme_cmds.c when a capture or replay is active.
+
+    M_PARAM_RO(1)
+    static M_INLINE bool is_Command_Capture_Or_Replay_Active(const tDevice* M_NONNULL device)
+    {
+        return device->drive_info.commandCapture != M_NULLPTR;
+    }
+
+    M_PARAM_RO(1) bool is_Command_Replay_Active(const tDevice* M_NONNULL device);
+
+    // Sends the command with send_IO and captures it, or replays it from the capture.
+    M_PARAM_RW(1) eReturnValues send_IO_With_Command_Capture(ScsiIoCtx* M_NONNULL scsiIoCtx);
+
+    // Records an NVMe command after the OS layer has completed it. Result is the value returned by the OS layer.
+    M_PARAM_RO(1) void capture_NVMe_Command(const nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues result);
+
+    // Returns the next record of the replay in place of sending the command to the OS layer.
+    M_PARAM_RW(1) eReturnValues replay_NVMe_Command(nvmeCmdCtx* M_NONNULL cmdCtx);
+
+#if defined(__cplusplus)
+}
+#endif
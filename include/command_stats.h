@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file command_stats.h
+//! \brief Defines optional per device command counters and latency histograms
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // Latency histograms use log-linear buckets: values below 2^COMMAND_STATS_SUB_BUCKET_BITS nanoseconds each get
+    // their own bucket, then every power of two is split into 2^COMMAND_STATS_SUB_BUCKET_BITS equal buckets. This keeps
+    // each bucket within 12.5% of the values recorded in it across the full 64bit nanosecond range.
+#define COMMAND_STATS_SUB_BUCKET_BITS (3)
+#define COMMAND_STATS_SUB_BUCKETS     (1 << COMMAND_STATS_SUB_BUCKET_BITS)
+#define COMMAND_STATS_HISTOGRAM_BUCKETS                                                                                \
+    ((64 - COMMAND_STATS_SUB_BUCKET_BITS + 1) * COMMAND_STATS_SUB_BUCKETS)
+
+    typedef enum eCommandStatsClassEnum
+    {
+        CMD_STATS_CLASS_READ,
+        CMD_STATS_CLASS_WRITE,
+        CMD_STATS_CLASS_VERIFY,
+        CMD_STATS_CLASS_FLUSH,
+        CMD_STATS_CLASS_DEALLOCATE, // UNMAP, TRIM, and dataset management deallocate
+        CMD_STATS_CLASS_OTHER,      // everything else: identify, logs, features, admin commands, etc
+        CMD_STATS_CLASS_COUNT
+    } eCommandStatsClass;
+
+    typedef struct s_commandClassStats
+    {
+        uint64_t commands; // completed commands, including those that failed or timed out
+        uint64_t errors;   // commands that completed with an error other than a timeout
+        uint64_t timeouts;
+        uint64_t retries; // commands the library resent with different options after a failure
+        uint64_t totalTimeNS;
+        uint64_t minTimeNS;
+        uint64_t maxTimeNS;
+        uint64_t latencyHistogram[COMMAND_STATS_HISTOGRAM_BUCKETS];
+    } commandClassStats;
+
+    typedef struct s_deviceCommandStats
+    {
+        uint64_t          collectionTimeNS; // time since the statistics were enabled or last reset
+        commandClassStats commandClass[CMD_STATS_CLASS_COUNT];
+    } deviceCommandStats;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  enable_Command_Stats(tDevice *device)
+    //
+    //! \brief   Description:  Starts collecting command counters and latency histograms for this device. Statistics
+    //!          use the command time the OS layer already measures, so no additional timing is done. When not
+    //!          enabled, the only cost to each command is a NULL pointer check.
+    //!          If already enabled, nothing is changed.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure to collect statistics for.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = enabled, MEMORY_FAILURE = unable to allocate memory for the statistics
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues enable_Command_Stats(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  disable_Command_Stats(tDevice *device)
+    //
+    //! \brief   Description:  Stops collecting statistics and frees them. Take a snapshot first to keep them.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void disable_Command_Stats(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  reset_Command_Stats(tDevice *device)
+    //
+    //! \brief   Description:  Clears all counters and histograms and restarts the collection time.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = reset, NOT_SUPPORTED = statistics are not enabled on this device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues reset_Command_Stats(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Command_Stats_Snapshot(const tDevice *device, deviceCommandStats *snapshot)
+    //
+    //! \brief   Description:  Copies the current statistics so they can be examined while collection continues.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[out] snapshot = where to copy the statistics to.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = copied, NOT_SUPPORTED = statistics are not enabled on this device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    OPENSEA_TRANSPORT_API eReturnValues get_Command_Stats_Snapshot(const tDevice* M_NONNULL      device,
+                                                                   deviceCommandStats* M_NONNULL snapshot);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Command_Latency_Percentile(const commandClassStats *stats, double percentile)
+    //
+    //! \brief   Description:  Gets the latency at or below which the requested percentage of commands completed.
+    //!          The result is the upper end of the histogram bucket holding that command, limited to the maximum time
+    //!          seen, so it is at most 12.5% above the actual value.
+    //
+    //  Entry:
+    //!   \param[in] stats = statistics for one command class from a snapshot.
+    //!   \param[in] percentile = 0.0 to 100.0. Ex: 99.9
+    //!
+    //  Exit:
+    //!   \return latency in nanoseconds. 0 if no commands have been recorded.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API uint64_t get_Command_Latency_Percentile(const commandClassStats* M_NONNULL stats,
+                                                                  double                            percentile);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  print_Command_Stats(const deviceCommandStats *stats)
+    //
+    //! \brief   Description:  Prints counters, average, minimum, maximum, and p50/p99/p99.9 latency for each command
+    //!          class with at least one command.
+    //
+    //  Entry:
+    //!   \param[in] stats = snapshot to print.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1) OPENSEA_TRANSPORT_API void print_Command_Stats(const deviceCommandStats* M_NONNULL stats);
+
+    // The functions below are used by the command layers (scsi_cmds.c, nvme_cmds.c, etc) to record commands.
+    // Each command issued is wrapped in begin_Command_Stats and end_Command_Stats. Only the outermost command is
+    // recorded, so a SCSI command handled by a software translator is counted once, as the SCSI command, rather than
+    // also counting each ATA or NVMe command it was translated into. The latency recorded is the completion time of the
+    // last command sent to the device.
+
+    M_PARAM_RO(1)
+    static M_INLINE bool is_Command_Stats_Enabled(const tDevice* M_NONNULL device)
+    {
+        return device->drive_info.commandStats != M_NULLPTR;
+    }
+
+    M_PARAM_RO(1) void begin_Command_Stats(const tDevice* M_NONNULL device);
+
+    // Use when a command was started with begin_Command_Stats, but was not sent to the device.
+    M_PARAM_RO(1) void cancel_Command_Stats(const tDevice* M_NONNULL device);
+
+    M_PARAM_RO(1)
+    void end_Command_Stats(const tDevice* M_NONNULL device, eCommandStatsClass commandClass, eReturnValues result);
+
+    M_PARAM_RO(1) void record_Command_Stats_Retry(const tDevice* M_NONNULL device, eCommandStatsClass commandClass);
+
+    // ataCommand is the ATA command opcode. sendFPDMASubcommand is only used with SEND FPDMA QUEUED.
+    M_CONST_FUNC eCommandStatsClass get_ATA_Command_Stats_Class(uint8_t ataCommand, uint8_t sendFPDMASubcommand);
+
+    M_PARAM_RO_SIZE(1, 2)
+    eCommandStatsClass get_SCSI_Command_Stats_Class(const uint8_t* M_NONNULL cdb, uint8_t cdbLength);
+
+    M_CONST_FUNC eCommandStatsClass get_NVMe_Command_Stats_Class(bool adminCommand, uint8_t opcode);
+
+#if defined(__cplusplus)
+}
+#endif
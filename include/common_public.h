@@ -1335,6 +1335,76 @@ extern "C"
         } nvmePTHacks;
     } passthroughHacks;
 
+    // Software translator caches. These are defined in sat_helper.c and sntl_helper.c. Each is a single allocation
+    // made by the translator the first time it is needed.
+    typedef struct s_satTranslatorCache satTranslatorCache, *ptrSatTranslatorCache;
+
+    static M_INLINE void safe_free_sat_translator_cache(satTranslatorCache* M_NULLABLE* M_NULLABLE cache)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, cache));
+    }
+
+    typedef struct s_sntlTranslatorCache sntlTranslatorCache, *ptrSntlTranslatorCache;
+
+    static M_INLINE void safe_free_sntl_translator_cache(sntlTranslatorCache* M_NULLABLE* M_NULLABLE cache)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, cache));
+    }
+
+    // Command statistics. Defined in command_stats.c. Only allocated while enabled with enable_Command_Stats.
+    typedef struct s_commandStatsContext commandStatsContext, *ptrCommandStatsContext;
+
+    static M_INLINE void safe_free_command_stats(commandStatsContext* M_NULLABLE* M_NULLABLE stats)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, stats));
+    }
+
+    // Flight recorder. Defined in flight_recorder.c. Only allocated while enabled with enable_Flight_Recorder.
+    typedef struct s_flightRecorderContext flightRecorderContext, *ptrFlightRecorderContext;
+
+    static M_INLINE void safe_free_flight_recorder(flightRecorderContext* M_NULLABLE* M_NULLABLE recorder)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, recorder));
+    }
+
+    // Command capture and replay. Defined in command_capture.c. Only allocated while a capture or replay is active.
+    // Freed with stop_Command_Capture_Or_Replay since a capture holds an open file.
+    typedef struct s_commandCaptureContext commandCaptureContext, *ptrCommandCaptureContext;
+
+    // Fault injection. Defined in fault_injection.c. Only allocated while started with start_Fault_Injection.
+    typedef struct s_faultInjectionContext faultInjectionContext, *ptrFaultInjectionContext;
+
+// Opcodes that use a service action and have a per-service action bitmap in scsiOpCodeSupportMap below. Any other
+// opcode that reports service actions is tracked at the opcode level only.
+#define SCSI_OPCODE_MAP_SERVICE_ACTION_OPCODES (14)
+// Only service actions 0 - 31 are tracked. This covers everything defined for the opcodes in the table at this time.
+#define SCSI_OPCODE_MAP_MAX_SERVICE_ACTION (31)
+
+    // This is filled in from the REPORT SUPPORTED OPERATION CODES (all commands) response during fill_In_Device_Info
+    // so that lower layers can know what a SCSI device supports without issuing extra commands to probe for support.
+    // If validMap is false then nothing else in here is valid and support must be determined by other means.
+    typedef struct s_scsiOpCodeSupportMap
+    {
+        bool     validMap;
+        uint8_t  padd[7];
+        uint8_t  opcodes[32]; // 1 bit per opcode. Bit set = supported
+        uint32_t serviceActions[SCSI_OPCODE_MAP_SERVICE_ACTION_OPCODES]; // 1 bit per service action for opcodes
+                                                                          // in the service action opcode table
+    } scsiOpCodeSupportMap;
+
+    // The block limits VPD page, read once on first use by get_SCSI_Block_Limits so that each caller does not send its
+    // own INQUIRY. If read is false nothing else in here is valid. Limits the device does not report are 0.
+    typedef struct s_scsiBlockLimitsData
+    {
+        bool     read;  // the page has been requested (or skipped for a device that does not support VPD pages)
+        bool     valid; // the device returned the page
+        uint8_t  padd[2];
+        uint32_t maximumTransferLength; // logical blocks
+        uint32_t maximumUnmapLBACount;
+        uint32_t maximumUnmapDescriptorCount;
+        uint64_t maximumWriteSameLength; // logical blocks
+    } scsiBlockLimitsData;
+
     typedef struct s_driveInfo
     {
         eMediaType       media_type;
@@ -1424,8 +1494,21 @@ extern "C"
             uint32_t numberOfLUs;        // number of logical units on the device
             uint32_t numberOfNamespaces; // number of namespaces on the controller
         };
-        // 9304 bytes to make divisible by 8
-        passthroughHacks passThroughHacks;
+        passthroughHacks     passThroughHacks;
+        scsiOpCodeSupportMap scsiOpCodeSupport; // SCSI devices only. Read at discovery from report supported op codes
+        scsiBlockLimitsData  scsiBlockLimits;   // SCSI devices only. Read on first use. See get_SCSI_Block_Limits
+        ptrSatTranslatorCache M_NULLABLE
+            satCache; // Used by the software SAT translator. Allocated on first use and freed in close_Device
+        ptrSntlTranslatorCache M_NULLABLE
+            sntlCache; // Used by the software NVMe translator. Allocated on first use and freed in close_Device
+        ptrCommandStatsContext M_NULLABLE
+            commandStats; // Command counters and latency histograms. See command_stats.h
+        ptrFlightRecorderContext M_NULLABLE
+            flightRecorder; // Ring of the most recent commands in binary form. See flight_recorder.h
+        ptrCommandCaptureContext M_NULLABLE
+            commandCapture; // Active command capture to a file or replay from one. See command_capture.h
+        ptrFaultInjectionContext M_NULLABLE
+            faultInjection; // Latency and failures injected in place of the OS. See fault_injection.h
     } driveInfo;
 
     // Sets the default command timeout value in tDevice
@@ -1869,7 +1952,7 @@ typedef errno_t lasterror_t; // errno in POSIX OSs
 
     typedef eReturnValues (*issue_io_func)(void* M_NONNULL);
 
-#define DEVICE_BLOCK_VERSION (12)
+#define DEVICE_BLOCK_VERSION (13)
 
     // verification for compatibility checking
     typedef struct s_versionBlock
@@ -2628,6 +2711,47 @@ typedef errno_t lasterror_t; // errno in POSIX OSs
     //-----------------------------------------------------------------------------
     M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* M_NONNULL device);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  release_Device_Resources()
+    //
+    //! \brief   Description:  Frees memory the library allocated on demand for a device (translator caches, etc).
+    //!                        This is called by close_Device, so it only needs to be called directly when a tDevice is
+    //!                        set up without open and close, such as when using a custom issue_io function.
+    //
+    //  Entry:
+    //!   \param[in] device = device struct that holds device information.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void release_Device_Resources(tDevice* M_NONNULL device);
+
+    // A contiguous run of logical blocks. Used by functions that work on lists of ranges, such as deallocation.
+    typedef struct s_lbaRange
+    {
+        uint64_t lba;
+        uint64_t length; // number of logical blocks
+    } lbaRange;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  coalesce_LBA_Ranges()
+    //
+    //! \brief   Description:  Sorts a list of LBA ranges by starting LBA, removes zero length ranges, and merges ranges
+    //!                        that overlap or are adjacent to each other. The list is modified in place.
+    //
+    //  Entry:
+    //!   \param[in,out] ranges = list of ranges to coalesce
+    //!   \param[in] numberOfRanges = number of entries in the list
+    //!
+    //  Exit:
+    //!   \return number of ranges at the start of the list after coalescing
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW_SIZE(1, 2)
+    OPENSEA_TRANSPORT_API uint32_t coalesce_LBA_Ranges(lbaRange* M_NONNULL ranges, uint32_t numberOfRanges);
+
     //-----------------------------------------------------------------------------
     //
     //  scan_And_Print_Devs()
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file emulated_target.h
+//! \brief Defines software emulated SAS, SATA, and NVMe targets that plug into a tDevice through its issue_io and
+//! issue_nvme_io function pointers
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // An emulated target answers commands in the same process instead of sending them to the OS. Everything above the
+    // OS layer (SAT and SNTL translation, device discovery, etc) runs exactly as it does with real hardware, so it can
+    // be exercised and measured on any system.
+    //
+    // SAS disk: answers SCSI commands directly.
+    // SATA disk: answers SCSI commands the way a SAT translator would, and ATA commands through ATA PASS-THROUGH(12)
+    //            and (16). The tDevice is set up as an ATA drive so the library talks to it with ATA commands.
+    // NVMe controller: answers admin and NVM commands. SCSI commands go through the library's software SNTL.
+    //
+    // SAS and SATA disks can be host managed zoned (ZBC/ZAC) with write pointers enforced for sequential write
+    // required zones.
+
+#define EMULATED_TARGET_MAX_NAMESPACES    (16)
+#define EMULATED_TARGET_DEFAULT_CAPACITY  UINT64_C(2097152) // logical blocks. 1GiB at 512B per logical block
+#define EMULATED_TARGET_MAX_TRANSFER_SIZE UINT32_C(1048576) // bytes. Reported in the block limits and MDTS
+
+    typedef enum eEmulatedTargetTypeEnum
+    {
+        EMULATED_TARGET_SAS_DISK,
+        EMULATED_TARGET_SATA_DISK, // behind a SAT translator
+        EMULATED_TARGET_NVME_CONTROLLER,
+    } eEmulatedTargetType;
+
+    typedef enum eEmulatedTargetBackingEnum
+    {
+        EMULATED_TARGET_BACKING_MEMORY, // allocated 1MiB at a time as it is written. Unwritten blocks read as zeros.
+        EMULATED_TARGET_BACKING_SPARSE_FILE, // a file as large as the media that only uses space as it is written
+    } eEmulatedTargetBacking;
+
+    typedef struct s_emulatedTargetConfig
+    {
+        eEmulatedTargetType    type;
+        eEmulatedTargetBacking backing;
+        const char* M_NULLABLE backingFileName; // sparse file only. Created, or overwritten if it exists.
+        uint64_t               capacity;         // logical blocks per namespace
+        uint32_t               logicalBlockSize; // 512 or 4096
+        uint32_t               namespaceCount;   // NVMe only. 1 to EMULATED_TARGET_MAX_NAMESPACES
+        uint64_t zoneSize; // SAS and SATA only. Logical blocks per zone. 0 = not zoned. Otherwise host managed and
+                           // the capacity is rounded down to a whole number of zones.
+        uint32_t conventionalZones; // zones at the start of the media that do not have a write pointer
+        uint64_t readLatencyNS;     // minimum time for reads and verifies
+        uint64_t writeLatencyNS;    // minimum time for writes, deallocation, and zone management
+        uint64_t otherLatencyNS;    // minimum time for everything else
+    } emulatedTargetConfig;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Default_Emulated_Target_Config(emulatedTargetConfig *config, eEmulatedTargetType type)
+    //
+    //! \brief   Description:  Fills in a configuration for a memory backed target of the requested type with
+    //!          EMULATED_TARGET_DEFAULT_CAPACITY logical blocks, no zones, and no added latency. 512B logical blocks
+    //!          for SAS and SATA, 4096B logical blocks and one namespace for NVMe.
+    //
+    //  Entry:
+    //!   \param[out] config = configuration to fill in.
+    //!   \param[in] type = type of target.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_WO(1)
+    OPENSEA_TRANSPORT_API void get_Default_Emulated_Target_Config(emulatedTargetConfig* M_NONNULL config,
+                                                                  eEmulatedTargetType             type);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  open_Emulated_Device(tDevice *device, const emulatedTargetConfig *config)
+    //
+    //! \brief   Description:  Creates an emulated target and sets up the device structure to talk to it, then fills in
+    //!          the drive information the same way as when a real device is opened. The device structure must be
+    //!          zeroed with its version block set, as for get_Device. Close it with close_Emulated_Device.
+    //
+    //  Entry:
+    //!   \param[in,out] device = pointer to the device structure to set up.
+    //!   \param[in] config = target to create. Not referenced after this returns.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = device is ready to use, BAD_PARAMETER = invalid configuration, MEMORY_FAILURE = unable to
+    //!   allocate the target, FILE_OPEN_ERROR = unable to create the backing file, LIBRARY_MISMATCH = device structure
+    //!   version does not match, other = error from fill_Drive_Info_Data
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_RO(2)
+    OPENSEA_TRANSPORT_API eReturnValues open_Emulated_Device(tDevice* M_NONNULL                   device,
+                                                             const emulatedTargetConfig* M_NONNULL config);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  close_Emulated_Device(tDevice *device)
+    //
+    //! \brief   Description:  Releases the device resources, then frees the target and closes its backing file.
+    //!          Everything written to a memory backed target is discarded.
+    //
+    //  Entry:
+    //!   \param[in,out] device = pointer to a device opened with open_Emulated_Device.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = closed, BAD_PARAMETER = not an emulated device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Emulated_Device(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  is_Emulated_Device(const tDevice *device)
+    //
+    //! \brief   Description:  Checks if the device was opened with open_Emulated_Device.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //!   \return true = emulated device, false = not an emulated device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1) OPENSEA_TRANSPORT_API bool is_Emulated_Device(const tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Emulated_Device_Command_Totals(const tDevice *device, uint64_t *commands, uint64_t *totalTimeNS)
+    //
+    //! \brief   Description:  Gets how many commands the emulated target has completed and the total time spent
+    //!          inside it, including any configured latency. Subtracting this from the time a call took leaves only
+    //!          the time spent in the library, which is what the benchmarks report.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to a device opened with open_Emulated_Device.
+    //!   \param[out] commands = number of commands completed since the device was opened.
+    //!   \param[out] totalTimeNS = total nanoseconds spent completing those commands.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = totals returned, BAD_PARAMETER = not an emulated device
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues get_Emulated_Device_Command_Totals(const tDevice* M_NONNULL device,
+                                                                           uint64_t* M_NONNULL       commands,
+                                                                           uint64_t* M_NONNULL       totalTimeNS);
+
+#if defined(__cplusplus)
+}
+#endif
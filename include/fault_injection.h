@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file fault_injection.h
+//! \brief Defines injection of latency and failures in place of the OS passthrough, for exercising and timing the
+//! library's retry, timeout, and fallback paths
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // Fault injection sits where the command layers (private_SCSI_Send_CDB and nvme_Cmd) hand a command to the OS
+    // layer, so it works the same on every platform, with real devices, emulated targets, and replays. Each command is
+    // checked against the rules in the order they were added and the first one that matches is applied. A rule can
+    // add latency before the command is sent, or complete the command in place of the OS with a timeout, a transport
+    // error, sense data, an ATA error, or an NVMe status. Everything the command layers do after the OS returns
+    // (sense decoding, the test unit ready workaround, passthrough fallbacks, retries) then runs as it would for a real
+    // failure, so its cost in wall time can be measured.
+    //
+    // A SCSI command translated in software (SNTL) is checked once as the SCSI command, then again as each NVMe command
+    // it is translated into.
+    //
+    // Which commands are affected is chosen with a pseudo random generator seeded by start_Fault_Injection, so the
+    // same seed and the same sequence of commands always inject the same faults.
+
+#define FAULT_INJECTION_MAX_RULES       (32)
+#define FAULT_INJECTION_PROBABILITY_MAX UINT32_C(1000000) // probabilities are in parts per million
+
+    typedef enum eFaultInjectionCommandTypeEnum
+    {
+        FAULT_INJECTION_ANY_COMMAND, // any command. Opcode and LBA matching is not available. Commands that cannot
+                                     // report the action's status, such as sense data on NVMe, are skipped.
+        FAULT_INJECTION_SCSI,        // SCSI commands that are not ATA passthrough. Opcode is the CDB operation code.
+        FAULT_INJECTION_ATA,         // ATA commands sent through SAT or another passthrough. Opcode is the ATA command.
+        FAULT_INJECTION_NVME_ADMIN,  // NVMe admin commands. Opcode is the admin opcode.
+        FAULT_INJECTION_NVME_NVM,    // NVMe I/O commands. Opcode is the NVM opcode.
+    } eFaultInjectionCommandType;
+
+    typedef enum eFaultInjectionActionEnum
+    {
+        FAULT_INJECTION_LATENCY_ONLY,    // add latency, then send the command normally
+        FAULT_INJECTION_TIMEOUT,         // do not send. Wait, then fail with OS_COMMAND_TIMEOUT
+        FAULT_INJECTION_TRANSPORT_ERROR, // do not send. Fail with transportError and no status from the device
+        FAULT_INJECTION_SENSE_DATA,      // do not send. Complete with check condition and senseKey/asc/ascq
+        FAULT_INJECTION_ATA_STATUS,      // do not send. ATA commands only: complete with ataStatus/ataError in an
+                                         // ATA status return descriptor, the same as a SAT translator
+        FAULT_INJECTION_NVME_STATUS,     // do not send. NVMe commands only: complete with the status code type/code
+    } eFaultInjectionAction;
+
+    typedef enum eFaultInjectionLatencyEnum
+    {
+        FAULT_INJECTION_NO_LATENCY,
+        FAULT_INJECTION_FIXED_LATENCY,   // latencyMinNS every time
+        FAULT_INJECTION_UNIFORM_LATENCY, // evenly distributed from latencyMinNS to latencyMaxNS
+        FAULT_INJECTION_TAIL_LATENCY,    // latencyMinNS, except latencyTailPPM of commands wait latencyMaxNS. This is
+                                         // the shape of a drive doing background work or error recovery
+    } eFaultInjectionLatency;
+
+    typedef struct s_faultInjectionRule
+    {
+        // Which commands this applies to
+        eFaultInjectionCommandType commandType;
+        bool                       matchOpcode;
+        uint8_t                    opcode;
+        bool     matchLBA; // only commands with an LBA range overlapping firstLBA to lastLBA match. Commands without
+                           // an LBA, or ones this does not know how to read the LBA from, do not match.
+        uint64_t firstLBA;
+        uint64_t lastLBA;        // inclusive
+        uint32_t skipCount;      // matching commands to let through before this rule starts applying
+        uint32_t maxInjections;  // stop applying after this many commands. 0 means no limit
+        uint32_t probabilityPPM; // chance each matching command is affected, in parts per million. 0 means always
+        // What happens to them
+        eFaultInjectionAction  action;
+        eFaultInjectionLatency latency; // applied before any action, including before sending the command
+        uint64_t               latencyMinNS;
+        uint64_t               latencyMaxNS;
+        uint32_t               latencyTailPPM; // FAULT_INJECTION_TAIL_LATENCY only
+        uint32_t      timeoutWaitMS;  // FAULT_INJECTION_TIMEOUT: how long to wait before failing. 0 waits the full
+                                      // command timeout, as the OS would
+        eReturnValues transportError; // FAULT_INJECTION_TRANSPORT_ERROR: OS_PASSTHROUGH_FAILURE if left SUCCESS
+        uint8_t       senseKey;       // FAULT_INJECTION_SENSE_DATA
+        uint8_t       asc;
+        uint8_t       ascq;
+        uint8_t       ataStatus; // FAULT_INJECTION_ATA_STATUS: status register, typically 51h
+        uint8_t       ataError;  // FAULT_INJECTION_ATA_STATUS: error register, typically 04h (abort)
+        uint8_t       nvmeStatusCodeType;
+        uint8_t       nvmeStatusCode;
+        bool          nvmeDoNotRetry;
+    } faultInjectionRule;
+
+    typedef struct s_faultInjectionStats
+    {
+        uint64_t commandsChecked;   // commands checked against the rules
+        uint64_t commandsDelayed;   // commands that had latency added
+        uint64_t commandsFailed;    // commands completed by an injected fault instead of being sent
+        uint64_t injectedLatencyNS; // total latency added, not including timeout waits
+        uint64_t injectedTimeoutNS; // total time spent waiting on injected timeouts
+        uint64_t ruleInjections[FAULT_INJECTION_MAX_RULES]; // commands each rule was applied to, in the order added
+    } faultInjectionStats;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  start_Fault_Injection(tDevice *device, uint64_t seed)
+    //
+    //! \brief   Description:  Starts checking every command sent to this device against the fault injection rules.
+    //!          There are no rules to begin with, so add them with add_Fault_Injection_Rule. If already started, the
+    //!          rules and statistics are cleared and the generator is reseeded.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] seed = seed for choosing which commands are affected when a rule has a probability or latency
+    //!   range. 0 uses a fixed default seed.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = started, MEMORY_FAILURE = unable to allocate memory
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues start_Fault_Injection(tDevice* M_NONNULL device, uint64_t seed);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  add_Fault_Injection_Rule(tDevice *device, const faultInjectionRule *rule)
+    //
+    //! \brief   Description:  Adds a rule after any already added. Rules are checked in the order added and only the
+    //!          first matching rule is applied to a command.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. start_Fault_Injection must be called first.
+    //!   \param[in] rule = rule to add. This is copied.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = added, NOT_SUPPORTED = fault injection is not started, BAD_PARAMETER = the rule is invalid
+    //!   (an ATA or NVMe status for the wrong type of command, an LBA or opcode match for any command, inverted
+    //!   ranges, or FAULT_INJECTION_MAX_RULES already added)
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_RO(2)
+    OPENSEA_TRANSPORT_API eReturnValues add_Fault_Injection_Rule(tDevice* M_NONNULL                  device,
+                                                                 const faultInjectionRule* M_NONNULL rule);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Fault_Injection_Stats(const tDevice *device, faultInjectionStats *stats)
+    //
+    //! \brief   Description:  Gets how many commands were affected and how much time was added by fault injection
+    //!          since it was started. Comparing the time added with the wall time of the whole operation shows how
+    //!          much more time the library spent handling the faults.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[out] stats = filled in with the statistics.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = stats returned, NOT_SUPPORTED = fault injection is not started
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    OPENSEA_TRANSPORT_API eReturnValues get_Fault_Injection_Stats(const tDevice* M_NONNULL      device,
+                                                                  faultInjectionStats* M_NONNULL stats);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  stop_Fault_Injection(tDevice *device)
+    //
+    //! \brief   Description:  Stops fault injection and frees the rules. Called by release_Device_Resources.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void stop_Fault_Injection(tDevice* M_NONNULL device);
+
+    // The functions below are used by scsi_cmds.c and nvme_cmds.c just before a command is handed to the OS layer.
+    // They apply any latency, and return true when the command was completed by an injected fault and must not be
+    // sent, with the result the OS layer would have returned in result.
+
+    M_PARAM_RO(1)
+    static M_INLINE bool is_Fault_Injection_Active(const tDevice* M_NONNULL device)
+    {
+        return device->drive_info.faultInjection != M_NULLPTR;
+    }
+
+    M_PARAM_RW(1) M_PARAM_WO(2) bool inject_SCSI_Fault(ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues* M_NONNULL result);
+
+    M_PARAM_RW(1) M_PARAM_WO(2) bool inject_NVMe_Fault(nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues* M_NONNULL result);
+
+#if defined(__cplusplus)
+}
+#endif
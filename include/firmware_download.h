@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file firmware_download.h
+//! \brief Defines downloading a whole firmware image in segments sized from what the device reports, sending each
+//! segment straight from the caller's image
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "cmds.h"
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The segment size is the largest one the device and the passthrough accept:
+    //  - ATA: the DOWNLOAD MICROCODE mode 3 minimum and maximum (identify words 234 and 235)
+    //  - NVMe: a multiple of the firmware update granularity (FWUG), no larger than MDTS
+    //  - SCSI: a multiple of the WRITE BUFFER offset boundary (READ BUFFER descriptor), no larger than the buffer
+    // and never more than the passthrough's maximum transfer length. A SCSI device with an offset boundary of FFh only
+    // accepts offset 0, so firmware_Download_Image sends the whole image in one command when it fits the buffer.
+    //
+    // Segments are sent directly from the image, so an image mapped into memory by the caller (mmap,
+    // MapViewOfFile) is never copied. Only an image that does not meet the device's I/O alignment, or a last
+    // segment that must be padded to a whole 512 byte block (ATA), goes through one internal buffer.
+
+    // Called after each segment. Return false to stop the download.
+    typedef bool (*firmwareDownloadProgressCallback)(uint32_t bytesSent, uint32_t imageSize, void* M_NULLABLE context);
+
+    typedef struct s_firmwareDownloadOptions
+    {
+        eDownloadMode dlMode;      // DL_FW_SEGMENTED, DL_FW_DEFERRED or DL_FW_DEFERRED_SELECT_ACTIVATE
+        uint8_t       slotNumber;  // NVMe firmware slot or SCSI buffer ID. 0 when unsure.
+        uint32_t      segmentSize; // bytes. 0 uses get_Firmware_Download_Segment_Size.
+        uint32_t      timeoutSeconds;
+        firmwareDownloadProgressCallback M_NULLABLE progressCallback;
+        void* M_NULLABLE                            callbackContext;
+    } firmwareDownloadOptions;
+
+    typedef struct s_firmwareDownloadResults
+    {
+        uint32_t segmentSize;    // segment size used
+        uint32_t segments;       // segments sent
+        uint32_t copiedSegments; // segments sent from the internal buffer instead of the image
+        uint32_t bytesSent;      // offset to restart from if the download stopped early
+    } firmwareDownloadResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Firmware_Download_Segment_Size(tDevice *device, uint8_t slotNumber)
+    //
+    //! \brief   Description:  Works out the largest firmware download segment the device and the passthrough accept.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. SCSI devices may be sent a READ BUFFER descriptor.
+    //!   \param[in] slotNumber = SCSI buffer ID the image will be written to. Ignored on ATA and NVMe.
+    //!
+    //  Exit:
+    //!   \return segment size in bytes. 0 when the device does not accept segmented downloads.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API uint32_t get_Firmware_Download_Segment_Size(const tDevice* M_NONNULL device,
+                                                                      uint8_t                  slotNumber);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  firmware_Download_Image(tDevice *device, firmwareDownloadOptions *options, uint8_t *image, uint32_t imageSize,
+    //                          firmwareDownloadResults *results)
+    //
+    //! \brief   Description:  Downloads a whole firmware image in segments with firmware_Download_Command.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] options = how to download the image
+    //!   \param[in] image = the whole firmware image. It is not modified.
+    //!   \param[in] imageSize = bytes in the image
+    //!   \param[out] results = optional. Filled in with how the image was sent, including when it fails.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = image downloaded (and activated with DL_FW_SEGMENTED), NOT_SUPPORTED = the device does not
+    //!   accept segmented downloads and the image does not fit in one command, BAD_PARAMETER = unsupported mode, the
+    //!   segment size does not suit the device or the image is larger than ATA DOWNLOAD MICROCODE can address,
+    //!   ABORTED = stopped by the progress callback, MEMORY_FAILURE = unable to allocate the internal buffer,
+    //!   anything else = the error from the segment that failed
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RO(2)
+    M_PARAM_RO_SIZE(3, 4)
+    M_PARAM_WO(5)
+    OPENSEA_TRANSPORT_API eReturnValues firmware_Download_Image(const tDevice* M_NONNULL                 device,
+                                                                const firmwareDownloadOptions* M_NONNULL options,
+                                                                const uint8_t* M_NONNULL                 image,
+                                                                uint32_t                                 imageSize,
+                                                                firmwareDownloadResults* M_NULLABLE      results);
+
+#if defined(__cplusplus)
+}
+#endif
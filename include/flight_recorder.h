@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file flight_recorder.h
+//! \brief Defines an always-on binary record of the most recent commands sent to a device
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#define FLIGHT_RECORDER_DEFAULT_ENTRIES (256)
+#define FLIGHT_RECORDER_MAX_ENTRIES     (65536)
+#define FLIGHT_RECORDER_COMMAND_LENGTH  (64) // large enough for any CDB the library sends and a full NVMe SQE
+#define FLIGHT_RECORDER_STATUS_LENGTH   (32) // first 32 bytes of sense data, or the NVMe completion queue entry
+
+#define FLIGHT_RECORDER_SIGNATURE  "SEAFLTRC" // 8 characters. Not NULL terminated in the file header
+#define FLIGHT_RECORDER_VERSION    (1)
+#define FLIGHT_RECORDER_BYTE_ORDER UINT32_C(0x01020304) // written in host byte order so a decoder can detect swapping
+
+    typedef enum eFlightRecorderCommandTypeEnum
+    {
+        FLIGHT_RECORDER_CMD_UNUSED     = 0,
+        FLIGHT_RECORDER_CMD_SCSI       = 1, // command is a CDB. ATA commands appear as ATA passthrough CDBs.
+        FLIGHT_RECORDER_CMD_NVME_ADMIN = 2, // command is a 64 byte submission queue entry
+        FLIGHT_RECORDER_CMD_NVME_NVM   = 3, // command is a 64 byte submission queue entry
+    } eFlightRecorderCommandType;
+
+    // Fixed size so the ring can be written to a file as is and decoded offline. Do not reorder or resize these
+    // fields without changing FLIGHT_RECORDER_VERSION.
+    typedef struct s_flightRecorderEntry
+    {
+        uint64_t sequence;    // count of commands recorded before this one since the recorder was enabled
+        uint64_t startTimeNS; // when the command was sent, relative to when the recorder was enabled
+        uint64_t durationNS;  // command time as measured by the OS layer
+        uint32_t dataLength;
+        int32_t  result;          // eReturnValues from the OS layer for SCSI, or after NVMe status translation
+        uint8_t  commandType;     // eFlightRecorderCommandType
+        uint8_t  direction;       // eDataTransferDirection
+        uint8_t  commandLength;   // valid bytes in command
+        uint8_t  statusLength;    // valid bytes in status. 0 when the command completed without sense data
+        uint8_t  nvmeStatusValid; // NVMe only: bits 3:0 are dw3Valid, dw2Valid, dw1Valid, dw0Valid
+        uint8_t  reserved[3];
+        uint8_t  command[FLIGHT_RECORDER_COMMAND_LENGTH];
+        uint8_t  status[FLIGHT_RECORDER_STATUS_LENGTH]; // SCSI: sense data. NVMe: completion dwords 0 - 3
+    } flightRecorderEntry;
+
+    // Header at the start of the data returned by get_Flight_Recorder_Data. It is followed by entryCount
+    // flightRecorderEntry structures ordered from oldest to newest.
+    typedef struct s_flightRecorderHeader
+    {
+        char     signature[8];  // FLIGHT_RECORDER_SIGNATURE
+        uint32_t byteOrder;     // FLIGHT_RECORDER_BYTE_ORDER
+        uint32_t version;       // FLIGHT_RECORDER_VERSION
+        uint32_t headerSize;    // sizeof(flightRecorderHeader)
+        uint32_t entrySize;     // sizeof(flightRecorderEntry)
+        uint32_t entryCount;    // number of entries following this header
+        uint32_t ringSize;      // number of entries the recorder was configured to hold
+        uint64_t totalCommands; // total commands recorded since the recorder was enabled. More than entryCount
+                                // means older commands were overwritten.
+    } flightRecorderHeader;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  enable_Flight_Recorder(tDevice *device, uint32_t entries)
+    //
+    //! \brief   Description:  Starts recording every command sent to this device into a fixed size ring in memory.
+    //!          Each command costs a couple of small copies and a timer read, no formatting is done, so this can be
+    //!          left on at all times. Use get_Flight_Recorder_Data after a failure to see the last commands that led up
+    //!          to it. If already enabled with the same size, nothing is changed. A different size starts a new ring.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure to record commands for.
+    //!   \param[in] entries = number of commands to keep. 0 uses FLIGHT_RECORDER_DEFAULT_ENTRIES.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = enabled, BAD_PARAMETER = entries is larger than FLIGHT_RECORDER_MAX_ENTRIES,
+    //!   MEMORY_FAILURE = unable to allocate memory for the ring
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    OPENSEA_TRANSPORT_API eReturnValues enable_Flight_Recorder(tDevice* M_NONNULL device, uint32_t entries);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  disable_Flight_Recorder(tDevice *device)
+    //
+    //! \brief   Description:  Stops recording and frees the ring. Use get_Flight_Recorder_Data first to keep it.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void disable_Flight_Recorder(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Flight_Recorder_Data_Size(const tDevice *device)
+    //
+    //! \brief   Description:  Gets the buffer size needed for get_Flight_Recorder_Data to return every entry currently
+    //!          held in the ring.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //!   \return size in bytes. 0 if the recorder is not enabled.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1) OPENSEA_TRANSPORT_API uint32_t get_Flight_Recorder_Data_Size(const tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Flight_Recorder_Data(const tDevice *device, uint8_t *ptrData, uint32_t dataSize)
+    //
+    //! \brief   Description:  Copies a flightRecorderHeader followed by the recorded entries, oldest first, into the
+    //!          provided buffer. The result can be written to a file as is and decoded offline. If the buffer is too
+    //!          small for every entry, the most recent entries that fit are returned.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[out] ptrData = buffer to fill.
+    //!   \param[in] dataSize = size of ptrData in bytes. Must be at least sizeof(flightRecorderHeader).
+    //!
+    //  Exit:
+    //!   \return SUCCESS = copied, NOT_SUPPORTED = recorder is not enabled, BAD_PARAMETER = buffer too small
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO_SIZE(2, 3)
+    OPENSEA_TRANSPORT_API eReturnValues get_Flight_Recorder_Data(const tDevice* M_NONNULL device,
+                                                                 uint8_t* M_NONNULL       ptrData,
+                                                                 uint32_t                 dataSize);
+
+    // The functions below are used by the command layers (scsi_cmds.c, nvme_cmds.c) to record each command after it
+    // completes. Commands generated by a software translator are recorded along with the SCSI command they were
+    // translated from, so the inner commands appear just before the command that caused them.
+
+    M_PARAM_RO(1)
+    static M_INLINE bool is_Flight_Recorder_Enabled(const tDevice* M_NONNULL device)
+    {
+        return device->drive_info.flightRecorder != M_NULLPTR;
+    }
+
+    M_PARAM_RO(1) void record_SCSI_Flight_Recorder_Entry(const ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues result);
+
+    M_PARAM_RO(1) void record_NVMe_Flight_Recorder_Entry(const nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues result);
+
+#if defined(__cplusplus)
+}
+#endif
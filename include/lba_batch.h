@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file lba_batch.h
+//! \brief Defines reading or verifying a list of discontiguous LBA ranges in one call, ordered and merged to need as
+//! few commands and seeks as possible
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The ranges in a batch are sent in ascending LBA order no matter what order they are given in, so a drive with
+    // heads sweeps across the media once instead of seeking back and forth. Ranges that overlap or are adjacent are
+    // merged into one command, up to the largest command the device accepts (get_Surface_Scan_Blocks_Per_Command).
+    // Reads of merged ranges go through one internal buffer and are copied out to each range's buffer.
+    //
+    // When a merged command fails, each of its ranges is sent again on its own, so every range gets its own result.
+
+    typedef enum eLBABatchOperationEnum
+    {
+        LBA_BATCH_READ,
+        LBA_BATCH_VERIFY,
+    } eLBABatchOperation;
+
+    typedef struct s_lbaBatchRange
+    {
+        uint64_t            lba;
+        uint32_t            length; // number of logical blocks
+        uint8_t* M_NULLABLE buffer; // LBA_BATCH_READ: length * logical block size bytes. Not used to verify.
+        eReturnValues       result; // set by run_LBA_Batch. BAD_PARAMETER when the range is not on the device
+    } lbaBatchRange;
+
+    typedef struct s_lbaBatchResults
+    {
+        uint32_t commands;       // read or verify commands sent, including retries
+        uint32_t mergedCommands; // commands that covered more than one range
+        uint32_t retriedRanges;  // ranges sent again on their own after a merged command failed
+        uint32_t failedRanges;
+    } lbaBatchResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  run_LBA_Batch(tDevice *device, eLBABatchOperation operation, lbaBatchRange *ranges, uint32_t numberOfRanges,
+    //                lbaBatchResults *results)
+    //
+    //! \brief   Description:  Reads or verifies every range in the list. The list itself is not reordered.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] operation = read or verify
+    //!   \param[in,out] ranges = ranges to read or verify. Each result is set.
+    //!   \param[in] numberOfRanges = number of entries in ranges
+    //!   \param[out] results = optional. Filled in with how the batch was sent.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = every range succeeded, FAILURE = at least one range failed (see each result),
+    //!   BAD_PARAMETER = a read range has no buffer, MEMORY_FAILURE = unable to allocate memory for the batch
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RW_SIZE(3, 4)
+    M_PARAM_WO(5)
+    OPENSEA_TRANSPORT_API eReturnValues run_LBA_Batch(const tDevice* M_NONNULL    device,
+                                                      eLBABatchOperation          operation,
+                                                      lbaBatchRange* M_NONNULL    ranges,
+                                                      uint32_t                    numberOfRanges,
+                                                      lbaBatchResults* M_NULLABLE results);
+
+#if defined(__cplusplus)
+}
+#endif
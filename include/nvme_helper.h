@@ -66,6 +66,7 @@ extern "C"
         NVME_IDENTIFY_CTRL                  = 1,
         NVME_IDENTIFY_ALL_ACTIVE_NS         = 2,
         NVME_IDENTIFY_NS_ID_DESCRIPTOR_LIST = 3,
+        NVME_IDENTIFY_CS_CTRL               = 6, // I/O command set specific identify controller (CSI in CDW11)
     } eNvmeIdentifyCNS;
 
     typedef enum eNvmePowerFlagsEnum
@@ -543,6 +543,54 @@ extern "C"
     OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Ext_Smt_Log(const tDevice* M_NONNULL         device,
                                                               EXTENDED_SMART_INFO_T* M_NONNULL ExtdSMARTInfo);
 
+    // Maximum number of ranges in a single dataset management command
+#define NVME_DSM_MAX_RANGES      UINT32_C(256)
+#define NVME_DSM_RANGE_SIZE      UINT32_C(16)
+#define NVME_DSM_MAX_BUFFER_SIZE (NVME_DSM_MAX_RANGES * NVME_DSM_RANGE_SIZE)
+
+    // \fn get_NVMe_MDTS_Bytes(const tDevice* M_NONNULL device)
+    // \brief Returns the maximum data transfer size (MDTS) from the identify controller data in bytes. MDTS is in
+    // units of the minimum memory page size (CAP.MPSMIN). The controller registers are not read here, so the smallest
+    // possible page size of 4KiB is used, which never gives a limit larger than the controller supports.
+    // \param device device struture
+    // \return MDTS in bytes, or 0 when no limit is reported or the limit does not fit in 32 bits
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API uint32_t get_NVMe_MDTS_Bytes(const tDevice* M_NONNULL device);
+
+    // \fn get_NVMe_DSM_Limits(const tDevice* M_NONNULL device, uint32_t* maxRanges, uint32_t* maxLBAsPerRange)
+    // \brief Reads the dataset management range limits (DMRL and DMRSL) from the NVM command set identify controller
+    // data. When the controller does not report limits, maxRanges is 256 and maxLBAsPerRange is UINT32_MAX.
+    // This issues an identify command, so callers should save the result.
+    // \param device device struture
+    // \param maxRanges maximum number of ranges in a single dataset management command
+    // \param maxLBAsPerRange maximum number of logical blocks in a single range
+    // \return SUCCESS - limits were read, !SUCCESS - defaults were returned
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues get_NVMe_DSM_Limits(const tDevice* M_NONNULL device,
+                                                            uint32_t* M_NONNULL      maxRanges,
+                                                            uint32_t* M_NONNULL      maxLBAsPerRange);
+
+    // \fn fill_NVMe_DSM_Range_Buffer(...)
+    // \brief Fills a dataset management buffer with ranges from a list of LBA ranges, splitting any range longer than
+    // maxLBAsPerRange. Start with rangeIndex and rangeOffset set to zero and call again with the same values until
+    // rangeIndex reaches numberOfRanges to build each command that is needed. Ranges should already be run through
+    // coalesce_LBA_Ranges to use the fewest commands.
+    // \param bufferSize buffer size. The number of ranges placed is limited to bufferSize / 16 and 256.
+    // \return number of ranges placed into the buffer
+    M_PARAM_RO_SIZE(1, 2)
+    M_PARAM_RW(3)
+    M_PARAM_RW(4)
+    M_PARAM_WO_SIZE(5, 6)
+    OPENSEA_TRANSPORT_API uint32_t fill_NVMe_DSM_Range_Buffer(const lbaRange* M_NONNULL ranges,
+                                                              uint32_t                  numberOfRanges,
+                                                              uint32_t* M_NONNULL       rangeIndex,
+                                                              uint64_t* M_NONNULL       rangeOffset,
+                                                              uint8_t* M_NONNULL        buffer,
+                                                              uint32_t                  bufferSize,
+                                                              uint32_t                  maxLBAsPerRange);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file nvme_log_reader.h
+//! \brief Defines reading large NVMe log pages, such as telemetry and the persistent event log, in MDTS sized chunks
+//! that are handed to a callback or written to a file as they arrive
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "secure_file.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The log is read with Get Log Page using the log page offset, one chunk at a time, through one buffer of the
+    // chunk size. A multi megabyte telemetry log never needs more memory than one chunk, and never a command larger
+    // than MDTS. Controllers that do not support offsets (LPA bit 2) can only return logs that fit in one chunk.
+    //
+    // Only one chunk is ever outstanding. The passthrough is synchronous, so a chunk is handed on before the next
+    // one is read into the same buffer, rather than keeping several reads in flight.
+    //
+    // The log specific field is sent with the first command only, and the remaining commands read the same data.
+    // For example: create telemetry host-initiated data, or establish the persistent event log context. Retain
+    // asynchronous event is set on every command but the last, unless the options ask for it on the last one too.
+    //
+    // With a log length of 0 the 512 byte header is read on its own first and the length is taken from it. The data
+    // is then read from offset 0, header included. This works for telemetry host-initiated and controller-initiated
+    // logs (up to data area 3, or 4 when enabled) and for the persistent event log (total log length).
+
+    // Called with each chunk, in order. Return false to stop reading.
+    typedef bool (*nvmeLogChunkCallback)(const uint8_t* M_NONNULL data,
+                                         uint32_t                 dataLength,
+                                         uint64_t                 offset,
+                                         void* M_NULLABLE         context);
+
+    typedef struct s_nvmeLogReaderOptions
+    {
+        uint8_t                         lid;
+        uint32_t                        nsid;
+        uint8_t                         lsp;       // first command only
+        bool                            rae;       // also set retain asynchronous event on the last chunk
+        uint64_t                        logLength; // bytes. 0 reads the length from the log header.
+        uint32_t                        chunkSize; // bytes. 0 uses get_NVMe_Log_Chunk_Size.
+        nvmeLogChunkCallback M_NULLABLE chunkCallback;
+        void* M_NULLABLE                callbackContext;
+    } nvmeLogReaderOptions;
+
+    typedef struct s_nvmeLogReaderResults
+    {
+        uint64_t logLength; // bytes in the log, as given or read from its header
+        uint64_t bytesRead;
+        uint32_t chunkSize; // chunk size used
+        uint32_t commands; // Get Log Page commands sent, including the header read
+    } nvmeLogReaderResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_NVMe_Log_Chunk_Size(tDevice *device)
+    //
+    //! \brief   Description:  Works out the largest Get Log Page transfer the controller and the passthrough accept.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!
+    //  Exit:
+    //!   \return chunk size in bytes
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1) OPENSEA_TRANSPORT_API uint32_t get_NVMe_Log_Chunk_Size(const tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  nvme_Read_Log_Stream(tDevice *device, nvmeLogReaderOptions *options, nvmeLogReaderResults *results)
+    //
+    //! \brief   Description:  Reads a log page in chunks and hands each one to the options' chunk callback.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. Must be an NVMe device.
+    //!   \param[in] options = log to read. chunkCallback must be set.
+    //!   \param[out] results = optional. Filled in with how the log was read, including when it fails.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = whole log read, NOT_SUPPORTED = not an NVMe device, or the log is larger than one chunk
+    //!   and the controller does not support offsets, BAD_PARAMETER = no callback, the chunk size is not a multiple
+    //!   of 4 bytes, or the length is 0 and either cannot be read from this log or the chunk size is less than 512
+    //!   bytes, ABORTED = stopped by the callback, MEMORY_FAILURE = unable to allocate the chunk buffer, anything
+    //!   else = the error from Get Log Page
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RO(2)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Log_Stream(const tDevice* M_NONNULL              device,
+                                                             const nvmeLogReaderOptions* M_NONNULL options,
+                                                             nvmeLogReaderResults* M_NULLABLE      results);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  nvme_Read_Log_To_File(tDevice *device, nvmeLogReaderOptions *options, secureFileInfo *file,
+    //                        nvmeLogReaderResults *results)
+    //
+    //! \brief   Description:  Reads a log page in chunks and writes each one to a file as it arrives. The file is an
+    //!                        opened secureFileInfo rather than a raw file descriptor, so writes get the same
+    //!                        checks as the other secure_file writers.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. Must be an NVMe device.
+    //!   \param[in] options = log to read. The chunk callback and its context are not used.
+    //!   \param[in] file = file opened for writing. The log is written at the current position.
+    //!   \param[out] results = optional. Filled in with how the log was read, including when it fails.
+    //!
+    //  Exit:
+    //!   \return same as nvme_Read_Log_Stream, and FAILURE = writing to the file failed
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RO(2)
+    M_PARAM_RW(3)
+    M_PARAM_WO(4)
+    OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Log_To_File(const tDevice* M_NONNULL              device,
+                                                              const nvmeLogReaderOptions* M_NONNULL options,
+                                                              secureFileInfo* M_NONNULL             file,
+                                                              nvmeLogReaderResults* M_NULLABLE      results);
+
+#if defined(__cplusplus)
+}
+#endif
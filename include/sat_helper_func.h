@@ -316,6 +316,24 @@ extern "C"
     M_PARAM_RO(1)
     M_PARAM_RW(2) eReturnValues translate_SCSI_Command(const tDevice* M_NONNULL device, ScsiIoCtx* M_NONNULL scsiIoCtx);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  sat_Invalidate_Translator_Cache(const tDevice *device)
+    //
+    //! \brief   Description:  Drops the identify data, log directory, device statistics and SMART data the software
+    //!          SAT translator has read from the drive so the next translated command rereads them. Called after ATA
+    //!          commands that change them (set features, security, download microcode, sanitize, set max, format),
+    //!          since those are sent without going through the translator.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure for the device the command was issued to.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    void sat_Invalidate_Translator_Cache(const tDevice* M_NONNULL device);
+
 #if defined(__cplusplus)
 }
 #endif
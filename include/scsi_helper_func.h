@@ -906,6 +906,67 @@ extern "C"
     is_SCSI_Operation_Code_Supported(const tDevice* M_NONNULL                  device,
                                      ptrScsiOperationCodeInfoRequest M_NONNULL request);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  read_SCSI_Supported_Op_Code_Map(tDevice *device)
+    //
+    //! \brief   Description: Reads the full list of supported operation codes from the device and saves a bitmap of
+    //! the reported operation codes and service actions in drive_info.scsiOpCodeSupport. Command size hacks that can be
+    //! determined from this list are also set so that fallbacks do not need to be probed one command at a time.
+    //! This is called during fill_In_Device_Info for SCSI devices.
+    //
+    //  Entry:
+    //!   \param[in] device - pointer to the device structure
+    //!
+    //  Exit:
+    //!   \return SUCCESS = map is valid, NOT_SUPPORTED = device cannot report a complete list, other = error
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    OPENSEA_TRANSPORT_API eReturnValues read_SCSI_Supported_Op_Code_Map(tDevice* M_NONNULL device);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_SCSI_Op_Code_Support_From_Map(const tDevice *device, uint8_t operationCode, bool serviceActionValid,
+    //  uint16_t serviceAction)
+    //
+    //! \brief   Description: Checks the saved supported operation code map without issuing any commands.
+    //
+    //  Entry:
+    //!   \param[in] device - pointer to the device structure
+    //!   \param[in] operationCode - operation code to look up
+    //!   \param[in] serviceActionValid - set to true when serviceAction should also be checked
+    //!   \param[in] serviceAction - service action to look up
+    //!
+    //  Exit:
+    //!   \return SCSI_CMD_SUPPORT_UNKNOWN when there is no map or the service action is not tracked, otherwise
+    //!   supported or not supported
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API eSCSICmdSupport get_SCSI_Op_Code_Support_From_Map(const tDevice* M_NONNULL device,
+                                                                            uint8_t                  operationCode,
+                                                                            bool     serviceActionValid,
+                                                                            uint16_t serviceAction);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_SCSI_Block_Limits(const tDevice *device)
+    //
+    //! \brief   Description: Returns the block limits VPD page limits saved in drive_info.scsiBlockLimits. The page is
+    //! read with INQUIRY the first time this is called after discovery, unless the device is known not to support VPD
+    //! pages. Later calls do not issue any commands.
+    //
+    //  Entry:
+    //!   \param[in] device - pointer to the device structure
+    //!
+    //  Exit:
+    //!   \return the saved limits. valid is false when the page could not be read.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API const scsiBlockLimitsData* get_SCSI_Block_Limits(const tDevice* M_NONNULL device);
+
     //-----------------------------------------------------------------------------
     //
     //  scsi_Log_Sense_Cmd()
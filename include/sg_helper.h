@@ -43,6 +43,30 @@ extern "C"
     // otherwise you must try MAX_CMD_TIMEOUT_SECONDS instead
     OPENSEA_TRANSPORT_API bool os_Is_Infinite_Timeout_Supported(void);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  set_Linux_Device_Root(const char *root)
+    //
+    //! \brief   Description:  Sets a directory to use in place of / when discovering and opening devices, so /dev
+    //!          and /sys are read from root/dev and root/sys. Handles found under it are files naming an emulated
+    //!          target ("emulated:sas", "emulated:sata", or "emulated:nvme") that answers commands for them instead
+    //!          of the OS. This lets discovery be measured against thousands of devices without the hardware.
+    //!          Not thread safe. Set it before scanning for devices.
+    //
+    //  Entry:
+    //!   \param[in] root = absolute path of the directory containing dev and sys. M_NULLPTR, "" or "/" uses the
+    //!   running system again.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = root set, BAD_PARAMETER = root is not an absolute path or is too long
+    //
+    //-----------------------------------------------------------------------------
+    M_NULL_TERM_STRING(1)
+    OPENSEA_TRANSPORT_API eReturnValues set_Linux_Device_Root(const char* M_NULLABLE root);
+
+    // Returns the root set with set_Linux_Device_Root, or an empty string for the running system
+    OPENSEA_TRANSPORT_API const char* get_Linux_Device_Root(void);
+
     // SG Driver status's since they are not available through standard includes we're using
 
 #ifndef OPENSEA_SG_ERR_DRIVER_MASK
@@ -41,6 +41,23 @@ extern "C"
     M_PARAM_RW(2)
     eReturnValues sntl_Translate_SCSI_Command(const tDevice* M_NONNULL device, ScsiIoCtx* M_NONNULL scsiIoCtx);
 
+    //-----------------------------------------------------------------------------
+    //
+    //  sntl_Invalidate_Translator_Cache(const tDevice *device)
+    //
+    //! \brief   Description:  Marks the identify data used by the SNTL as stale and drops any logs it has cached.
+    //!          Called after NVMe commands that change identify data (format, sanitize, namespace management or
+    //!          attachment, firmware activation) so the next translated command rereads it.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure for the device the command was issued to.
+    //!
+    //  Exit:
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    void sntl_Invalidate_Translator_Cache(const tDevice* M_NONNULL device);
+
 #if defined(__cplusplus)
 }
 #endif
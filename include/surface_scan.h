@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file surface_scan.h
+//! \brief Defines a full or partial media scan that reads or verifies a range of LBAs with the largest commands the
+//! device accepts and reports each bad range found without stopping the scan
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // A scan sends one command at a time, each as large as the device and the passthrough allow, so the number of
+    // commands (and the per command overhead in the OS and the library) is as small as possible. Verify commands are
+    // used where the device has them, so no data crosses the bus.
+    //
+    // When a command fails with a media error (SCSI medium error sense, ATA uncorrectable or ID not found, or an NVMe
+    // media and data integrity error status) the command's range is split in half and each half is scanned again,
+    // down to single LBAs, to find exactly which LBAs are bad. Adjacent bad LBAs are reported together as one range
+    // through the callback and the scan continues after them. Any other failure (the command did not reach the
+    // device, timed out, or is not supported) stops the scan, since retrying smaller ranges would not help. An NVMe
+    // failure is only a media error when the OS returns the completion status.
+
+#define SURFACE_SCAN_MAX_READ_BYTES   UINT32_C(1048576)  // largest buffer allocated for a read scan, or one write
+#define SURFACE_SCAN_MAX_VERIFY_BYTES UINT32_C(67108864) // largest range of media one verify command covers
+
+    typedef enum eSurfaceScanModeEnum
+    {
+        SURFACE_SCAN_VERIFY, // verify commands. NVMe devices without the verify command are read instead.
+        SURFACE_SCAN_READ,   // read commands. The data is discarded.
+        SURFACE_SCAN_WRITE,  // only for sizing write commands with get_Surface_Scan_Blocks_Per_Command. Never scans.
+    } eSurfaceScanMode;
+
+    typedef struct s_surfaceScanBadRange
+    {
+        uint64_t      lba;
+        uint64_t      length;   // number of logical blocks
+        eReturnValues result;   // what the command for the first LBA of the range returned
+        uint8_t       senseKey; // SCSI and ATA devices: sense data for the first LBA of the range
+        uint8_t       asc;
+        uint8_t       ascq;
+        uint8_t       ataError;   // ATA devices: error register for the first LBA of the range
+        uint32_t      nvmeStatus; // NVMe devices: completion dword 3 for the first LBA, when the OS returns it
+    } surfaceScanBadRange;
+
+    // Called once for each bad range, in LBA order. Return false to stop the scan.
+    typedef bool (*surfaceScanBadRangeCallback)(const surfaceScanBadRange* M_NONNULL badRange,
+                                                void* M_NULLABLE                     context);
+
+    typedef struct s_surfaceScanOptions
+    {
+        eSurfaceScanMode                       mode;
+        uint64_t                               startLBA;
+        uint64_t                               length; // number of logical blocks. 0 scans to the end of the device
+        uint32_t                               blocksPerCommand; // 0 uses get_Surface_Scan_Blocks_Per_Command
+        uint32_t                               maxBadRanges;     // stop after this many. 0 means no limit
+        surfaceScanBadRangeCallback M_NULLABLE badRangeCallback;
+        void* M_NULLABLE                       callbackContext;
+    } surfaceScanOptions;
+
+    typedef struct s_surfaceScanResults
+    {
+        eSurfaceScanMode modeUsed;         // SURFACE_SCAN_READ when a verify scan had to read instead
+        uint32_t         blocksPerCommand; // largest command used
+        uint64_t         lbasScanned;      // including the bad LBAs
+        uint64_t         commands;         // including the commands sent to find the bad LBAs
+        uint32_t         badRanges;
+        uint64_t         badLBAs;
+        uint64_t         nextLBA; // where to restart the scan if it stopped early
+    } surfaceScanResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Surface_Scan_Blocks_Per_Command(tDevice *device, eSurfaceScanMode mode)
+    //
+    //! \brief   Description:  Gets the largest number of logical blocks a single read, write or verify command can
+    //!          cover on this device. This is limited by the size of the command's transfer length field, the maximum
+    //!          transfer length the device reports (block limits VPD page or NVMe MDTS), known passthrough limits, and
+    //!          SURFACE_SCAN_MAX_READ_BYTES (read and write) or SURFACE_SCAN_MAX_VERIFY_BYTES.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. SCSI devices may be sent an inquiry for the block limits.
+    //!   \param[in] mode = read, write or verify
+    //!
+    //  Exit:
+    //!   \return number of logical blocks, always at least 1
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API uint32_t get_Surface_Scan_Blocks_Per_Command(const tDevice* M_NONNULL device,
+                                                                       eSurfaceScanMode         mode);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  surface_Scan(tDevice *device, const surfaceScanOptions *options, surfaceScanResults *results)
+    //
+    //! \brief   Description:  Reads or verifies a range of LBAs and reports each range of bad LBAs through the
+    //!          callback in the options.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] options = what to scan and how
+    //!   \param[out] results = optional. Filled in with what was scanned, including when the scan stops early.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = the whole range was scanned and no bad LBAs were found, FAILURE = the scan finished, or
+    //!   stopped at maxBadRanges, and bad LBAs were found, ABORTED = the callback stopped the scan, BAD_PARAMETER =
+    //!   the range is past the end of the device, the mode is SURFACE_SCAN_WRITE or blocksPerCommand is larger than
+    //!   get_Surface_Scan_Blocks_Per_Command, MEMORY_FAILURE = unable to allocate the read buffer, anything else
+    //!   = the error that stopped the scan
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RO(2)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues surface_Scan(const tDevice* M_NONNULL            device,
+                                                     const surfaceScanOptions* M_NONNULL options,
+                                                     surfaceScanResults* M_NULLABLE      results);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file zero_range.h
+//! \brief Defines zeroing a range of LBAs with the fastest zeroing command the device supports
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // get_Zero_Range_Capabilities looks at what the device supports once and lists the zeroing methods it can use,
+    // fastest first:
+    //  1. Commands that deallocate the LBAs, when the device reports that deallocated LBAs read back as zeros: NVMe
+    //     Write Zeroes with the deallocate bit, SCSI WRITE SAME with the UNMAP bit, ATA ZEROS EXT with the TRIM bit.
+    //  2. Commands that make the device write zeros to the media itself: NVMe Write Zeroes, SCSI WRITE SAME, ATA ZEROS
+    //     EXT, ATA SCT Write Same.
+    //  3. Write commands from one zero filled buffer, as large as the device and the passthrough allow.
+    // zero_Range uses the first method in the list and splits the range into commands no larger than that method
+    // allows. When the device rejects a method (invalid operation code or field, or an ATA abort) before it has
+    // completed a single command, it is treated as not supported, removed from the list and the next method is used.
+    // Any other failure, such as a timeout, stops zero_Range since the command may still be running. Pass the same
+    // capabilities to every call for the same device to avoid probing it again.
+
+    typedef enum eZeroRangeMethodEnum
+    {
+        ZERO_RANGE_NVME_WRITE_ZEROES_DEALLOCATE,
+        ZERO_RANGE_SCSI_WRITE_SAME_UNMAP,
+        ZERO_RANGE_ATA_ZEROS_EXT_TRIM,
+        ZERO_RANGE_NVME_WRITE_ZEROES,
+        ZERO_RANGE_SCSI_WRITE_SAME,
+        ZERO_RANGE_ATA_ZEROS_EXT,
+        ZERO_RANGE_ATA_SCT_WRITE_SAME,
+        ZERO_RANGE_WRITE,
+    } eZeroRangeMethod;
+
+#define ZERO_RANGE_MAX_METHODS 4
+
+    typedef struct s_zeroRangeMethodInfo
+    {
+        eZeroRangeMethod method;
+        uint64_t         maxBlocks; // largest number of logical blocks one command covers
+        bool             confirmed; // a command with this method has completed successfully
+    } zeroRangeMethodInfo;
+
+    typedef struct s_zeroRangeCapabilities
+    {
+        uint32_t            blockSize;
+        uint8_t             numberOfMethods;
+        zeroRangeMethodInfo methods[ZERO_RANGE_MAX_METHODS]; // fastest first. The last one is always ZERO_RANGE_WRITE
+    } zeroRangeCapabilities;
+
+    typedef struct s_zeroRangeResults
+    {
+        eZeroRangeMethod methodUsed; // method that zeroed the last LBAs
+        uint64_t         commands;   // including commands that failed before falling back to the next method
+        uint64_t         lbasZeroed;
+        uint64_t         nextLBA; // first LBA not zeroed when the range was not finished
+    } zeroRangeResults;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Zero_Range_Capabilities(tDevice *device, zeroRangeCapabilities *capabilities)
+    //
+    //! \brief   Description:  Finds the zeroing methods this device supports and the largest command each one takes.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. SCSI devices may be sent inquiries for the block limits
+    //!                       and logical block provisioning VPD pages.
+    //!   \param[out] capabilities = filled in with the methods, fastest first
+    //!
+    //  Exit:
+    //!   \return SUCCESS = capabilities filled in, BAD_PARAMETER = the logical block size is not known
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    OPENSEA_TRANSPORT_API eReturnValues get_Zero_Range_Capabilities(const tDevice* M_NONNULL         device,
+                                                                    zeroRangeCapabilities* M_NONNULL capabilities);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  zero_Range(tDevice *device, zeroRangeCapabilities *capabilities, uint64_t lba, uint64_t length,
+    //             zeroRangeResults *results)
+    //
+    //! \brief   Description:  Zeros a range of LBAs with the fastest method in the capabilities.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in,out] capabilities = optional. From get_Zero_Range_Capabilities. Methods found not to work are
+    //!                                 removed. When M_NULLPTR the device is probed for this call only.
+    //!   \param[in] lba = first LBA to zero
+    //!   \param[in] length = number of logical blocks to zero
+    //!   \param[out] results = optional. Filled in with how the range was zeroed, including when it fails.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = the whole range was zeroed, BAD_PARAMETER = the range is past the end of the device,
+    //!   MEMORY_FAILURE = unable to allocate the zero buffer, anything else = the error from the write that failed
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_RW(2)
+    M_PARAM_WO(5)
+    OPENSEA_TRANSPORT_API eReturnValues zero_Range(const tDevice* M_NONNULL           device,
+                                                   zeroRangeCapabilities* M_NULLABLE capabilities,
+                                                   uint64_t                          lba,
+                                                   uint64_t                          length,
+                                                   zeroRangeResults* M_NULLABLE      results);
+
+#if defined(__cplusplus)
+}
+#endif
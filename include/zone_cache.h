@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file zone_cache.h
+//! \brief Defines a write pointer cache for zoned devices that is kept up to date locally as writes and zone
+//! management commands succeed, and a helper that appends to a zone at its cached write pointer
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+#include "zone_report.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // The cache reads every zone once (get_Zone_Table). After that, a write or zone management command sent through
+    // the cache moves the cached write pointers and conditions the same way the device does, so no REPORT ZONES is
+    // needed to know where the next write goes. When a command fails, the zones it touched are read again from the
+    // device (get_Zone_Info), since the device may have written or changed part of them.
+    //
+    // Opening another sequential write required zone when maxOpenZones are already open would make the device close
+    // an implicitly opened zone of its choosing, so the cache closes one itself first and its conditions stay
+    // correct. Zones opened explicitly are never closed by the cache.
+    //
+    // The cache only knows about commands sent through it. Anything else that writes to or manages the zones must be
+    // followed by refresh_Zone_Cache.
+
+    typedef struct s_zoneCache
+    {
+        const tDevice* device;
+        zoneTable      table;        // every zone, in LBA order
+        uint32_t       maxOpenZones; // sequential write required zones. UINT32_MAX when the device reports no limit.
+        uint32_t       openZones;    // sequential write required zones implicitly or explicitly opened
+        uint32_t       resyncs;      // zones read again from the device after a command failed
+    } zoneCache;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  init_Zone_Cache(tDevice *device, zoneCache *cache)
+    //
+    //! \brief   Description:  Reads every zone and the device's open zone limit into a new cache.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. Must be a SCSI or ATA zoned device.
+    //!   \param[out] cache = cache to set up. Free it with free_Zone_Cache.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = cache is ready, anything else = the error reading the zones
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(2)
+    OPENSEA_TRANSPORT_API eReturnValues init_Zone_Cache(const tDevice* M_NONNULL device, zoneCache* M_NONNULL cache);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  refresh_Zone_Cache(zoneCache *cache)
+    //
+    //! \brief   Description:  Reads every zone from the device again.
+    //
+    //  Entry:
+    //!   \param[in,out] cache = cache from init_Zone_Cache
+    //!
+    //  Exit:
+    //!   \return SUCCESS = cache is up to date, anything else = the error reading the zones. The cache is empty.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues refresh_Zone_Cache(zoneCache* M_NONNULL cache);
+
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void free_Zone_Cache(zoneCache* M_NULLABLE cache);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Zone_Cache_Zone(zoneCache *cache, uint64_t lba)
+    //
+    //! \brief   Description:  Finds the cached zone that contains an LBA.
+    //
+    //  Entry:
+    //!   \param[in] cache = cache from init_Zone_Cache
+    //!   \param[in] lba = any LBA in the zone
+    //!
+    //  Exit:
+    //!   \return pointer to the cached zone, M_NULLPTR when no zone contains the LBA
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    OPENSEA_TRANSPORT_API const zoneInfo* get_Zone_Cache_Zone(const zoneCache* M_NONNULL cache, uint64_t lba);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  zone_Cache_Write(zoneCache *cache, uint64_t lba, uint8_t *ptrData, uint32_t dataSize)
+    //
+    //! \brief   Description:  Writes with write_LBA and updates the write pointers and conditions of the zones
+    //!          written.
+    //
+    //  Entry:
+    //!   \param[in,out] cache = cache from init_Zone_Cache
+    //!   \param[in] lba = LBA to start writing at
+    //!   \param[in] ptrData = data to write
+    //!   \param[in] dataSize = bytes to write. Must be a multiple of the logical block size.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = written, FAILURE = the zone needs opening and every open zone was opened explicitly,
+    //!   anything else = the error from the write
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_RO_SIZE(3, 4)
+    OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Write(zoneCache* M_NONNULL cache,
+                                                         uint64_t             lba,
+                                                         uint8_t* M_NONNULL   ptrData,
+                                                         uint32_t             dataSize);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  zone_Cache_Management(zoneCache *cache, eZMAction action, bool all, uint64_t zoneID)
+    //
+    //! \brief   Description:  Opens, closes, finishes or resets the write pointer of a zone, or all zones, and updates
+    //!          the cache to match.
+    //
+    //  Entry:
+    //!   \param[in,out] cache = cache from init_Zone_Cache
+    //!   \param[in] action = ZM_ACTION_OPEN_ZONE, ZM_ACTION_CLOSE_ZONE, ZM_ACTION_FINISH_ZONE or
+    //!   ZM_ACTION_RESET_WRITE_POINTERS
+    //!   \param[in] all = apply the action to every zone it applies to
+    //!   \param[in] zoneID = start LBA of the zone. Ignored when all is set.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = done, BAD_PARAMETER = not one of the actions above or not the start of a zone, FAILURE =
+    //!   opening the zone would go over the open zone limit and every open zone was opened explicitly, anything else
+    //!   = the error from the command
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Management(zoneCache* M_NONNULL cache,
+                                                              eZMAction            action,
+                                                              bool                 all,
+                                                              uint64_t             zoneID);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  zone_Cache_Append(zoneCache *cache, uint64_t zoneID, uint8_t *ptrData, uint32_t dataSize, uint64_t *lbaWritten)
+    //
+    //! \brief   Description:  Writes the data at the cached write pointer of a zone, like a zone append command.
+    //
+    //  Entry:
+    //!   \param[in,out] cache = cache from init_Zone_Cache
+    //!   \param[in] zoneID = any LBA in the zone to append to. Must be a write pointer zone.
+    //!   \param[in] ptrData = data to write
+    //!   \param[in] dataSize = bytes to write. Must be a multiple of the logical block size.
+    //!   \param[out] lbaWritten = optional. Set to the LBA the data was written at.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = written, BAD_PARAMETER = not a write pointer zone or the data does not fit in what is left
+    //!   of the zone, FAILURE = the zone needs opening and every open zone was opened explicitly, anything else = the
+    //!   error from the write
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_RO_SIZE(3, 4)
+    M_PARAM_WO(5)
+    OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Append(zoneCache* M_NONNULL  cache,
+                                                          uint64_t              zoneID,
+                                                          uint8_t* M_NONNULL    ptrData,
+                                                          uint32_t              dataSize,
+                                                          uint64_t* M_NULLABLE lbaWritten);
+
+#if defined(__cplusplus)
+}
+#endif
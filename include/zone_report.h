@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MPL-2.0
+
+//! \file zone_report.h
+//! \brief Defines reading the zones of a zoned device (ZBC or ZAC) through an iterator that pages through REPORT
+//! ZONES and parses the zone descriptors into a compact zone table
+//! \copyright
+//! Do NOT modify or remove this copyright and license
+//!
+//! Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//!
+//! This software is subject to the terms of the Mozilla Public License, v. 2.0.
+//! If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "common_public.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    // Each REPORT ZONES (ZBC) or REPORT ZONES EXT (ZAC) the iterator sends uses the largest buffer the device and the
+    // passthrough accept, so a drive with hundreds of thousands of zones is read in as few commands as possible. The
+    // partial bit is always set: the zone list length then only covers the descriptors returned, so the drive does not
+    // have to count every remaining zone that matches the reporting options on each page.
+    //
+    // The reporting options filter the zones on the drive, so only matching zones cross the bus. The next page starts
+    // after the last zone returned by the previous one.
+
+    typedef enum eZoneTypeEnum
+    {
+        ZONE_TYPE_RESERVED                      = 0x0,
+        ZONE_TYPE_CONVENTIONAL                  = 0x1,
+        ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED     = 0x2,
+        ZONE_TYPE_SEQUENTIAL_WRITE_PREFERRED    = 0x3,
+        ZONE_TYPE_SEQUENTIAL_OR_BEFORE_REQUIRED = 0x4,
+        ZONE_TYPE_GAP                           = 0x5,
+    } eZoneType;
+
+    typedef enum eZoneConditionEnum
+    {
+        ZONE_CONDITION_NOT_WRITE_POINTER = 0x0,
+        ZONE_CONDITION_EMPTY             = 0x1,
+        ZONE_CONDITION_IMPLICITLY_OPENED = 0x2,
+        ZONE_CONDITION_EXPLICITLY_OPENED = 0x3,
+        ZONE_CONDITION_CLOSED            = 0x4,
+        ZONE_CONDITION_INACTIVE          = 0x5,
+        ZONE_CONDITION_READ_ONLY         = 0xD,
+        ZONE_CONDITION_FULL              = 0xE,
+        ZONE_CONDITION_OFFLINE           = 0xF,
+    } eZoneCondition;
+
+    // One zone descriptor, half the size of the 64 byte descriptor the device returns
+    typedef struct s_zoneInfo
+    {
+        uint64_t startLBA;
+        uint64_t length;       // number of logical blocks
+        uint64_t writePointer; // not valid for conventional and gap zones, or the read only, offline, full conditions
+        uint8_t  type;         // eZoneType
+        uint8_t  condition;    // eZoneCondition
+        bool     resetRecommended;
+        bool     nonSequentialResourcesActive;
+    } zoneInfo;
+
+    typedef struct s_zoneReportIterator
+    {
+        const tDevice*        device;
+        eZoneReportingOptions reportingOptions;
+        uint64_t              nextZoneLocator;
+        uint64_t              maxLBA;
+        uint8_t*              buffer;
+        uint32_t              bufferSize;
+        uint32_t              descriptorsInBuffer;
+        uint32_t              nextDescriptor;
+        bool                  bigEndian; // ZBC. ZAC data is little endian.
+        bool                  lastPage;  // the descriptors in the buffer are the last ones
+    } zoneReportIterator;
+
+    typedef struct s_zoneTable
+    {
+        uint32_t             numberOfZones;
+        zoneInfo* M_NULLABLE zones;
+    } zoneTable;
+
+    //-----------------------------------------------------------------------------
+    //
+    //  init_Zone_Report_Iterator(tDevice *device, eZoneReportingOptions reportingOptions, uint64_t startLBA,
+    //                            zoneReportIterator *iterator)
+    //
+    //! \brief   Description:  Sets up an iterator over the zones that match the reporting options, starting with the
+    //!          zone that contains startLBA. No command is sent until get_Next_Zones is called.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure. Must be a SCSI or ATA zoned device.
+    //!   \param[in] reportingOptions = which zones to report
+    //!   \param[in] startLBA = zone locator for the first report
+    //!   \param[out] iterator = iterator to set up. Free it with free_Zone_Report_Iterator.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = iterator is ready, NOT_SUPPORTED = not an ATA or SCSI device, MEMORY_FAILURE = unable to
+    //!   allocate the report buffer
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(4)
+    OPENSEA_TRANSPORT_API eReturnValues init_Zone_Report_Iterator(const tDevice* M_NONNULL      device,
+                                                                  eZoneReportingOptions         reportingOptions,
+                                                                  uint64_t                      startLBA,
+                                                                  zoneReportIterator* M_NONNULL iterator);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Next_Zones(zoneReportIterator *iterator, zoneInfo *zones, uint32_t maxZones, uint32_t *zonesReturned)
+    //
+    //! \brief   Description:  Gets the next zones from the iterator, sending another report when the buffered
+    //!          descriptors run out.
+    //
+    //  Entry:
+    //!   \param[in,out] iterator = iterator from init_Zone_Report_Iterator
+    //!   \param[out] zones = filled in with up to maxZones zones
+    //!   \param[in] maxZones = number of entries in zones
+    //!   \param[out] zonesReturned = number of zones filled in. 0 once every matching zone has been returned.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = zonesReturned is set, anything else = the error from the report command
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RW(1)
+    M_PARAM_WO_SIZE(2, 3)
+    M_PARAM_WO(4)
+    OPENSEA_TRANSPORT_API eReturnValues get_Next_Zones(zoneReportIterator* M_NONNULL iterator,
+                                                       zoneInfo* M_NONNULL           zones,
+                                                       uint32_t                      maxZones,
+                                                       uint32_t* M_NONNULL           zonesReturned);
+
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void free_Zone_Report_Iterator(zoneReportIterator* M_NULLABLE iterator);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Zone_Info(tDevice *device, uint64_t lba, zoneInfo *zone)
+    //
+    //! \brief   Description:  Reads the one zone that contains an LBA with the smallest report the device takes.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] lba = any LBA in the zone
+    //!   \param[out] zone = filled in with the zone
+    //!
+    //  Exit:
+    //!   \return SUCCESS = zone filled in, FAILURE = no zone was reported, anything else = the error from the report
+    //!   command
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(3)
+    OPENSEA_TRANSPORT_API eReturnValues get_Zone_Info(const tDevice* M_NONNULL device,
+                                                      uint64_t                 lba,
+                                                      zoneInfo* M_NONNULL      zone);
+
+    //-----------------------------------------------------------------------------
+    //
+    //  get_Zone_Table(tDevice *device, eZoneReportingOptions reportingOptions, uint64_t startLBA, uint32_t maxZones,
+    //                 zoneTable *table)
+    //
+    //! \brief   Description:  Reads the zones that match the reporting options into a table, in LBA order.
+    //
+    //  Entry:
+    //!   \param[in] device = pointer to the device structure.
+    //!   \param[in] reportingOptions = which zones to report
+    //!   \param[in] startLBA = zone locator for the first report
+    //!   \param[in] maxZones = stop after this many zones. 0 reads every matching zone.
+    //!   \param[out] table = filled in with the zones. Free it with free_Zone_Table.
+    //!
+    //  Exit:
+    //!   \return SUCCESS = table filled in, MEMORY_FAILURE = unable to allocate the table, anything else = the error
+    //!   from the report command. The table is empty on error.
+    //
+    //-----------------------------------------------------------------------------
+    M_PARAM_RO(1)
+    M_PARAM_WO(5)
+    OPENSEA_TRANSPORT_API eReturnValues get_Zone_Table(const tDevice* M_NONNULL device,
+                                                       eZoneReportingOptions    reportingOptions,
+                                                       uint64_t                 startLBA,
+                                                       uint32_t                 maxZones,
+                                                       zoneTable* M_NONNULL     table);
+
+    M_PARAM_RW(1) OPENSEA_TRANSPORT_API void free_Zone_Table(zoneTable* M_NULLABLE table);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -3119,6 +3119,7 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
     int retValue = 0;
     if (dev != M_NULLPTR)
     {
+        release_Device_Resources(dev);
         retValue                = close(dev->os_info.fd);
         dev->os_info.last_error = errno;
 
@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file allocation_map.c
+// \brief Implements reading the logical block provisioning status of a range of LBAs into a compact list of mapped,
+// deallocated and anchored extents
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "allocation_map.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "surface_scan.h"
+
+#define GET_LBA_STATUS_HEADER_LEN     UINT32_C(8)
+#define GET_LBA_STATUS_DESCRIPTOR_LEN UINT32_C(16)
+// Starting size of an extent list. It doubles as needed.
+#define ALLOCATION_MAP_INITIAL_EXTENTS UINT32_C(256)
+
+static eAllocationState get_Allocation_State(uint8_t provisioningStatus)
+{
+    switch (provisioningStatus)
+    {
+    case 1:
+        return ALLOCATION_DEALLOCATED;
+    case 2:
+        return ALLOCATION_ANCHORED;
+    default:
+        // 0 = mapped or unknown, 3 = mapped, 4 = unknown
+        return ALLOCATION_MAPPED;
+    }
+}
+
+// Adds an extent to the end of the map, merging it into the last one when it continues it with the same state
+static eReturnValues add_Allocation_Extent(allocationMap*   map,
+                                           uint32_t*        capacity,
+                                           uint64_t         startLBA,
+                                           uint64_t         length,
+                                           eAllocationState state)
+{
+    allocationExtent* last = map->numberOfExtents > UINT32_C(0) ? &map->extents[map->numberOfExtents - 1] : M_NULLPTR;
+    switch (state)
+    {
+    case ALLOCATION_DEALLOCATED:
+        map->deallocatedBlocks += length;
+        break;
+    case ALLOCATION_ANCHORED:
+        map->anchoredBlocks += length;
+        break;
+    case ALLOCATION_MAPPED:
+        map->mappedBlocks += length;
+        break;
+    }
+    if (last != M_NULLPTR && last->state == state && last->startLBA + last->length == startLBA)
+    {
+        last->length += length;
+        return SUCCESS;
+    }
+    if (map->numberOfExtents == *capacity)
+    {
+        uint32_t          newCapacity = *capacity == UINT32_C(0) ? ALLOCATION_MAP_INITIAL_EXTENTS : *capacity * 2;
+        allocationExtent* temp        = M_REINTERPRET_CAST(
+            allocationExtent*, safe_realloc(map->extents, C_CAST(size_t, newCapacity) * sizeof(allocationExtent)));
+        if (temp == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+        map->extents = temp;
+        *capacity    = newCapacity;
+    }
+    map->extents[map->numberOfExtents].startLBA = startLBA;
+    map->extents[map->numberOfExtents].length   = length;
+    map->extents[map->numberOfExtents].state    = state;
+    ++map->numberOfExtents;
+    return SUCCESS;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues get_Allocation_Map(const tDevice* M_NONNULL device,
+                                                       uint64_t                 startLBA,
+                                                       uint64_t                 length,
+                                                       allocationMap* M_NONNULL map)
+{
+    eReturnValues ret        = SUCCESS;
+    uint32_t      blockSize  = get_Device_BlockSize(device);
+    uint32_t      capacity   = UINT32_C(0);
+    uint32_t      bufferSize = UINT32_C(0);
+    uint8_t*      buffer     = M_NULLPTR;
+    uint64_t      endLBA     = UINT64_C(0); // first LBA after the range
+    uint64_t      nextLBA    = startLBA;
+    safe_memset(map, sizeof(allocationMap), 0, sizeof(allocationMap));
+    if (get_Device_DriveType(device) != SCSI_DRIVE)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (startLBA > device->drive_info.deviceMaxLba ||
+        (length > UINT64_C(0) && length - UINT64_C(1) > device->drive_info.deviceMaxLba - startLBA))
+    {
+        return BAD_PARAMETER;
+    }
+    endLBA = length == UINT64_C(0) ? device->drive_info.deviceMaxLba + UINT64_C(1) : startLBA + length;
+    if (blockSize == UINT32_C(0))
+    {
+        blockSize = LEGACY_DRIVE_SEC_SIZE;
+    }
+    // the largest read transfer is also the largest GET LBA STATUS response. Only whole descriptors are useful.
+    bufferSize = get_Surface_Scan_Blocks_Per_Command(device, SURFACE_SCAN_READ) * blockSize;
+    bufferSize = M_Max(bufferSize, LEGACY_DRIVE_SEC_SIZE);
+    bufferSize = ((bufferSize - GET_LBA_STATUS_HEADER_LEN) / GET_LBA_STATUS_DESCRIPTOR_LEN) *
+                     GET_LBA_STATUS_DESCRIPTOR_LEN +
+                 GET_LBA_STATUS_HEADER_LEN;
+    buffer     = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(bufferSize, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    while (ret == SUCCESS && nextLBA < endLBA)
+    {
+        uint32_t descriptors = UINT32_C(0);
+        uint64_t reportedEnd = nextLBA;
+        ret                  = scsi_Get_Lba_Status(device, nextLBA, bufferSize, buffer);
+        ++map->commands;
+        if (ret != SUCCESS)
+        {
+            if (map->commands == UINT32_C(1) && ret == FAILURE)
+            {
+                // rejected outright, most likely an unsupported command
+                ret = NOT_SUPPORTED;
+            }
+            break;
+        }
+        descriptors = C_CAST(uint32_t, M_Min(M_BytesTo4ByteValue(buffer[0], buffer[1], buffer[2], buffer[3]) +
+                                                 UINT32_C(4),
+                                             bufferSize));
+        descriptors = descriptors < GET_LBA_STATUS_HEADER_LEN
+                          ? UINT32_C(0)
+                          : (descriptors - GET_LBA_STATUS_HEADER_LEN) / GET_LBA_STATUS_DESCRIPTOR_LEN;
+        for (uint32_t iter = UINT32_C(0); iter < descriptors && ret == SUCCESS && reportedEnd < endLBA; ++iter)
+        {
+            const uint8_t* descriptor =
+                &buffer[GET_LBA_STATUS_HEADER_LEN + C_CAST(size_t, iter) * GET_LBA_STATUS_DESCRIPTOR_LEN];
+            uint64_t descriptorLBA =
+                M_BytesTo8ByteValue(descriptor[0], descriptor[1], descriptor[2], descriptor[3], descriptor[4],
+                                    descriptor[5], descriptor[6], descriptor[7]);
+            uint64_t descriptorEnd =
+                descriptorLBA + M_BytesTo4ByteValue(descriptor[8], descriptor[9], descriptor[10], descriptor[11]);
+            descriptorEnd = M_Min(descriptorEnd, endLBA);
+            if (descriptorEnd <= reportedEnd)
+            {
+                // overlaps what is already listed, or zero length
+                continue;
+            }
+            if (descriptorLBA > reportedEnd)
+            {
+                // not described by the device, so it has to be treated as mapped
+                ret = add_Allocation_Extent(map, &capacity, reportedEnd, descriptorLBA - reportedEnd,
+                                            ALLOCATION_MAPPED);
+                reportedEnd = descriptorLBA;
+                if (ret != SUCCESS)
+                {
+                    break;
+                }
+            }
+            ret         = add_Allocation_Extent(map, &capacity, reportedEnd, descriptorEnd - reportedEnd,
+                                                get_Allocation_State(get_bit_range_uint8(descriptor[12], 3, 0)));
+            reportedEnd = descriptorEnd;
+        }
+        if (ret == SUCCESS && reportedEnd == nextLBA)
+        {
+            // no progress. The device has nothing more to report.
+            if (map->commands == UINT32_C(1))
+            {
+                ret = FAILURE;
+            }
+            else
+            {
+                // keep what was read and treat the rest as mapped, the same as any other LBAs the device does not
+                // describe
+                ret = add_Allocation_Extent(map, &capacity, nextLBA, endLBA - nextLBA, ALLOCATION_MAPPED);
+            }
+            break;
+        }
+        nextLBA = reportedEnd;
+    }
+    safe_free_aligned(&buffer);
+    if (ret != SUCCESS)
+    {
+        free_Allocation_Map(map);
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API void free_Allocation_Map(allocationMap* M_NULLABLE map)
+{
+    if (map != M_NULLPTR)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, &map->extents));
+        safe_memset(map, sizeof(allocationMap), 0, sizeof(allocationMap));
+    }
+}
+
+OPENSEA_TRANSPORT_API uint32_t get_Allocation_Map_Mapped_Ranges(const allocationMap* M_NONNULL map,
+                                                                lbaRange* M_NULLABLE           ranges,
+                                                                uint32_t                       maxRanges)
+{
+    uint32_t mappedExtents = UINT32_C(0);
+    for (uint32_t iter = UINT32_C(0); iter < map->numberOfExtents; ++iter)
+    {
+        if (map->extents[iter].state == ALLOCATION_MAPPED)
+        {
+            if (ranges != M_NULLPTR && mappedExtents < maxRanges)
+            {
+                ranges[mappedExtents].lba    = map->extents[iter].startLBA;
+                ranges[mappedExtents].length = map->extents[iter].length;
+            }
+            ++mappedExtents;
+        }
+    }
+    return mappedExtents;
+}
@@ -76,6 +76,45 @@ OPENSEA_TRANSPORT_API eReturnValues ata_Passthrough_Command(const tDevice* M_NON
         ret = BAD_PARAMETER;
         break;
     }
+    // Native ATA passthrough does not go through the software SAT translator, so drop what it has cached from the
+    // drive after anything that can change it. Even a failed command may have partially changed things.
+    switch (ataCommandOptions->tfr.CommandStatus)
+    {
+    case ATA_SMART_CMD:
+        switch (ataCommandOptions->tfr.ErrorFeature)
+        {
+        case ATA_SMART_READ_DATA:
+        case ATA_SMART_RDATTR_THRESH:
+        case ATA_SMART_READ_LOG:
+        case ATA_SMART_RTSMART:
+            break;
+        default:
+            sat_Invalidate_Translator_Cache(device);
+            break;
+        }
+        break;
+    case ATA_SET_FEATURE:
+    case ATA_SECURITY_SET_PASS:
+    case ATA_SECURITY_UNLOCK_CMD:
+    case ATA_SECURITY_ERASE_PREP:
+    case ATA_SECURITY_ERASE_UNIT_CMD:
+    case ATA_SECURITY_FREEZE_LOCK_CMD:
+    case ATA_SECURITY_DISABLE_PASS:
+    case ATA_DOWNLOAD_MICROCODE_CMD:
+    case ATA_DOWNLOAD_MICROCODE_DMA:
+    case ATA_SANITIZE:
+    case ATA_SET_MAX:
+    case ATA_SET_MAX_EXT:
+    case ATA_ACCESSABLE_MAX_ADDR:
+    case ATA_DCO:
+    case ATA_FORMAT_TRACK_CMD:
+    case ATA_WRITE_LOG_EXT_CMD:
+    case ATA_WRITE_LOG_EXT_DMA:
+        sat_Invalidate_Translator_Cache(device);
+        break;
+    default:
+        break;
+    }
     return ret;
 }
 
@@ -4791,3 +4791,102 @@ bool did_ATA_Command_Timeout(const tDevice* M_NONNULL device, const ataPassthrou
     }
     return timedOut;
 }
+
+M_PARAM_RO_SIZE(1, 2)
+M_PARAM_RW(3)
+M_PARAM_RW(4)
+M_PARAM_WO_SIZE(5, 6)
+OPENSEA_TRANSPORT_API uint32_t fill_ATA_DSM_Trim_Buffer(const lbaRange* M_NONNULL ranges,
+                                                        uint32_t                  numberOfRanges,
+                                                        uint32_t* M_NONNULL       rangeIndex,
+                                                        uint64_t* M_NONNULL       rangeOffset,
+                                                        uint8_t* M_NONNULL        buffer,
+                                                        uint32_t                  bufferSize,
+                                                        bool                      xl)
+{
+    uint32_t entries     = UINT32_C(0);
+    uint32_t entrySize   = xl ? UINT32_C(16) : UINT32_C(8);
+    uint64_t maxPerEntry = xl ? UINT64_MAX : UINT64_C(0xFFFF);
+    if (ranges == M_NULLPTR || rangeIndex == M_NULLPTR || rangeOffset == M_NULLPTR || buffer == M_NULLPTR)
+    {
+        return entries;
+    }
+    if (0 != safe_memset(buffer, bufferSize, 0, bufferSize))
+        M_UNLIKELY
+        {
+            return entries;
+        }
+    while (*rangeIndex < numberOfRanges && ((entries + UINT32_C(1)) * entrySize) <= bufferSize)
+    {
+        const lbaRange* range = &ranges[*rangeIndex];
+        if (*rangeOffset >= range->length)
+        {
+            *rangeIndex += UINT32_C(1);
+            *rangeOffset = UINT64_C(0);
+            continue;
+        }
+        uint64_t lba    = range->lba + *rangeOffset;
+        uint64_t count  = M_Min(range->length - *rangeOffset, maxPerEntry);
+        uint32_t offset = entries * entrySize;
+        // Entries are little endian. Bits 47:0 are the LBA. Bits 63:48 are the count for the non-XL format. XL puts a
+        // full 64bit count in the second qword.
+        buffer[offset + 0] = M_Byte0(lba);
+        buffer[offset + 1] = M_Byte1(lba);
+        buffer[offset + 2] = M_Byte2(lba);
+        buffer[offset + 3] = M_Byte3(lba);
+        buffer[offset + 4] = M_Byte4(lba);
+        buffer[offset + 5] = M_Byte5(lba);
+        if (xl)
+        {
+            buffer[offset + 8]  = M_Byte0(count);
+            buffer[offset + 9]  = M_Byte1(count);
+            buffer[offset + 10] = M_Byte2(count);
+            buffer[offset + 11] = M_Byte3(count);
+            buffer[offset + 12] = M_Byte4(count);
+            buffer[offset + 13] = M_Byte5(count);
+            buffer[offset + 14] = M_Byte6(count);
+            buffer[offset + 15] = M_Byte7(count);
+        }
+        else
+        {
+            buffer[offset + 6] = M_Byte0(count);
+            buffer[offset + 7] = M_Byte1(count);
+        }
+        *rangeOffset += count;
+        ++entries;
+    }
+    // step past a range that was finished exactly so callers can check rangeIndex to know if more commands are needed
+    if (*rangeIndex < numberOfRanges && *rangeOffset >= ranges[*rangeIndex].length)
+    {
+        *rangeIndex += UINT32_C(1);
+        *rangeOffset = UINT64_C(0);
+    }
+    return entries;
+}
+
+M_PARAM_RO(1) OPENSEA_TRANSPORT_API bool is_ATA_NCQ_Trim_Supported(const tDevice* M_NONNULL device)
+{
+    bool supported = false;
+    // NCQ, SEND/RECEIVE FPDMA QUEUED, and GPL must all be supported before the NCQ send and receive log can be read
+    if (device->drive_info.ata_Options.nativeCommandQueuingSupported &&
+        device->drive_info.ata_Options.generalPurposeLoggingSupported &&
+        is_ATA_Identify_Word_Valid_SATA(le16_to_host(device->drive_info.IdentifyData.ata.Word077)) &&
+        le16_to_host(device->drive_info.IdentifyData.ata.Word077) & BIT6)
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, ncqSendReceiveLog, LEGACY_DRIVE_SEC_SIZE);
+        if (SUCCESS == ata_Read_Log_Ext(device, ATA_LOG_SATA_NCQ_SEND_AND_RECEIVE_LOG, 0, ncqSendReceiveLog,
+                                        LEGACY_DRIVE_SEC_SIZE,
+                                        device->drive_info.ata_Options.readLogWriteLogDMASupported &&
+                                            device->drive_info.ata_Options.sataReadLogDMASameAsPIO,
+                                        0))
+        {
+            // dword 0 bit 0 = data set management is supported in SEND FPDMA QUEUED
+            // dword 1 bit 0 = the TRIM bit is supported in queued data set management
+            if (ncqSendReceiveLog[0] & BIT0 && ncqSendReceiveLog[4] & BIT0)
+            {
+                supported = true;
+            }
+        }
+    }
+    return supported;
+}
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file ata_log_reader.c
+// \brief Implements reading large ATA general purpose logs in the largest chunks the device and the bridge accept,
+// handing each chunk to a callback as it arrives
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "ata_helper_func.h"
+#include "ata_log_reader.h"
+#include "surface_scan.h"
+
+// Log page numbers are 16 bits
+#define ATA_LOG_READER_MAX_PAGES UINT32_C(65536)
+// The page count of one READ LOG EXT is 16 bits
+#define ATA_LOG_READER_MAX_CHUNK_PAGES UINT16_C(65535)
+
+static bool is_ATA_Queued_Log_Read_Supported(const tDevice* device)
+{
+    uint16_t word077 = le16_to_host(device->drive_info.IdentifyData.ata.Word077);
+    return device->drive_info.ata_Options.nativeCommandQueuingSupported &&
+           get_Device_InterfaceType(device) != IDE_INTERFACE && is_ATA_Identify_Word_Valid_SATA(word077) &&
+           (word077 & BIT6) > 0;
+}
+
+static uint16_t get_ATA_Log_Chunk_Pages(const tDevice* device)
+{
+    uint32_t blockSize = get_Device_BlockSize(device);
+    uint32_t pages     = UINT32_C(0);
+    if (blockSize == UINT32_C(0))
+    {
+        blockSize = LEGACY_DRIVE_SEC_SIZE;
+    }
+    // the largest read transfer through the passthrough and any bridge is also the largest log read
+    pages = get_Surface_Scan_Blocks_Per_Command(device, SURFACE_SCAN_READ) * blockSize / LEGACY_DRIVE_SEC_SIZE;
+    return C_CAST(uint16_t, M_Max(M_Min(pages, C_CAST(uint32_t, ATA_LOG_READER_MAX_CHUNK_PAGES)), UINT32_C(1)));
+}
+
+static eReturnValues get_ATA_Log_Pages_From_Directory(const tDevice* device, uint8_t logAddress, uint32_t* logPages)
+{
+    eReturnValues ret = SUCCESS;
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, logDirectory, ATA_LOG_PAGE_LEN_BYTES);
+    *logPages = UINT32_C(0);
+    ret       = send_ATA_Read_Log_Ext_Cmd(device, ATA_LOG_DIRECTORY, 0, logDirectory, ATA_LOG_PAGE_LEN_BYTES, 0);
+    if (ret == SUCCESS)
+    {
+        *logPages = get_ATA_Log_Size_From_Directory(logDirectory, logAddress) / ATA_LOG_PAGE_LEN_BYTES;
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues ata_Read_Log_Stream(const tDevice* M_NONNULL             device,
+                                                        const ataLogReaderOptions* M_NONNULL options,
+                                                        ataLogReaderResults* M_NULLABLE      results)
+{
+    eReturnValues       ret    = SUCCESS;
+    uint8_t*            buffer = M_NULLPTR;
+    ataLogReaderResults localResults;
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(ataLogReaderResults), 0, sizeof(ataLogReaderResults));
+    if (get_Device_DriveType(device) != ATA_DRIVE || !device->drive_info.ata_Options.generalPurposeLoggingSupported)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (options->chunkCallback == M_NULLPTR || options->logPages > ATA_LOG_READER_MAX_PAGES)
+    {
+        return BAD_PARAMETER;
+    }
+    results->logPages = options->logPages;
+    if (results->logPages == UINT32_C(0))
+    {
+        ret = get_ATA_Log_Pages_From_Directory(device, options->logAddress, &results->logPages);
+        if (ret != SUCCESS)
+        {
+            return ret;
+        }
+        if (results->logPages == UINT32_C(0))
+        {
+            return NOT_SUPPORTED;
+        }
+    }
+    results->chunkPages = options->chunkPages > UINT16_C(0) ? options->chunkPages : get_ATA_Log_Chunk_Pages(device);
+    results->chunkPages = C_CAST(uint16_t, M_Min(C_CAST(uint32_t, results->chunkPages), results->logPages));
+    // the NCQ command error log is read to recover from a failed queued command, so it is never read queued
+    results->queued = !options->noQueuedReads && options->logAddress != ATA_LOG_NCQ_COMMAND_ERROR_LOG &&
+                      is_ATA_Queued_Log_Read_Supported(device);
+    buffer          = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(C_CAST(size_t, results->chunkPages) *
+                                                                           ATA_LOG_PAGE_LEN_BYTES,
+                                                                       sizeof(uint8_t),
+                                                                       get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    while (ret == SUCCESS && results->pagesRead < results->logPages)
+    {
+        uint16_t firstPage  = C_CAST(uint16_t, results->pagesRead);
+        uint32_t chunkPages = M_Min(C_CAST(uint32_t, results->chunkPages), results->logPages - results->pagesRead);
+        uint32_t chunkSize  = chunkPages * ATA_LOG_PAGE_LEN_BYTES;
+        if (results->queued)
+        {
+            ret = ata_NCQ_Read_Log_DMA_Ext(device, options->logAddress, firstPage, buffer, chunkSize,
+                                           options->featureRegister, 0, 0);
+            ++results->commands;
+            if (ret != SUCCESS)
+            {
+                // the device, driver or bridge does not take the queued command. Use the non-queued one from now on.
+                results->queued = false;
+            }
+        }
+        if (!results->queued)
+        {
+            ret = send_ATA_Read_Log_Ext_Cmd(device, options->logAddress, firstPage, buffer, chunkSize,
+                                            options->featureRegister);
+            ++results->commands;
+        }
+        if (ret != SUCCESS)
+        {
+            break;
+        }
+        results->pagesRead += chunkPages;
+        if (!options->chunkCallback(buffer, chunkSize, firstPage, options->callbackContext))
+        {
+            ret = ABORTED;
+        }
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
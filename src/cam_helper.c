@@ -1431,6 +1431,7 @@ static int ad_filter(const struct dirent* entry)
 
 M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
 {
+    release_Device_Resources(dev);
     if (dev->os_info.cam_dev)
     {
         cam_close_device(dev->os_info.cam_dev);
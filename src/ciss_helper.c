@@ -1190,6 +1190,7 @@ M_PARAM_RW(1) eReturnValues close_CISS_RAID_Device(tDevice* M_NONNULL device)
 
     if (device != M_NULLPTR && device->os_info.cissDeviceData)
     {
+        release_Device_Resources(device);
         if (close(device->os_info.cissDeviceData->cissHandle))
         {
             set_Device_Last_Error(device, errno);
@@ -1273,6 +1274,7 @@ static eReturnValues get_CISS_Physical_LUN_Count(int fd, uint32_t* M_NONNULL cou
             ret = ciss_Passthrough(&physicalLunCMD, CISS_CMD_CONTROLLER);
 
             // done with this memory now, so clean it up
+            release_Device_Resources(&pseudoDev);
             safe_free_ciss_dev_info(&pseudoDev.os_info.cissDeviceData);
 
             // print_Data_Buffer(data, dataLength, false);
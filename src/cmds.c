@@ -1155,6 +1155,245 @@ OPENSEA_TRANSPORT_API eReturnValues write_Same(const tDevice* M_NONNULL device,
     return ret;
 }
 
+// SCSI UNMAP parameter list: 8 byte header followed by 16 byte block descriptors. The list length field is 16 bits.
+#define DEALLOCATE_SCSI_UNMAP_HEADER_LEN      UINT32_C(8)
+#define DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN  UINT32_C(16)
+#define DEALLOCATE_SCSI_UNMAP_MAX_DESCRIPTORS                                                                          \
+    ((C_CAST(uint32_t, UINT16_MAX) - DEALLOCATE_SCSI_UNMAP_HEADER_LEN) / DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN)
+
+// Fills an UNMAP parameter list from the ranges, the same way fill_ATA_DSM_Trim_Buffer does for ATA. Stops at
+// maxDescriptors or when another descriptor would go over maxLBAs for the whole command.
+static uint32_t fill_SCSI_Unmap_Buffer(const lbaRange* ranges,
+                                       uint32_t        numberOfRanges,
+                                       uint32_t*       rangeIndex,
+                                       uint64_t*       rangeOffset,
+                                       uint8_t*        buffer,
+                                       uint32_t        maxDescriptors,
+                                       uint32_t        maxLBAs)
+{
+    uint32_t descriptors = UINT32_C(0);
+    uint64_t lbasPlaced  = UINT64_C(0);
+    uint32_t bufferSize  = DEALLOCATE_SCSI_UNMAP_HEADER_LEN + (maxDescriptors * DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN);
+    safe_memset(buffer, bufferSize, 0, bufferSize);
+    while (*rangeIndex < numberOfRanges && descriptors < maxDescriptors && lbasPlaced < maxLBAs)
+    {
+        const lbaRange* range = &ranges[*rangeIndex];
+        if (*rangeOffset >= range->length)
+        {
+            *rangeIndex += UINT32_C(1);
+            *rangeOffset = UINT64_C(0);
+            continue;
+        }
+        uint64_t lba    = range->lba + *rangeOffset;
+        uint32_t count =
+            C_CAST(uint32_t, M_Min(range->length - *rangeOffset, C_CAST(uint64_t, maxLBAs) - lbasPlaced));
+        uint32_t offset = DEALLOCATE_SCSI_UNMAP_HEADER_LEN + (descriptors * DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN);
+        // big endian LBA, then the number of logical blocks. The last 4 bytes are reserved.
+        buffer[offset + 0]  = M_Byte7(lba);
+        buffer[offset + 1]  = M_Byte6(lba);
+        buffer[offset + 2]  = M_Byte5(lba);
+        buffer[offset + 3]  = M_Byte4(lba);
+        buffer[offset + 4]  = M_Byte3(lba);
+        buffer[offset + 5]  = M_Byte2(lba);
+        buffer[offset + 6]  = M_Byte1(lba);
+        buffer[offset + 7]  = M_Byte0(lba);
+        buffer[offset + 8]  = M_Byte3(count);
+        buffer[offset + 9]  = M_Byte2(count);
+        buffer[offset + 10] = M_Byte1(count);
+        buffer[offset + 11] = M_Byte0(count);
+        *rangeOffset += count;
+        lbasPlaced += count;
+        ++descriptors;
+    }
+    if (*rangeIndex < numberOfRanges && *rangeOffset >= ranges[*rangeIndex].length)
+    {
+        *rangeIndex += UINT32_C(1);
+        *rangeOffset = UINT64_C(0);
+    }
+    // unmap data length does not include itself, block descriptor data length is just the descriptors
+    uint16_t descriptorLength = C_CAST(uint16_t, descriptors * DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN);
+    buffer[0]                 = M_Byte1(descriptorLength + UINT16_C(6));
+    buffer[1]                 = M_Byte0(descriptorLength + UINT16_C(6));
+    buffer[2]                 = M_Byte1(descriptorLength);
+    buffer[3]                 = M_Byte0(descriptorLength);
+    return descriptors;
+}
+
+static eReturnValues deallocate_SCSI_Ranges(const tDevice* device, const lbaRange* ranges, uint32_t numberOfRanges)
+{
+    eReturnValues              ret            = SUCCESS;
+    const scsiBlockLimitsData* blockLimits    = get_SCSI_Block_Limits(device);
+    uint32_t                   maxLBAs        = blockLimits->maximumUnmapLBACount;
+    uint32_t                   maxDescriptors = blockLimits->maximumUnmapDescriptorCount;
+    uint32_t                   rangeIndex     = UINT32_C(0);
+    uint64_t                   rangeOffset    = UINT64_C(0);
+    uint8_t*                   buffer         = M_NULLPTR;
+    if (maxLBAs == UINT32_C(0) || maxDescriptors == UINT32_C(0))
+    {
+        // both are zero when UNMAP is not supported
+        return NOT_SUPPORTED;
+    }
+    maxDescriptors = M_Min(maxDescriptors, DEALLOCATE_SCSI_UNMAP_MAX_DESCRIPTORS);
+    buffer         = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(DEALLOCATE_SCSI_UNMAP_HEADER_LEN +
+                                          (maxDescriptors * DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN),
+                                      sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    while (rangeIndex < numberOfRanges && ret == SUCCESS)
+    {
+        uint32_t descriptors = fill_SCSI_Unmap_Buffer(ranges, numberOfRanges, &rangeIndex, &rangeOffset, buffer,
+                                                      maxDescriptors, maxLBAs);
+        if (descriptors == UINT32_C(0))
+        {
+            break;
+        }
+        ret = scsi_Unmap(device, false, 0,
+                         C_CAST(uint16_t, DEALLOCATE_SCSI_UNMAP_HEADER_LEN +
+                                              (descriptors * DEALLOCATE_SCSI_UNMAP_DESCRIPTOR_LEN)),
+                         buffer);
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
+
+static eReturnValues deallocate_ATA_Ranges(const tDevice* device, const lbaRange* ranges, uint32_t numberOfRanges)
+{
+    eReturnValues ret         = SUCCESS;
+    uint32_t      bufferSize  = LEGACY_DRIVE_SEC_SIZE; // identify word 105 is the number of 512B blocks allowed
+    uint32_t      rangeIndex  = UINT32_C(0);
+    uint64_t      rangeOffset = UINT64_C(0);
+    bool          xl          = device->drive_info.softSATFlags.dataSetManagementXLSupported;
+    uint32_t      entrySize   = xl ? UINT32_C(16) : UINT32_C(8);
+    bool          queued      = false;
+    uint8_t*      buffer      = M_NULLPTR;
+    if (!(is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word169)) &&
+          le16_to_host(device->drive_info.IdentifyData.ata.Word169) & BIT0))
+    {
+        return NOT_SUPPORTED;
+    }
+    if (is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word105)) &&
+        le16_to_host(device->drive_info.IdentifyData.ata.Word105) > 0)
+    {
+        bufferSize =
+            C_CAST(uint32_t, le16_to_host(device->drive_info.IdentifyData.ata.Word105)) * LEGACY_DRIVE_SEC_SIZE;
+    }
+    buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(bufferSize, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    // queued TRIM only takes the regular range entries
+    queued = !xl && is_ATA_NCQ_Trim_Supported(device);
+    while (rangeIndex < numberOfRanges && ret == SUCCESS)
+    {
+        uint32_t entries = fill_ATA_DSM_Trim_Buffer(ranges, numberOfRanges, &rangeIndex, &rangeOffset, buffer,
+                                                    bufferSize, xl);
+        // only transfer the 512B blocks that hold entries
+        uint32_t transferBlocks = ((entries * entrySize) + LEGACY_DRIVE_SEC_SIZE - UINT32_C(1)) / LEGACY_DRIVE_SEC_SIZE;
+        uint32_t transferLength = transferBlocks * LEGACY_DRIVE_SEC_SIZE;
+        if (entries == UINT32_C(0))
+        {
+            break;
+        }
+        if (queued)
+        {
+            ret = ata_NCQ_Data_Set_Management(device, true, buffer, transferLength, 0, 0);
+            if (ret != SUCCESS)
+            {
+                // Not all passthroughs can issue queued commands. Use the non-queued command from here on.
+                queued = false;
+            }
+        }
+        if (!queued)
+        {
+            ret = ata_Data_Set_Management(device, true, buffer, transferLength, xl);
+        }
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
+
+static eReturnValues deallocate_NVMe_Ranges(const tDevice* device, const lbaRange* ranges, uint32_t numberOfRanges)
+{
+    eReturnValues ret             = SUCCESS;
+    uint32_t      maxRanges       = NVME_DSM_MAX_RANGES;
+    uint32_t      maxLBAsPerRange = UINT32_MAX;
+    uint32_t      rangeIndex      = UINT32_C(0);
+    uint64_t      rangeOffset     = UINT64_C(0);
+    uint8_t*      buffer          = M_NULLPTR;
+    if (!(le16_to_host(device->drive_info.IdentifyData.nvme.ctrl.oncs) & BIT2))
+    {
+        return NOT_SUPPORTED;
+    }
+    // defaults are filled in when the limits cannot be read
+    M_STATIC_CAST(void, get_NVMe_DSM_Limits(device, &maxRanges, &maxLBAsPerRange));
+    buffer = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(NVME_DSM_MAX_BUFFER_SIZE, sizeof(uint8_t),
+                                                              get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    while (rangeIndex < numberOfRanges && ret == SUCCESS)
+    {
+        uint32_t entries = fill_NVMe_DSM_Range_Buffer(ranges, numberOfRanges, &rangeIndex, &rangeOffset, buffer,
+                                                      maxRanges * NVME_DSM_RANGE_SIZE, maxLBAsPerRange);
+        if (entries == UINT32_C(0))
+        {
+            break;
+        }
+        ret = nvme_Dataset_Management(device, C_CAST(uint8_t, NVME_0_BASED_ADJUST(entries)), true, false, false, buffer,
+                                      NVME_DSM_MAX_BUFFER_SIZE);
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
+
+M_PARAM_RO(1)
+M_PARAM_RW_SIZE(2, 3)
+OPENSEA_TRANSPORT_API eReturnValues deallocate_Ranges(const tDevice* M_NONNULL device,
+                                                      lbaRange* M_NONNULL      ranges,
+                                                      uint32_t                 numberOfRanges)
+{
+    eReturnValues ret    = NOT_SUPPORTED;
+    uint64_t      maxLBA = device->drive_info.deviceMaxLba;
+    if (ranges == M_NULLPTR && numberOfRanges > UINT32_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    numberOfRanges = coalesce_LBA_Ranges(ranges, numberOfRanges);
+    if (numberOfRanges == UINT32_C(0))
+    {
+        return SUCCESS;
+    }
+    for (uint32_t iter = UINT32_C(0); iter < numberOfRanges; ++iter)
+    {
+        if (ranges[iter].lba > maxLBA || ranges[iter].length - 1 > maxLBA - ranges[iter].lba)
+        {
+            return BAD_PARAMETER;
+        }
+    }
+    switch (get_Device_DriveType(device))
+    {
+    case ATA_DRIVE:
+        ret = deallocate_ATA_Ranges(device, ranges, numberOfRanges);
+        break;
+    case NVME_DRIVE:
+        ret = deallocate_NVMe_Ranges(device, ranges, numberOfRanges);
+        break;
+    case SCSI_DRIVE:
+        ret = deallocate_SCSI_Ranges(device, ranges, numberOfRanges);
+        break;
+    default:
+        ret = NOT_SUPPORTED;
+        break;
+    }
+    return ret;
+}
+
 OPENSEA_TRANSPORT_API bool is_Write_Psuedo_Uncorrectable_Supported(const tDevice* M_NONNULL device)
 {
     bool supported = false;
@@ -0,0 +1,514 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file command_capture.c
+// \brief Implements capture of the commands sent to a device to a file, and replay of a capture in place of the OS
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "secure_file.h"
+#include "type_conversion.h"
+
+#include "command_capture.h"
+#include "platform_helper.h"
+#include "sntl_helper.h"
+
+typedef enum eCommandCaptureModeEnum
+{
+    COMMAND_CAPTURE_MODE_CAPTURE,
+    COMMAND_CAPTURE_MODE_REPLAY
+} eCommandCaptureMode;
+
+struct s_commandCaptureContext
+{
+    eCommandCaptureMode mode;
+    bool                failed; // a write to the capture failed, or replay diverged from the capture
+    uint8_t             padd[3];
+    uint64_t            records; // records written or replayed. Used to detect commands that were translated
+    secureFileInfo* M_NULLABLE captureFile;
+    uint8_t* M_NULLABLE        replayData;
+    size_t                     replayDataSize;
+    size_t                     replayOffset; // offset of the next record to replay
+};
+
+// 64 bits so that lengths read from a capture cannot wrap the sum
+static M_INLINE uint64_t get_Capture_Record_Size(uint32_t dataOutLength, uint32_t dataInLength, uint8_t senseLength)
+{
+    uint64_t recordSize = C_CAST(uint64_t, sizeof(commandCaptureRecord)) + C_CAST(uint64_t, dataOutLength) +
+                          C_CAST(uint64_t, dataInLength) + C_CAST(uint64_t, senseLength);
+    return (recordSize + UINT64_C(7)) & ~UINT64_C(7);
+}
+
+M_PARAM_RW(1)
+M_NULL_TERM_STRING(2)
+M_PARAM_RO(2)
+OPENSEA_TRANSPORT_API eReturnValues start_Command_Capture(tDevice* M_NONNULL    device,
+                                                          const char* M_NONNULL fileName)
+{
+    ptrCommandCaptureContext context = M_NULLPTR;
+    commandCaptureHeader     header;
+    size_t                   written = SIZE_T_C(0);
+    if (device->drive_info.commandCapture != M_NULLPTR)
+    {
+        return BAD_PARAMETER;
+    }
+    context = M_REINTERPRET_CAST(ptrCommandCaptureContext, safe_calloc(1, sizeof(commandCaptureContext)));
+    if (context == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    context->mode        = COMMAND_CAPTURE_MODE_CAPTURE;
+    context->captureFile = secure_Open_File(fileName, "wb", M_NULLPTR, M_NULLPTR, M_NULLPTR);
+    if (context->captureFile == M_NULLPTR || context->captureFile->error != SEC_FILE_SUCCESS)
+    {
+        free_Secure_File_Info(&context->captureFile);
+        safe_free_core(M_REINTERPRET_CAST(void**, &context));
+        return FILE_OPEN_ERROR;
+    }
+    safe_memset(&header, sizeof(commandCaptureHeader), 0, sizeof(commandCaptureHeader));
+    safe_memcpy(header.signature, sizeof(header.signature), COMMAND_CAPTURE_SIGNATURE, sizeof(header.signature));
+    header.byteOrder        = COMMAND_CAPTURE_BYTE_ORDER;
+    header.version          = COMMAND_CAPTURE_VERSION;
+    header.headerSize       = C_CAST(uint32_t, sizeof(commandCaptureHeader));
+    header.recordHeaderSize = C_CAST(uint32_t, sizeof(commandCaptureRecord));
+    header.interfaceType    = C_CAST(int32_t, device->drive_info.interface_type);
+    header.driveType        = C_CAST(int32_t, device->drive_info.drive_type);
+    header.passthroughType  = C_CAST(int32_t, device->drive_info.passThroughHacks.passthroughType);
+    header.namespaceID      = device->drive_info.namespaceID;
+    if (SEC_FILE_SUCCESS != secure_Write_File(context->captureFile, &header, sizeof(commandCaptureHeader),
+                                              sizeof(uint8_t), sizeof(commandCaptureHeader), &written) ||
+        written != sizeof(commandCaptureHeader))
+    {
+        secure_Close_File(context->captureFile);
+        free_Secure_File_Info(&context->captureFile);
+        safe_free_core(M_REINTERPRET_CAST(void**, &context));
+        return ERROR_WRITING_FILE;
+    }
+    device->drive_info.commandCapture = context;
+    return SUCCESS;
+}
+
+M_PARAM_RW(1)
+M_PARAM_RO_SIZE(2, 3)
+OPENSEA_TRANSPORT_API eReturnValues start_Command_Replay(tDevice* M_NONNULL       device,
+                                                         const uint8_t* M_NONNULL captureData,
+                                                         size_t                   captureDataSize)
+{
+    ptrCommandCaptureContext    context = M_NULLPTR;
+    const commandCaptureHeader* header  = M_REINTERPRET_CAST(const commandCaptureHeader*, captureData);
+    if (device->drive_info.commandCapture != M_NULLPTR)
+    {
+        return BAD_PARAMETER;
+    }
+    if (captureDataSize < sizeof(commandCaptureHeader) ||
+        memcmp(header->signature, COMMAND_CAPTURE_SIGNATURE, sizeof(header->signature)) != 0)
+    {
+        return VALIDATION_FAILURE;
+    }
+    if (header->byteOrder != COMMAND_CAPTURE_BYTE_ORDER || header->version > COMMAND_CAPTURE_VERSION ||
+        header->recordHeaderSize != sizeof(commandCaptureRecord))
+    {
+        return NOT_SUPPORTED;
+    }
+    if (header->headerSize < sizeof(commandCaptureHeader) || header->headerSize > captureDataSize)
+    {
+        return VALIDATION_FAILURE;
+    }
+    context = M_REINTERPRET_CAST(ptrCommandCaptureContext, safe_calloc(1, sizeof(commandCaptureContext)));
+    if (context == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    context->replayData = M_REINTERPRET_CAST(uint8_t*, safe_malloc(captureDataSize));
+    if (context->replayData == M_NULLPTR)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, &context));
+        return MEMORY_FAILURE;
+    }
+    safe_memcpy(context->replayData, captureDataSize, captureData, captureDataSize);
+    context->mode           = COMMAND_CAPTURE_MODE_REPLAY;
+    context->replayDataSize = captureDataSize;
+    context->replayOffset   = header->headerSize;
+    // Take the same paths through the translators that the captured device did
+    device->drive_info.interface_type                   = C_CAST(eInterfaceType, header->interfaceType);
+    device->drive_info.drive_type                       = C_CAST(eDriveType, header->driveType);
+    device->drive_info.passThroughHacks.passthroughType = C_CAST(ePassthroughType, header->passthroughType);
+    device->drive_info.namespaceID                      = header->namespaceID;
+    device->drive_info.commandCapture                   = context;
+    return SUCCESS;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues stop_Command_Capture_Or_Replay(tDevice* M_NONNULL device)
+{
+    eReturnValues            ret     = SUCCESS;
+    ptrCommandCaptureContext context = device->drive_info.commandCapture;
+    if (context == M_NULLPTR)
+    {
+        return SUCCESS;
+    }
+    if (context->captureFile != M_NULLPTR)
+    {
+        if (SEC_FILE_SUCCESS != secure_Close_File(context->captureFile))
+        {
+            context->failed = true;
+        }
+        free_Secure_File_Info(&context->captureFile);
+    }
+    if (context->failed)
+    {
+        ret = FAILURE;
+    }
+    safe_free(&context->replayData);
+    device->drive_info.commandCapture = M_NULLPTR;
+    safe_free_core(M_REINTERPRET_CAST(void**, &context));
+    return ret;
+}
+
+M_PARAM_RO(1) bool is_Command_Replay_Active(const tDevice* M_NONNULL device)
+{
+    return device->drive_info.commandCapture != M_NULLPTR &&
+           device->drive_info.commandCapture->mode == COMMAND_CAPTURE_MODE_REPLAY;
+}
+
+static bool write_Capture_Bytes(ptrCommandCaptureContext context, const void* data, size_t length)
+{
+    size_t written = SIZE_T_C(0);
+    if (length == SIZE_T_C(0))
+    {
+        return true;
+    }
+    if (SEC_FILE_SUCCESS !=
+            secure_Write_File(context->captureFile, data, length, sizeof(uint8_t), length, &written) ||
+        written != length)
+    {
+        return false;
+    }
+    return true;
+}
+
+// Fills in recordSize and writes the record and everything that follows it. After the first failed write, capture
+// stops writing and stop_Command_Capture_Or_Replay reports the failure.
+static void write_Capture_Record(const tDevice* M_NONNULL device,
+                                 commandCaptureRecord*    record,
+                                 const uint8_t*           dataOut,
+                                 const uint8_t*           dataIn,
+                                 const uint8_t*           sense)
+{
+    ptrCommandCaptureContext context = device->drive_info.commandCapture;
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, padding, 8);
+    uint64_t unpaddedSize = C_CAST(uint64_t, sizeof(commandCaptureRecord)) + C_CAST(uint64_t, record->dataOutLength) +
+                            C_CAST(uint64_t, record->dataInLength) + C_CAST(uint64_t, record->senseLength);
+    uint64_t recordSize   = get_Capture_Record_Size(record->dataOutLength, record->dataInLength, record->senseLength);
+    if (context->failed)
+    {
+        return;
+    }
+    if (recordSize > UINT32_MAX)
+    {
+        print_tDevice_Verbose_String(device, VERBOSITY_COMMAND_NAMES,
+                                     "Command capture: command data too large to capture. Capture stopped.\n");
+        context->failed = true;
+        return;
+    }
+    record->recordSize = C_CAST(uint32_t, recordSize);
+    if (!write_Capture_Bytes(context, record, sizeof(commandCaptureRecord)) ||
+        !write_Capture_Bytes(context, dataOut, record->dataOutLength) ||
+        !write_Capture_Bytes(context, dataIn, record->dataInLength) ||
+        !write_Capture_Bytes(context, sense, record->senseLength) ||
+        !write_Capture_Bytes(context, padding, C_CAST(size_t, recordSize - unpaddedSize)))
+    {
+        print_tDevice_Verbose_String(device, VERBOSITY_COMMAND_NAMES,
+                                     "Command capture: write to the capture file failed. Capture stopped.\n");
+        context->failed = true;
+        return;
+    }
+    ++context->records;
+}
+
+static void capture_SCSI_Command(const ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues result)
+{
+    commandCaptureRecord record;
+    const uint8_t*       dataOut = M_NULLPTR;
+    const uint8_t*       dataIn  = M_NULLPTR;
+    safe_memset(&record, sizeof(commandCaptureRecord), 0, sizeof(commandCaptureRecord));
+    record.commandType    = COMMAND_CAPTURE_SCSI;
+    record.direction      = C_CAST(uint8_t, scsiIoCtx->direction);
+    record.commandLength  = C_CAST(uint8_t, M_Min(scsiIoCtx->cdbLength, COMMAND_CAPTURE_COMMAND_LENGTH));
+    record.transferLength = scsiIoCtx->dataLength;
+    record.result         = C_CAST(int32_t, result);
+    record.commandTimeNS  = get_tDevice_Last_Command_Completion_Time_NS(scsiIoCtx->device);
+    record.timeoutSeconds = scsiIoCtx->timeout;
+    record.scsiStatus[0]  = scsiIoCtx->returnStatus.format;
+    record.scsiStatus[1]  = scsiIoCtx->returnStatus.senseKey;
+    record.scsiStatus[2]  = scsiIoCtx->returnStatus.asc;
+    record.scsiStatus[3]  = scsiIoCtx->returnStatus.ascq;
+    record.scsiStatus[4]  = scsiIoCtx->returnStatus.fru;
+    safe_memcpy(record.command, COMMAND_CAPTURE_COMMAND_LENGTH, scsiIoCtx->cdb, record.commandLength);
+    if (scsiIoCtx->pAtaCmdOpts != M_NULLPTR)
+    {
+        record.rtfrValid = UINT8_C(1);
+        safe_memcpy(record.ataReturnTFRs, sizeof(record.ataReturnTFRs), &scsiIoCtx->pAtaCmdOpts->rtfr,
+                    M_Min(sizeof(ataReturnTFRs), sizeof(record.ataReturnTFRs)));
+    }
+    if (scsiIoCtx->pdata != M_NULLPTR && scsiIoCtx->dataLength > UINT32_C(0))
+    {
+        // A bidirectional transfer shares one buffer, so only its final contents are available.
+        if (scsiIoCtx->direction == XFER_DATA_OUT)
+        {
+            dataOut              = scsiIoCtx->pdata;
+            record.dataOutLength = scsiIoCtx->dataLength;
+        }
+        else if (scsiIoCtx->direction != XFER_NO_DATA)
+        {
+            dataIn              = scsiIoCtx->pdata;
+            record.dataInLength = scsiIoCtx->dataLength;
+        }
+    }
+    if (scsiIoCtx->psense != M_NULLPTR)
+    {
+        record.senseLength = C_CAST(uint8_t, M_Min(scsiIoCtx->senseDataSize, SPC3_SENSE_LEN));
+    }
+    write_Capture_Record(scsiIoCtx->device, &record, dataOut, dataIn, scsiIoCtx->psense);
+}
+
+M_PARAM_RO(1) void capture_NVMe_Command(const nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues result)
+{
+    commandCaptureRecord record;
+    const uint8_t*       dataOut = M_NULLPTR;
+    const uint8_t*       dataIn  = M_NULLPTR;
+    if (cmdCtx->device->drive_info.commandCapture == M_NULLPTR ||
+        cmdCtx->device->drive_info.commandCapture->mode != COMMAND_CAPTURE_MODE_CAPTURE)
+    {
+        return;
+    }
+    safe_memset(&record, sizeof(commandCaptureRecord), 0, sizeof(commandCaptureRecord));
+    record.commandType =
+        C_CAST(uint8_t, cmdCtx->commandType == NVM_ADMIN_CMD ? COMMAND_CAPTURE_NVME_ADMIN : COMMAND_CAPTURE_NVME_NVM);
+    record.direction      = C_CAST(uint8_t, cmdCtx->commandDirection);
+    record.commandLength  = C_CAST(uint8_t, M_Min(sizeof(nvmeCommands), COMMAND_CAPTURE_COMMAND_LENGTH));
+    record.transferLength = cmdCtx->dataSize;
+    record.result         = C_CAST(int32_t, result);
+    record.commandTimeNS  = get_tDevice_Last_Command_Completion_Time_NS(cmdCtx->device);
+    record.timeoutSeconds = cmdCtx->timeout;
+    record.completion[0]  = cmdCtx->commandCompletionData.dw0;
+    record.completion[1]  = cmdCtx->commandCompletionData.dw1;
+    record.completion[2]  = cmdCtx->commandCompletionData.dw2;
+    record.completion[3]  = cmdCtx->commandCompletionData.dw3;
+    if (cmdCtx->commandCompletionData.dw0Valid)
+    {
+        record.completionValid |= BIT0;
+    }
+    if (cmdCtx->commandCompletionData.dw1Valid)
+    {
+        record.completionValid |= BIT1;
+    }
+    if (cmdCtx->commandCompletionData.dw2Valid)
+    {
+        record.completionValid |= BIT2;
+    }
+    if (cmdCtx->commandCompletionData.dw3Valid)
+    {
+        record.completionValid |= BIT3;
+    }
+    safe_memcpy(record.command, COMMAND_CAPTURE_COMMAND_LENGTH, &cmdCtx->cmd, record.commandLength);
+    if (cmdCtx->ptrData != M_NULLPTR && cmdCtx->dataSize > UINT32_C(0))
+    {
+        if (cmdCtx->commandDirection == XFER_DATA_OUT)
+        {
+            dataOut              = cmdCtx->ptrData;
+            record.dataOutLength = cmdCtx->dataSize;
+        }
+        else if (cmdCtx->commandDirection != XFER_NO_DATA)
+        {
+            dataIn              = cmdCtx->ptrData;
+            record.dataInLength = cmdCtx->dataSize;
+        }
+    }
+    write_Capture_Record(cmdCtx->device, &record, dataOut, dataIn, M_NULLPTR);
+}
+
+// Gets the next record to replay without consuming it. Returns M_NULLPTR at the end of the capture or if the record
+// is malformed. The data out, data in and sense data of a returned record all lie within its recordSize, and the
+// record lies within the capture.
+static const commandCaptureRecord* peek_Replay_Record(const commandCaptureContext* context)
+{
+    const commandCaptureRecord* record    = M_NULLPTR;
+    uint64_t                    dataSpace = UINT64_C(0);
+    if (context->replayOffset >= context->replayDataSize ||
+        context->replayDataSize - context->replayOffset < sizeof(commandCaptureRecord))
+    {
+        return M_NULLPTR;
+    }
+    record = M_REINTERPRET_CAST(const commandCaptureRecord*, context->replayData + context->replayOffset);
+    if (record->recordSize > context->replayDataSize - context->replayOffset ||
+        record->recordSize < sizeof(commandCaptureRecord) || record->commandLength > COMMAND_CAPTURE_COMMAND_LENGTH)
+    {
+        return M_NULLPTR;
+    }
+    dataSpace = C_CAST(uint64_t, record->recordSize) - sizeof(commandCaptureRecord);
+    if (record->dataOutLength > dataSpace || record->dataInLength > dataSpace - record->dataOutLength ||
+        record->senseLength > dataSpace - record->dataOutLength - record->dataInLength ||
+        C_CAST(uint64_t, record->recordSize) <
+            get_Capture_Record_Size(record->dataOutLength, record->dataInLength, record->senseLength))
+    {
+        return M_NULLPTR;
+    }
+    return record;
+}
+
+static eReturnValues replay_Diverged(const tDevice* M_NONNULL device, const char* reason)
+{
+    ptrCommandCaptureContext context = device->drive_info.commandCapture;
+    print_tDevice_Verbose_Formatted_String(device, VERBOSITY_COMMAND_NAMES,
+                                           "Command replay: %s after %" PRIu64 " commands\n", reason,
+                                           context->records);
+    context->failed = true;
+    set_Last_Command_Time_To_tDevice(M_CONST_CAST(tDevice*, device), UINT64_C(0));
+    return OS_PASSTHROUGH_FAILURE;
+}
+
+// Checks that a command matches the record, then consumes the record and copies any data in to the caller's buffer.
+static bool consume_Replay_Record(const tDevice* M_NONNULL    device,
+                                  const commandCaptureRecord* record,
+                                  eCommandCaptureType         commandType,
+                                  const void*                 command,
+                                  uint8_t                     commandLength,
+                                  eDataTransferDirection      direction,
+                                  uint8_t* M_NULLABLE         data,
+                                  uint32_t                    dataLength)
+{
+    ptrCommandCaptureContext context = device->drive_info.commandCapture;
+    const uint8_t*           dataIn  = M_REINTERPRET_CAST(const uint8_t*, record + 1) + record->dataOutLength;
+    if (record->commandType != C_CAST(uint8_t, commandType) || record->commandLength != commandLength ||
+        record->direction != C_CAST(uint8_t, direction) || record->transferLength != dataLength ||
+        memcmp(record->command, command, commandLength) != 0)
+    {
+        return false;
+    }
+    if (record->dataInLength > UINT32_C(0) && data != M_NULLPTR)
+    {
+        safe_memcpy(data, dataLength, dataIn, M_Min(record->dataInLength, dataLength));
+    }
+    set_Last_Command_Time_To_tDevice(M_CONST_CAST(tDevice*, device), record->commandTimeNS);
+    context->replayOffset += record->recordSize;
+    ++context->records;
+    return true;
+}
+
+static eReturnValues replay_SCSI_Command(ScsiIoCtx* M_NONNULL scsiIoCtx, const commandCaptureRecord* record)
+{
+    const uint8_t* sense =
+        M_REINTERPRET_CAST(const uint8_t*, record + 1) + record->dataOutLength + record->dataInLength;
+    uint8_t commandLength = C_CAST(uint8_t, M_Min(scsiIoCtx->cdbLength, COMMAND_CAPTURE_COMMAND_LENGTH));
+    if (!consume_Replay_Record(scsiIoCtx->device, record, COMMAND_CAPTURE_SCSI, scsiIoCtx->cdb, commandLength,
+                               scsiIoCtx->direction, scsiIoCtx->pdata, scsiIoCtx->dataLength))
+    {
+        return replay_Diverged(scsiIoCtx->device, "SCSI command does not match the capture");
+    }
+    scsiIoCtx->returnStatus.format   = record->scsiStatus[0];
+    scsiIoCtx->returnStatus.senseKey = record->scsiStatus[1];
+    scsiIoCtx->returnStatus.asc      = record->scsiStatus[2];
+    scsiIoCtx->returnStatus.ascq     = record->scsiStatus[3];
+    scsiIoCtx->returnStatus.fru      = record->scsiStatus[4];
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+    {
+        safe_memset(scsiIoCtx->psense, scsiIoCtx->senseDataSize, 0, scsiIoCtx->senseDataSize);
+        safe_memcpy(scsiIoCtx->psense, scsiIoCtx->senseDataSize, sense,
+                    M_Min(scsiIoCtx->senseDataSize, C_CAST(uint32_t, record->senseLength)));
+    }
+    copy_Last_Command_Sense_Data_To_tDevice(scsiIoCtx->device, sense, record->senseLength);
+    if (record->rtfrValid && scsiIoCtx->pAtaCmdOpts != M_NULLPTR)
+    {
+        safe_memcpy(&scsiIoCtx->pAtaCmdOpts->rtfr, sizeof(ataReturnTFRs), record->ataReturnTFRs,
+                    M_Min(sizeof(ataReturnTFRs), sizeof(record->ataReturnTFRs)));
+    }
+    return C_CAST(eReturnValues, record->result);
+}
+
+M_PARAM_RW(1) eReturnValues send_IO_With_Command_Capture(ScsiIoCtx* M_NONNULL scsiIoCtx)
+{
+    eReturnValues            ret     = UNKNOWN;
+    ptrCommandCaptureContext context = scsiIoCtx->device->drive_info.commandCapture;
+    if (context == M_NULLPTR)
+    {
+        return send_IO(scsiIoCtx);
+    }
+    if (context->mode == COMMAND_CAPTURE_MODE_REPLAY)
+    {
+        const commandCaptureRecord* record = peek_Replay_Record(context);
+        if (record == M_NULLPTR)
+        {
+            ret = replay_Diverged(scsiIoCtx->device, "end of capture reached");
+        }
+        else if (record->commandType == COMMAND_CAPTURE_SCSI)
+        {
+            ret = replay_SCSI_Command(scsiIoCtx, record);
+        }
+        else if (get_Device_DriveType(scsiIoCtx->device) == NVME_DRIVE)
+        {
+            // This SCSI command was translated to NVMe when captured. Run the translator here instead of going through
+            // the OS layer so its commands are replayed and nothing reaches the device.
+            ret = sntl_Translate_SCSI_Command(scsiIoCtx->device, scsiIoCtx);
+        }
+        else
+        {
+            ret = replay_Diverged(scsiIoCtx->device, "SCSI command does not match the capture");
+        }
+    }
+    else
+    {
+        // If any records are written while this command is in the OS layer, it was translated and those commands
+        // were captured instead.
+        uint64_t recordsBefore = context->records;
+        ret                    = send_IO(scsiIoCtx);
+        if (context->records == recordsBefore)
+        {
+            capture_SCSI_Command(scsiIoCtx, ret);
+        }
+    }
+    return ret;
+}
+
+M_PARAM_RW(1) eReturnValues replay_NVMe_Command(nvmeCmdCtx* M_NONNULL cmdCtx)
+{
+    const commandCaptureRecord* record = M_NULLPTR;
+    eCommandCaptureType commandType = cmdCtx->commandType == NVM_ADMIN_CMD ? COMMAND_CAPTURE_NVME_ADMIN
+                                                                           : COMMAND_CAPTURE_NVME_NVM;
+    if (!is_Command_Replay_Active(cmdCtx->device))
+    {
+        return BAD_PARAMETER;
+    }
+    record = peek_Replay_Record(cmdCtx->device->drive_info.commandCapture);
+    safe_memset(&cmdCtx->commandCompletionData, sizeof(completionQueueEntry), 0, sizeof(completionQueueEntry));
+    if (record == M_NULLPTR)
+    {
+        return replay_Diverged(cmdCtx->device, "end of capture reached");
+    }
+    if (!consume_Replay_Record(cmdCtx->device, record, commandType, &cmdCtx->cmd,
+                               C_CAST(uint8_t, M_Min(sizeof(nvmeCommands), COMMAND_CAPTURE_COMMAND_LENGTH)),
+                               cmdCtx->commandDirection, cmdCtx->ptrData, cmdCtx->dataSize))
+    {
+        return replay_Diverged(cmdCtx->device, "NVMe command does not match the capture");
+    }
+    cmdCtx->commandCompletionData.dw0      = record->completion[0];
+    cmdCtx->commandCompletionData.dw1      = record->completion[1];
+    cmdCtx->commandCompletionData.dw2      = record->completion[2];
+    cmdCtx->commandCompletionData.dw3      = record->completion[3];
+    cmdCtx->commandCompletionData.dw0Valid = (record->completionValid & BIT0) > 0;
+    cmdCtx->commandCompletionData.dw1Valid = (record->completionValid & BIT1) > 0;
+    cmdCtx->commandCompletionData.dw2Valid = (record->completionValid & BIT2) > 0;
+    cmdCtx->commandCompletionData.dw3Valid = (record->completionValid & BIT3) > 0;
+    return C_CAST(eReturnValues, record->result);
+}
@@ -0,0 +1,462 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file command_stats.c
+// \brief Implements optional per device command counters and latency histograms
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "command_stats.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+
+struct s_commandStatsContext
+{
+    deviceCommandStats stats;
+    seatimer           collectionTimer; // started when enabled or reset. Used for collectionTimeNS
+    uint32_t           depth;           // number of commands in progress. Nested commands are not recorded
+    uint8_t            padd[4];
+};
+
+static void clear_Command_Stats(ptrCommandStatsContext context)
+{
+    safe_memset(&context->stats, sizeof(deviceCommandStats), 0, sizeof(deviceCommandStats));
+    for (uint8_t classIter = UINT8_C(0); classIter < CMD_STATS_CLASS_COUNT; ++classIter)
+    {
+        context->stats.commandClass[classIter].minTimeNS = UINT64_MAX;
+    }
+    safe_memset(&context->collectionTimer, sizeof(seatimer), 0, sizeof(seatimer));
+    start_Timer(&context->collectionTimer);
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues enable_Command_Stats(tDevice* M_NONNULL device)
+{
+    if (device->drive_info.commandStats == M_NULLPTR)
+    {
+        ptrCommandStatsContext context =
+            M_REINTERPRET_CAST(ptrCommandStatsContext, safe_calloc(1, sizeof(commandStatsContext)));
+        if (context == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+        clear_Command_Stats(context);
+        device->drive_info.commandStats = context;
+    }
+    return SUCCESS;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API void disable_Command_Stats(tDevice* M_NONNULL device)
+{
+    safe_free_command_stats(&device->drive_info.commandStats);
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues reset_Command_Stats(tDevice* M_NONNULL device)
+{
+    if (device->drive_info.commandStats == M_NULLPTR)
+    {
+        return NOT_SUPPORTED;
+    }
+    clear_Command_Stats(device->drive_info.commandStats);
+    return SUCCESS;
+}
+
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+OPENSEA_TRANSPORT_API eReturnValues get_Command_Stats_Snapshot(const tDevice* M_NONNULL      device,
+                                                               deviceCommandStats* M_NONNULL snapshot)
+{
+    const commandStatsContext* context = device->drive_info.commandStats;
+    seatimer                   elapsed;
+    if (context == M_NULLPTR)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (0 != safe_memcpy(snapshot, sizeof(deviceCommandStats), &context->stats, sizeof(deviceCommandStats)))
+        M_UNLIKELY
+        {
+            return FAILURE;
+        }
+    elapsed = context->collectionTimer;
+    stop_Timer(&elapsed);
+    snapshot->collectionTimeNS = get_Nano_Seconds(elapsed);
+    return SUCCESS;
+}
+
+static M_INLINE uint8_t get_Most_Significant_Bit_Index(uint64_t value)
+{
+    uint8_t index = UINT8_C(0);
+    if (value >= (UINT64_C(1) << 32))
+    {
+        value >>= 32;
+        index += 32;
+    }
+    if (value >= (UINT64_C(1) << 16))
+    {
+        value >>= 16;
+        index += 16;
+    }
+    if (value >= (UINT64_C(1) << 8))
+    {
+        value >>= 8;
+        index += 8;
+    }
+    if (value >= (UINT64_C(1) << 4))
+    {
+        value >>= 4;
+        index += 4;
+    }
+    if (value >= (UINT64_C(1) << 2))
+    {
+        value >>= 2;
+        index += 2;
+    }
+    if (value >= (UINT64_C(1) << 1))
+    {
+        index += 1;
+    }
+    return index;
+}
+
+static M_INLINE uint16_t get_Latency_Bucket(uint64_t timeNS)
+{
+    if (timeNS < COMMAND_STATS_SUB_BUCKETS)
+    {
+        return C_CAST(uint16_t, timeNS);
+    }
+    uint8_t  shift      = get_Most_Significant_Bit_Index(timeNS) - COMMAND_STATS_SUB_BUCKET_BITS;
+    uint64_t subBucket  = (timeNS >> shift) - COMMAND_STATS_SUB_BUCKETS;
+    uint16_t bucketBase = C_CAST(uint16_t, (shift + 1) * COMMAND_STATS_SUB_BUCKETS);
+    return C_CAST(uint16_t, bucketBase + subBucket);
+}
+
+// Largest value that is counted in the bucket
+static M_INLINE uint64_t get_Latency_Bucket_Upper_Bound(uint16_t bucket)
+{
+    if (bucket < COMMAND_STATS_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    uint8_t  shift    = C_CAST(uint8_t, (bucket / COMMAND_STATS_SUB_BUCKETS) - 1);
+    uint64_t mantissa = C_CAST(uint64_t, COMMAND_STATS_SUB_BUCKETS + (bucket % COMMAND_STATS_SUB_BUCKETS));
+    if (shift + COMMAND_STATS_SUB_BUCKET_BITS >= 63 && mantissa == (COMMAND_STATS_SUB_BUCKETS * 2) - 1)
+    {
+        return UINT64_MAX;
+    }
+    return ((mantissa + UINT64_C(1)) << shift) - UINT64_C(1);
+}
+
+M_PARAM_RO(1)
+OPENSEA_TRANSPORT_API uint64_t get_Command_Latency_Percentile(const commandClassStats* M_NONNULL stats,
+                                                              double                            percentile)
+{
+    uint64_t target = UINT64_C(0);
+    uint64_t seen   = UINT64_C(0);
+    if (stats->commands == UINT64_C(0))
+    {
+        return UINT64_C(0);
+    }
+    if (percentile <= 0.0)
+    {
+        return stats->minTimeNS;
+    }
+    if (percentile >= 100.0)
+    {
+        return stats->maxTimeNS;
+    }
+    target = C_CAST(uint64_t, (percentile / 100.0) * C_CAST(double, stats->commands));
+    if (C_CAST(double, target) < (percentile / 100.0) * C_CAST(double, stats->commands))
+    {
+        ++target; // round up so that p99.9 of 1000 commands is the 1000th and not the 999th
+    }
+    for (uint16_t bucket = UINT16_C(0); bucket < COMMAND_STATS_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        seen += stats->latencyHistogram[bucket];
+        if (seen >= target)
+        {
+            return M_Min(get_Latency_Bucket_Upper_Bound(bucket), stats->maxTimeNS);
+        }
+    }
+    return stats->maxTimeNS;
+}
+
+static const char* get_Command_Stats_Class_Name(eCommandStatsClass commandClass)
+{
+    switch (commandClass)
+    {
+    case CMD_STATS_CLASS_READ:
+        return "Read";
+    case CMD_STATS_CLASS_WRITE:
+        return "Write";
+    case CMD_STATS_CLASS_VERIFY:
+        return "Verify";
+    case CMD_STATS_CLASS_FLUSH:
+        return "Flush";
+    case CMD_STATS_CLASS_DEALLOCATE:
+        return "Deallocate";
+    case CMD_STATS_CLASS_OTHER:
+    case CMD_STATS_CLASS_COUNT:
+        break;
+    }
+    return "Other";
+}
+
+#define COMMAND_STATS_NS_PER_US (1000.0)
+
+M_PARAM_RO(1) OPENSEA_TRANSPORT_API void print_Command_Stats(const deviceCommandStats* M_NONNULL stats)
+{
+    printf("\nCommand Statistics (%0.02f seconds)\n", C_CAST(double, stats->collectionTimeNS) / 1000000000.0);
+    printf("%-10s %12s %8s %8s %8s %12s %12s %12s %12s %12s %12s\n", "Class", "Commands", "Errors", "Timeouts",
+           "Retries", "Avg (us)", "Min (us)", "p50 (us)", "p99 (us)", "p99.9 (us)", "Max (us)");
+    for (uint8_t classIter = UINT8_C(0); classIter < CMD_STATS_CLASS_COUNT; ++classIter)
+    {
+        const commandClassStats* classStats = &stats->commandClass[classIter];
+        if (classStats->commands == UINT64_C(0))
+        {
+            continue;
+        }
+        printf("%-10s %12" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+               " %12.02f %12.02f %12.02f %12.02f %12.02f %12.02f\n",
+               get_Command_Stats_Class_Name(C_CAST(eCommandStatsClass, classIter)), classStats->commands,
+               classStats->errors, classStats->timeouts, classStats->retries,
+               (C_CAST(double, classStats->totalTimeNS) / C_CAST(double, classStats->commands)) /
+                   COMMAND_STATS_NS_PER_US,
+               C_CAST(double, classStats->minTimeNS) / COMMAND_STATS_NS_PER_US,
+               C_CAST(double, get_Command_Latency_Percentile(classStats, 50.0)) / COMMAND_STATS_NS_PER_US,
+               C_CAST(double, get_Command_Latency_Percentile(classStats, 99.0)) / COMMAND_STATS_NS_PER_US,
+               C_CAST(double, get_Command_Latency_Percentile(classStats, 99.9)) / COMMAND_STATS_NS_PER_US,
+               C_CAST(double, classStats->maxTimeNS) / COMMAND_STATS_NS_PER_US);
+    }
+}
+
+M_PARAM_RO(1) void begin_Command_Stats(const tDevice* M_NONNULL device)
+{
+    ptrCommandStatsContext context = device->drive_info.commandStats;
+    if (context != M_NULLPTR)
+    {
+        ++context->depth;
+    }
+}
+
+M_PARAM_RO(1) void cancel_Command_Stats(const tDevice* M_NONNULL device)
+{
+    ptrCommandStatsContext context = device->drive_info.commandStats;
+    if (context != M_NULLPTR && context->depth > UINT32_C(0))
+    {
+        --context->depth;
+    }
+}
+
+M_PARAM_RO(1)
+void end_Command_Stats(const tDevice* M_NONNULL device, eCommandStatsClass commandClass, eReturnValues result)
+{
+    ptrCommandStatsContext context = device->drive_info.commandStats;
+    if (context == M_NULLPTR)
+    {
+        return;
+    }
+    if (context->depth > UINT32_C(0))
+    {
+        --context->depth;
+    }
+    if (context->depth == UINT32_C(0) && commandClass < CMD_STATS_CLASS_COUNT)
+    {
+        commandClassStats* classStats = &context->stats.commandClass[commandClass];
+        uint64_t           timeNS     = get_tDevice_Last_Command_Completion_Time_NS(device);
+        ++classStats->commands;
+        switch (result)
+        {
+        case SUCCESS:
+            break;
+        case OS_COMMAND_TIMEOUT:
+            ++classStats->timeouts;
+            break;
+        default:
+            ++classStats->errors;
+            break;
+        }
+        if (timeNS > UINT64_MAX - classStats->totalTimeNS)
+        {
+            classStats->totalTimeNS = UINT64_MAX;
+        }
+        else
+        {
+            classStats->totalTimeNS += timeNS;
+        }
+        classStats->minTimeNS = M_Min(classStats->minTimeNS, timeNS);
+        classStats->maxTimeNS = M_Max(classStats->maxTimeNS, timeNS);
+        ++classStats->latencyHistogram[get_Latency_Bucket(timeNS)];
+    }
+}
+
+M_PARAM_RO(1) void record_Command_Stats_Retry(const tDevice* M_NONNULL device, eCommandStatsClass commandClass)
+{
+    ptrCommandStatsContext context = device->drive_info.commandStats;
+    if (context != M_NULLPTR && commandClass < CMD_STATS_CLASS_COUNT)
+    {
+        ++context->stats.commandClass[commandClass].retries;
+    }
+}
+
+eCommandStatsClass get_ATA_Command_Stats_Class(uint8_t ataCommand, uint8_t sendFPDMASubcommand)
+{
+    switch (ataCommand)
+    {
+    case ATA_READ_SECT:
+    case ATA_READ_SECT_NORETRY:
+    case ATA_READ_SECT_EXT:
+    case ATA_READ_DMA_EXT:
+    case ATA_READ_DMA_QUE_EXT:
+    case ATA_READ_READ_MULTIPLE_EXT:
+    case ATA_READ_STREAM_DMA_EXT:
+    case ATA_READ_STREAM_EXT:
+    case ATA_READ_FPDMA_QUEUED_CMD:
+    case ATA_READ_MULTIPLE_CMD:
+    case ATA_READ_DMA_QUEUED_CMD:
+    case ATA_READ_DMA_RETRY_CMD:
+    case ATA_READ_DMA_NORETRY:
+        return CMD_STATS_CLASS_READ;
+    case ATA_WRITE_SECT:
+    case ATA_WRITE_SECT_NORETRY:
+    case ATA_WRITE_SECT_EXT:
+    case ATA_WRITE_DMA_EXT:
+    case ATA_WRITE_DMA_QUE_EXT:
+    case ATA_WRITE_MULTIPLE_EXT:
+    case ATA_WRITE_STREAM_DMA_EXT:
+    case ATA_WRITE_STREAM_EXT:
+    case ATA_WRITE_SECTV_RETRY:
+    case ATA_WRITE_DMA_FUA_EXT:
+    case ATA_WRITE_DMA_QUE_FUA_EXT:
+    case ATA_WRITE_FPDMA_QUEUED_CMD:
+    case ATA_WRITE_MULTIPLE_CMD:
+    case ATA_WRITE_DMA_RETRY_CMD:
+    case ATA_WRITE_DMA_NORETRY:
+    case ATA_WRITE_DMA_QUEUED_CMD:
+    case ATA_WRITE_MULTIPLE_FUA_EXT:
+        return CMD_STATS_CLASS_WRITE;
+    case ATA_READ_VERIFY_RETRY:
+    case ATA_READ_VERIFY_NORETRY:
+    case ATA_READ_VERIFY_EXT:
+        return CMD_STATS_CLASS_VERIFY;
+    case ATA_FLUSH_CACHE_CMD:
+    case ATA_FLUSH_CACHE_EXT:
+        return CMD_STATS_CLASS_FLUSH;
+    case ATA_DATA_SET_MANAGEMENT_CMD:
+    case ATA_DATA_SET_MANAGEMENT_XL_CMD:
+        return CMD_STATS_CLASS_DEALLOCATE;
+    case ATA_SEND_FPDMA:
+        if (sendFPDMASubcommand == UINT8_C(0)) // data set management
+        {
+            return CMD_STATS_CLASS_DEALLOCATE;
+        }
+        break;
+    default:
+        break;
+    }
+    return CMD_STATS_CLASS_OTHER;
+}
+
+M_PARAM_RO_SIZE(1, 2)
+eCommandStatsClass get_SCSI_Command_Stats_Class(const uint8_t* M_NONNULL cdb, uint8_t cdbLength)
+{
+    if (cdbLength == UINT8_C(0))
+    {
+        return CMD_STATS_CLASS_OTHER;
+    }
+    switch (cdb[OPERATION_CODE])
+    {
+    case READ6:
+    case READ10:
+    case READ12:
+    case READ16:
+        return CMD_STATS_CLASS_READ;
+    case WRITE6:
+    case WRITE10:
+    case WRITE12:
+    case WRITE16:
+    case WRITE_AND_VERIFY_10:
+    case WRITE_AND_VERIFY_12:
+    case WRITE_AND_VERIFY_16:
+        return CMD_STATS_CLASS_WRITE;
+    case VERIFY10:
+    case VERIFY12:
+    case VERIFY16:
+        return CMD_STATS_CLASS_VERIFY;
+    case SYNCHRONIZE_CACHE_10:
+    case SYNCHRONIZE_CACHE_16_CMD:
+        return CMD_STATS_CLASS_FLUSH;
+    case UNMAP_CMD:
+        return CMD_STATS_CLASS_DEALLOCATE;
+    case 0x7F: // variable length CDB
+        if (cdbLength >= 10)
+        {
+            switch (M_BytesTo2ByteValue(cdb[8], cdb[9]))
+            {
+            case 0x0009:
+                return CMD_STATS_CLASS_READ;
+            case 0x000B:
+            case 0x000C:
+                return CMD_STATS_CLASS_WRITE;
+            case 0x000A:
+                return CMD_STATS_CLASS_VERIFY;
+            default:
+                break;
+            }
+        }
+        break;
+    case ATA_PASS_THROUGH_12:
+        if (cdbLength >= 12)
+        {
+            return get_ATA_Command_Stats_Class(cdb[9], UINT8_C(0xFF));
+        }
+        break;
+    case ATA_PASS_THROUGH_16:
+        if (cdbLength >= 16)
+        {
+            // SEND FPDMA subcommand is in bits 12:8 of the count field
+            return get_ATA_Command_Stats_Class(cdb[14], get_bit_range_uint8(cdb[5], 4, 0));
+        }
+        break;
+    default:
+        break;
+    }
+    return CMD_STATS_CLASS_OTHER;
+}
+
+eCommandStatsClass get_NVMe_Command_Stats_Class(bool adminCommand, uint8_t opcode)
+{
+    if (!adminCommand)
+    {
+        switch (opcode)
+        {
+        case NVME_CMD_READ:
+            return CMD_STATS_CLASS_READ;
+        case NVME_CMD_WRITE:
+            return CMD_STATS_CLASS_WRITE;
+        case NVME_CMD_VERIFY:
+            return CMD_STATS_CLASS_VERIFY;
+        case NVME_CMD_FLUSH:
+            return CMD_STATS_CLASS_FLUSH;
+        case NVME_CMD_DATA_SET_MANAGEMENT:
+            return CMD_STATS_CLASS_DEALLOCATE;
+        default:
+            break;
+        }
+    }
+    return CMD_STATS_CLASS_OTHER;
+}
@@ -20,11 +20,14 @@
 #include "memory_safety.h"
 #include "precision_timer.h"
 #include "secure_file.h"
+#include "sort_and_search.h"
 #include "string_utils.h"
 #include "type_conversion.h"
 
+#include "command_capture.h"
 #include "common_public.h"
 #include "csmi_helper_func.h"
+#include "fault_injection.h"
 #include "platform_helper.h"
 #include "vendor/seagate/seagate_common_types.h"
 
@@ -3618,6 +3621,8 @@ OPENSEA_TRANSPORT_API eReturnValues remove_Device(tDevice* M_NONNULL           d
     {
         safe_free(&(deviceList + driveToRemoveIdx)->raid_device);
     }
+    // the entries after this one are copied over it, so anything it allocated must be freed first
+    release_Device_Resources(deviceList + driveToRemoveIdx);
 
     for (i = driveToRemoveIdx; i < *numberOfDevices - UINT32_C(1); i++)
     {
@@ -3628,7 +3633,8 @@ OPENSEA_TRANSPORT_API eReturnValues remove_Device(tDevice* M_NONNULL           d
             }
     }
 
-    M_INITIALIZE_STRUCTURE((deviceList + i), sizeof(tDevice));
+    // the vacated last slot holds the same pointers as the one before it, so nothing may free them twice
+    safe_memset((deviceList + i), sizeof(tDevice), 0, sizeof(tDevice));
     *numberOfDevices -= UINT32_C(1);
     ret = SUCCESS;
 
@@ -7937,3 +7943,79 @@ OPENSEA_TRANSPORT_API int print_tDevice_Data_Buffer(const tDevice* M_NONNULL dev
     }
     return 0;
 }
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API void release_Device_Resources(tDevice* M_NONNULL device)
+{
+    if (device != M_NULLPTR)
+    {
+        safe_free_sat_translator_cache(&device->drive_info.satCache);
+        safe_free_sntl_translator_cache(&device->drive_info.sntlCache);
+        safe_free_command_stats(&device->drive_info.commandStats);
+        safe_free_flight_recorder(&device->drive_info.flightRecorder);
+        stop_Command_Capture_Or_Replay(device);
+        stop_Fault_Injection(device);
+    }
+}
+
+// Used with qsort
+static int cmp_LBA_Range(const void* a, const void* b)
+{
+    const lbaRange* rangeA = M_REINTERPRET_CAST(const lbaRange*, a);
+    const lbaRange* rangeB = M_REINTERPRET_CAST(const lbaRange*, b);
+    if (rangeA->lba < rangeB->lba)
+    {
+        return -1;
+    }
+    else if (rangeA->lba > rangeB->lba)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+// Returns the LBA after the end of the range. Saturates rather than wrapping so that merging stays correct.
+static M_INLINE uint64_t get_LBA_Range_End(const lbaRange* range)
+{
+    if (range->length > UINT64_MAX - range->lba)
+    {
+        return UINT64_MAX;
+    }
+    return range->lba + range->length;
+}
+
+M_PARAM_RW_SIZE(1, 2)
+OPENSEA_TRANSPORT_API uint32_t coalesce_LBA_Ranges(lbaRange* M_NONNULL ranges, uint32_t numberOfRanges)
+{
+    uint32_t merged = UINT32_C(0);
+    bool     sorted = true;
+    if (ranges == M_NULLPTR || numberOfRanges == UINT32_C(0))
+    {
+        return UINT32_C(0);
+    }
+    if (0 != safe_qsort(ranges, numberOfRanges, sizeof(lbaRange), cmp_LBA_Range))
+        M_UNLIKELY
+        {
+            // leave the order as it was. It is still valid, just not optimized. Zero length ranges are still removed.
+            sorted = false;
+        }
+    for (uint32_t rangeIter = UINT32_C(0); rangeIter < numberOfRanges; ++rangeIter)
+    {
+        if (ranges[rangeIter].length == UINT64_C(0))
+        {
+            continue;
+        }
+        if (sorted && merged > UINT32_C(0) && ranges[rangeIter].lba <= get_LBA_Range_End(&ranges[merged - 1]))
+        {
+            // overlaps or touches the previous range, so extend that one instead
+            uint64_t previousEnd = get_LBA_Range_End(&ranges[merged - 1]);
+            uint64_t currentEnd  = get_LBA_Range_End(&ranges[rangeIter]);
+            ranges[merged - 1].length = M_Max(previousEnd, currentEnd) - ranges[merged - 1].lba;
+        }
+        else
+        {
+            ranges[merged] = ranges[rangeIter];
+            ++merged;
+        }
+    }
+    return merged;
+}
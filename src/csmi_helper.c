@@ -4072,6 +4072,7 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_CSMI_RAID_Device(tDevice
 
     if (device != M_NULLPTR)
     {
+        release_Device_Resources(device);
 #    if defined(_WIN32)
         if (CloseHandle(device->os_info.fd))
         {
@@ -5287,6 +5288,9 @@ OPENSEA_TRANSPORT_API eReturnValues get_CSMI_RAID_Device_Count(uint32_t* M_NONNU
                                                 ++phyInfoDrivesFound;
                                             }
                                         }
+                                        // the passthrough may have allocated translator caches and statistics
+                                        release_Device_Resources(&tempDevice);
+                                        safe_free_csmi_dev_info(&tempDevice.os_info.csmiDeviceData);
                                     }
                                 }
                                 else
@@ -6407,6 +6411,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_CSMI_RAID_Device_List(tDevice* M_NONNULL
                                                                                 }
                                                                             }
                                                                         }
+                                                                        release_Device_Resources(&tempDevice);
                                                                         safe_free_csmi_dev_info(
                                                                             &tempDevice.os_info.csmiDeviceData);
                                                                     }
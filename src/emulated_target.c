@@ -0,0 +1,2328 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file emulated_target.c
+// \brief Implements software emulated SAS, SATA, and NVMe targets that plug into a tDevice through its issue_io and
+// issue_nvme_io function pointers
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "secure_file.h"
+#include "sleep.h"
+#include "string_utils.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "cmds.h"
+#include "emulated_target.h"
+#include "nvme_helper.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "sntl_helper.h"
+
+#define EMULATED_STORE_CHUNK_SIZE  UINT64_C(1048576)
+#define EMULATED_ZERO_BUFFER_SIZE  UINT32_C(65536)
+#define EMULATED_ATA_SECTOR_SIZE   UINT32_C(512) // logs and zone reports are in 512B pages regardless of block size
+#define EMULATED_VENDOR_ID         "OPENSEA "    // 8 characters
+#define EMULATED_SAT_VENDOR_ID     "ATA     "    // 8 characters
+#define EMULATED_SCSI_PRODUCT_ID   "EMULATED SAS    " // 16 characters
+#define EMULATED_ATA_MODEL         "EMULATED SATA DISK"
+#define EMULATED_NVME_MODEL        "EMULATED NVME CONTROLLER"
+#define EMULATED_FIRMWARE_REVISION "EMU1.0  " // 8 characters
+#define EMULATED_NVME_SUBNQN       "nqn.2014-08.org.nvmexpress:emulated"
+#define EMULATED_MAX_LOG_PAGE_SIZE UINT32_C(4096)
+#define EMULATED_TEMPERATURE_C     UINT8_C(40)
+#define EMULATED_ROTATION_RATE     UINT16_C(7200)
+
+// Zone types and conditions are the same values in ZBC and ZAC
+#define EMULATED_ZONE_TYPE_CONVENTIONAL  UINT8_C(0x1)
+#define EMULATED_ZONE_TYPE_SEQ_REQUIRED  UINT8_C(0x2)
+#define EMULATED_ZONE_COND_NOT_WP        UINT8_C(0x0)
+#define EMULATED_ZONE_COND_EMPTY         UINT8_C(0x1)
+#define EMULATED_ZONE_COND_IMPLICIT_OPEN UINT8_C(0x2)
+#define EMULATED_ZONE_COND_EXPLICIT_OPEN UINT8_C(0x3)
+#define EMULATED_ZONE_COND_CLOSED        UINT8_C(0x4)
+#define EMULATED_ZONE_COND_FULL          UINT8_C(0xE)
+#define EMULATED_ZONE_DESCRIPTOR_LENGTH  UINT32_C(64) // also the length of the report header
+
+// Zone management out service actions (ZBC) and actions (ZAC) share these values
+#define EMULATED_ZONE_ACTION_CLOSE  UINT8_C(0x01)
+#define EMULATED_ZONE_ACTION_FINISH UINT8_C(0x02)
+#define EMULATED_ZONE_ACTION_OPEN   UINT8_C(0x03)
+#define EMULATED_ZONE_ACTION_RESET  UINT8_C(0x04)
+
+#define EMULATED_ATA_STATUS_GOOD  UINT8_C(0x50) // DRDY and DSC/DWF
+#define EMULATED_ATA_STATUS_ERROR UINT8_C(0x51)
+#define EMULATED_ATA_ERROR_ABRT   UINT8_C(0x04)
+#define EMULATED_ATA_ERROR_IDNF   UINT8_C(0x10)
+#define EMULATED_ATA_ERROR_UNC    UINT8_C(0x40)
+
+// Result of emulating a command, independent of how it is reported on each interface.
+typedef enum eEmulatedStatusEnum
+{
+    EMULATED_STATUS_GOOD,
+    EMULATED_STATUS_INVALID_OPCODE,
+    EMULATED_STATUS_INVALID_FIELD,
+    EMULATED_STATUS_INVALID_PARAMETER, // in the data sent with the command
+    EMULATED_STATUS_LBA_OUT_OF_RANGE,
+    EMULATED_STATUS_UNALIGNED_WRITE,     // write to a sequential zone not at its write pointer
+    EMULATED_STATUS_WRITE_BOUNDARY,      // write crosses the end of a sequential zone
+    EMULATED_STATUS_MISCOMPARE,          // verify with data did not match
+    EMULATED_STATUS_READ_ERROR,          // the backing store could not be read
+    EMULATED_STATUS_WRITE_ERROR,         // the backing store could not be written
+} eEmulatedStatus;
+
+typedef enum eEmulatedLatencyEnum
+{
+    EMULATED_LATENCY_READ,
+    EMULATED_LATENCY_WRITE,
+    EMULATED_LATENCY_OTHER,
+} eEmulatedLatency;
+
+typedef struct s_emulatedZone
+{
+    uint64_t start;
+    uint64_t writePointer;
+    uint8_t  type;
+    uint8_t  condition;
+} emulatedZone;
+
+typedef struct s_emulatedTarget
+{
+    eEmulatedTargetType type;
+    uint32_t            logicalBlockSize;
+    uint64_t            capacity; // logical blocks per namespace
+    uint32_t            namespaceCount;
+    uint64_t            latencyNS[3]; // indexed by eEmulatedLatency
+    uint64_t            mediaSize;    // bytes, all namespaces
+    uint8_t**           chunks;       // memory backing. NULL chunks have never been written
+    uint64_t            chunkCount;
+    secureFileInfo*     backingFile; // sparse file backing
+    uint64_t            zoneSize;
+    uint32_t            zoneCount; // 0 when not zoned
+    emulatedZone*       zones;
+    uint64_t            wwn;
+    char                serialNumber[SERIAL_NUM_LEN + 1];
+    bool                writeCacheEnabled;
+    seatimer            powerOnTimer;
+    uint64_t            blocksRead;
+    uint64_t            blocksWritten;
+    uint64_t            readCommands;
+    uint64_t            writeCommands;
+    uint64_t            commandsCompleted;
+    uint64_t            totalCommandTimeNS;
+    uint8_t             ataIdentify[512]; // SATA only
+} emulatedTarget;
+
+static M_INLINE emulatedTarget* get_Emulated_Target(const tDevice* device)
+{
+    return M_REINTERPRET_CAST(emulatedTarget*, device->raid_device);
+}
+
+// Stores the low length bytes of value at ptr. SCSI fields are big endian, ATA and NVMe fields are little endian.
+static void set_Emulated_Field(uint8_t* ptr, uint64_t value, uint8_t length, bool bigEndian)
+{
+    for (uint8_t iter = UINT8_C(0); iter < length; ++iter)
+    {
+        uint8_t byteValue = M_STATIC_CAST(uint8_t, value >> (8 * iter));
+        if (bigEndian)
+        {
+            ptr[length - 1 - iter] = byteValue;
+        }
+        else
+        {
+            ptr[iter] = byteValue;
+        }
+    }
+}
+
+static uint64_t get_Emulated_Field(const uint8_t* ptr, uint8_t length, bool bigEndian)
+{
+    uint64_t value = UINT64_C(0);
+    for (uint8_t iter = UINT8_C(0); iter < length; ++iter)
+    {
+        value <<= 8;
+        value |= bigEndian ? ptr[iter] : ptr[length - 1 - iter];
+    }
+    return value;
+}
+
+// Copies a string padded with spaces. ATA strings swap each pair of characters.
+static void set_Emulated_String(uint8_t* ptr, const char* string, size_t fieldLength, bool ataString)
+{
+    size_t stringLength = safe_strlen(string);
+    for (size_t iter = SIZE_T_C(0); iter < fieldLength; ++iter)
+    {
+        size_t destination = ataString ? (iter ^ SIZE_T_C(1)) : iter;
+        ptr[destination]   = M_STATIC_CAST(uint8_t, iter < stringLength ? string[iter] : ' ');
+    }
+}
+
+//
+// Backing store
+//
+
+static eEmulatedStatus read_Emulated_Media(emulatedTarget* target, uint64_t offset, uint8_t* buffer, uint64_t length)
+{
+    if (target->backingFile != M_NULLPTR)
+    {
+        size_t bytesRead = SIZE_T_C(0);
+        if (SEC_FILE_SUCCESS != secure_Seek_File(target->backingFile, C_CAST(int64_t, offset), SEEK_SET) ||
+            SEC_FILE_SUCCESS != secure_Read_File(target->backingFile, buffer, C_CAST(size_t, length), sizeof(uint8_t),
+                                                 C_CAST(size_t, length), &bytesRead) ||
+            bytesRead != length)
+        {
+            return EMULATED_STATUS_READ_ERROR;
+        }
+        return EMULATED_STATUS_GOOD;
+    }
+    while (length > UINT64_C(0))
+    {
+        uint64_t chunk       = offset / EMULATED_STORE_CHUNK_SIZE;
+        uint64_t chunkOffset = offset % EMULATED_STORE_CHUNK_SIZE;
+        size_t   bytes       = C_CAST(size_t, M_Min(length, EMULATED_STORE_CHUNK_SIZE - chunkOffset));
+        if (target->chunks[chunk] == M_NULLPTR)
+        {
+            safe_memset(buffer, bytes, 0, bytes);
+        }
+        else
+        {
+            safe_memcpy(buffer, bytes, target->chunks[chunk] + chunkOffset, bytes);
+        }
+        buffer += bytes;
+        offset += bytes;
+        length -= bytes;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus write_Emulated_Media(emulatedTarget* target,
+                                            uint64_t        offset,
+                                            const uint8_t*  buffer,
+                                            uint64_t        length)
+{
+    if (target->backingFile != M_NULLPTR)
+    {
+        size_t bytesWritten = SIZE_T_C(0);
+        if (SEC_FILE_SUCCESS != secure_Seek_File(target->backingFile, C_CAST(int64_t, offset), SEEK_SET) ||
+            SEC_FILE_SUCCESS != secure_Write_File(target->backingFile, buffer, C_CAST(size_t, length),
+                                                  sizeof(uint8_t), C_CAST(size_t, length), &bytesWritten) ||
+            bytesWritten != length)
+        {
+            return EMULATED_STATUS_WRITE_ERROR;
+        }
+        return EMULATED_STATUS_GOOD;
+    }
+    while (length > UINT64_C(0))
+    {
+        uint64_t chunk       = offset / EMULATED_STORE_CHUNK_SIZE;
+        uint64_t chunkOffset = offset % EMULATED_STORE_CHUNK_SIZE;
+        size_t   bytes       = C_CAST(size_t, M_Min(length, EMULATED_STORE_CHUNK_SIZE - chunkOffset));
+        if (target->chunks[chunk] == M_NULLPTR)
+        {
+            target->chunks[chunk] =
+                M_REINTERPRET_CAST(uint8_t*, safe_calloc(C_CAST(size_t, EMULATED_STORE_CHUNK_SIZE), sizeof(uint8_t)));
+            if (target->chunks[chunk] == M_NULLPTR)
+            {
+                return EMULATED_STATUS_WRITE_ERROR;
+            }
+        }
+        safe_memcpy(target->chunks[chunk] + chunkOffset, C_CAST(size_t, EMULATED_STORE_CHUNK_SIZE - chunkOffset),
+                    buffer, bytes);
+        buffer += bytes;
+        offset += bytes;
+        length -= bytes;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+// Used for deallocation and zone resets. Whole chunks are freed so memory use goes back down.
+static eEmulatedStatus zero_Emulated_Media(emulatedTarget* target, uint64_t offset, uint64_t length)
+{
+    if (target->backingFile != M_NULLPTR)
+    {
+        eEmulatedStatus status     = EMULATED_STATUS_GOOD;
+        uint8_t*        zeroBuffer =
+            M_REINTERPRET_CAST(uint8_t*, safe_calloc(EMULATED_ZERO_BUFFER_SIZE, sizeof(uint8_t)));
+        if (zeroBuffer == M_NULLPTR)
+        {
+            return EMULATED_STATUS_WRITE_ERROR;
+        }
+        while (length > UINT64_C(0) && status == EMULATED_STATUS_GOOD)
+        {
+            uint64_t bytes = M_Min(length, C_CAST(uint64_t, EMULATED_ZERO_BUFFER_SIZE));
+            status         = write_Emulated_Media(target, offset, zeroBuffer, bytes);
+            offset += bytes;
+            length -= bytes;
+        }
+        safe_free(&zeroBuffer);
+        return status;
+    }
+    while (length > UINT64_C(0))
+    {
+        uint64_t chunk       = offset / EMULATED_STORE_CHUNK_SIZE;
+        uint64_t chunkOffset = offset % EMULATED_STORE_CHUNK_SIZE;
+        uint64_t bytes       = M_Min(length, EMULATED_STORE_CHUNK_SIZE - chunkOffset);
+        if (bytes == EMULATED_STORE_CHUNK_SIZE)
+        {
+            safe_free(&target->chunks[chunk]);
+        }
+        else if (target->chunks[chunk] != M_NULLPTR)
+        {
+            safe_memset(target->chunks[chunk] + chunkOffset, C_CAST(size_t, EMULATED_STORE_CHUNK_SIZE - chunkOffset),
+                        0, C_CAST(size_t, bytes));
+        }
+        offset += bytes;
+        length -= bytes;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus flush_Emulated_Media(emulatedTarget* target)
+{
+    if (target->backingFile != M_NULLPTR && SEC_FILE_SUCCESS != secure_Flush_File(target->backingFile))
+    {
+        return EMULATED_STATUS_WRITE_ERROR;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+//
+// Logical blocks and zones
+//
+
+static M_INLINE bool is_Emulated_Target_Zoned(const emulatedTarget* target)
+{
+    return target->zoneCount > UINT32_C(0);
+}
+
+static M_INLINE uint64_t get_Emulated_Namespace_Offset(const emulatedTarget* target, uint32_t namespaceIndex)
+{
+    return C_CAST(uint64_t, namespaceIndex) * target->capacity * target->logicalBlockSize;
+}
+
+static eEmulatedStatus check_Emulated_LBA_Range(const emulatedTarget* target, uint64_t lba, uint64_t count)
+{
+    if (lba > target->capacity || count > target->capacity - lba)
+    {
+        return EMULATED_STATUS_LBA_OUT_OF_RANGE;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+// Blocks in a sequential write required zone at or after the write pointer read as zeros.
+static eEmulatedStatus read_Emulated_Blocks(emulatedTarget* target,
+                                           uint32_t        namespaceIndex,
+                                           uint64_t        lba,
+                                           uint64_t        count,
+                                           uint8_t*        buffer)
+{
+    uint64_t        offset     = get_Emulated_Namespace_Offset(target, namespaceIndex);
+    uint64_t        totalCount = count;
+    eEmulatedStatus status     = EMULATED_STATUS_GOOD;
+    if (!is_Emulated_Target_Zoned(target))
+    {
+        status = read_Emulated_Media(target, offset + (lba * target->logicalBlockSize), buffer,
+                                     count * target->logicalBlockSize);
+    }
+    while (is_Emulated_Target_Zoned(target) && count > UINT64_C(0) && status == EMULATED_STATUS_GOOD)
+    {
+        const emulatedZone* zone     = &target->zones[lba / target->zoneSize];
+        uint64_t            blocks   = M_Min(count, zone->start + target->zoneSize - lba);
+        uint64_t            readable = blocks;
+        if (zone->type == EMULATED_ZONE_TYPE_SEQ_REQUIRED)
+        {
+            readable = zone->writePointer > lba ? M_Min(blocks, zone->writePointer - lba) : UINT64_C(0);
+        }
+        if (readable > UINT64_C(0))
+        {
+            status = read_Emulated_Media(target, offset + (lba * target->logicalBlockSize), buffer,
+                                         readable * target->logicalBlockSize);
+        }
+        if (blocks > readable)
+        {
+            size_t zeroLength = C_CAST(size_t, (blocks - readable) * target->logicalBlockSize);
+            safe_memset(buffer + (readable * target->logicalBlockSize), zeroLength, 0, zeroLength);
+        }
+        buffer += blocks * target->logicalBlockSize;
+        lba += blocks;
+        count -= blocks;
+    }
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        target->blocksRead += totalCount;
+    }
+    return status;
+}
+
+static eEmulatedStatus check_Emulated_Zoned_Write(const emulatedTarget* target, uint64_t lba, uint64_t count)
+{
+    const emulatedZone* zone = M_NULLPTR;
+    if (!is_Emulated_Target_Zoned(target) || count == UINT64_C(0))
+    {
+        return EMULATED_STATUS_GOOD;
+    }
+    zone = &target->zones[lba / target->zoneSize];
+    if (zone->type == EMULATED_ZONE_TYPE_SEQ_REQUIRED)
+    {
+        if (lba != zone->writePointer)
+        {
+            return EMULATED_STATUS_UNALIGNED_WRITE;
+        }
+        if (count > zone->start + target->zoneSize - lba)
+        {
+            return EMULATED_STATUS_WRITE_BOUNDARY;
+        }
+    }
+    else if (target->zones[(lba + count - 1) / target->zoneSize].type != EMULATED_ZONE_TYPE_CONVENTIONAL)
+    {
+        return EMULATED_STATUS_WRITE_BOUNDARY;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus write_Emulated_Blocks(emulatedTarget* target,
+                                            uint32_t        namespaceIndex,
+                                            uint64_t        lba,
+                                            uint64_t        count,
+                                            const uint8_t*  buffer)
+{
+    eEmulatedStatus status = check_Emulated_Zoned_Write(target, lba, count);
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        status = write_Emulated_Media(target,
+                                      get_Emulated_Namespace_Offset(target, namespaceIndex) +
+                                          (lba * target->logicalBlockSize),
+                                      buffer, count * target->logicalBlockSize);
+    }
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        target->blocksWritten += count;
+        if (is_Emulated_Target_Zoned(target) && count > UINT64_C(0))
+        {
+            emulatedZone* zone = &target->zones[lba / target->zoneSize];
+            if (zone->type == EMULATED_ZONE_TYPE_SEQ_REQUIRED)
+            {
+                zone->writePointer += count;
+                if (zone->writePointer == zone->start + target->zoneSize)
+                {
+                    zone->condition = EMULATED_ZONE_COND_FULL;
+                }
+                else if (zone->condition != EMULATED_ZONE_COND_EXPLICIT_OPEN)
+                {
+                    zone->condition = EMULATED_ZONE_COND_IMPLICIT_OPEN;
+                }
+            }
+        }
+    }
+    return status;
+}
+
+static eEmulatedStatus compare_Emulated_Blocks(emulatedTarget* target,
+                                              uint32_t        namespaceIndex,
+                                              uint64_t        lba,
+                                              uint64_t        count,
+                                              const uint8_t*  expected)
+{
+    eEmulatedStatus status = EMULATED_STATUS_GOOD;
+    uint8_t*        media  = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc(C_CAST(size_t, count * target->logicalBlockSize), sizeof(uint8_t)));
+    if (media == M_NULLPTR)
+    {
+        return EMULATED_STATUS_READ_ERROR;
+    }
+    status = read_Emulated_Blocks(target, namespaceIndex, lba, count, media);
+    if (status == EMULATED_STATUS_GOOD &&
+        memcmp(media, expected, C_CAST(size_t, count * target->logicalBlockSize)) != 0)
+    {
+        status = EMULATED_STATUS_MISCOMPARE;
+    }
+    safe_free(&media);
+    return status;
+}
+
+static eEmulatedStatus deallocate_Emulated_Blocks(emulatedTarget* target,
+                                                 uint32_t        namespaceIndex,
+                                                 uint64_t        lba,
+                                                 uint64_t        count)
+{
+    eEmulatedStatus status = check_Emulated_LBA_Range(target, lba, count);
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        status = zero_Emulated_Media(target,
+                                     get_Emulated_Namespace_Offset(target, namespaceIndex) +
+                                         (lba * target->logicalBlockSize),
+                                     count * target->logicalBlockSize);
+    }
+    return status;
+}
+
+static eEmulatedStatus apply_Emulated_Zone_Action(emulatedTarget* target, emulatedZone* zone, uint8_t action, bool all)
+{
+    switch (action)
+    {
+    case EMULATED_ZONE_ACTION_CLOSE:
+        if (zone->condition == EMULATED_ZONE_COND_IMPLICIT_OPEN || zone->condition == EMULATED_ZONE_COND_EXPLICIT_OPEN)
+        {
+            zone->condition =
+                zone->writePointer == zone->start ? EMULATED_ZONE_COND_EMPTY : EMULATED_ZONE_COND_CLOSED;
+        }
+        break;
+    case EMULATED_ZONE_ACTION_FINISH:
+        if (!all || zone->condition != EMULATED_ZONE_COND_EMPTY)
+        {
+            zone->writePointer = zone->start + target->zoneSize;
+            zone->condition    = EMULATED_ZONE_COND_FULL;
+        }
+        break;
+    case EMULATED_ZONE_ACTION_OPEN:
+        // open all only opens closed zones. Opening a full zone has no effect.
+        if ((all && zone->condition == EMULATED_ZONE_COND_CLOSED) ||
+            (!all && zone->condition != EMULATED_ZONE_COND_FULL))
+        {
+            zone->condition = EMULATED_ZONE_COND_EXPLICIT_OPEN;
+        }
+        break;
+    case EMULATED_ZONE_ACTION_RESET:
+        if (zone->writePointer != zone->start)
+        {
+            eEmulatedStatus status = deallocate_Emulated_Blocks(target, 0, zone->start, target->zoneSize);
+            if (status != EMULATED_STATUS_GOOD)
+            {
+                return status;
+            }
+        }
+        zone->writePointer = zone->start;
+        zone->condition    = EMULATED_ZONE_COND_EMPTY;
+        break;
+    default:
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulated_Zone_Action(emulatedTarget* target, uint8_t action, uint64_t zoneID, bool all)
+{
+    eEmulatedStatus status = EMULATED_STATUS_GOOD;
+    if (all)
+    {
+        for (uint32_t iter = UINT32_C(0); iter < target->zoneCount && status == EMULATED_STATUS_GOOD; ++iter)
+        {
+            if (target->zones[iter].type == EMULATED_ZONE_TYPE_SEQ_REQUIRED)
+            {
+                status = apply_Emulated_Zone_Action(target, &target->zones[iter], action, true);
+            }
+        }
+        return status;
+    }
+    if (zoneID >= target->capacity || (zoneID % target->zoneSize) != UINT64_C(0) ||
+        target->zones[zoneID / target->zoneSize].type != EMULATED_ZONE_TYPE_SEQ_REQUIRED)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    return apply_Emulated_Zone_Action(target, &target->zones[zoneID / target->zoneSize], action, false);
+}
+
+static bool is_Valid_Emulated_Zone_Reporting_Option(uint8_t reportingOptions)
+{
+    switch (reportingOptions)
+    {
+    case 0x00: // all
+    case 0x01: // empty
+    case 0x02: // implicitly open
+    case 0x03: // explicitly open
+    case 0x04: // closed
+    case 0x05: // full
+    case 0x06: // read only
+    case 0x07: // offline
+    case 0x10: // reset write pointer recommended
+    case 0x11: // non-sequential write resources active
+    case 0x3F: // not write pointer
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool does_Emulated_Zone_Match(const emulatedZone* zone, uint8_t reportingOptions)
+{
+    switch (reportingOptions)
+    {
+    case 0x00:
+        return true;
+    case 0x01:
+        return zone->condition == EMULATED_ZONE_COND_EMPTY;
+    case 0x02:
+        return zone->condition == EMULATED_ZONE_COND_IMPLICIT_OPEN;
+    case 0x03:
+        return zone->condition == EMULATED_ZONE_COND_EXPLICIT_OPEN;
+    case 0x04:
+        return zone->condition == EMULATED_ZONE_COND_CLOSED;
+    case 0x05:
+        return zone->condition == EMULATED_ZONE_COND_FULL;
+    case 0x3F:
+        return zone->condition == EMULATED_ZONE_COND_NOT_WP;
+    default:
+        return false;
+    }
+}
+
+// Builds a REPORT ZONES response. ZBC is big endian, ZAC is little endian, otherwise they are the same.
+static void fill_Emulated_Zone_Report(const emulatedTarget* target,
+                                      uint64_t              zoneLocator,
+                                      uint8_t               reportingOptions,
+                                      bool                  partial,
+                                      bool                  bigEndian,
+                                      uint8_t*              buffer,
+                                      uint32_t              bufferLength)
+{
+    uint32_t descriptorsThatFit = UINT32_C(0);
+    uint32_t matchingZones      = UINT32_C(0);
+    uint32_t offset             = EMULATED_ZONE_DESCRIPTOR_LENGTH;
+    safe_memset(buffer, bufferLength, 0, bufferLength);
+    if (bufferLength >= EMULATED_ZONE_DESCRIPTOR_LENGTH)
+    {
+        descriptorsThatFit = (bufferLength - EMULATED_ZONE_DESCRIPTOR_LENGTH) / EMULATED_ZONE_DESCRIPTOR_LENGTH;
+    }
+    for (uint32_t iter = C_CAST(uint32_t, zoneLocator / target->zoneSize); iter < target->zoneCount; ++iter)
+    {
+        const emulatedZone* zone = &target->zones[iter];
+        if (!does_Emulated_Zone_Match(zone, reportingOptions))
+        {
+            continue;
+        }
+        if (matchingZones < descriptorsThatFit)
+        {
+            buffer[offset]     = zone->type;
+            buffer[offset + 1] = M_STATIC_CAST(uint8_t, zone->condition << 4);
+            set_Emulated_Field(&buffer[offset + 8], target->zoneSize, 8, bigEndian);
+            set_Emulated_Field(&buffer[offset + 16], zone->start, 8, bigEndian);
+            set_Emulated_Field(&buffer[offset + 24],
+                               zone->type == EMULATED_ZONE_TYPE_CONVENTIONAL ? UINT64_MAX : zone->writePointer, 8,
+                               bigEndian);
+            offset += EMULATED_ZONE_DESCRIPTOR_LENGTH;
+        }
+        else if (partial)
+        {
+            break;
+        }
+        ++matchingZones;
+    }
+    if (bufferLength >= 16)
+    {
+        set_Emulated_Field(&buffer[0], C_CAST(uint64_t, matchingZones) * EMULATED_ZONE_DESCRIPTOR_LENGTH, 4, bigEndian);
+        // SAME field is 0: zone types and lengths may differ between zones
+        set_Emulated_Field(&buffer[8], target->capacity - 1, 8, bigEndian);
+    }
+}
+
+//
+// SCSI
+//
+
+static void set_Emulated_Sense_Data(ScsiIoCtx* scsiIoCtx,
+                                    uint8_t    senseKey,
+                                    uint8_t    asc,
+                                    uint8_t    ascq,
+                                    bool       descriptorFormat,
+                                    const uint8_t* ataStatusReturnDescriptor)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, SPC3_SENSE_LEN);
+    if (descriptorFormat)
+    {
+        senseData[0] = SCSI_SENSE_CUR_INFO_DESC;
+        senseData[1] = M_Nibble0(senseKey);
+        senseData[2] = asc;
+        senseData[3] = ascq;
+        if (ataStatusReturnDescriptor != M_NULLPTR)
+        {
+            safe_memcpy(&senseData[8], SPC3_SENSE_LEN - 8, ataStatusReturnDescriptor, 14);
+            senseData[7] = 14;
+        }
+    }
+    else
+    {
+        senseData[0]  = SCSI_SENSE_CUR_INFO_FIXED;
+        senseData[2]  = M_Nibble0(senseKey);
+        senseData[7]  = 10;
+        senseData[12] = asc;
+        senseData[13] = ascq;
+    }
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+    {
+        safe_memcpy(scsiIoCtx->psense, scsiIoCtx->senseDataSize, senseData,
+                    M_Min(scsiIoCtx->senseDataSize, SPC3_SENSE_LEN));
+    }
+    safe_memcpy(scsiIoCtx->device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN, senseData, SPC3_SENSE_LEN);
+    scsiIoCtx->returnStatus.format   = senseData[0];
+    scsiIoCtx->returnStatus.senseKey = senseKey;
+    scsiIoCtx->returnStatus.asc      = asc;
+    scsiIoCtx->returnStatus.ascq     = ascq;
+    scsiIoCtx->returnStatus.fru      = 0;
+}
+
+static void set_Emulated_SCSI_Status(ScsiIoCtx* scsiIoCtx, eEmulatedStatus status)
+{
+    switch (status)
+    {
+    case EMULATED_STATUS_GOOD:
+        if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+        {
+            safe_memset(scsiIoCtx->psense, scsiIoCtx->senseDataSize, 0, scsiIoCtx->senseDataSize);
+        }
+        scsiIoCtx->returnStatus.format   = 0xFF;
+        scsiIoCtx->returnStatus.senseKey = 0;
+        scsiIoCtx->returnStatus.asc      = 0;
+        scsiIoCtx->returnStatus.ascq     = 0;
+        break;
+    case EMULATED_STATUS_INVALID_OPCODE:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x20, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_INVALID_FIELD:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x24, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_INVALID_PARAMETER:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_LBA_OUT_OF_RANGE:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x21, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_UNALIGNED_WRITE:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x21, 0x04, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_WRITE_BOUNDARY:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x21, 0x05, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_MISCOMPARE:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_MISCOMPARE, 0x1D, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_READ_ERROR:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_MEDIUM_ERROR, 0x11, 0x00, false, M_NULLPTR);
+        break;
+    case EMULATED_STATUS_WRITE_ERROR:
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_MEDIUM_ERROR, 0x0C, 0x00, false, M_NULLPTR);
+        break;
+    }
+}
+
+// Returns up to allocationLength bytes of a response built in a local buffer.
+static void return_Emulated_SCSI_Data(ScsiIoCtx* scsiIoCtx,
+                                      const uint8_t* data,
+                                      uint32_t       dataLength,
+                                      uint32_t       allocationLength)
+{
+    uint32_t length = M_Min(M_Min(dataLength, allocationLength), scsiIoCtx->dataLength);
+    if (scsiIoCtx->pdata != M_NULLPTR && length > UINT32_C(0))
+    {
+        safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, data, length);
+    }
+}
+
+static M_INLINE uint8_t get_Emulated_Peripheral_Device_Type(const emulatedTarget* target)
+{
+    return is_Emulated_Target_Zoned(target) ? PERIPHERAL_HOST_MANAGED_ZONED_BLOCK_DEVICE
+                                            : PERIPHERAL_DIRECT_ACCESS_BLOCK_DEVICE;
+}
+
+static uint32_t fill_Emulated_Standard_Inquiry(const emulatedTarget* target, uint8_t* data)
+{
+    data[0] = get_Emulated_Peripheral_Device_Type(target);
+    data[2] = 0x06; // SPC-4
+    data[3] = 0x02; // response data format
+    data[4] = 96 - 5;
+    data[7] = BIT1; // CMDQUE
+    if (target->type == EMULATED_TARGET_SATA_DISK)
+    {
+        set_Emulated_String(&data[8], EMULATED_SAT_VENDOR_ID, 8, false);
+        set_Emulated_String(&data[16], EMULATED_ATA_MODEL, 16, false);
+    }
+    else
+    {
+        set_Emulated_String(&data[8], EMULATED_VENDOR_ID, 8, false);
+        set_Emulated_String(&data[16], EMULATED_SCSI_PRODUCT_ID, 16, false);
+    }
+    set_Emulated_String(&data[32], EMULATED_FIRMWARE_REVISION, 4, false);
+    return 96;
+}
+
+static eEmulatedStatus fill_Emulated_VPD_Page(const emulatedTarget* target,
+                                              uint8_t               pageCode,
+                                              uint8_t*              data,
+                                              uint32_t*             length)
+{
+    data[0] = get_Emulated_Peripheral_Device_Type(target);
+    data[1] = pageCode;
+    switch (pageCode)
+    {
+    case SUPPORTED_VPD_PAGES:
+    {
+        uint16_t pages = UINT16_C(4);
+        data[pages++]  = SUPPORTED_VPD_PAGES;
+        data[pages++]  = UNIT_SERIAL_NUMBER;
+        data[pages++]  = DEVICE_IDENTIFICATION;
+        if (target->type == EMULATED_TARGET_SATA_DISK)
+        {
+            data[pages++] = ATA_INFORMATION;
+        }
+        data[pages++] = BLOCK_LIMITS;
+        data[pages++] = BLOCK_DEVICE_CHARACTERISTICS;
+        if (is_Emulated_Target_Zoned(target))
+        {
+            data[pages++] = ZONED_BLOCK_DEVICE_CHARACTERISTICS;
+        }
+        else
+        {
+            data[pages++] = LOGICAL_BLOCK_PROVISIONING;
+        }
+        data[3] = M_STATIC_CAST(uint8_t, pages - 4);
+        *length = pages;
+        break;
+    }
+    case UNIT_SERIAL_NUMBER:
+        data[3] = SERIAL_NUM_LEN;
+        set_Emulated_String(&data[4], target->serialNumber, SERIAL_NUM_LEN, false);
+        *length = 4 + SERIAL_NUM_LEN;
+        break;
+    case DEVICE_IDENTIFICATION:
+        // one NAA designator for the logical unit
+        data[3] = 12;
+        data[4] = 0x01; // binary
+        data[5] = 0x03; // NAA, associated with the logical unit
+        data[7] = 8;
+        set_Emulated_Field(&data[8], target->wwn, 8, true);
+        *length = 16;
+        break;
+    case ATA_INFORMATION:
+        if (target->type != EMULATED_TARGET_SATA_DISK)
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        set_Emulated_Field(&data[2], 0x238, 2, true);
+        set_Emulated_String(&data[8], EMULATED_VENDOR_ID, 8, false);
+        set_Emulated_String(&data[16], "SOFTWARE SATL   ", 16, false);
+        set_Emulated_String(&data[32], EMULATED_FIRMWARE_REVISION, 4, false);
+        // device signature from the register device to host FIS
+        data[36] = 0x34;
+        data[38] = EMULATED_ATA_STATUS_GOOD;
+        data[39] = 0x01;
+        data[40] = 0x01;
+        data[41] = is_Emulated_Target_Zoned(target) ? 0xCD : 0x00;
+        data[42] = is_Emulated_Target_Zoned(target) ? 0xAB : 0x00;
+        data[48] = 0x01;
+        data[56] = ATA_IDENTIFY;
+        safe_memcpy(&data[60], 512, target->ataIdentify, 512);
+        *length = 572;
+        break;
+    case BLOCK_LIMITS:
+        data[3] = 0x3C;
+        set_Emulated_Field(&data[8], EMULATED_TARGET_MAX_TRANSFER_SIZE / target->logicalBlockSize, 4, true);
+        set_Emulated_Field(&data[12], EMULATED_TARGET_MAX_TRANSFER_SIZE / target->logicalBlockSize, 4, true);
+        if (!is_Emulated_Target_Zoned(target))
+        {
+            set_Emulated_Field(&data[20], UINT32_MAX, 4, true); // maximum unmap LBA count
+            set_Emulated_Field(&data[24], 256, 4, true);        // maximum unmap block descriptor count
+        }
+        *length = 64;
+        break;
+    case BLOCK_DEVICE_CHARACTERISTICS:
+        data[3] = 0x3C;
+        set_Emulated_Field(&data[4], EMULATED_ROTATION_RATE, 2, true);
+        data[7] = 0x02; // 3.5"
+        *length = 64;
+        break;
+    case LOGICAL_BLOCK_PROVISIONING:
+        if (is_Emulated_Target_Zoned(target))
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        data[3] = 0x04;
+        data[5] = BIT7 | BIT2; // LBPU, LBPRZ
+        data[6] = 0x02;        // thin provisioned
+        *length = 8;
+        break;
+    case ZONED_BLOCK_DEVICE_CHARACTERISTICS:
+        if (!is_Emulated_Target_Zoned(target))
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        data[3] = 0x3C;
+        data[4] = BIT0; // URSWRZ: reads after the write pointer return zeros
+        set_Emulated_Field(&data[16], UINT32_MAX, 4, true); // no limit on open sequential write required zones
+        *length = 64;
+        break;
+    default:
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static uint32_t fill_Emulated_Mode_Pages(const emulatedTarget* target, uint8_t pageCode, bool changeable, uint8_t* data)
+{
+    uint32_t length = UINT32_C(0);
+    if (pageCode == MP_CACHING || pageCode == MP_RETURN_ALL_PAGES)
+    {
+        data[length]     = MP_CACHING;
+        data[length + 1] = 0x12;
+        if (changeable || target->writeCacheEnabled)
+        {
+            data[length + 2] = BIT2; // WCE
+        }
+        length += 20;
+    }
+    if (pageCode == MP_CONTROL || pageCode == MP_RETURN_ALL_PAGES)
+    {
+        data[length]     = MP_CONTROL;
+        data[length + 1] = 0x0A;
+        length += 12;
+    }
+    return length;
+}
+
+static eEmulatedStatus emulate_Mode_Sense(const emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, modeData, 128);
+    bool     sixByte          = scsiIoCtx->cdb[OPERATION_CODE] == MODE_SENSE_6_CMD;
+    bool     blockDescriptor  = (scsiIoCtx->cdb[1] & BIT3) == 0; // DBD
+    uint8_t  pageControl      = get_bit_range_uint8(scsiIoCtx->cdb[2], 7, 6);
+    uint8_t  pageCode         = get_bit_range_uint8(scsiIoCtx->cdb[2], 5, 0);
+    uint8_t  subpage          = scsiIoCtx->cdb[3];
+    uint32_t headerLength     = sixByte ? MODE_PARAMETER_HEADER_6_LEN : MODE_PARAMETER_HEADER_10_LEN;
+    uint32_t length           = headerLength;
+    uint32_t allocationLength =
+        sixByte ? scsiIoCtx->cdb[4] : C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[7], 2, true));
+    uint32_t pagesLength      = UINT32_C(0);
+    if (pageControl == 0x03)
+    {
+        set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ILLEGAL_REQUEST, 0x39, 0x00, false, M_NULLPTR);
+        return EMULATED_STATUS_GOOD; // saving parameters not supported. Sense data already set.
+    }
+    if (!(subpage == 0 || (subpage == MP_SP_ALL_SUBPAGES && pageCode == MP_RETURN_ALL_PAGES)))
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    if (blockDescriptor)
+    {
+        uint8_t* descriptor = &modeData[headerLength];
+        set_Emulated_Field(&descriptor[0], M_Min(target->capacity, UINT32_MAX), 4, true);
+        set_Emulated_Field(&descriptor[5], target->logicalBlockSize, 3, true);
+        length += SHORT_LBA_BLOCK_DESCRIPTOR_LEN;
+    }
+    pagesLength = fill_Emulated_Mode_Pages(target, pageCode, pageControl == 0x01, &modeData[length]);
+    if (pagesLength == 0)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    length += pagesLength;
+    if (sixByte)
+    {
+        modeData[0] = M_STATIC_CAST(uint8_t, length - 1);
+        modeData[2] = BIT4; // DPOFUA
+        modeData[3] = blockDescriptor ? SHORT_LBA_BLOCK_DESCRIPTOR_LEN : 0;
+    }
+    else
+    {
+        set_Emulated_Field(&modeData[0], length - 2, 2, true);
+        modeData[3] = BIT4; // DPOFUA
+        modeData[7] = blockDescriptor ? SHORT_LBA_BLOCK_DESCRIPTOR_LEN : 0;
+    }
+    return_Emulated_SCSI_Data(scsiIoCtx, modeData, length, allocationLength);
+    set_Emulated_SCSI_Status(scsiIoCtx, EMULATED_STATUS_GOOD);
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_Log_Sense(ScsiIoCtx* scsiIoCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, logData, 32);
+    uint8_t  pageCode         = get_bit_range_uint8(scsiIoCtx->cdb[2], 5, 0);
+    uint32_t allocationLength = C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[7], 2, true));
+    uint32_t length           = UINT32_C(4);
+    if (scsiIoCtx->cdb[3] != 0)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    logData[0] = pageCode;
+    switch (pageCode)
+    {
+    case LP_SUPPORTED_LOG_PAGES:
+        logData[length++] = LP_SUPPORTED_LOG_PAGES;
+        logData[length++] = LP_TEMPERATURE;
+        break;
+    case LP_TEMPERATURE:
+        // temperature, then reference temperature parameter
+        logData[length + 2] = 0x03;
+        logData[length + 3] = 2;
+        logData[length + 5] = EMULATED_TEMPERATURE_C;
+        length += 6;
+        logData[length + 1] = 0x01;
+        logData[length + 2] = 0x03;
+        logData[length + 3] = 2;
+        logData[length + 5] = 65;
+        length += 6;
+        break;
+    default:
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    set_Emulated_Field(&logData[2], length - 4, 2, true);
+    return_Emulated_SCSI_Data(scsiIoCtx, logData, length, allocationLength);
+    return EMULATED_STATUS_GOOD;
+}
+
+static bool get_Emulated_CDB_LBA_Range(const uint8_t* cdb, uint64_t* lba, uint64_t* count)
+{
+    switch (cdb[OPERATION_CODE])
+    {
+    case READ6:
+    case WRITE6:
+        *lba   = get_Emulated_Field(&cdb[1], 3, true) & UINT64_C(0x1FFFFF);
+        *count = cdb[4] == 0 ? 256 : cdb[4];
+        return true;
+    case READ10:
+    case WRITE10:
+    case VERIFY10:
+        *lba   = get_Emulated_Field(&cdb[2], 4, true);
+        *count = get_Emulated_Field(&cdb[7], 2, true);
+        return true;
+    case READ16:
+    case WRITE16:
+    case VERIFY16:
+        *lba   = get_Emulated_Field(&cdb[2], 8, true);
+        *count = get_Emulated_Field(&cdb[10], 4, true);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static eEmulatedStatus emulate_SCSI_Read_Write_Verify(emulatedTarget*   target,
+                                                      ScsiIoCtx*        scsiIoCtx,
+                                                      eEmulatedLatency* latencyClass)
+{
+    uint64_t        lba    = UINT64_C(0);
+    uint64_t        count  = UINT64_C(0);
+    uint8_t         opcode = scsiIoCtx->cdb[OPERATION_CODE];
+    eEmulatedStatus status = EMULATED_STATUS_GOOD;
+    get_Emulated_CDB_LBA_Range(scsiIoCtx->cdb, &lba, &count);
+    status = check_Emulated_LBA_Range(target, lba, count);
+    if (status != EMULATED_STATUS_GOOD)
+    {
+        return status;
+    }
+    switch (opcode)
+    {
+    case READ6:
+    case READ10:
+    case READ16:
+        *latencyClass = EMULATED_LATENCY_READ;
+        if (count * target->logicalBlockSize > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return count == 0 ? EMULATED_STATUS_GOOD : EMULATED_STATUS_INVALID_FIELD;
+        }
+        ++target->readCommands;
+        return read_Emulated_Blocks(target, 0, lba, count, scsiIoCtx->pdata);
+    case WRITE6:
+    case WRITE10:
+    case WRITE16:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        if (count * target->logicalBlockSize > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return count == 0 ? EMULATED_STATUS_GOOD : EMULATED_STATUS_INVALID_FIELD;
+        }
+        ++target->writeCommands;
+        return write_Emulated_Blocks(target, 0, lba, count, scsiIoCtx->pdata);
+    default: // verify
+        *latencyClass = EMULATED_LATENCY_READ;
+        switch (get_bit_range_uint8(scsiIoCtx->cdb[1], 2, 1)) // BYTCHK
+        {
+        case 0:
+            return EMULATED_STATUS_GOOD;
+        case 1:
+            if (count * target->logicalBlockSize > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+            {
+                return count == 0 ? EMULATED_STATUS_GOOD : EMULATED_STATUS_INVALID_FIELD;
+            }
+            return compare_Emulated_Blocks(target, 0, lba, count, scsiIoCtx->pdata);
+        default:
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+    }
+}
+
+static eEmulatedStatus emulate_Unmap(emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    uint32_t descriptorLength = UINT32_C(0);
+    if (is_Emulated_Target_Zoned(target))
+    {
+        return EMULATED_STATUS_INVALID_OPCODE;
+    }
+    if (scsiIoCtx->pdata == M_NULLPTR || scsiIoCtx->dataLength < UINT32_C(8))
+    {
+        return scsiIoCtx->dataLength == 0 ? EMULATED_STATUS_GOOD : EMULATED_STATUS_INVALID_PARAMETER;
+    }
+    descriptorLength = C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->pdata[2], 2, true));
+    if (descriptorLength > scsiIoCtx->dataLength - 8 || descriptorLength % 16 != 0)
+    {
+        return EMULATED_STATUS_INVALID_PARAMETER;
+    }
+    for (uint32_t offset = UINT32_C(8); offset < descriptorLength + 8; offset += 16)
+    {
+        uint64_t        lba    = get_Emulated_Field(&scsiIoCtx->pdata[offset], 8, true);
+        uint64_t        count  = get_Emulated_Field(&scsiIoCtx->pdata[offset + 8], 4, true);
+        eEmulatedStatus status = deallocate_Emulated_Blocks(target, 0, lba, count);
+        if (status != EMULATED_STATUS_GOOD)
+        {
+            return status;
+        }
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_Zone_Management_In(emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    uint64_t zoneLocator      = get_Emulated_Field(&scsiIoCtx->cdb[2], 8, true);
+    uint32_t allocationLength = C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[10], 4, true));
+    uint8_t  reportingOptions = get_bit_range_uint8(scsiIoCtx->cdb[14], 5, 0);
+    if (!is_Emulated_Target_Zoned(target))
+    {
+        return EMULATED_STATUS_INVALID_OPCODE;
+    }
+    if (get_bit_range_uint8(scsiIoCtx->cdb[1], 4, 0) != 0x00 ||
+        !is_Valid_Emulated_Zone_Reporting_Option(reportingOptions))
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    if (zoneLocator >= target->capacity)
+    {
+        return EMULATED_STATUS_LBA_OUT_OF_RANGE;
+    }
+    if (scsiIoCtx->pdata != M_NULLPTR)
+    {
+        fill_Emulated_Zone_Report(target, zoneLocator, reportingOptions, scsiIoCtx->cdb[14] & BIT7, true,
+                                  scsiIoCtx->pdata, M_Min(allocationLength, scsiIoCtx->dataLength));
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_Zone_Management_Out(emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    if (!is_Emulated_Target_Zoned(target))
+    {
+        return EMULATED_STATUS_INVALID_OPCODE;
+    }
+    return emulated_Zone_Action(target, get_bit_range_uint8(scsiIoCtx->cdb[1], 4, 0),
+                                get_Emulated_Field(&scsiIoCtx->cdb[2], 8, true), scsiIoCtx->cdb[14] & BIT0);
+}
+
+static eEmulatedStatus emulate_Inquiry(const emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, inquiryData, 576);
+    uint32_t        length           = UINT32_C(0);
+    uint32_t        allocationLength = C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[3], 2, true));
+    eEmulatedStatus status           = EMULATED_STATUS_GOOD;
+    if (scsiIoCtx->cdb[1] & BIT0)
+    {
+        status = fill_Emulated_VPD_Page(target, scsiIoCtx->cdb[2], inquiryData, &length);
+    }
+    else if (scsiIoCtx->cdb[2] != 0)
+    {
+        status = EMULATED_STATUS_INVALID_FIELD;
+    }
+    else
+    {
+        length = fill_Emulated_Standard_Inquiry(target, inquiryData);
+    }
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        return_Emulated_SCSI_Data(scsiIoCtx, inquiryData, length, allocationLength);
+    }
+    return status;
+}
+
+static eEmulatedStatus emulate_Read_Capacity(const emulatedTarget* target, ScsiIoCtx* scsiIoCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, capacityData, READ_CAPACITY_16_LEN);
+    if (scsiIoCtx->cdb[OPERATION_CODE] == READ_CAPACITY_10)
+    {
+        set_Emulated_Field(&capacityData[0], M_Min(target->capacity - 1, UINT32_MAX), 4, true);
+        set_Emulated_Field(&capacityData[4], target->logicalBlockSize, 4, true);
+        return_Emulated_SCSI_Data(scsiIoCtx, capacityData, READ_CAPACITY_10_LEN, READ_CAPACITY_10_LEN);
+        return EMULATED_STATUS_GOOD;
+    }
+    if (get_bit_range_uint8(scsiIoCtx->cdb[1], 4, 0) != 0x10)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    set_Emulated_Field(&capacityData[0], target->capacity - 1, 8, true);
+    set_Emulated_Field(&capacityData[8], target->logicalBlockSize, 4, true);
+    if (is_Emulated_Target_Zoned(target))
+    {
+        capacityData[12] = BIT4; // RC BASIS: capacity is the whole device
+    }
+    else
+    {
+        capacityData[14] = BIT7 | BIT6; // LBPME, LBPRZ
+    }
+    return_Emulated_SCSI_Data(scsiIoCtx, capacityData, READ_CAPACITY_16_LEN,
+                              C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[10], 4, true)));
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_ATA_Passthrough(emulatedTarget*   target,
+                                               ScsiIoCtx*        scsiIoCtx,
+                                               eEmulatedLatency* latencyClass);
+
+// Returns EMULATED_STATUS_GOOD when the sense data was already set by the command.
+static eEmulatedStatus emulate_SCSI_Command(emulatedTarget*   target,
+                                            ScsiIoCtx*        scsiIoCtx,
+                                            eEmulatedLatency* latencyClass)
+{
+    *latencyClass = EMULATED_LATENCY_OTHER;
+    switch (scsiIoCtx->cdb[OPERATION_CODE])
+    {
+    case TEST_UNIT_READY_CMD:
+    case START_STOP_UNIT_CMD:
+    case SEND_DIAGNOSTIC_CMD:
+    case MODE_SELECT_6_CMD:
+    case MODE_SELECT10:
+        return EMULATED_STATUS_GOOD;
+    case REQUEST_SENSE_CMD:
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, senseData, 18);
+        senseData[0] = SCSI_SENSE_CUR_INFO_FIXED;
+        senseData[7] = 10;
+        return_Emulated_SCSI_Data(scsiIoCtx, senseData, 18, scsiIoCtx->cdb[4]);
+        return EMULATED_STATUS_GOOD;
+    }
+    case INQUIRY_CMD:
+        return emulate_Inquiry(target, scsiIoCtx);
+    case READ_CAPACITY_10:
+    case READ_CAPACITY_16:
+        return emulate_Read_Capacity(target, scsiIoCtx);
+    case REPORT_LUNS_CMD:
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, lunData, 16);
+        lunData[3] = 8; // LUN 0 only
+        return_Emulated_SCSI_Data(scsiIoCtx, lunData, 16,
+                                  C_CAST(uint32_t, get_Emulated_Field(&scsiIoCtx->cdb[6], 4, true)));
+        return EMULATED_STATUS_GOOD;
+    }
+    case MODE_SENSE_6_CMD:
+    case MODE_SENSE10:
+        return emulate_Mode_Sense(target, scsiIoCtx);
+    case LOG_SENSE_CMD:
+        return emulate_Log_Sense(scsiIoCtx);
+    case READ6:
+    case READ10:
+    case READ16:
+    case WRITE6:
+    case WRITE10:
+    case WRITE16:
+    case VERIFY10:
+    case VERIFY16:
+        return emulate_SCSI_Read_Write_Verify(target, scsiIoCtx, latencyClass);
+    case SYNCHRONIZE_CACHE_10:
+    case SYNCHRONIZE_CACHE_16_CMD:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        return flush_Emulated_Media(target);
+    case UNMAP_CMD:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        return emulate_Unmap(target, scsiIoCtx);
+    case ZONE_MANAGEMENT_IN:
+        return emulate_Zone_Management_In(target, scsiIoCtx);
+    case ZONE_MANAGEMENT_OUT:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        return emulate_Zone_Management_Out(target, scsiIoCtx);
+    case ATA_PASS_THROUGH_12:
+    case ATA_PASS_THROUGH_16:
+        if (target->type == EMULATED_TARGET_SATA_DISK)
+        {
+            return emulate_ATA_Passthrough(target, scsiIoCtx, latencyClass);
+        }
+        return EMULATED_STATUS_INVALID_OPCODE;
+    default:
+        return EMULATED_STATUS_INVALID_OPCODE;
+    }
+}
+
+//
+// ATA (SATA target through ATA PASS-THROUGH)
+//
+
+typedef struct s_emulatedATARegisters
+{
+    uint16_t feature;
+    uint16_t count;
+    uint64_t lba;
+    uint8_t  device;
+    uint8_t  command;
+    uint8_t  status;
+    uint8_t  error;
+    bool     extend;
+} emulatedATARegisters;
+
+static bool fill_Emulated_ATA_Log_Page(const emulatedTarget* target, uint8_t logAddress, uint16_t page, uint8_t* data)
+{
+    safe_memset(data, EMULATED_ATA_SECTOR_SIZE, 0, EMULATED_ATA_SECTOR_SIZE);
+    if (logAddress == ATA_LOG_DIRECTORY && page == 0)
+    {
+        data[0] = 0x01; // version
+        set_Emulated_Field(&data[ATA_LOG_IDENTIFY_DEVICE_DATA * 2], is_Emulated_Target_Zoned(target) ? 10 : 2, 2,
+                           false);
+        return true;
+    }
+    if (logAddress != ATA_LOG_IDENTIFY_DEVICE_DATA)
+    {
+        return false;
+    }
+    switch (page)
+    {
+    case ATA_ID_DATA_LOG_SUPPORTED_PAGES:
+        set_Emulated_Field(&data[0], ATA_ID_DATA_QWORD_VALID_BIT | 0x0001, 8, false);
+        data[ATA_ID_DATA_SUP_PG_LIST_OFFSET]     = ATA_ID_DATA_LOG_SUPPORTED_PAGES;
+        data[ATA_ID_DATA_SUP_PG_LIST_OFFSET + 1] = ATA_ID_DATA_LOG_COPY_OF_IDENTIFY_DATA;
+        data[ATA_ID_DATA_SUP_PG_LIST_LEN_OFFSET] = 2;
+        if (is_Emulated_Target_Zoned(target))
+        {
+            data[ATA_ID_DATA_SUP_PG_LIST_OFFSET + 2] = ATA_ID_DATA_LOG_ZONED_DEVICE_INFORMATION;
+            data[ATA_ID_DATA_SUP_PG_LIST_LEN_OFFSET] = 3;
+        }
+        return true;
+    case ATA_ID_DATA_LOG_COPY_OF_IDENTIFY_DATA:
+        safe_memcpy(data, EMULATED_ATA_SECTOR_SIZE, target->ataIdentify, 512);
+        return true;
+    case ATA_ID_DATA_LOG_ZONED_DEVICE_INFORMATION:
+        if (!is_Emulated_Target_Zoned(target))
+        {
+            return false;
+        }
+        set_Emulated_Field(&data[0],
+                           ATA_ID_DATA_QWORD_VALID_BIT |
+                               (C_CAST(uint64_t, ATA_ID_DATA_LOG_ZONED_DEVICE_INFORMATION) << 16) | 0x0001,
+                           8, false);
+        set_Emulated_Field(&data[8], ATA_ID_DATA_QWORD_VALID_BIT | BIT0, 8, false); // URSWRZ
+        set_Emulated_Field(&data[16], ATA_ID_DATA_QWORD_VALID_BIT, 8, false);
+        set_Emulated_Field(&data[24], ATA_ID_DATA_QWORD_VALID_BIT | UINT32_MAX, 8, false);
+        set_Emulated_Field(&data[32], ATA_ID_DATA_QWORD_VALID_BIT | UINT32_MAX, 8, false);
+        set_Emulated_Field(&data[40], ATA_ID_DATA_QWORD_VALID_BIT | UINT32_MAX, 8, false);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void set_Emulated_ATA_Error(emulatedATARegisters* registers, eEmulatedStatus status)
+{
+    if (status == EMULATED_STATUS_GOOD)
+    {
+        return;
+    }
+    registers->status = EMULATED_ATA_STATUS_ERROR;
+    switch (status)
+    {
+    case EMULATED_STATUS_LBA_OUT_OF_RANGE:
+        registers->error = EMULATED_ATA_ERROR_IDNF;
+        break;
+    case EMULATED_STATUS_READ_ERROR:
+        registers->error = EMULATED_ATA_ERROR_UNC;
+        break;
+    default:
+        registers->error = EMULATED_ATA_ERROR_ABRT;
+        break;
+    }
+}
+
+static eEmulatedStatus emulate_ATA_Read_Write_Verify(emulatedTarget*       target,
+                                                     ScsiIoCtx*            scsiIoCtx,
+                                                     emulatedATARegisters* registers,
+                                                     eEmulatedLatency*     latencyClass)
+{
+    bool            ext    = true;
+    uint64_t        count  = registers->count;
+    eEmulatedStatus status = EMULATED_STATUS_GOOD;
+    switch (registers->command)
+    {
+    case ATA_READ_SECT:
+    case ATA_READ_DMA_RETRY_CMD:
+    case ATA_WRITE_SECT:
+    case ATA_WRITE_DMA_RETRY_CMD:
+    case ATA_READ_VERIFY_RETRY:
+    case ATA_READ_VERIFY_NORETRY:
+        ext = false;
+        break;
+    default:
+        break;
+    }
+    if (ext)
+    {
+        count = count == 0 ? 65536 : count;
+    }
+    else
+    {
+        count = (count & 0xFF) == 0 ? 256 : (count & 0xFF);
+    }
+    status = check_Emulated_LBA_Range(target, registers->lba, count);
+    if (status != EMULATED_STATUS_GOOD)
+    {
+        return status;
+    }
+    switch (registers->command)
+    {
+    case ATA_READ_SECT:
+    case ATA_READ_DMA_RETRY_CMD:
+    case ATA_READ_SECT_EXT:
+    case ATA_READ_DMA_EXT:
+        *latencyClass = EMULATED_LATENCY_READ;
+        if (count * target->logicalBlockSize > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        ++target->readCommands;
+        return read_Emulated_Blocks(target, 0, registers->lba, count, scsiIoCtx->pdata);
+    case ATA_WRITE_SECT:
+    case ATA_WRITE_DMA_RETRY_CMD:
+    case ATA_WRITE_SECT_EXT:
+    case ATA_WRITE_DMA_EXT:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        if (count * target->logicalBlockSize > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        ++target->writeCommands;
+        return write_Emulated_Blocks(target, 0, registers->lba, count, scsiIoCtx->pdata);
+    default: // verify
+        *latencyClass = EMULATED_LATENCY_READ;
+        return EMULATED_STATUS_GOOD;
+    }
+}
+
+static eEmulatedStatus emulate_ATA_Read_Log(const emulatedTarget* target,
+                                            ScsiIoCtx*            scsiIoCtx,
+                                            emulatedATARegisters* registers)
+{
+    uint8_t  logAddress = M_Byte0(registers->lba);
+    uint16_t page       = M_BytesTo2ByteValue(M_Byte4(registers->lba), M_Byte1(registers->lba));
+    if (registers->count == 0 || scsiIoCtx->pdata == M_NULLPTR ||
+        C_CAST(uint32_t, registers->count) * EMULATED_ATA_SECTOR_SIZE > scsiIoCtx->dataLength)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    for (uint16_t iter = UINT16_C(0); iter < registers->count; ++iter)
+    {
+        if (!fill_Emulated_ATA_Log_Page(target, logAddress, page + iter,
+                                        &scsiIoCtx->pdata[C_CAST(uint32_t, iter) * EMULATED_ATA_SECTOR_SIZE]))
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_ATA_Trim(emulatedTarget*             target,
+                                        ScsiIoCtx*                  scsiIoCtx,
+                                        const emulatedATARegisters* registers)
+{
+    uint32_t pages = registers->count == 0 ? 65536 : registers->count;
+    if (is_Emulated_Target_Zoned(target) || (registers->feature & BIT0) == 0)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    if (pages * EMULATED_ATA_SECTOR_SIZE > scsiIoCtx->dataLength || scsiIoCtx->pdata == M_NULLPTR)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    for (uint32_t offset = UINT32_C(0); offset < pages * EMULATED_ATA_SECTOR_SIZE; offset += 8)
+    {
+        uint64_t entry  = get_Emulated_Field(&scsiIoCtx->pdata[offset], 8, false);
+        uint64_t length = M_Word3(entry);
+        if (length > 0)
+        {
+            eEmulatedStatus status = deallocate_Emulated_Blocks(target, 0, entry & MAX_48_BIT_LBA, length);
+            if (status != EMULATED_STATUS_GOOD)
+            {
+                return status;
+            }
+        }
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static eEmulatedStatus emulate_ATA_Command(emulatedTarget*       target,
+                                           ScsiIoCtx*            scsiIoCtx,
+                                           emulatedATARegisters* registers,
+                                           eEmulatedLatency*     latencyClass)
+{
+    switch (registers->command)
+    {
+    case ATA_IDENTIFY:
+        if (scsiIoCtx->dataLength < 512 || scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, target->ataIdentify, 512);
+        return EMULATED_STATUS_GOOD;
+    case ATA_READ_LOG_EXT:
+    case ATA_READ_LOG_EXT_DMA:
+        return emulate_ATA_Read_Log(target, scsiIoCtx, registers);
+    case ATA_READ_SECT:
+    case ATA_READ_DMA_RETRY_CMD:
+    case ATA_READ_SECT_EXT:
+    case ATA_READ_DMA_EXT:
+    case ATA_WRITE_SECT:
+    case ATA_WRITE_DMA_RETRY_CMD:
+    case ATA_WRITE_SECT_EXT:
+    case ATA_WRITE_DMA_EXT:
+    case ATA_READ_VERIFY_RETRY:
+    case ATA_READ_VERIFY_NORETRY:
+    case ATA_READ_VERIFY_EXT:
+        return emulate_ATA_Read_Write_Verify(target, scsiIoCtx, registers, latencyClass);
+    case ATA_FLUSH_CACHE_CMD:
+    case ATA_FLUSH_CACHE_EXT:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        return flush_Emulated_Media(target);
+    case ATA_SET_FEATURE:
+        if (M_Byte0(registers->feature) == SF_ENABLE_VOLITILE_WRITE_CACHE)
+        {
+            target->writeCacheEnabled = true;
+        }
+        else if (M_Byte0(registers->feature) == SF_DISABLE_VOLITILE_WRITE_CACHE)
+        {
+            target->writeCacheEnabled = false;
+        }
+        return EMULATED_STATUS_GOOD;
+    case ATA_CHECK_POWER_MODE_CMD:
+        registers->count = 0xFF; // active or idle
+        return EMULATED_STATUS_GOOD;
+    case ATA_STANDBY_IMMD:
+    case ATA_IDLE_IMMEDIATE_CMD:
+        return EMULATED_STATUS_GOOD;
+    case ATA_DATA_SET_MANAGEMENT_CMD:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        return emulate_ATA_Trim(target, scsiIoCtx, registers);
+    case ATA_ZONE_MANAGEMENT_IN:
+        if (!is_Emulated_Target_Zoned(target) || M_Byte0(registers->feature) != ZM_ACTION_REPORT_ZONES ||
+            !is_Valid_Emulated_Zone_Reporting_Option(get_bit_range_uint8(M_Byte1(registers->feature), 5, 0)) ||
+            scsiIoCtx->pdata == M_NULLPTR)
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        if (registers->lba >= target->capacity)
+        {
+            return EMULATED_STATUS_LBA_OUT_OF_RANGE;
+        }
+        fill_Emulated_Zone_Report(target, registers->lba, get_bit_range_uint8(M_Byte1(registers->feature), 5, 0),
+                                  M_Byte1(registers->feature) & BIT7, false, scsiIoCtx->pdata,
+                                  M_Min(C_CAST(uint32_t, registers->count) * EMULATED_ATA_SECTOR_SIZE,
+                                        scsiIoCtx->dataLength));
+        return EMULATED_STATUS_GOOD;
+    case ATA_ZONE_MANAGEMENT_OUT:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        if (!is_Emulated_Target_Zoned(target))
+        {
+            return EMULATED_STATUS_INVALID_FIELD;
+        }
+        return emulated_Zone_Action(target, get_bit_range_uint8(M_Byte0(registers->feature), 4, 0), registers->lba,
+                                    M_Byte1(registers->feature) & BIT0);
+    default:
+        return EMULATED_STATUS_INVALID_OPCODE;
+    }
+}
+
+// SAT: a check condition with an ATA Status Return descriptor is returned for errors, or when CK_COND is set.
+static eEmulatedStatus emulate_ATA_Passthrough(emulatedTarget*   target,
+                                               ScsiIoCtx*        scsiIoCtx,
+                                               eEmulatedLatency* latencyClass)
+{
+    emulatedATARegisters registers;
+    const uint8_t*       cdb       = scsiIoCtx->cdb;
+    uint8_t              protocol  = get_bit_range_uint8(cdb[1], 4, 1);
+    bool                 checkCond = cdb[2] & BIT5;
+    safe_memset(&registers, sizeof(emulatedATARegisters), 0, sizeof(emulatedATARegisters));
+    registers.status = EMULATED_ATA_STATUS_GOOD;
+    if (cdb[OPERATION_CODE] == ATA_PASS_THROUGH_12)
+    {
+        registers.feature = cdb[3];
+        registers.count   = cdb[4];
+        registers.lba     = get_Emulated_Field(&cdb[5], 3, false);
+        registers.device  = cdb[8];
+        registers.command = cdb[9];
+    }
+    else
+    {
+        registers.extend  = cdb[1] & BIT0;
+        registers.feature = registers.extend ? M_BytesTo2ByteValue(cdb[3], cdb[4]) : cdb[4];
+        registers.count   = registers.extend ? M_BytesTo2ByteValue(cdb[5], cdb[6]) : cdb[6];
+        registers.lba     = M_BytesTo4ByteValue(0, cdb[12], cdb[10], cdb[8]);
+        if (registers.extend)
+        {
+            registers.lba |= C_CAST(uint64_t, M_BytesTo4ByteValue(0, cdb[11], cdb[9], cdb[7])) << 24;
+        }
+        registers.device  = cdb[13];
+        registers.command = cdb[14];
+    }
+    if (!registers.extend)
+    {
+        registers.lba |= C_CAST(uint64_t, M_Nibble0(registers.device)) << 24;
+    }
+    if (protocol == 0 || protocol == 1)
+    {
+        // hard and soft reset
+        set_Emulated_SCSI_Status(scsiIoCtx, EMULATED_STATUS_GOOD);
+        return EMULATED_STATUS_GOOD;
+    }
+    if (protocol != 15) // 15 returns the registers from the last command. Those are always good here.
+    {
+        set_Emulated_ATA_Error(&registers, emulate_ATA_Command(target, scsiIoCtx, &registers, latencyClass));
+    }
+    if (checkCond || registers.status != EMULATED_ATA_STATUS_GOOD || protocol == 15)
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, descriptor, 14);
+        descriptor[0]  = SENSE_DESCRIPTOR_ATA_STATUS_RETURN;
+        descriptor[1]  = 0x0C;
+        descriptor[2]  = registers.extend ? BIT0 : 0;
+        descriptor[3]  = registers.error;
+        descriptor[4]  = M_Byte1(registers.count);
+        descriptor[5]  = M_Byte0(registers.count);
+        descriptor[6]  = M_Byte3(registers.lba);
+        descriptor[7]  = M_Byte0(registers.lba);
+        descriptor[8]  = M_Byte4(registers.lba);
+        descriptor[9]  = M_Byte1(registers.lba);
+        descriptor[10] = M_Byte5(registers.lba);
+        descriptor[11] = M_Byte2(registers.lba);
+        descriptor[12] = registers.device;
+        descriptor[13] = registers.status;
+        if (registers.status == EMULATED_ATA_STATUS_GOOD)
+        {
+            set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_RECOVERED_ERROR, 0x00, 0x1D, true, descriptor);
+        }
+        else
+        {
+            set_Emulated_Sense_Data(scsiIoCtx, SENSE_KEY_ABORTED_COMMAND, 0x00, 0x00, true, descriptor);
+        }
+    }
+    else
+    {
+        set_Emulated_SCSI_Status(scsiIoCtx, EMULATED_STATUS_GOOD);
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+//
+// NVMe
+//
+
+static M_INLINE uint32_t get_Emulated_NVMe_Status(uint8_t statusCodeType, uint8_t statusCode)
+{
+    uint32_t status = (C_CAST(uint32_t, statusCodeType & 0x07) << 25) | (C_CAST(uint32_t, statusCode) << 17);
+    if (statusCodeType != NVME_SCT_GENERIC_COMMAND_STATUS || statusCode != NVME_GEN_SC_SUCCESS_)
+    {
+        status |= BIT31; // do not retry
+    }
+    return status;
+}
+
+static uint32_t get_Emulated_NVMe_Status_From_Result(eEmulatedStatus status)
+{
+    switch (status)
+    {
+    case EMULATED_STATUS_GOOD:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_SUCCESS_);
+    case EMULATED_STATUS_INVALID_OPCODE:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_OPCODE_);
+    case EMULATED_STATUS_LBA_OUT_OF_RANGE:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_LBA_RANGE_);
+    case EMULATED_STATUS_MISCOMPARE:
+        return get_Emulated_NVMe_Status(NVME_SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS, NVME_MED_ERR_SC_COMPARE_FAILED_);
+    case EMULATED_STATUS_READ_ERROR:
+        return get_Emulated_NVMe_Status(NVME_SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS, NVME_MED_ERR_SC_UNREC_READ_ERROR_);
+    case EMULATED_STATUS_WRITE_ERROR:
+        return get_Emulated_NVMe_Status(NVME_SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS, NVME_MED_ERR_SC_WRITE_FAULT_);
+    default:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_FIELD_);
+    }
+}
+
+static void fill_Emulated_NVMe_Identify_Controller(const emulatedTarget* target, uint8_t* data)
+{
+    set_Emulated_String(&data[4], target->serialNumber, 20, false);
+    set_Emulated_String(&data[24], EMULATED_NVME_MODEL, 40, false);
+    set_Emulated_String(&data[64], EMULATED_FIRMWARE_REVISION, 8, false);
+    data[77] = 8;                                       // MDTS: 2^8 * 4KiB = EMULATED_TARGET_MAX_TRANSFER_SIZE
+    set_Emulated_Field(&data[78], 1, 2, false);         // controller ID
+    set_Emulated_Field(&data[80], 0x00010400, 4, false); // version 1.4
+    data[111] = 0x01;                                   // I/O controller
+    data[260] = 0x02;                                   // one firmware slot
+    data[261] = BIT2;                                   // extended data for get log page
+    set_Emulated_Field(&data[266], 273 + 70, 2, false); // warning composite temperature threshold. Kelvin
+    set_Emulated_Field(&data[268], 273 + 80, 2, false); // critical composite temperature threshold. Kelvin
+    data[512] = 0x66;                                   // SQES
+    data[513] = 0x44;                                   // CQES
+    set_Emulated_Field(&data[516], target->namespaceCount, 4, false);
+    set_Emulated_Field(&data[520], BIT2 | BIT3 | BIT7, 2, false); // ONCS: DSM, write zeroes, verify
+    data[525] = BIT0;                                              // volatile write cache present
+    set_Emulated_String(&data[768], EMULATED_NVME_SUBNQN, safe_strlen(EMULATED_NVME_SUBNQN), false);
+    set_Emulated_Field(&data[2048], 500, 2, false); // power state 0: 5W
+}
+
+static uint64_t get_Emulated_NVMe_EUI64(const emulatedTarget* target, uint32_t namespaceID)
+{
+    return (target->wwn & ~UINT64_C(0xF000000000000000)) ^ (C_CAST(uint64_t, namespaceID) << 8);
+}
+
+static void fill_Emulated_NVMe_Identify_Namespace(const emulatedTarget* target, uint32_t namespaceID, uint8_t* data)
+{
+    uint8_t lbads = UINT8_C(0);
+    while ((UINT32_C(1) << lbads) < target->logicalBlockSize)
+    {
+        ++lbads;
+    }
+    if (namespaceID != NVME_ALL_NAMESPACES)
+    {
+        set_Emulated_Field(&data[0], target->capacity, 8, false);  // NSZE
+        set_Emulated_Field(&data[8], target->capacity, 8, false);  // NCAP
+        set_Emulated_Field(&data[16], target->capacity, 8, false); // NUSE
+        data[33] = 0x01;                                           // DLFEAT: deallocated blocks read as zeros
+        set_Emulated_Field(&data[104], get_Emulated_NVMe_EUI64(target, namespaceID), 8, true); // NGUID
+        set_Emulated_Field(&data[120], get_Emulated_NVMe_EUI64(target, namespaceID), 8, true); // EUI64
+    }
+    data[130] = lbads; // LBA format 0
+}
+
+static uint32_t emulate_NVMe_Identify(const emulatedTarget* target, nvmeCmdCtx* cmdCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, identifyData, NVME_IDENTIFY_DATA_LEN);
+    uint32_t namespaceID = cmdCtx->cmd.adminCmd.nsid;
+    switch (M_Byte0(cmdCtx->cmd.adminCmd.cdw10))
+    {
+    case NVME_IDENTIFY_CTRL:
+        fill_Emulated_NVMe_Identify_Controller(target, identifyData);
+        break;
+    case NVME_IDENTIFY_NS:
+        if ((namespaceID == 0 || namespaceID > target->namespaceCount) && namespaceID != NVME_ALL_NAMESPACES)
+        {
+            return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_NS_);
+        }
+        fill_Emulated_NVMe_Identify_Namespace(target, namespaceID, identifyData);
+        break;
+    case NVME_IDENTIFY_ALL_ACTIVE_NS:
+    {
+        uint32_t offset = UINT32_C(0);
+        for (uint32_t nsid = namespaceID + 1; nsid <= target->namespaceCount && namespaceID < UINT32_C(0xFFFFFFFE);
+             ++nsid)
+        {
+            set_Emulated_Field(&identifyData[offset], nsid, 4, false);
+            offset += 4;
+        }
+        break;
+    }
+    case 0x03: // namespace identification descriptor list
+        if (namespaceID == 0 || namespaceID > target->namespaceCount)
+        {
+            return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_NS_);
+        }
+        identifyData[0] = 0x01; // EUI64
+        identifyData[1] = 8;
+        set_Emulated_Field(&identifyData[4], get_Emulated_NVMe_EUI64(target, namespaceID), 8, true);
+        break;
+    default:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_FIELD_);
+    }
+    if (cmdCtx->ptrData != M_NULLPTR)
+    {
+        safe_memcpy(cmdCtx->ptrData, cmdCtx->dataSize, identifyData, M_Min(cmdCtx->dataSize, NVME_IDENTIFY_DATA_LEN));
+    }
+    return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_SUCCESS_);
+}
+
+// NVMe data units are thousands of 512B units, rounded up
+static uint64_t get_Emulated_NVMe_Data_Units(const emulatedTarget* target, uint64_t blocks)
+{
+    uint64_t units512 = blocks * (target->logicalBlockSize / 512);
+    return (units512 + 999) / 1000;
+}
+
+static uint32_t emulate_NVMe_Get_Log_Page(const emulatedTarget* target, nvmeCmdCtx* cmdCtx)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, logData, EMULATED_MAX_LOG_PAGE_SIZE);
+    uint32_t logLength      = UINT32_C(0);
+    uint64_t offset         = M_DWordsTo8ByteValue(cmdCtx->cmd.adminCmd.cdw13, cmdCtx->cmd.adminCmd.cdw12);
+    uint64_t requestedBytes = ((C_CAST(uint64_t, M_Word0(cmdCtx->cmd.adminCmd.cdw11)) << 16) |
+                               M_Word1(cmdCtx->cmd.adminCmd.cdw10)) +
+                              1;
+    requestedBytes *= 4;
+    switch (M_Byte0(cmdCtx->cmd.adminCmd.cdw10))
+    {
+    case NVME_LOG_ERROR_ID:
+        logLength = 64; // one entry, never any errors
+        break;
+    case NVME_LOG_SMART_ID:
+    {
+        seatimer powerOnTime = target->powerOnTimer;
+        stop_Timer(&powerOnTime);
+        set_Emulated_Field(&logData[1], 273 + EMULATED_TEMPERATURE_C, 2, false);
+        logData[3] = 100; // available spare
+        logData[4] = 10;  // available spare threshold
+        set_Emulated_Field(&logData[32], get_Emulated_NVMe_Data_Units(target, target->blocksRead), 8, false);
+        set_Emulated_Field(&logData[48], get_Emulated_NVMe_Data_Units(target, target->blocksWritten), 8, false);
+        set_Emulated_Field(&logData[64], target->readCommands, 8, false);
+        set_Emulated_Field(&logData[80], target->writeCommands, 8, false);
+        set_Emulated_Field(&logData[128], get_Nano_Seconds(powerOnTime) / UINT64_C(3600000000000), 8, false);
+        logLength = 512;
+        break;
+    }
+    case NVME_LOG_FW_SLOT_ID:
+        logData[0] = 0x01; // slot 1 active
+        set_Emulated_String(&logData[8], EMULATED_FIRMWARE_REVISION, 8, false);
+        logLength = 512;
+        break;
+    default:
+        return get_Emulated_NVMe_Status(NVME_SCT_COMMAND_SPECIFIC_STATUS, NVME_CMD_SP_SC_INVALID_LOG_PAGE_);
+    }
+    if (offset >= logLength || (offset % 4) != 0)
+    {
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_FIELD_);
+    }
+    if (cmdCtx->ptrData != M_NULLPTR)
+    {
+        uint64_t copyLength = M_Min(M_Min(requestedBytes, logLength - offset), C_CAST(uint64_t, cmdCtx->dataSize));
+        safe_memset(cmdCtx->ptrData, cmdCtx->dataSize, 0, cmdCtx->dataSize);
+        safe_memcpy(cmdCtx->ptrData, cmdCtx->dataSize, &logData[offset], C_CAST(size_t, copyLength));
+    }
+    return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_SUCCESS_);
+}
+
+static uint32_t emulate_NVMe_Features(emulatedTarget* target, nvmeCmdCtx* cmdCtx)
+{
+    bool     setFeatures = cmdCtx->cmd.adminCmd.opcode == NVME_ADMIN_CMD_SET_FEATURES;
+    uint32_t value       = UINT32_C(0);
+    switch (M_Byte0(cmdCtx->cmd.adminCmd.cdw10))
+    {
+    case NVME_FEAT_ARBITRATION_:
+    case NVME_FEAT_POWER_MGMT_:
+    case NVME_FEAT_ERR_RECOVERY_:
+    case NVME_FEAT_IRQ_COALESCE_:
+    case NVME_FEAT_WRITE_ATOMIC_:
+    case NVME_FEAT_ASYNC_EVENT_:
+        break;
+    case NVME_FEAT_TEMP_THRESH_:
+        value = 273 + 70;
+        break;
+    case NVME_FEAT_VOLATILE_WC_:
+        if (setFeatures)
+        {
+            target->writeCacheEnabled = cmdCtx->cmd.adminCmd.cdw11 & BIT0;
+        }
+        value = target->writeCacheEnabled ? BIT0 : 0;
+        break;
+    case NVME_FEAT_NUM_QUEUES_:
+        value = UINT32_C(0x003F003F);
+        break;
+    default:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_FIELD_);
+    }
+    cmdCtx->commandCompletionData.dw0 = value;
+    return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_SUCCESS_);
+}
+
+static uint32_t emulate_NVMe_Admin_Command(emulatedTarget* target, nvmeCmdCtx* cmdCtx)
+{
+    switch (cmdCtx->cmd.adminCmd.opcode)
+    {
+    case NVME_ADMIN_CMD_IDENTIFY:
+        return emulate_NVMe_Identify(target, cmdCtx);
+    case NVME_ADMIN_CMD_GET_LOG_PAGE:
+        return emulate_NVMe_Get_Log_Page(target, cmdCtx);
+    case NVME_ADMIN_CMD_GET_FEATURES:
+    case NVME_ADMIN_CMD_SET_FEATURES:
+        return emulate_NVMe_Features(target, cmdCtx);
+    default:
+        return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_OPCODE_);
+    }
+}
+
+static eEmulatedStatus emulate_NVMe_Dataset_Management(emulatedTarget* target,
+                                                       uint32_t        namespaceIndex,
+                                                       nvmeCmdCtx*     cmdCtx)
+{
+    uint32_t ranges = M_Byte0(cmdCtx->cmd.nvmCmd.cdw10) + UINT32_C(1);
+    if ((cmdCtx->cmd.nvmCmd.cdw11 & BIT2) == 0) // only deallocate does anything
+    {
+        return EMULATED_STATUS_GOOD;
+    }
+    if (cmdCtx->ptrData == M_NULLPTR || ranges * 16 > cmdCtx->dataSize)
+    {
+        return EMULATED_STATUS_INVALID_FIELD;
+    }
+    for (uint32_t iter = UINT32_C(0); iter < ranges; ++iter)
+    {
+        const uint8_t*  range  = &cmdCtx->ptrData[iter * 16];
+        eEmulatedStatus status = deallocate_Emulated_Blocks(
+            target, namespaceIndex, get_Emulated_Field(&range[8], 8, false), get_Emulated_Field(&range[4], 4, false));
+        if (status != EMULATED_STATUS_GOOD)
+        {
+            return status;
+        }
+    }
+    return EMULATED_STATUS_GOOD;
+}
+
+static uint32_t emulate_NVMe_NVM_Command(emulatedTarget* target, nvmeCmdCtx* cmdCtx, eEmulatedLatency* latencyClass)
+{
+    uint32_t        namespaceID = cmdCtx->cmd.nvmCmd.nsid;
+    uint64_t        lba         = M_DWordsTo8ByteValue(cmdCtx->cmd.nvmCmd.cdw11, cmdCtx->cmd.nvmCmd.cdw10);
+    uint64_t        count       = C_CAST(uint64_t, M_Word0(cmdCtx->cmd.nvmCmd.cdw12)) + 1;
+    eEmulatedStatus status      = EMULATED_STATUS_GOOD;
+    if (namespaceID == 0 || namespaceID > target->namespaceCount)
+    {
+        if (cmdCtx->cmd.nvmCmd.opcode != NVME_CMD_FLUSH || namespaceID != NVME_ALL_NAMESPACES)
+        {
+            return get_Emulated_NVMe_Status(NVME_SCT_GENERIC_COMMAND_STATUS, NVME_GEN_SC_INVALID_NS_);
+        }
+    }
+    switch (cmdCtx->cmd.nvmCmd.opcode)
+    {
+    case NVME_CMD_FLUSH:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        status        = flush_Emulated_Media(target);
+        break;
+    case NVME_CMD_READ:
+    case NVME_CMD_WRITE:
+    case NVME_CMD_VERIFY:
+        status = check_Emulated_LBA_Range(target, lba, count);
+        if (status != EMULATED_STATUS_GOOD)
+        {
+            break;
+        }
+        if (cmdCtx->cmd.nvmCmd.opcode == NVME_CMD_VERIFY)
+        {
+            *latencyClass = EMULATED_LATENCY_READ;
+            break;
+        }
+        if (cmdCtx->ptrData == M_NULLPTR || count * target->logicalBlockSize > cmdCtx->dataSize)
+        {
+            status = EMULATED_STATUS_INVALID_FIELD;
+        }
+        else if (cmdCtx->cmd.nvmCmd.opcode == NVME_CMD_READ)
+        {
+            *latencyClass = EMULATED_LATENCY_READ;
+            ++target->readCommands;
+            status = read_Emulated_Blocks(target, namespaceID - 1, lba, count, cmdCtx->ptrData);
+        }
+        else
+        {
+            *latencyClass = EMULATED_LATENCY_WRITE;
+            ++target->writeCommands;
+            status = write_Emulated_Blocks(target, namespaceID - 1, lba, count, cmdCtx->ptrData);
+        }
+        break;
+    case NVME_CMD_WRITE_ZEROS:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        status        = deallocate_Emulated_Blocks(target, namespaceID - 1, lba, count);
+        break;
+    case NVME_CMD_DATA_SET_MANAGEMENT:
+        *latencyClass = EMULATED_LATENCY_WRITE;
+        status        = emulate_NVMe_Dataset_Management(target, namespaceID - 1, cmdCtx);
+        break;
+    default:
+        status = EMULATED_STATUS_INVALID_OPCODE;
+        break;
+    }
+    return get_Emulated_NVMe_Status_From_Result(status);
+}
+
+//
+// issue_io and issue_nvme_io
+//
+
+static void complete_Emulated_Command(tDevice*         device,
+                                      emulatedTarget*  target,
+                                      seatimer*        commandTimer,
+                                      eEmulatedLatency latencyClass)
+{
+    uint64_t latencyNS = target->latencyNS[latencyClass];
+    if (latencyNS > UINT64_C(0))
+    {
+        seatimer elapsed = *commandTimer;
+        stop_Timer(&elapsed);
+        while (get_Nano_Seconds(elapsed) < latencyNS)
+        {
+            uint64_t remainingNS = latencyNS - get_Nano_Seconds(elapsed);
+            // sleep for most of it, then spin so short latencies are still accurate
+            if (remainingNS > UINT64_C(2000000))
+            {
+                delay_Milliseconds(C_CAST(uint32_t, M_Min((remainingNS / UINT64_C(1000000)) - 1, UINT32_MAX)));
+            }
+            elapsed = *commandTimer;
+            stop_Timer(&elapsed);
+        }
+    }
+    stop_Timer(commandTimer);
+    ++target->commandsCompleted;
+    target->totalCommandTimeNS += get_Nano_Seconds(*commandTimer);
+    set_tDevice_Last_Command_Completion_Time_NS(device, get_Nano_Seconds(*commandTimer));
+}
+
+static eReturnValues emulated_Target_Issue_IO(void* ioCtx)
+{
+    ScsiIoCtx*       scsiIoCtx    = M_REINTERPRET_CAST(ScsiIoCtx*, ioCtx);
+    emulatedTarget*  target       = get_Emulated_Target(scsiIoCtx->device);
+    eEmulatedLatency latencyClass = EMULATED_LATENCY_OTHER;
+    eEmulatedStatus  status       = EMULATED_STATUS_GOOD;
+    DECLARE_SEATIMER(commandTimer);
+    if (target == M_NULLPTR)
+    {
+        return BAD_PARAMETER;
+    }
+    if (target->type == EMULATED_TARGET_NVME_CONTROLLER)
+    {
+        // translated to NVMe commands, which come back through emulated_Target_Issue_NVMe_IO
+        return sntl_Translate_SCSI_Command(scsiIoCtx->device, scsiIoCtx);
+    }
+    start_Timer(&commandTimer);
+    // Commands that set their own sense data (ATA passthrough, saving mode pages) do so before returning good, so only
+    // set it here when nothing else has.
+    scsiIoCtx->returnStatus.format = 0xFF;
+    status                         = emulate_SCSI_Command(target, scsiIoCtx, &latencyClass);
+    if (status != EMULATED_STATUS_GOOD || scsiIoCtx->returnStatus.format == 0xFF)
+    {
+        set_Emulated_SCSI_Status(scsiIoCtx, status);
+    }
+    complete_Emulated_Command(scsiIoCtx->device, target, &commandTimer, latencyClass);
+    return SUCCESS;
+}
+
+static eReturnValues emulated_Target_Issue_NVMe_IO(void* ioCtx)
+{
+    nvmeCmdCtx*      cmdCtx       = M_REINTERPRET_CAST(nvmeCmdCtx*, ioCtx);
+    emulatedTarget*  target       = get_Emulated_Target(cmdCtx->device);
+    eEmulatedLatency latencyClass = EMULATED_LATENCY_OTHER;
+    DECLARE_SEATIMER(commandTimer);
+    if (target == M_NULLPTR || target->type != EMULATED_TARGET_NVME_CONTROLLER)
+    {
+        return BAD_PARAMETER;
+    }
+    start_Timer(&commandTimer);
+    safe_memset(&cmdCtx->commandCompletionData, sizeof(completionQueueEntry), 0, sizeof(completionQueueEntry));
+    if (cmdCtx->commandType == NVM_ADMIN_CMD)
+    {
+        cmdCtx->commandCompletionData.dw3 = emulate_NVMe_Admin_Command(target, cmdCtx);
+    }
+    else
+    {
+        cmdCtx->commandCompletionData.dw3 = emulate_NVMe_NVM_Command(target, cmdCtx, &latencyClass);
+    }
+    cmdCtx->commandCompletionData.dw0Valid = true;
+    cmdCtx->commandCompletionData.dw3Valid = true;
+    complete_Emulated_Command(cmdCtx->device, target, &commandTimer, latencyClass);
+    return SUCCESS;
+}
+
+//
+// Setup and teardown
+//
+
+static void fill_Emulated_ATA_Identify(emulatedTarget* target)
+{
+    uint8_t* identify = target->ataIdentify;
+    uint8_t  checksum = UINT8_C(0);
+    set_Emulated_Field(&identify[0 * 2], 0x0040, 2, false); // fixed
+    set_Emulated_Field(&identify[1 * 2], 16383, 2, false);
+    set_Emulated_Field(&identify[3 * 2], 16, 2, false);
+    set_Emulated_Field(&identify[6 * 2], 63, 2, false);
+    set_Emulated_String(&identify[10 * 2], target->serialNumber, 20, true);
+    set_Emulated_String(&identify[23 * 2], EMULATED_FIRMWARE_REVISION, 8, true);
+    set_Emulated_String(&identify[27 * 2], EMULATED_ATA_MODEL, 40, true);
+    set_Emulated_Field(&identify[47 * 2], 0x8010, 2, false);
+    set_Emulated_Field(&identify[49 * 2], BIT9 | BIT8, 2, false); // LBA, DMA
+    set_Emulated_Field(&identify[53 * 2], BIT2 | BIT1, 2, false);
+    set_Emulated_Field(&identify[60 * 2], M_Min(target->capacity, MAX_28BIT), 4, false);
+    set_Emulated_Field(&identify[63 * 2], 0x0007, 2, false);
+    set_Emulated_Field(&identify[64 * 2], 0x0003, 2, false);
+    set_Emulated_Field(&identify[76 * 2], BIT2 | BIT1, 2, false); // SATA gen 1 and 2
+    set_Emulated_Field(&identify[80 * 2], 0x0FF0, 2, false);      // ATA/ATAPI-4 through ACS-4
+    set_Emulated_Field(&identify[82 * 2], BIT6 | BIT5, 2, false); // look ahead, write cache
+    set_Emulated_Field(&identify[83 * 2], BIT14 | BIT13 | BIT12 | BIT10, 2, false); // flush, flush ext, 48bit
+    set_Emulated_Field(&identify[84 * 2], BIT14 | BIT5, 2, false);                  // GPL
+    set_Emulated_Field(&identify[85 * 2], BIT6 | BIT5, 2, false);
+    set_Emulated_Field(&identify[86 * 2], BIT15 | BIT13 | BIT12 | BIT10, 2, false);
+    set_Emulated_Field(&identify[87 * 2], BIT14 | BIT5, 2, false);
+    set_Emulated_Field(&identify[88 * 2], BIT14 | 0x007F, 2, false); // UDMA 0-6 supported, 6 selected
+    set_Emulated_Field(&identify[100 * 2], target->capacity, 8, false);
+    if (target->logicalBlockSize > 512)
+    {
+        set_Emulated_Field(&identify[106 * 2], BIT14 | BIT12, 2, false);
+        set_Emulated_Field(&identify[117 * 2], target->logicalBlockSize / 2, 4, false);
+    }
+    else
+    {
+        set_Emulated_Field(&identify[106 * 2], BIT14, 2, false);
+    }
+    set_Emulated_Field(&identify[108 * 2], M_Word3(target->wwn), 2, false);
+    set_Emulated_Field(&identify[109 * 2], M_Word2(target->wwn), 2, false);
+    set_Emulated_Field(&identify[110 * 2], M_Word1(target->wwn), 2, false);
+    set_Emulated_Field(&identify[111 * 2], M_Word0(target->wwn), 2, false);
+    set_Emulated_Field(&identify[119 * 2], BIT14 | BIT3, 2, false); // read/write log DMA ext
+    set_Emulated_Field(&identify[120 * 2], BIT14 | BIT3, 2, false);
+    if (!is_Emulated_Target_Zoned(target))
+    {
+        set_Emulated_Field(&identify[169 * 2], BIT0, 2, false); // TRIM
+    }
+    set_Emulated_Field(&identify[217 * 2], EMULATED_ROTATION_RATE, 2, false);
+    set_Emulated_Field(&identify[222 * 2], 0x10FF, 2, false); // serial ATA
+    identify[510] = 0xA5;
+    for (uint16_t iter = UINT16_C(0); iter < 511; ++iter)
+    {
+        checksum = M_STATIC_CAST(uint8_t, checksum + identify[iter]);
+    }
+    identify[511] = M_STATIC_CAST(uint8_t, 0 - checksum);
+}
+
+static void free_Emulated_Target(emulatedTarget** target)
+{
+    if (target != M_NULLPTR && *target != M_NULLPTR)
+    {
+        if ((*target)->chunks != M_NULLPTR)
+        {
+            for (uint64_t iter = UINT64_C(0); iter < (*target)->chunkCount; ++iter)
+            {
+                safe_free(&(*target)->chunks[iter]);
+            }
+            safe_free_core(M_REINTERPRET_CAST(void**, &(*target)->chunks));
+        }
+        if ((*target)->backingFile != M_NULLPTR)
+        {
+            M_STATIC_CAST(void, secure_Close_File((*target)->backingFile));
+            free_Secure_File_Info(&(*target)->backingFile);
+        }
+        safe_free_core(M_REINTERPRET_CAST(void**, &(*target)->zones));
+        safe_free_core(M_REINTERPRET_CAST(void**, target));
+    }
+}
+
+static eReturnValues create_Emulated_Backing(emulatedTarget* target, const emulatedTargetConfig* config)
+{
+    if (config->backing == EMULATED_TARGET_BACKING_SPARSE_FILE)
+    {
+        size_t  bytesWritten = SIZE_T_C(0);
+        uint8_t lastByte     = UINT8_C(0);
+        if (config->backingFileName == M_NULLPTR)
+        {
+            return BAD_PARAMETER;
+        }
+        target->backingFile = secure_Open_File(config->backingFileName, "w+b", M_NULLPTR, M_NULLPTR, M_NULLPTR);
+        if (target->backingFile == M_NULLPTR || target->backingFile->error != SEC_FILE_SUCCESS)
+        {
+            return FILE_OPEN_ERROR;
+        }
+        // writing the last byte sets the size without allocating anything before it
+        if (SEC_FILE_SUCCESS !=
+                secure_Seek_File(target->backingFile, C_CAST(int64_t, target->mediaSize - 1), SEEK_SET) ||
+            SEC_FILE_SUCCESS != secure_Write_File(target->backingFile, &lastByte, sizeof(lastByte), sizeof(uint8_t),
+                                                  sizeof(lastByte), &bytesWritten))
+        {
+            return ERROR_WRITING_FILE;
+        }
+        return SUCCESS;
+    }
+    target->chunkCount = (target->mediaSize + EMULATED_STORE_CHUNK_SIZE - 1) / EMULATED_STORE_CHUNK_SIZE;
+    target->chunks =
+        M_REINTERPRET_CAST(uint8_t**, safe_calloc(C_CAST(size_t, target->chunkCount), sizeof(uint8_t*)));
+    return target->chunks == M_NULLPTR ? MEMORY_FAILURE : SUCCESS;
+}
+
+static eReturnValues create_Emulated_Target(const emulatedTargetConfig* config, emulatedTarget** newTarget)
+{
+    eReturnValues   ret    = SUCCESS;
+    emulatedTarget* target = M_NULLPTR;
+    uint32_t        namespaces = config->type == EMULATED_TARGET_NVME_CONTROLLER ? config->namespaceCount : 1;
+    uint64_t        capacity   = config->capacity;
+    if ((config->logicalBlockSize != 512 && config->logicalBlockSize != 4096) || namespaces == 0 ||
+        namespaces > EMULATED_TARGET_MAX_NAMESPACES)
+    {
+        return BAD_PARAMETER;
+    }
+    if (config->zoneSize > 0)
+    {
+        if (config->type == EMULATED_TARGET_NVME_CONTROLLER || capacity / config->zoneSize > UINT32_MAX)
+        {
+            return BAD_PARAMETER;
+        }
+        capacity -= capacity % config->zoneSize;
+    }
+    if (capacity == 0 || capacity > MAX_48_BIT_LBA || capacity > (UINT64_MAX / config->logicalBlockSize) / namespaces)
+    {
+        return BAD_PARAMETER;
+    }
+    target = M_REINTERPRET_CAST(emulatedTarget*, safe_calloc(1, sizeof(emulatedTarget)));
+    if (target == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    target->type                             = config->type;
+    target->logicalBlockSize                 = config->logicalBlockSize;
+    target->capacity                         = capacity;
+    target->namespaceCount                   = namespaces;
+    target->latencyNS[EMULATED_LATENCY_READ]  = config->readLatencyNS;
+    target->latencyNS[EMULATED_LATENCY_WRITE] = config->writeLatencyNS;
+    target->latencyNS[EMULATED_LATENCY_OTHER] = config->otherLatencyNS;
+    target->mediaSize                        = capacity * config->logicalBlockSize * namespaces;
+    target->writeCacheEnabled                = true;
+    // NAA 5 with the IEEE company ID left 0. Deterministic so emulated runs can be compared.
+    target->wwn = UINT64_C(0x5000000000000000) | (C_CAST(uint64_t, config->type) << 48) | (capacity & UINT32_MAX);
+    snprintf_err_handle(target->serialNumber, SERIAL_NUM_LEN + 1, "EMU%u%016" PRIX64,
+                        C_CAST(unsigned int, config->type), target->wwn);
+    start_Timer(&target->powerOnTimer);
+    if (config->zoneSize > 0)
+    {
+        target->zoneSize  = config->zoneSize;
+        target->zoneCount = C_CAST(uint32_t, capacity / config->zoneSize);
+        target->zones     = M_REINTERPRET_CAST(emulatedZone*, safe_calloc(target->zoneCount, sizeof(emulatedZone)));
+        if (target->zones == M_NULLPTR)
+        {
+            free_Emulated_Target(&target);
+            return MEMORY_FAILURE;
+        }
+        for (uint32_t iter = UINT32_C(0); iter < target->zoneCount; ++iter)
+        {
+            target->zones[iter].start        = C_CAST(uint64_t, iter) * config->zoneSize;
+            target->zones[iter].writePointer = target->zones[iter].start;
+            if (iter < config->conventionalZones)
+            {
+                target->zones[iter].type      = EMULATED_ZONE_TYPE_CONVENTIONAL;
+                target->zones[iter].condition = EMULATED_ZONE_COND_NOT_WP;
+            }
+            else
+            {
+                target->zones[iter].type      = EMULATED_ZONE_TYPE_SEQ_REQUIRED;
+                target->zones[iter].condition = EMULATED_ZONE_COND_EMPTY;
+            }
+        }
+    }
+    ret = create_Emulated_Backing(target, config);
+    if (ret != SUCCESS)
+    {
+        free_Emulated_Target(&target);
+        return ret;
+    }
+    if (config->type == EMULATED_TARGET_SATA_DISK)
+    {
+        fill_Emulated_ATA_Identify(target);
+    }
+    *newTarget = target;
+    return SUCCESS;
+}
+
+M_PARAM_WO(1)
+OPENSEA_TRANSPORT_API void get_Default_Emulated_Target_Config(emulatedTargetConfig* M_NONNULL config,
+                                                              eEmulatedTargetType             type)
+{
+    safe_memset(config, sizeof(emulatedTargetConfig), 0, sizeof(emulatedTargetConfig));
+    config->type             = type;
+    config->backing          = EMULATED_TARGET_BACKING_MEMORY;
+    config->capacity         = EMULATED_TARGET_DEFAULT_CAPACITY;
+    config->logicalBlockSize = type == EMULATED_TARGET_NVME_CONTROLLER ? 4096 : 512;
+    config->namespaceCount   = 1;
+}
+
+M_PARAM_RW(1)
+M_PARAM_RO(2)
+OPENSEA_TRANSPORT_API eReturnValues open_Emulated_Device(tDevice* M_NONNULL                   device,
+                                                         const emulatedTargetConfig* M_NONNULL config)
+{
+    eReturnValues   ret    = SUCCESS;
+    emulatedTarget* target = M_NULLPTR;
+    if (!validate_Device_Struct(device->sanity))
+    {
+        return LIBRARY_MISMATCH;
+    }
+    ret = create_Emulated_Target(config, &target);
+    if (ret != SUCCESS)
+    {
+        return ret;
+    }
+    device->raid_device = target;
+    device->issue_io    = emulated_Target_Issue_IO;
+    set_Device_InterfaceType(device, RAID_INTERFACE);
+    set_Device_IO_Minimum_Alignment(device, sizeof(void*));
+    switch (config->type)
+    {
+    case EMULATED_TARGET_SAS_DISK:
+        set_Device_DriveType(device, SCSI_DRIVE);
+        set_Device_Handle_Name(device, "emulated:sas");
+        set_Device_Handle_Friendly_Name(device, "emulated:sas");
+        break;
+    case EMULATED_TARGET_SATA_DISK:
+        set_Device_DriveType(device, ATA_DRIVE);
+        set_Device_Handle_Name(device, "emulated:sata");
+        set_Device_Handle_Friendly_Name(device, "emulated:sata");
+        break;
+    case EMULATED_TARGET_NVME_CONTROLLER:
+        set_Device_DriveType(device, NVME_DRIVE);
+        set_Device_Handle_Name(device, "emulated:nvme");
+        set_Device_Handle_Friendly_Name(device, "emulated:nvme");
+        device->issue_nvme_io                                = emulated_Target_Issue_NVMe_IO;
+        device->drive_info.namespaceID                       = 1;
+        device->drive_info.passThroughHacks.passthroughType = NVME_PASSTHROUGH_SYSTEM;
+        break;
+    }
+    ret = fill_Drive_Info_Data(device);
+    if (ret != SUCCESS)
+    {
+        release_Device_Resources(device);
+        device->issue_io      = M_NULLPTR;
+        device->issue_nvme_io = M_NULLPTR;
+        device->raid_device   = M_NULLPTR;
+        free_Emulated_Target(&target);
+    }
+    return ret;
+}
+
+M_PARAM_RO(1) OPENSEA_TRANSPORT_API bool is_Emulated_Device(const tDevice* M_NONNULL device)
+{
+    return device->issue_io == emulated_Target_Issue_IO && device->raid_device != M_NULLPTR;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Emulated_Device(tDevice* M_NONNULL device)
+{
+    emulatedTarget* target = M_NULLPTR;
+    if (!is_Emulated_Device(device))
+    {
+        return BAD_PARAMETER;
+    }
+    release_Device_Resources(device);
+    target                = get_Emulated_Target(device);
+    device->issue_io      = M_NULLPTR;
+    device->issue_nvme_io = M_NULLPTR;
+    device->raid_device   = M_NULLPTR;
+    free_Emulated_Target(&target);
+    return SUCCESS;
+}
+
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+M_PARAM_WO(3)
+OPENSEA_TRANSPORT_API eReturnValues get_Emulated_Device_Command_Totals(const tDevice* M_NONNULL device,
+                                                                       uint64_t* M_NONNULL       commands,
+                                                                       uint64_t* M_NONNULL       totalTimeNS)
+{
+    const emulatedTarget* target = M_NULLPTR;
+    if (!is_Emulated_Device(device))
+    {
+        return BAD_PARAMETER;
+    }
+    target       = get_Emulated_Target(device);
+    *commands    = target->commandsCompleted;
+    *totalTimeNS = target->totalCommandTimeNS;
+    return SUCCESS;
+}
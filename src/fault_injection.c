@@ -0,0 +1,601 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file fault_injection.c
+// \brief Implements injection of latency and failures in place of the OS passthrough, for exercising and timing the
+// library's retry, timeout, and fallback paths
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "sleep.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "fault_injection.h"
+
+#define FAULT_INJECTION_DEFAULT_SEED UINT64_C(0x9E3779B97F4A7C15)
+#define FAULT_INJECTION_SENSE_LENGTH (22) // descriptor sense header and an ATA status return descriptor
+
+struct s_faultInjectionContext
+{
+    uint64_t            prngState;
+    uint32_t            ruleCount;
+    uint32_t            matches[FAULT_INJECTION_MAX_RULES]; // matching commands seen by each rule, for skipCount
+    faultInjectionRule  rules[FAULT_INJECTION_MAX_RULES];
+    faultInjectionStats stats;
+};
+
+// xorshift64*. Kept per device rather than using the shared generator so a seed always gives the same faults.
+static uint64_t next_Fault_Injection_Random(ptrFaultInjectionContext context)
+{
+    uint64_t value = context->prngState;
+    value ^= value >> 12;
+    value ^= value << 25;
+    value ^= value >> 27;
+    context->prngState = value;
+    return value * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+static bool roll_Fault_Injection_PPM(ptrFaultInjectionContext context, uint32_t probabilityPPM)
+{
+    if (probabilityPPM == UINT32_C(0) || probabilityPPM >= FAULT_INJECTION_PROBABILITY_MAX)
+    {
+        return true;
+    }
+    return (next_Fault_Injection_Random(context) % FAULT_INJECTION_PROBABILITY_MAX) < probabilityPPM;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues start_Fault_Injection(tDevice* M_NONNULL device, uint64_t seed)
+{
+    ptrFaultInjectionContext context = device->drive_info.faultInjection;
+    if (context == M_NULLPTR)
+    {
+        context = M_REINTERPRET_CAST(ptrFaultInjectionContext, safe_calloc(1, sizeof(faultInjectionContext)));
+        if (context == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+    }
+    else
+    {
+        safe_memset(context, sizeof(faultInjectionContext), 0, sizeof(faultInjectionContext));
+    }
+    // xorshift never leaves a state of zero
+    context->prngState                = seed == UINT64_C(0) ? FAULT_INJECTION_DEFAULT_SEED : seed;
+    device->drive_info.faultInjection = context;
+    return SUCCESS;
+}
+
+static bool is_Valid_Fault_Injection_Rule(const faultInjectionRule* rule)
+{
+    if (rule->commandType == FAULT_INJECTION_ANY_COMMAND && (rule->matchOpcode || rule->matchLBA))
+    {
+        return false;
+    }
+    if (rule->matchLBA && rule->lastLBA < rule->firstLBA)
+    {
+        return false;
+    }
+    if (rule->latency != FAULT_INJECTION_NO_LATENCY && rule->latency != FAULT_INJECTION_FIXED_LATENCY &&
+        rule->latencyMaxNS < rule->latencyMinNS)
+    {
+        return false;
+    }
+    switch (rule->action)
+    {
+    case FAULT_INJECTION_ATA_STATUS:
+        return rule->commandType == FAULT_INJECTION_ATA;
+    case FAULT_INJECTION_NVME_STATUS:
+        return rule->commandType == FAULT_INJECTION_NVME_ADMIN || rule->commandType == FAULT_INJECTION_NVME_NVM;
+    case FAULT_INJECTION_SENSE_DATA:
+        return rule->commandType != FAULT_INJECTION_NVME_ADMIN && rule->commandType != FAULT_INJECTION_NVME_NVM;
+    case FAULT_INJECTION_LATENCY_ONLY:
+    case FAULT_INJECTION_TIMEOUT:
+    case FAULT_INJECTION_TRANSPORT_ERROR:
+        return true;
+    }
+    return false;
+}
+
+M_PARAM_RW(1)
+M_PARAM_RO(2)
+OPENSEA_TRANSPORT_API eReturnValues add_Fault_Injection_Rule(tDevice* M_NONNULL                  device,
+                                                             const faultInjectionRule* M_NONNULL rule)
+{
+    ptrFaultInjectionContext context = device->drive_info.faultInjection;
+    faultInjectionRule*      added   = M_NULLPTR;
+    if (context == M_NULLPTR)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (context->ruleCount >= FAULT_INJECTION_MAX_RULES || !is_Valid_Fault_Injection_Rule(rule))
+    {
+        return BAD_PARAMETER;
+    }
+    added = &context->rules[context->ruleCount];
+    safe_memcpy(added, sizeof(faultInjectionRule), rule, sizeof(faultInjectionRule));
+    if (added->action == FAULT_INJECTION_TRANSPORT_ERROR && added->transportError == SUCCESS)
+    {
+        added->transportError = OS_PASSTHROUGH_FAILURE;
+    }
+    context->matches[context->ruleCount] = UINT32_C(0);
+    ++context->ruleCount;
+    return SUCCESS;
+}
+
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+OPENSEA_TRANSPORT_API eReturnValues get_Fault_Injection_Stats(const tDevice* M_NONNULL      device,
+                                                              faultInjectionStats* M_NONNULL stats)
+{
+    if (device->drive_info.faultInjection == M_NULLPTR)
+    {
+        return NOT_SUPPORTED;
+    }
+    safe_memcpy(stats, sizeof(faultInjectionStats), &device->drive_info.faultInjection->stats,
+                sizeof(faultInjectionStats));
+    return SUCCESS;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API void stop_Fault_Injection(tDevice* M_NONNULL device)
+{
+    safe_free_core(M_REINTERPRET_CAST(void**, &device->drive_info.faultInjection));
+}
+
+//
+// Matching
+//
+
+// What the command layer knows about a command before it is sent. hasLBA is false for commands without an LBA range
+// and for ones the range cannot be read from.
+typedef struct s_faultInjectionCommand
+{
+    eFaultInjectionCommandType commandType;
+    uint8_t                    opcode;
+    bool                       hasLBA;
+    uint64_t                   lba;
+    uint64_t                   count;
+} faultInjectionCommand;
+
+// Sense data can only be returned for SCSI and ATA passthrough commands, ATA status only for ATA commands and NVMe
+// status only for NVMe commands. An any command rule never applies its action to a command that cannot report it.
+static bool can_Fault_Injection_Action_Apply(eFaultInjectionAction action, eFaultInjectionCommandType commandType)
+{
+    bool nvmeCommand = commandType == FAULT_INJECTION_NVME_ADMIN || commandType == FAULT_INJECTION_NVME_NVM;
+    switch (action)
+    {
+    case FAULT_INJECTION_SENSE_DATA:
+        return !nvmeCommand;
+    case FAULT_INJECTION_ATA_STATUS:
+        return commandType == FAULT_INJECTION_ATA;
+    case FAULT_INJECTION_NVME_STATUS:
+        return nvmeCommand;
+    case FAULT_INJECTION_LATENCY_ONLY:
+    case FAULT_INJECTION_TIMEOUT:
+    case FAULT_INJECTION_TRANSPORT_ERROR:
+        return true;
+    }
+    return false;
+}
+
+static bool does_Fault_Injection_Rule_Match(const faultInjectionRule* rule, const faultInjectionCommand* command)
+{
+    if (rule->commandType != FAULT_INJECTION_ANY_COMMAND && rule->commandType != command->commandType)
+    {
+        return false;
+    }
+    if (!can_Fault_Injection_Action_Apply(rule->action, command->commandType))
+    {
+        return false;
+    }
+    if (rule->matchOpcode && rule->opcode != command->opcode)
+    {
+        return false;
+    }
+    if (rule->matchLBA)
+    {
+        // a count of zero still touches the starting LBA as far as matching is concerned
+        uint64_t lastLBA = command->lba + (command->count > UINT64_C(0) ? command->count - UINT64_C(1) : UINT64_C(0));
+        if (!command->hasLBA || lastLBA < rule->firstLBA || command->lba > rule->lastLBA)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds the first rule that applies to this command and counts it. Returns M_NULLPTR when the command is sent as is.
+static const faultInjectionRule* find_Fault_Injection_Rule(ptrFaultInjectionContext     context,
+                                                           const faultInjectionCommand* command)
+{
+    ++context->stats.commandsChecked;
+    for (uint32_t iter = UINT32_C(0); iter < context->ruleCount; ++iter)
+    {
+        const faultInjectionRule* rule = &context->rules[iter];
+        if (!does_Fault_Injection_Rule_Match(rule, command))
+        {
+            continue;
+        }
+        if (context->matches[iter] < UINT32_MAX)
+        {
+            ++context->matches[iter];
+        }
+        if (context->matches[iter] <= rule->skipCount)
+        {
+            continue;
+        }
+        if (rule->maxInjections > UINT32_C(0) && context->stats.ruleInjections[iter] >= rule->maxInjections)
+        {
+            continue;
+        }
+        if (!roll_Fault_Injection_PPM(context, rule->probabilityPPM))
+        {
+            continue;
+        }
+        ++context->stats.ruleInjections[iter];
+        return rule;
+    }
+    return M_NULLPTR;
+}
+
+static void get_SCSI_Fault_Injection_Command(const ScsiIoCtx* scsiIoCtx, faultInjectionCommand* command)
+{
+    const uint8_t* cdb = scsiIoCtx->cdb;
+    safe_memset(command, sizeof(faultInjectionCommand), 0, sizeof(faultInjectionCommand));
+    if (scsiIoCtx->pAtaCmdOpts != M_NULLPTR)
+    {
+        const ataTFRBlock* tfr = &scsiIoCtx->pAtaCmdOpts->tfr;
+        bool               ext = scsiIoCtx->pAtaCmdOpts->commandType >= ATA_CMD_TYPE_EXTENDED_TASKFILE;
+        command->commandType   = FAULT_INJECTION_ATA;
+        command->opcode        = tfr->CommandStatus;
+        switch (tfr->CommandStatus)
+        {
+        case ATA_READ_SECT:
+        case ATA_READ_SECT_EXT:
+        case ATA_READ_DMA_EXT:
+        case ATA_WRITE_SECT:
+        case ATA_WRITE_SECT_EXT:
+        case ATA_WRITE_DMA_EXT:
+        case ATA_WRITE_DMA_FUA_EXT:
+        case ATA_READ_VERIFY_RETRY:
+        case ATA_READ_VERIFY_NORETRY:
+        case ATA_READ_VERIFY_EXT:
+        case ATA_READ_DMA_RETRY_CMD:
+        case ATA_WRITE_DMA_RETRY_CMD:
+        case ATA_READ_FPDMA_QUEUED_CMD:
+        case ATA_WRITE_FPDMA_QUEUED_CMD:
+            command->hasLBA = true;
+            if (ext)
+            {
+                command->lba = M_BytesTo8ByteValue(0, 0, tfr->LbaHi48, tfr->LbaMid48, tfr->LbaLow48, tfr->LbaHi,
+                                                   tfr->LbaMid, tfr->LbaLow);
+            }
+            else
+            {
+                command->lba = M_BytesTo4ByteValue(M_Nibble0(tfr->DeviceHead), tfr->LbaHi, tfr->LbaMid, tfr->LbaLow);
+            }
+            // queued commands carry the count in the feature registers
+            if (tfr->CommandStatus == ATA_READ_FPDMA_QUEUED_CMD || tfr->CommandStatus == ATA_WRITE_FPDMA_QUEUED_CMD)
+            {
+                command->count = M_BytesTo2ByteValue(tfr->Feature48, tfr->ErrorFeature);
+            }
+            else
+            {
+                command->count = ext ? M_BytesTo2ByteValue(tfr->SectorCount48, tfr->SectorCount) : tfr->SectorCount;
+            }
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+    command->commandType = FAULT_INJECTION_SCSI;
+    command->opcode      = cdb[OPERATION_CODE];
+    switch (cdb[OPERATION_CODE])
+    {
+    case READ6:
+    case WRITE6:
+        command->hasLBA = true;
+        command->lba    = M_BytesTo4ByteValue(0, get_bit_range_uint8(cdb[1], 4, 0), cdb[2], cdb[3]);
+        command->count  = cdb[4];
+        break;
+    case READ10:
+    case WRITE10:
+    case VERIFY10:
+    case WRITE_AND_VERIFY_10:
+    case WRITE_SAME_10_CMD:
+        command->hasLBA = true;
+        command->lba    = M_BytesTo4ByteValue(cdb[2], cdb[3], cdb[4], cdb[5]);
+        command->count  = M_BytesTo2ByteValue(cdb[7], cdb[8]);
+        break;
+    case READ12:
+    case WRITE12:
+    case VERIFY12:
+    case WRITE_AND_VERIFY_12:
+        command->hasLBA = true;
+        command->lba    = M_BytesTo4ByteValue(cdb[2], cdb[3], cdb[4], cdb[5]);
+        command->count  = M_BytesTo4ByteValue(cdb[6], cdb[7], cdb[8], cdb[9]);
+        break;
+    case READ16:
+    case WRITE16:
+    case VERIFY16:
+    case WRITE_AND_VERIFY_16:
+    case WRITE_SAME_16_CMD:
+        command->hasLBA = true;
+        command->lba    = M_BytesTo8ByteValue(cdb[2], cdb[3], cdb[4], cdb[5], cdb[6], cdb[7], cdb[8], cdb[9]);
+        command->count  = M_BytesTo4ByteValue(cdb[10], cdb[11], cdb[12], cdb[13]);
+        break;
+    default:
+        break;
+    }
+}
+
+static void get_NVMe_Fault_Injection_Command(const nvmeCmdCtx* cmdCtx, faultInjectionCommand* command)
+{
+    safe_memset(command, sizeof(faultInjectionCommand), 0, sizeof(faultInjectionCommand));
+    if (cmdCtx->commandType == NVM_ADMIN_CMD)
+    {
+        command->commandType = FAULT_INJECTION_NVME_ADMIN;
+        command->opcode      = cmdCtx->cmd.adminCmd.opcode;
+        return;
+    }
+    command->commandType = FAULT_INJECTION_NVME_NVM;
+    command->opcode      = cmdCtx->cmd.nvmCmd.opcode;
+    switch (command->opcode)
+    {
+    case NVME_CMD_WRITE:
+    case NVME_CMD_READ:
+    case NVME_CMD_WRITE_UNCOR:
+    case NVME_CMD_COMPARE:
+    case NVME_CMD_WRITE_ZEROS:
+    case NVME_CMD_VERIFY:
+        command->hasLBA = true;
+        command->lba    = M_DWordsTo8ByteValue(cmdCtx->cmd.dwords.cdw11, cmdCtx->cmd.dwords.cdw10);
+        command->count  = C_CAST(uint64_t, M_Word0(cmdCtx->cmd.dwords.cdw12)) + UINT64_C(1); // 0's based
+        break;
+    default:
+        break;
+    }
+}
+
+//
+// Injection
+//
+
+// Sleeps for most of the time, then spins so short latencies are still accurate
+static void wait_Fault_Injection_NS(uint64_t waitNS)
+{
+    DECLARE_SEATIMER(waitTimer);
+    start_Timer(&waitTimer);
+    for (;;)
+    {
+        uint64_t elapsedNS = UINT64_C(0);
+        seatimer elapsed   = waitTimer;
+        stop_Timer(&elapsed);
+        elapsedNS = get_Nano_Seconds(elapsed);
+        if (elapsedNS >= waitNS)
+        {
+            break;
+        }
+        if (waitNS - elapsedNS > UINT64_C(2000000))
+        {
+            delay_Milliseconds(C_CAST(uint32_t, M_Min(((waitNS - elapsedNS) / UINT64_C(1000000)) - 1, UINT32_MAX)));
+        }
+    }
+}
+
+static uint64_t get_Fault_Injection_Latency_NS(ptrFaultInjectionContext context, const faultInjectionRule* rule)
+{
+    switch (rule->latency)
+    {
+    case FAULT_INJECTION_NO_LATENCY:
+        break;
+    case FAULT_INJECTION_FIXED_LATENCY:
+        return rule->latencyMinNS;
+    case FAULT_INJECTION_UNIFORM_LATENCY:
+    {
+        uint64_t range = rule->latencyMaxNS - rule->latencyMinNS;
+        if (range == UINT64_C(0))
+        {
+            return rule->latencyMinNS;
+        }
+        if (range == UINT64_MAX)
+        {
+            return next_Fault_Injection_Random(context);
+        }
+        return rule->latencyMinNS + (next_Fault_Injection_Random(context) % (range + UINT64_C(1)));
+    }
+    case FAULT_INJECTION_TAIL_LATENCY:
+        return (rule->latencyTailPPM > UINT32_C(0) && roll_Fault_Injection_PPM(context, rule->latencyTailPPM))
+                   ? rule->latencyMaxNS
+                   : rule->latencyMinNS;
+    }
+    return UINT64_C(0);
+}
+
+// Applies the latency of the rule. Returns the time waited.
+static uint64_t apply_Fault_Injection_Latency(ptrFaultInjectionContext context, const faultInjectionRule* rule)
+{
+    uint64_t latencyNS = get_Fault_Injection_Latency_NS(context, rule);
+    if (latencyNS > UINT64_C(0))
+    {
+        wait_Fault_Injection_NS(latencyNS);
+        ++context->stats.commandsDelayed;
+        context->stats.injectedLatencyNS += latencyNS;
+    }
+    return latencyNS;
+}
+
+// Waits out an injected timeout and sets the command time so the command layers see it as timed out.
+static void apply_Fault_Injection_Timeout(ptrFaultInjectionContext  context,
+                                          const faultInjectionRule* rule,
+                                          tDevice*                  device,
+                                          uint32_t                  commandTimeoutSeconds,
+                                          uint64_t                  latencyNS)
+{
+    uint32_t timeoutSeconds = M_Max(commandTimeoutSeconds, get_tDevice_Default_Command_Timeout(device));
+    uint64_t waitNS         = C_CAST(uint64_t, timeoutSeconds) * UINT64_C(1000000000);
+    if (rule->timeoutWaitMS > UINT32_C(0))
+    {
+        waitNS = C_CAST(uint64_t, rule->timeoutWaitMS) * UINT64_C(1000000);
+    }
+    wait_Fault_Injection_NS(waitNS);
+    context->stats.injectedTimeoutNS += waitNS;
+    // report one second past the timeout no matter how long was actually waited
+    set_tDevice_Last_Command_Completion_Time_NS(
+        device, latencyNS + (C_CAST(uint64_t, timeoutSeconds) + UINT64_C(1)) * UINT64_C(1000000000));
+}
+
+static void set_Fault_Injection_Sense_Data(ScsiIoCtx* scsiIoCtx, const faultInjectionRule* rule)
+{
+    DECLARE_ZERO_INIT_ARRAY(uint8_t, sense, FAULT_INJECTION_SENSE_LENGTH);
+    uint32_t senseLength = UINT32_C(18);
+    if (rule->action == FAULT_INJECTION_ATA_STATUS)
+    {
+        // Descriptor format with an ATA status return descriptor, as a SAT translator returns for an ATA error
+        sense[0]                         = SCSI_SENSE_CUR_INFO_DESC;
+        sense[1]                         = SENSE_KEY_ABORTED_COMMAND;
+        sense[2]                         = UINT8_C(0x00);
+        sense[3]                         = UINT8_C(0x1D); // ATA pass through information available
+        sense[7]                         = UINT8_C(14);
+        sense[8]                         = UINT8_C(0x09);
+        sense[9]                         = UINT8_C(0x0C);
+        sense[11]                        = rule->ataError;
+        sense[21]                        = rule->ataStatus;
+        senseLength                      = FAULT_INJECTION_SENSE_LENGTH;
+        scsiIoCtx->returnStatus.format   = SCSI_SENSE_CUR_INFO_DESC;
+        scsiIoCtx->returnStatus.senseKey = SENSE_KEY_ABORTED_COMMAND;
+        scsiIoCtx->returnStatus.asc      = UINT8_C(0x00);
+        scsiIoCtx->returnStatus.ascq     = UINT8_C(0x1D);
+        // passthroughs that do not go through SAT hand back the registers directly
+        safe_memset(&scsiIoCtx->pAtaCmdOpts->rtfr, sizeof(ataReturnTFRs), 0, sizeof(ataReturnTFRs));
+        scsiIoCtx->pAtaCmdOpts->rtfr.error  = rule->ataError;
+        scsiIoCtx->pAtaCmdOpts->rtfr.status = rule->ataStatus;
+    }
+    else
+    {
+        sense[0]                         = SCSI_SENSE_CUR_INFO_FIXED;
+        sense[2]                         = M_Nibble0(rule->senseKey);
+        sense[7]                         = UINT8_C(10);
+        sense[12]                        = rule->asc;
+        sense[13]                        = rule->ascq;
+        scsiIoCtx->returnStatus.format   = SCSI_SENSE_CUR_INFO_FIXED;
+        scsiIoCtx->returnStatus.senseKey = M_Nibble0(rule->senseKey);
+        scsiIoCtx->returnStatus.asc      = rule->asc;
+        scsiIoCtx->returnStatus.ascq     = rule->ascq;
+    }
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+    {
+        safe_memset(scsiIoCtx->psense, scsiIoCtx->senseDataSize, 0, scsiIoCtx->senseDataSize);
+        safe_memcpy(scsiIoCtx->psense, scsiIoCtx->senseDataSize, sense, M_Min(scsiIoCtx->senseDataSize, senseLength));
+    }
+}
+
+M_PARAM_RW(1) M_PARAM_WO(2) bool inject_SCSI_Fault(ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues* M_NONNULL result)
+{
+    ptrFaultInjectionContext  context   = scsiIoCtx->device->drive_info.faultInjection;
+    const faultInjectionRule* rule      = M_NULLPTR;
+    uint64_t                  latencyNS = UINT64_C(0);
+    faultInjectionCommand     command;
+    if (context == M_NULLPTR)
+    {
+        return false;
+    }
+    get_SCSI_Fault_Injection_Command(scsiIoCtx, &command);
+    rule = find_Fault_Injection_Rule(context, &command);
+    if (rule == M_NULLPTR)
+    {
+        return false;
+    }
+    latencyNS = apply_Fault_Injection_Latency(context, rule);
+    if (rule->action == FAULT_INJECTION_LATENCY_ONLY)
+    {
+        return false;
+    }
+    ++context->stats.commandsFailed;
+    safe_memset(&scsiIoCtx->returnStatus, sizeof(scsiStatus), 0, sizeof(scsiStatus));
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0))
+    {
+        safe_memset(scsiIoCtx->psense, scsiIoCtx->senseDataSize, 0, scsiIoCtx->senseDataSize);
+    }
+    set_tDevice_Last_Command_Completion_Time_NS(scsiIoCtx->device, latencyNS);
+    switch (rule->action)
+    {
+    case FAULT_INJECTION_TIMEOUT:
+        apply_Fault_Injection_Timeout(context, rule, scsiIoCtx->device, scsiIoCtx->timeout, latencyNS);
+        *result = OS_COMMAND_TIMEOUT;
+        break;
+    case FAULT_INJECTION_SENSE_DATA:
+    case FAULT_INJECTION_ATA_STATUS:
+        set_Fault_Injection_Sense_Data(scsiIoCtx, rule);
+        *result = SUCCESS;
+        break;
+    case FAULT_INJECTION_TRANSPORT_ERROR:
+    case FAULT_INJECTION_LATENCY_ONLY:
+    case FAULT_INJECTION_NVME_STATUS:
+        *result = rule->transportError;
+        break;
+    }
+    return true;
+}
+
+M_PARAM_RW(1) M_PARAM_WO(2) bool inject_NVMe_Fault(nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues* M_NONNULL result)
+{
+    ptrFaultInjectionContext  context   = cmdCtx->device->drive_info.faultInjection;
+    const faultInjectionRule* rule      = M_NULLPTR;
+    uint64_t                  latencyNS = UINT64_C(0);
+    faultInjectionCommand     command;
+    if (context == M_NULLPTR)
+    {
+        return false;
+    }
+    get_NVMe_Fault_Injection_Command(cmdCtx, &command);
+    rule = find_Fault_Injection_Rule(context, &command);
+    if (rule == M_NULLPTR)
+    {
+        return false;
+    }
+    latencyNS = apply_Fault_Injection_Latency(context, rule);
+    if (rule->action == FAULT_INJECTION_LATENCY_ONLY)
+    {
+        return false;
+    }
+    ++context->stats.commandsFailed;
+    safe_memset(&cmdCtx->commandCompletionData, sizeof(completionQueueEntry), 0, sizeof(completionQueueEntry));
+    set_tDevice_Last_Command_Completion_Time_NS(cmdCtx->device, latencyNS);
+    switch (rule->action)
+    {
+    case FAULT_INJECTION_TIMEOUT:
+        apply_Fault_Injection_Timeout(context, rule, cmdCtx->device, cmdCtx->timeout, latencyNS);
+        *result = OS_COMMAND_TIMEOUT;
+        break;
+    case FAULT_INJECTION_NVME_STATUS:
+        cmdCtx->commandCompletionData.dw3 = (rule->nvmeDoNotRetry ? BIT31 : UINT32_C(0)) |
+                                            (C_CAST(uint32_t, rule->nvmeStatusCodeType & 0x07) << 25) |
+                                            (C_CAST(uint32_t, rule->nvmeStatusCode) << 17);
+        cmdCtx->commandCompletionData.dw0Valid = true;
+        cmdCtx->commandCompletionData.dw3Valid = true;
+        *result                                = SUCCESS;
+        break;
+    case FAULT_INJECTION_TRANSPORT_ERROR:
+    case FAULT_INJECTION_LATENCY_ONLY:
+    case FAULT_INJECTION_SENSE_DATA:
+    case FAULT_INJECTION_ATA_STATUS:
+        *result = rule->transportError;
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file firmware_download.c
+// \brief Implements downloading a whole firmware image in segments sized from what the device reports, sending each
+// segment straight from the caller's image
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "cmds.h"
+#include "firmware_download.h"
+#include "nvme_helper.h"
+#include "nvme_helper_func.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+
+// Largest segment sent, even when the device accepts more, so a single command never runs for too long
+#define FIRMWARE_DOWNLOAD_MAX_SEGMENT_BYTES UINT32_C(1048576)
+// Used when the device does not report any limit. This is the size most tools have always used.
+#define FIRMWARE_DOWNLOAD_DEFAULT_SEGMENT_BYTES UINT32_C(65536)
+// FWUG is in units of 4KiB
+#define FIRMWARE_DOWNLOAD_NVME_UNIT_BYTES UINT32_C(4096)
+#define FIRMWARE_DOWNLOAD_READ_BUFFER_DESCRIPTOR_LEN UINT32_C(4)
+
+static M_INLINE uint32_t min_Nonzero_Bytes(uint32_t bytes, uint32_t limitBytes)
+{
+    if (limitBytes > UINT32_C(0))
+    {
+        bytes = M_Min(bytes, limitBytes);
+    }
+    return bytes;
+}
+
+// Every segment but the last must be a multiple of this many bytes. Returns the largest segment in maxBytes.
+// Returns 0 with offsetZeroOnly set when the device only accepts the whole image in one command at offset 0. maxBytes
+// is then the largest image it accepts, or 0 when that is unknown.
+static uint32_t get_Firmware_Download_Granularity(const tDevice* device,
+                                                  uint8_t        slotNumber,
+                                                  uint32_t*      maxBytes,
+                                                  bool*          offsetZeroOnly)
+{
+    uint32_t granularity = UINT32_C(0);
+    *maxBytes            = FIRMWARE_DOWNLOAD_MAX_SEGMENT_BYTES;
+    *offsetZeroOnly      = false;
+    switch (get_Device_DriveType(device))
+    {
+    case ATA_DRIVE:
+    {
+        uint16_t minBlocks = le16_to_host(device->drive_info.IdentifyData.ata.Word234);
+        uint16_t maxBlocks = le16_to_host(device->drive_info.IdentifyData.ata.Word235);
+        granularity        = LEGACY_DRIVE_SEC_SIZE;
+        if (is_ATA_Identify_Word_Valid(maxBlocks))
+        {
+            *maxBytes = M_Min(*maxBytes, C_CAST(uint32_t, maxBlocks) * LEGACY_DRIVE_SEC_SIZE);
+        }
+        else
+        {
+            *maxBytes = FIRMWARE_DOWNLOAD_DEFAULT_SEGMENT_BYTES;
+        }
+        *maxBytes = min_Nonzero_Bytes(*maxBytes, device->drive_info.passThroughHacks.ataPTHacks.maxTransferLength);
+        if (is_ATA_Identify_Word_Valid(minBlocks))
+        {
+            // the device takes nothing smaller, even if the passthrough says it cannot send that much
+            *maxBytes = M_Max(*maxBytes, C_CAST(uint32_t, minBlocks) * LEGACY_DRIVE_SEC_SIZE);
+        }
+    }
+    break;
+    case NVME_DRIVE:
+    {
+        uint8_t fwug = device->drive_info.IdentifyData.nvme.ctrl.fwug;
+        if (fwug == UINT8_C(0xFF))
+        {
+            // no restriction beyond whole dwords
+            granularity = sizeof(uint32_t);
+        }
+        else if (fwug == UINT8_C(0))
+        {
+            // not reported
+            granularity = FIRMWARE_DOWNLOAD_NVME_UNIT_BYTES;
+        }
+        else
+        {
+            granularity = C_CAST(uint32_t, fwug) * FIRMWARE_DOWNLOAD_NVME_UNIT_BYTES;
+        }
+        *maxBytes = min_Nonzero_Bytes(*maxBytes, get_NVMe_MDTS_Bytes(device));
+        *maxBytes = min_Nonzero_Bytes(*maxBytes, device->drive_info.passThroughHacks.nvmePTHacks.maxTransferLength);
+    }
+    break;
+    case SCSI_DRIVE:
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, descriptor, FIRMWARE_DOWNLOAD_READ_BUFFER_DESCRIPTOR_LEN);
+        if (SUCCESS == scsi_Read_Buffer(device, SCSI_RB_DESCRIPTOR, slotNumber, 0,
+                                        FIRMWARE_DOWNLOAD_READ_BUFFER_DESCRIPTOR_LEN, descriptor))
+        {
+            uint32_t capacity = M_BytesTo4ByteValue(0, descriptor[1], descriptor[2], descriptor[3]);
+            if (descriptor[0] == UINT8_C(0xFF))
+            {
+                // only offset 0 is accepted, so the image can only be sent in one command. The segment size limit
+                // does not apply since there is no way to split it.
+                *offsetZeroOnly = true;
+                *maxBytes       = capacity;
+            }
+            else
+            {
+                granularity = UINT32_C(1) << M_Min(descriptor[0], UINT8_C(20));
+                *maxBytes   = min_Nonzero_Bytes(*maxBytes, capacity);
+            }
+        }
+        else
+        {
+            granularity = LEGACY_DRIVE_SEC_SIZE;
+            *maxBytes   = FIRMWARE_DOWNLOAD_DEFAULT_SEGMENT_BYTES;
+        }
+        *maxBytes = min_Nonzero_Bytes(*maxBytes, device->drive_info.passThroughHacks.scsiHacks.maxTransferLength);
+    }
+    break;
+    default:
+        break;
+    }
+    return granularity;
+}
+
+OPENSEA_TRANSPORT_API uint32_t get_Firmware_Download_Segment_Size(const tDevice* M_NONNULL device,
+                                                                  uint8_t                  slotNumber)
+{
+    uint32_t maxBytes       = UINT32_C(0);
+    bool     offsetZeroOnly = false;
+    uint32_t granularity    = get_Firmware_Download_Granularity(device, slotNumber, &maxBytes, &offsetZeroOnly);
+    if (granularity == UINT32_C(0))
+    {
+        return UINT32_C(0);
+    }
+    return M_Max(maxBytes / granularity, UINT32_C(1)) * granularity;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues firmware_Download_Image(const tDevice* M_NONNULL                 device,
+                                                            const firmwareDownloadOptions* M_NONNULL options,
+                                                            const uint8_t* M_NONNULL                 image,
+                                                            uint32_t                                 imageSize,
+                                                            firmwareDownloadResults* M_NULLABLE      results)
+{
+    eReturnValues           ret        = SUCCESS;
+    eDownloadMode           dlMode     = options->dlMode;
+    uint32_t                padding    = UINT32_C(1); // the last segment is padded to a multiple of this
+    size_t                  alignment  = get_Device_IO_Minimum_Alignment(device);
+    uint8_t*                bounce     = M_NULLPTR;
+    bool                    nvmeCommit = false;
+    firmwareDownloadResults localResults;
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(firmwareDownloadResults), 0, sizeof(firmwareDownloadResults));
+    if (image == M_NULLPTR || imageSize == UINT32_C(0) ||
+        (dlMode != DL_FW_SEGMENTED && dlMode != DL_FW_DEFERRED && dlMode != DL_FW_DEFERRED_SELECT_ACTIVATE))
+    {
+        return BAD_PARAMETER;
+    }
+    switch (get_Device_DriveType(device))
+    {
+    case ATA_DRIVE:
+        padding = LEGACY_DRIVE_SEC_SIZE;
+        if (imageSize > UINT32_C(65535) * LEGACY_DRIVE_SEC_SIZE)
+        {
+            // DOWNLOAD MICROCODE gives the offset in 16 bits of 512 byte blocks
+            return BAD_PARAMETER;
+        }
+        break;
+    case NVME_DRIVE:
+        padding = sizeof(uint32_t);
+        if (dlMode == DL_FW_SEGMENTED)
+        {
+            // NVMe has no download and activate in one. Download, then commit the image.
+            dlMode     = DL_FW_DEFERRED;
+            nvmeCommit = true;
+        }
+        break;
+    default:
+        break;
+    }
+    results->segmentSize = options->segmentSize;
+    if (results->segmentSize == UINT32_C(0))
+    {
+        uint32_t maxBytes       = UINT32_C(0);
+        bool     offsetZeroOnly = false;
+        uint32_t granularity =
+            get_Firmware_Download_Granularity(device, options->slotNumber, &maxBytes, &offsetZeroOnly);
+        if (offsetZeroOnly)
+        {
+            // the whole image in one command, when the device can hold it
+            uint64_t paddedSize = ((C_CAST(uint64_t, imageSize) + padding - UINT64_C(1)) / padding) * padding;
+            if (paddedSize <= UINT32_MAX && (maxBytes == UINT32_C(0) || paddedSize <= maxBytes))
+            {
+                results->segmentSize = C_CAST(uint32_t, paddedSize);
+            }
+        }
+        else if (granularity > UINT32_C(0))
+        {
+            results->segmentSize = M_Max(maxBytes / granularity, UINT32_C(1)) * granularity;
+        }
+    }
+    if (results->segmentSize == UINT32_C(0))
+    {
+        return NOT_SUPPORTED;
+    }
+    if (results->segmentSize % padding != UINT32_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    if (alignment == 0)
+    {
+        alignment = 1;
+    }
+    while (ret == SUCCESS && results->bytesSent < imageSize)
+    {
+        uint32_t       remaining   = imageSize - results->bytesSent;
+        uint32_t       xferLen     = M_Min(remaining, results->segmentSize);
+        bool           lastSegment = xferLen == remaining;
+        const uint8_t* segment     = image + results->bytesSent;
+        if (xferLen % padding != UINT32_C(0) || C_CAST(uintptr_t, segment) % alignment != 0)
+        {
+            // the segment cannot be sent as it is in the image
+            uint32_t paddedLen = ((xferLen + padding - UINT32_C(1)) / padding) * padding;
+            if (bounce == M_NULLPTR)
+            {
+                bounce = M_REINTERPRET_CAST(
+                    uint8_t*, safe_calloc_aligned(results->segmentSize, sizeof(uint8_t), alignment));
+                if (bounce == M_NULLPTR)
+                {
+                    ret = MEMORY_FAILURE;
+                    break;
+                }
+            }
+            safe_memset(bounce, results->segmentSize, 0, results->segmentSize);
+            safe_memcpy(bounce, results->segmentSize, segment, xferLen);
+            segment = bounce;
+            xferLen = paddedLen;
+            ++results->copiedSegments;
+        }
+        ret = firmware_Download_Command(device, dlMode, results->bytesSent, xferLen, M_CONST_CAST(uint8_t*, segment),
+                                        options->slotNumber, false, results->bytesSent == UINT32_C(0), lastSegment,
+                                        options->timeoutSeconds, false, 0, false);
+        ++results->segments;
+        if (ret != SUCCESS)
+        {
+            break;
+        }
+        results->bytesSent += M_Min(xferLen, remaining);
+        if (options->progressCallback != M_NULLPTR &&
+            !options->progressCallback(results->bytesSent, imageSize, options->callbackContext))
+        {
+            ret = ABORTED;
+        }
+    }
+    safe_free_aligned(&bounce);
+    if (ret == SUCCESS && nvmeCommit)
+    {
+        ret = firmware_Download_Activate(device, options->slotNumber, false, options->timeoutSeconds, false, 0, false);
+    }
+    return ret;
+}
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file flight_recorder.c
+// \brief Implements an always-on binary record of the most recent commands sent to a device
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "precision_timer.h"
+#include "type_conversion.h"
+
+#include "flight_recorder.h"
+
+struct s_flightRecorderContext
+{
+    seatimer             enabledTimer;  // started when enabled. Entry start times are relative to this
+    uint64_t             totalCommands; // also the sequence number of the next entry
+    uint32_t             ringSize;
+    uint32_t             nextEntry; // index the next command will be written to
+    flightRecorderEntry* entries;   // ringSize entries, allocated in the same block as this structure
+};
+
+M_PARAM_RW(1)
+OPENSEA_TRANSPORT_API eReturnValues enable_Flight_Recorder(tDevice* M_NONNULL device, uint32_t entries)
+{
+    ptrFlightRecorderContext context = M_NULLPTR;
+    if (entries == UINT32_C(0))
+    {
+        entries = FLIGHT_RECORDER_DEFAULT_ENTRIES;
+    }
+    if (entries > FLIGHT_RECORDER_MAX_ENTRIES)
+    {
+        return BAD_PARAMETER;
+    }
+    if (device->drive_info.flightRecorder != M_NULLPTR)
+    {
+        if (device->drive_info.flightRecorder->ringSize == entries)
+        {
+            return SUCCESS;
+        }
+        safe_free_flight_recorder(&device->drive_info.flightRecorder);
+    }
+    context = M_REINTERPRET_CAST(
+        ptrFlightRecorderContext,
+        safe_calloc(1, sizeof(flightRecorderContext) + (C_CAST(size_t, entries) * sizeof(flightRecorderEntry))));
+    if (context == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    context->ringSize = entries;
+    context->entries  = M_REINTERPRET_CAST(flightRecorderEntry*, context + 1);
+    start_Timer(&context->enabledTimer);
+    device->drive_info.flightRecorder = context;
+    return SUCCESS;
+}
+
+M_PARAM_RW(1) OPENSEA_TRANSPORT_API void disable_Flight_Recorder(tDevice* M_NONNULL device)
+{
+    safe_free_flight_recorder(&device->drive_info.flightRecorder);
+}
+
+static M_INLINE uint32_t get_Flight_Recorder_Entry_Count(const flightRecorderContext* context)
+{
+    return C_CAST(uint32_t, M_Min(context->totalCommands, C_CAST(uint64_t, context->ringSize)));
+}
+
+M_PARAM_RO(1) OPENSEA_TRANSPORT_API uint32_t get_Flight_Recorder_Data_Size(const tDevice* M_NONNULL device)
+{
+    uint32_t size = UINT32_C(0);
+    if (device->drive_info.flightRecorder != M_NULLPTR)
+    {
+        size = C_CAST(uint32_t, sizeof(flightRecorderHeader) +
+                                    (get_Flight_Recorder_Entry_Count(device->drive_info.flightRecorder) *
+                                     sizeof(flightRecorderEntry)));
+    }
+    return size;
+}
+
+M_PARAM_RO(1)
+M_PARAM_WO_SIZE(2, 3)
+OPENSEA_TRANSPORT_API eReturnValues get_Flight_Recorder_Data(const tDevice* M_NONNULL device,
+                                                             uint8_t* M_NONNULL       ptrData,
+                                                             uint32_t                 dataSize)
+{
+    const flightRecorderContext* context = device->drive_info.flightRecorder;
+    flightRecorderHeader         header;
+    uint32_t                     count       = UINT32_C(0);
+    uint32_t                     firstEntry  = UINT32_C(0);
+    uint32_t                     beforeWrap  = UINT32_C(0);
+    size_t                       entryOffset = sizeof(flightRecorderHeader);
+    if (context == M_NULLPTR)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (dataSize < sizeof(flightRecorderHeader))
+    {
+        return BAD_PARAMETER;
+    }
+    // return the newest entries that fit, still ordered oldest to newest
+    count = M_Min(get_Flight_Recorder_Entry_Count(context),
+                  C_CAST(uint32_t, (dataSize - sizeof(flightRecorderHeader)) / sizeof(flightRecorderEntry)));
+    firstEntry = (context->nextEntry + context->ringSize - count) % context->ringSize;
+    beforeWrap = M_Min(count, context->ringSize - firstEntry);
+
+    safe_memset(&header, sizeof(flightRecorderHeader), 0, sizeof(flightRecorderHeader));
+    safe_memcpy(header.signature, sizeof(header.signature), FLIGHT_RECORDER_SIGNATURE, sizeof(header.signature));
+    header.byteOrder     = FLIGHT_RECORDER_BYTE_ORDER;
+    header.version       = FLIGHT_RECORDER_VERSION;
+    header.headerSize    = C_CAST(uint32_t, sizeof(flightRecorderHeader));
+    header.entrySize     = C_CAST(uint32_t, sizeof(flightRecorderEntry));
+    header.entryCount    = count;
+    header.ringSize      = context->ringSize;
+    header.totalCommands = context->totalCommands;
+    safe_memset(ptrData, dataSize, 0, dataSize);
+    if (0 != safe_memcpy(ptrData, dataSize, &header, sizeof(flightRecorderHeader)))
+        M_UNLIKELY
+        {
+            return FAILURE;
+        }
+    if (beforeWrap > UINT32_C(0))
+    {
+        if (0 != safe_memcpy(ptrData + entryOffset, dataSize - entryOffset, &context->entries[firstEntry],
+                             beforeWrap * sizeof(flightRecorderEntry)))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        entryOffset += beforeWrap * sizeof(flightRecorderEntry);
+    }
+    if (count > beforeWrap)
+    {
+        if (0 != safe_memcpy(ptrData + entryOffset, dataSize - entryOffset, &context->entries[0],
+                             (count - beforeWrap) * sizeof(flightRecorderEntry)))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+    }
+    return SUCCESS;
+}
+
+// Claims the next slot in the ring and fills in everything common to all command types. The timer read here is the
+// only timing done. The start time is back calculated from the command time the OS layer already measured.
+static flightRecorderEntry* start_Flight_Recorder_Entry(const tDevice* M_NONNULL device,
+                                                        eFlightRecorderCommandType commandType,
+                                                        eDataTransferDirection     direction,
+                                                        uint32_t                   dataLength,
+                                                        eReturnValues              result)
+{
+    ptrFlightRecorderContext context = device->drive_info.flightRecorder;
+    flightRecorderEntry*     entry   = &context->entries[context->nextEntry];
+    seatimer                 now     = context->enabledTimer;
+    uint64_t                 nowNS   = UINT64_C(0);
+    stop_Timer(&now);
+    nowNS = get_Nano_Seconds(now);
+    safe_memset(entry, sizeof(flightRecorderEntry), 0, sizeof(flightRecorderEntry));
+    entry->sequence    = context->totalCommands;
+    entry->durationNS  = get_tDevice_Last_Command_Completion_Time_NS(device);
+    entry->startTimeNS = nowNS > entry->durationNS ? nowNS - entry->durationNS : UINT64_C(0);
+    entry->dataLength  = dataLength;
+    entry->result      = C_CAST(int32_t, result);
+    entry->commandType = C_CAST(uint8_t, commandType);
+    entry->direction   = C_CAST(uint8_t, direction);
+    ++context->totalCommands;
+    ++context->nextEntry;
+    if (context->nextEntry >= context->ringSize)
+    {
+        context->nextEntry = UINT32_C(0);
+    }
+    return entry;
+}
+
+M_PARAM_RO(1) void record_SCSI_Flight_Recorder_Entry(const ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues result)
+{
+    flightRecorderEntry* entry = M_NULLPTR;
+    if (scsiIoCtx->device->drive_info.flightRecorder == M_NULLPTR)
+    {
+        return;
+    }
+    entry = start_Flight_Recorder_Entry(scsiIoCtx->device, FLIGHT_RECORDER_CMD_SCSI, scsiIoCtx->direction,
+                                        scsiIoCtx->dataLength, result);
+    entry->commandLength = C_CAST(uint8_t, M_Min(scsiIoCtx->cdbLength, FLIGHT_RECORDER_COMMAND_LENGTH));
+    safe_memcpy(entry->command, FLIGHT_RECORDER_COMMAND_LENGTH, scsiIoCtx->cdb, entry->commandLength);
+    // Only keep sense data when there is some. The response code is 0 when the OS layer did not return any.
+    if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > UINT32_C(0) &&
+        (scsiIoCtx->psense[0] & 0x7F) != 0)
+    {
+        entry->statusLength = C_CAST(uint8_t, M_Min(scsiIoCtx->senseDataSize, FLIGHT_RECORDER_STATUS_LENGTH));
+        safe_memcpy(entry->status, FLIGHT_RECORDER_STATUS_LENGTH, scsiIoCtx->psense, entry->statusLength);
+    }
+}
+
+M_PARAM_RO(1) void record_NVMe_Flight_Recorder_Entry(const nvmeCmdCtx* M_NONNULL cmdCtx, eReturnValues result)
+{
+    flightRecorderEntry* entry = M_NULLPTR;
+    uint32_t             completion[4];
+    if (cmdCtx->device->drive_info.flightRecorder == M_NULLPTR)
+    {
+        return;
+    }
+    entry = start_Flight_Recorder_Entry(
+        cmdCtx->device,
+        cmdCtx->commandType == NVM_ADMIN_CMD ? FLIGHT_RECORDER_CMD_NVME_ADMIN : FLIGHT_RECORDER_CMD_NVME_NVM,
+        cmdCtx->commandDirection, cmdCtx->dataSize, result);
+    entry->commandLength = C_CAST(uint8_t, M_Min(sizeof(nvmeCommands), FLIGHT_RECORDER_COMMAND_LENGTH));
+    safe_memcpy(entry->command, FLIGHT_RECORDER_COMMAND_LENGTH, &cmdCtx->cmd, entry->commandLength);
+    completion[0]        = cmdCtx->commandCompletionData.dw0;
+    completion[1]        = cmdCtx->commandCompletionData.dw1;
+    completion[2]        = cmdCtx->commandCompletionData.dw2;
+    completion[3]        = cmdCtx->commandCompletionData.dw3;
+    entry->statusLength  = C_CAST(uint8_t, sizeof(completion));
+    safe_memcpy(entry->status, FLIGHT_RECORDER_STATUS_LENGTH, completion, sizeof(completion));
+    if (cmdCtx->commandCompletionData.dw0Valid)
+    {
+        entry->nvmeStatusValid |= BIT0;
+    }
+    if (cmdCtx->commandCompletionData.dw1Valid)
+    {
+        entry->nvmeStatusValid |= BIT1;
+    }
+    if (cmdCtx->commandCompletionData.dw2Valid)
+    {
+        entry->nvmeStatusValid |= BIT2;
+    }
+    if (cmdCtx->commandCompletionData.dw3Valid)
+    {
+        entry->nvmeStatusValid |= BIT3;
+    }
+}
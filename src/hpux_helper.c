@@ -772,6 +772,7 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
     DISABLE_NONNULL_COMPARE
     if (dev != M_NULLPTR)
     {
+        release_Device_Resources(dev);
         retValue                = close(dev->os_info.fd);
         dev->os_info.last_error = errno;
 
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file lba_batch.c
+// \brief Implements reading or verifying a list of discontiguous LBA ranges in one call, ordered and merged to need as
+// few commands and seeks as possible
+
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "sort_and_search.h"
+#include "type_conversion.h"
+
+#include "cmds.h"
+#include "lba_batch.h"
+#include "surface_scan.h"
+
+typedef struct s_lbaBatchState
+{
+    const tDevice*     device;
+    eLBABatchOperation operation;
+    uint32_t           blockSize;
+    uint32_t           maxBlocks;   // largest command
+    uint8_t*           mergeBuffer; // reads of merged ranges. Allocated the first time it is needed.
+    lbaBatchResults*   results;
+} lbaBatchState;
+
+// Used with qsort. Ranges that start at the same LBA keep the order they were given in.
+static int cmp_LBA_Batch_Range(const void* a, const void* b)
+{
+    const lbaBatchRange* rangeA = *M_REINTERPRET_CAST(const lbaBatchRange* const*, a);
+    const lbaBatchRange* rangeB = *M_REINTERPRET_CAST(const lbaBatchRange* const*, b);
+    if (rangeA->lba != rangeB->lba)
+    {
+        return rangeA->lba < rangeB->lba ? -1 : 1;
+    }
+    if (rangeA != rangeB)
+    {
+        return rangeA < rangeB ? -1 : 1;
+    }
+    return 0;
+}
+
+static M_INLINE uint64_t get_LBA_Batch_Range_End(const lbaBatchRange* range)
+{
+    return range->lba + range->length;
+}
+
+static eReturnValues send_LBA_Batch_Command(lbaBatchState* state, uint64_t lba, uint32_t count, uint8_t* buffer)
+{
+    ++state->results->commands;
+    if (state->operation == LBA_BATCH_READ)
+    {
+        return read_LBA(state->device, lba, false, buffer, count * state->blockSize);
+    }
+    else
+    {
+        return verify_LBA(state->device, lba, count);
+    }
+}
+
+// Sends one range on its own, split into as many commands as it needs. Reads go straight into the range's buffer.
+static eReturnValues send_LBA_Batch_Range(lbaBatchState* state, const lbaBatchRange* range)
+{
+    eReturnValues ret    = SUCCESS;
+    uint32_t      offset = UINT32_C(0);
+    while (offset < range->length && ret == SUCCESS)
+    {
+        uint32_t count  = M_Min(range->length - offset, state->maxBlocks);
+        uint8_t* buffer = M_NULLPTR;
+        if (state->operation == LBA_BATCH_READ)
+        {
+            buffer = &range->buffer[C_CAST(size_t, offset) * state->blockSize];
+        }
+        ret = send_LBA_Batch_Command(state, range->lba + offset, count, buffer);
+        offset += count;
+    }
+    return ret;
+}
+
+// Sends the merged ranges sorted[first] to sorted[last - 1], which start at runStart and cover runLength blocks
+static void send_LBA_Batch_Run(lbaBatchState* state,
+                               lbaBatchRange** sorted,
+                               uint32_t        first,
+                               uint32_t        last,
+                               uint64_t        runStart,
+                               uint32_t        runLength)
+{
+    eReturnValues ret = SUCCESS;
+    if (last - first == UINT32_C(1))
+    {
+        sorted[first]->result = send_LBA_Batch_Range(state, sorted[first]);
+        return;
+    }
+    ++state->results->mergedCommands;
+    ret = send_LBA_Batch_Command(state, runStart, runLength, state->mergeBuffer);
+    for (uint32_t iter = first; iter < last; ++iter)
+    {
+        if (ret == SUCCESS)
+        {
+            if (state->operation == LBA_BATCH_READ)
+            {
+                size_t rangeBytes = C_CAST(size_t, sorted[iter]->length) * state->blockSize;
+                safe_memcpy(sorted[iter]->buffer, rangeBytes,
+                            &state->mergeBuffer[C_CAST(size_t, sorted[iter]->lba - runStart) * state->blockSize],
+                            rangeBytes);
+            }
+            sorted[iter]->result = SUCCESS;
+        }
+        else
+        {
+            // find out which of the ranges failed
+            ++state->results->retriedRanges;
+            sorted[iter]->result = send_LBA_Batch_Range(state, sorted[iter]);
+        }
+    }
+}
+
+OPENSEA_TRANSPORT_API eReturnValues run_LBA_Batch(const tDevice* M_NONNULL    device,
+                                                  eLBABatchOperation          operation,
+                                                  lbaBatchRange* M_NONNULL    ranges,
+                                                  uint32_t                    numberOfRanges,
+                                                  lbaBatchResults* M_NULLABLE results)
+{
+    eReturnValues   ret         = SUCCESS;
+    uint32_t        sortedCount = UINT32_C(0);
+    uint64_t        maxLBA      = device->drive_info.deviceMaxLba;
+    lbaBatchRange** sorted      = M_NULLPTR;
+    lbaBatchResults localResults;
+    lbaBatchState   state;
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(lbaBatchResults), 0, sizeof(lbaBatchResults));
+    safe_memset(&state, sizeof(lbaBatchState), 0, sizeof(lbaBatchState));
+    state.device    = device;
+    state.operation = operation;
+    state.blockSize = get_Device_BlockSize(device);
+    state.results   = results;
+    if (state.blockSize == UINT32_C(0) || (numberOfRanges > UINT32_C(0) && ranges == M_NULLPTR))
+    {
+        return BAD_PARAMETER;
+    }
+    if (numberOfRanges == UINT32_C(0))
+    {
+        return SUCCESS;
+    }
+    for (uint32_t iter = UINT32_C(0); iter < numberOfRanges; ++iter)
+    {
+        if (operation == LBA_BATCH_READ && ranges[iter].buffer == M_NULLPTR && ranges[iter].length > UINT32_C(0))
+        {
+            return BAD_PARAMETER;
+        }
+    }
+    sorted = M_REINTERPRET_CAST(lbaBatchRange**, safe_calloc(numberOfRanges, sizeof(lbaBatchRange*)));
+    if (sorted == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    // Ranges not on the device, and empty ones, are finished now and left out of the sort
+    for (uint32_t iter = UINT32_C(0); iter < numberOfRanges; ++iter)
+    {
+        if (ranges[iter].length == UINT32_C(0))
+        {
+            ranges[iter].result = SUCCESS;
+        }
+        else if (ranges[iter].lba > maxLBA || ranges[iter].length - 1 > maxLBA - ranges[iter].lba)
+        {
+            ranges[iter].result = BAD_PARAMETER;
+        }
+        else
+        {
+            ranges[iter].result   = UNKNOWN;
+            sorted[sortedCount++] = &ranges[iter];
+        }
+    }
+    if (sortedCount > UINT32_C(1))
+    {
+        // If this fails the ranges are sent in the order given, which is still correct, just slower
+        M_STATIC_CAST(void, safe_qsort(sorted, sortedCount, sizeof(lbaBatchRange*), cmp_LBA_Batch_Range));
+    }
+    state.maxBlocks = get_Surface_Scan_Blocks_Per_Command(
+        device, operation == LBA_BATCH_READ ? SURFACE_SCAN_READ : SURFACE_SCAN_VERIFY);
+    for (uint32_t first = UINT32_C(0); first < sortedCount && ret == SUCCESS;)
+    {
+        uint32_t last     = first + 1;
+        uint64_t runStart = sorted[first]->lba;
+        uint64_t runEnd   = get_LBA_Batch_Range_End(sorted[first]);
+        // Merge the ranges that overlap or touch this one, as long as the command stays within the limit
+        while (last < sortedCount && sorted[last]->lba >= runStart && sorted[last]->lba <= runEnd &&
+               M_Max(runEnd, get_LBA_Batch_Range_End(sorted[last])) - runStart <= state.maxBlocks)
+        {
+            runEnd = M_Max(runEnd, get_LBA_Batch_Range_End(sorted[last]));
+            ++last;
+        }
+        if (last - first > UINT32_C(1) && operation == LBA_BATCH_READ && state.mergeBuffer == M_NULLPTR)
+        {
+            state.mergeBuffer = M_REINTERPRET_CAST(
+                uint8_t*, safe_calloc_aligned(C_CAST(size_t, state.maxBlocks) * state.blockSize, sizeof(uint8_t),
+                                              get_Device_IO_Minimum_Alignment(device)));
+            if (state.mergeBuffer == M_NULLPTR)
+            {
+                ret = MEMORY_FAILURE;
+                break;
+            }
+        }
+        send_LBA_Batch_Run(&state, sorted, first, last, runStart, C_CAST(uint32_t, runEnd - runStart));
+        first = last;
+    }
+    if (ret == SUCCESS)
+    {
+        for (uint32_t iter = UINT32_C(0); iter < numberOfRanges; ++iter)
+        {
+            if (ranges[iter].result != SUCCESS)
+            {
+                ++results->failedRanges;
+                ret = FAILURE;
+            }
+        }
+    }
+    safe_free_aligned(&state.mergeBuffer);
+    safe_free_core(M_REINTERPRET_CAST(void**, &sorted));
+    return ret;
+}
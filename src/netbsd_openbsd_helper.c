@@ -157,6 +157,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device(const char* M_NONNULL filename, t
 
 M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
 {
+    release_Device_Resources(dev);
     if (dev->os_info.fd)
     {
         close(dev->os_info.fd);
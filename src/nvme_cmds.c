@@ -27,11 +27,16 @@
 #include "platform_helper.h"
 
 #include "asmedia_nvme_helper.h"
+#include "command_capture.h"
+#include "command_stats.h"
 #include "common_public.h"
+#include "fault_injection.h"
+#include "flight_recorder.h"
 #include "jmicron_nvme_helper.h"
 #include "nvme_helper.h"
 #include "nvme_helper_func.h"
 #include "realtek_nvme_helper.h"
+#include "sntl_helper.h"
 
 M_PARAM_RO(1) eReturnValues nvme_Reset(const tDevice* M_NONNULL device)
 {
@@ -192,30 +197,69 @@ OPENSEA_TRANSPORT_API eReturnValues nvme_Cmd(const tDevice* M_NONNULL device, nv
             print_tDevice_Verbose_String(device, VERBOSITY_BUFFERS, "\n");
         }
     }
-    switch (device->drive_info.passThroughHacks.passthroughType)
+    if (is_Command_Stats_Enabled(device))
     {
-    case NVME_PASSTHROUGH_SYSTEM:
-        ret = send_NVMe_IO(cmdCtx);
-        break;
-    case NVME_PASSTHROUGH_JMICRON:
-        ret = send_JM_NVMe_Cmd(cmdCtx);
-        break;
-    case NVME_PASSTHROUGH_ASMEDIA_BASIC:
-        ret = send_ASMedia_Basic_NVMe_Passthrough_Cmd(cmdCtx);
-        break;
-    case NVME_PASSTHROUGH_ASMEDIA:
-        ret = send_ASM_NVMe_Cmd(cmdCtx);
-        break;
-    case NVME_PASSTHROUGH_REALTEK:
-        ret = send_Realtek_NVMe_Cmd(cmdCtx);
-        break;
-    case NVME_PASSTHROUGH_REALTEK_BASIC:
-        ret = send_Realtek_Basic_NVMe_Cmd(cmdCtx);
-        break;
-    default:
-        return BAD_PARAMETER;
+        begin_Command_Stats(device);
+    }
+    if (is_Fault_Injection_Active(device) && inject_NVMe_Fault(cmdCtx, &ret))
+    {
+        // completed by an injected fault instead of the OS
+    }
+    else if (is_Command_Replay_Active(device))
+    {
+        ret = replay_NVMe_Command(cmdCtx);
+    }
+    else
+    {
+        switch (device->drive_info.passThroughHacks.passthroughType)
+        {
+        case NVME_PASSTHROUGH_SYSTEM:
+            ret = send_NVMe_IO(cmdCtx);
+            break;
+        case NVME_PASSTHROUGH_JMICRON:
+            ret = send_JM_NVMe_Cmd(cmdCtx);
+            break;
+        case NVME_PASSTHROUGH_ASMEDIA_BASIC:
+            ret = send_ASMedia_Basic_NVMe_Passthrough_Cmd(cmdCtx);
+            break;
+        case NVME_PASSTHROUGH_ASMEDIA:
+            ret = send_ASM_NVMe_Cmd(cmdCtx);
+            break;
+        case NVME_PASSTHROUGH_REALTEK:
+            ret = send_Realtek_NVMe_Cmd(cmdCtx);
+            break;
+        case NVME_PASSTHROUGH_REALTEK_BASIC:
+            ret = send_Realtek_Basic_NVMe_Cmd(cmdCtx);
+            break;
+        default:
+            if (is_Command_Stats_Enabled(device))
+            {
+                cancel_Command_Stats(device);
+            }
+            return BAD_PARAMETER;
+        }
+        if (is_Command_Capture_Or_Replay_Active(device))
+        {
+            capture_NVMe_Command(cmdCtx, ret);
+        }
     }
     ret = set_NVMe_Last_Completion(M_CONST_CAST(tDevice*, device), cmdCtx, ret);
+    if (cmdCtx->commandType == NVM_ADMIN_CMD)
+    {
+        switch (opcode)
+        {
+        case NVME_ADMIN_CMD_NAMESPACE_MANAGEMENT:
+        case NVME_ADMIN_CMD_ACTIVATE_FW:
+        case NVME_ADMIN_CMD_NAMESPACE_ATTACHMENT:
+        case NVME_ADMIN_CMD_FORMAT_NVM:
+        case NVME_ADMIN_CMD_SANITIZE:
+            // even a failed command may have partially changed things, so always drop what the SNTL has cached
+            sntl_Invalidate_Translator_Cache(device);
+            break;
+        default:
+            break;
+        }
+    }
     // print NVMe command result
     print_tDevice_Verbose_NVMe_Cmd_Result(device, VERBOSITY_COMMAND_VERBOSE, cmdCtx);
     if (device->drive_info.passThroughHacks.passthroughType == NVME_PASSTHROUGH_SYSTEM)
@@ -241,6 +285,14 @@ OPENSEA_TRANSPORT_API eReturnValues nvme_Cmd(const tDevice* M_NONNULL device, nv
     {
         ret = OS_COMMAND_TIMEOUT;
     }
+    if (is_Flight_Recorder_Enabled(device))
+    {
+        record_NVMe_Flight_Recorder_Entry(cmdCtx, ret);
+    }
+    if (is_Command_Stats_Enabled(device))
+    {
+        end_Command_Stats(device, get_NVMe_Command_Stats_Class(cmdCtx->commandType == NVM_ADMIN_CMD, opcode), ret);
+    }
     return ret;
 }
 
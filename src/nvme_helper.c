@@ -99,6 +99,9 @@ M_PARAM_RW(1) eReturnValues fill_In_NVMe_Device_Info(tDevice* device)
     printf("-->%s\n", __FUNCTION__);
 #endif
 
+    // the identify data is reread below, so nothing the SNTL decoded from the old data can be used
+    safe_free_sntl_translator_cache(&device->drive_info.sntlCache);
+
     ret = nvme_Identify(device, C_CAST(uint8_t*, ctrlData), 0, NVME_IDENTIFY_CTRL);
 
 #ifdef _DEBUG
@@ -1265,3 +1268,124 @@ OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Ext_Smt_Log(const tDevice* M_NONNU
     print_tDevice_Return_Enum(device, "Read Ext SMART Log", ret);
     return ret;
 }
+
+// MDTS is a power of two in units of CAP.MPSMIN, which is 2^(12 + MPSMIN) bytes, so 4KiB at the smallest
+#define NVME_MDTS_MIN_PAGE_SIZE_BYTES UINT32_C(4096)
+// 2^20 pages of 4KiB no longer fits in 32 bits
+#define NVME_MDTS_MAX_32BIT_EXPONENT UINT8_C(20)
+
+M_PARAM_RO(1)
+OPENSEA_TRANSPORT_API uint32_t get_NVMe_MDTS_Bytes(const tDevice* M_NONNULL device)
+{
+    uint8_t mdts = device->drive_info.IdentifyData.nvme.ctrl.mdts;
+    if (mdts > UINT8_C(0) && mdts < NVME_MDTS_MAX_32BIT_EXPONENT)
+    {
+        return (UINT32_C(1) << mdts) * NVME_MDTS_MIN_PAGE_SIZE_BYTES;
+    }
+    return UINT32_C(0);
+}
+
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+M_PARAM_WO(3)
+OPENSEA_TRANSPORT_API eReturnValues get_NVMe_DSM_Limits(const tDevice* M_NONNULL device,
+                                                        uint32_t* M_NONNULL      maxRanges,
+                                                        uint32_t* M_NONNULL      maxLBAsPerRange)
+{
+    eReturnValues ret = NOT_SUPPORTED;
+    if (maxRanges == M_NULLPTR || maxLBAsPerRange == M_NULLPTR)
+    {
+        return BAD_PARAMETER;
+    }
+    *maxRanges       = NVME_DSM_MAX_RANGES;
+    *maxLBAsPerRange = UINT32_MAX;
+    // The NVM command set identify controller data was added with the command set specific identify in 2.0
+    if (le32_to_host(device->drive_info.IdentifyData.nvme.ctrl.ver) >= UINT32_C(0x00020000))
+    {
+        uint8_t* csCtrlData =
+            M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(NVME_IDENTIFY_DATA_LEN, sizeof(uint8_t),
+                                                             get_Device_IO_Minimum_Alignment(device)));
+        if (csCtrlData == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+        ret = nvme_Identify(device, csCtrlData, 0, NVME_IDENTIFY_CS_CTRL);
+        if (ret == SUCCESS)
+        {
+            // byte 3 = DMRL, bytes 7:4 = DMRSL. Zero means no limit is reported.
+            if (csCtrlData[3] > 0)
+            {
+                *maxRanges = csCtrlData[3];
+            }
+            uint32_t dmrsl = M_BytesTo4ByteValue(csCtrlData[7], csCtrlData[6], csCtrlData[5], csCtrlData[4]);
+            if (dmrsl > 0)
+            {
+                *maxLBAsPerRange = dmrsl;
+            }
+        }
+        safe_free_aligned(&csCtrlData);
+    }
+    return ret;
+}
+
+M_PARAM_RO_SIZE(1, 2)
+M_PARAM_RW(3)
+M_PARAM_RW(4)
+M_PARAM_WO_SIZE(5, 6)
+OPENSEA_TRANSPORT_API uint32_t fill_NVMe_DSM_Range_Buffer(const lbaRange* M_NONNULL ranges,
+                                                          uint32_t                  numberOfRanges,
+                                                          uint32_t* M_NONNULL       rangeIndex,
+                                                          uint64_t* M_NONNULL       rangeOffset,
+                                                          uint8_t* M_NONNULL        buffer,
+                                                          uint32_t                  bufferSize,
+                                                          uint32_t                  maxLBAsPerRange)
+{
+    uint32_t entries    = UINT32_C(0);
+    uint32_t maxEntries = M_Min(bufferSize / NVME_DSM_RANGE_SIZE, NVME_DSM_MAX_RANGES);
+    if (ranges == M_NULLPTR || rangeIndex == M_NULLPTR || rangeOffset == M_NULLPTR || buffer == M_NULLPTR ||
+        maxLBAsPerRange == UINT32_C(0))
+    {
+        return entries;
+    }
+    if (0 != safe_memset(buffer, bufferSize, 0, bufferSize))
+        M_UNLIKELY
+        {
+            return entries;
+        }
+    while (*rangeIndex < numberOfRanges && entries < maxEntries)
+    {
+        const lbaRange* range = &ranges[*rangeIndex];
+        if (*rangeOffset >= range->length)
+        {
+            *rangeIndex += UINT32_C(1);
+            *rangeOffset = UINT64_C(0);
+            continue;
+        }
+        uint64_t lba    = range->lba + *rangeOffset;
+        uint32_t count  = M_STATIC_CAST(uint32_t, M_Min(range->length - *rangeOffset, maxLBAsPerRange));
+        uint32_t offset = entries * NVME_DSM_RANGE_SIZE;
+        // bytes 3:0 are context attributes (left zero), 7:4 the length in logical blocks, 15:8 the starting LBA. All
+        // little endian.
+        buffer[offset + 4]  = M_Byte0(count);
+        buffer[offset + 5]  = M_Byte1(count);
+        buffer[offset + 6]  = M_Byte2(count);
+        buffer[offset + 7]  = M_Byte3(count);
+        buffer[offset + 8]  = M_Byte0(lba);
+        buffer[offset + 9]  = M_Byte1(lba);
+        buffer[offset + 10] = M_Byte2(lba);
+        buffer[offset + 11] = M_Byte3(lba);
+        buffer[offset + 12] = M_Byte4(lba);
+        buffer[offset + 13] = M_Byte5(lba);
+        buffer[offset + 14] = M_Byte6(lba);
+        buffer[offset + 15] = M_Byte7(lba);
+        *rangeOffset += count;
+        ++entries;
+    }
+    // step past a range that was finished exactly so callers can check rangeIndex to know if more commands are needed
+    if (*rangeIndex < numberOfRanges && *rangeOffset >= ranges[*rangeIndex].length)
+    {
+        *rangeIndex += UINT32_C(1);
+        *rangeOffset = UINT64_C(0);
+    }
+    return entries;
+}
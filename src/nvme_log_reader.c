@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file nvme_log_reader.c
+// \brief Implements reading large NVMe log pages in MDTS sized chunks that are handed to a callback or written to a
+// file as they arrive
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "secure_file.h"
+#include "type_conversion.h"
+
+#include "nvme_helper.h"
+#include "nvme_helper_func.h"
+#include "nvme_log_reader.h"
+
+// Largest chunk read, even when MDTS allows more, so the buffer stays small
+#define NVME_LOG_READER_MAX_CHUNK_BYTES UINT32_C(1048576)
+// Telemetry data areas are counted in 512 byte blocks, starting with the header in block 0
+#define NVME_LOG_READER_TELEMETRY_BLOCK UINT64_C(512)
+// Enough of a log header to find the length of the log
+#define NVME_LOG_READER_HEADER_BYTES UINT32_C(512)
+
+typedef struct s_nvmeLogFileContext
+{
+    secureFileInfo* file;
+    bool            writeFailed;
+} nvmeLogFileContext;
+
+// Offsets in Get Log Page (extended data) are supported when LPA bit 2 is set
+static M_INLINE bool is_NVMe_Log_Offset_Supported(const tDevice* device)
+{
+    return (device->drive_info.IdentifyData.nvme.ctrl.lpa & BIT2) > 0;
+}
+
+static M_INLINE bool has_NVMe_Log_Length_In_Header(uint8_t lid)
+{
+    return lid == NVME_LOG_TELEMETRY_HOST_ID || lid == NVME_LOG_TELEMETRY_CTRL_ID ||
+           lid == NVME_LOG_PERSISTENT_EVENT_LOG_ID;
+}
+
+// Length of the log from its header. 0 when this log has no length in its header.
+static uint64_t get_NVMe_Log_Length_From_Header(uint8_t lid, const uint8_t* header)
+{
+    uint64_t length = UINT64_C(0);
+    switch (lid)
+    {
+    case NVME_LOG_TELEMETRY_HOST_ID:
+    case NVME_LOG_TELEMETRY_CTRL_ID:
+    {
+        // data area 4 last block is 0 unless the host enabled it
+        uint32_t area3LastBlock = M_BytesTo2ByteValue(header[13], header[12]);
+        uint32_t area4LastBlock = M_BytesTo4ByteValue(header[19], header[18], header[17], header[16]);
+        length =
+            (C_CAST(uint64_t, M_Max(area3LastBlock, area4LastBlock)) + UINT64_C(1)) * NVME_LOG_READER_TELEMETRY_BLOCK;
+    }
+    break;
+    case NVME_LOG_PERSISTENT_EVENT_LOG_ID:
+        length = M_BytesTo8ByteValue(header[15], header[14], header[13], header[12], header[11], header[10], header[9],
+                                     header[8]);
+        break;
+    default:
+        break;
+    }
+    return length;
+}
+
+static bool write_NVMe_Log_Chunk_To_File(const uint8_t* M_NONNULL data,
+                                         uint32_t                 dataLength,
+                                         uint64_t                 offset,
+                                         void* M_NULLABLE         context)
+{
+    nvmeLogFileContext* fileContext = M_REINTERPRET_CAST(nvmeLogFileContext*, context);
+    size_t              written     = SIZE_T_C(0);
+    M_USE_UNUSED(offset);
+    if (SEC_FILE_SUCCESS != secure_Write_File(fileContext->file, data, dataLength, sizeof(uint8_t), dataLength,
+                                              &written) ||
+        written != dataLength)
+    {
+        fileContext->writeFailed = true;
+        return false;
+    }
+    return true;
+}
+
+OPENSEA_TRANSPORT_API uint32_t get_NVMe_Log_Chunk_Size(const tDevice* M_NONNULL device)
+{
+    uint32_t chunkSize = NVME_LOG_READER_MAX_CHUNK_BYTES;
+    uint32_t mdtsBytes = get_NVMe_MDTS_Bytes(device);
+    if (mdtsBytes > UINT32_C(0))
+    {
+        chunkSize = M_Min(chunkSize, mdtsBytes);
+    }
+    if (device->drive_info.passThroughHacks.nvmePTHacks.maxTransferLength > UINT32_C(0))
+    {
+        chunkSize = M_Min(chunkSize, device->drive_info.passThroughHacks.nvmePTHacks.maxTransferLength);
+    }
+    // whole dwords, and at least enough for a log header
+    chunkSize = M_Max(chunkSize / NVME_DWORD_SIZE * NVME_DWORD_SIZE, NVME_LOG_READER_HEADER_BYTES);
+    return chunkSize;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Log_Stream(const tDevice* M_NONNULL              device,
+                                                         const nvmeLogReaderOptions* M_NONNULL options,
+                                                         nvmeLogReaderResults* M_NULLABLE      results)
+{
+    eReturnValues        ret    = SUCCESS;
+    uint8_t*             buffer = M_NULLPTR;
+    nvmeLogReaderResults localResults;
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(nvmeLogReaderResults), 0, sizeof(nvmeLogReaderResults));
+    if (get_Device_DriveType(device) != NVME_DRIVE)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (options->chunkCallback == M_NULLPTR || options->chunkSize % NVME_DWORD_SIZE != UINT32_C(0) ||
+        (options->logLength == UINT64_C(0) &&
+         (!has_NVMe_Log_Length_In_Header(options->lid) ||
+          (options->chunkSize > UINT32_C(0) && options->chunkSize < NVME_LOG_READER_HEADER_BYTES))))
+    {
+        return BAD_PARAMETER;
+    }
+    results->logLength = options->logLength;
+    results->chunkSize = options->chunkSize > UINT32_C(0) ? options->chunkSize : get_NVMe_Log_Chunk_Size(device);
+    if (!is_NVMe_Log_Offset_Supported(device))
+    {
+        // everything has to come back from offset 0 in one command
+        if (results->logLength > results->chunkSize)
+        {
+            return NOT_SUPPORTED;
+        }
+        if (results->logLength > UINT64_C(0))
+        {
+            results->chunkSize = C_CAST(uint32_t, results->logLength + NVME_DWORD_SIZE - 1) / NVME_DWORD_SIZE *
+                                 NVME_DWORD_SIZE;
+        }
+    }
+    buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(results->chunkSize, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    if (results->logLength == UINT64_C(0))
+    {
+        // Read the header on its own so the length is known before any data is read. The header is read again with
+        // the data, but the last data read can then clear retain asynchronous event without another command.
+        nvmeGetLogPageCmdOpts getLogPage;
+        safe_memset(&getLogPage, sizeof(nvmeGetLogPageCmdOpts), 0, sizeof(nvmeGetLogPageCmdOpts));
+        getLogPage.nsid    = options->nsid;
+        getLogPage.addr    = buffer;
+        getLogPage.dataLen = NVME_LOG_READER_HEADER_BYTES;
+        getLogPage.lid     = options->lid;
+        getLogPage.lsp     = options->lsp;
+        getLogPage.rae     = 1;
+        ret                = nvme_Get_Log_Page(device, &getLogPage);
+        ++results->commands;
+        if (ret == SUCCESS)
+        {
+            results->logLength = get_NVMe_Log_Length_From_Header(options->lid, buffer);
+            if (results->logLength == UINT64_C(0))
+            {
+                ret = FAILURE;
+            }
+            else if (!is_NVMe_Log_Offset_Supported(device) && results->logLength > results->chunkSize)
+            {
+                ret = NOT_SUPPORTED;
+            }
+        }
+    }
+    while (ret == SUCCESS && results->bytesRead < results->logLength)
+    {
+        nvmeGetLogPageCmdOpts getLogPage;
+        uint64_t              remaining = results->logLength - results->bytesRead;
+        uint32_t              chunk     = results->chunkSize;
+        if (remaining < C_CAST(uint64_t, chunk))
+        {
+            // round up to whole dwords. Only the log's own bytes are handed on.
+            chunk = C_CAST(uint32_t, remaining + NVME_DWORD_SIZE - 1) / NVME_DWORD_SIZE * NVME_DWORD_SIZE;
+        }
+        safe_memset(&getLogPage, sizeof(nvmeGetLogPageCmdOpts), 0, sizeof(nvmeGetLogPageCmdOpts));
+        getLogPage.nsid    = options->nsid;
+        getLogPage.addr    = buffer;
+        getLogPage.dataLen = chunk;
+        getLogPage.lid     = options->lid;
+        getLogPage.lsp     = results->commands == UINT32_C(0) ? options->lsp : UINT8_C(0);
+        getLogPage.offset  = results->bytesRead;
+        getLogPage.rae     = (options->rae || remaining > chunk) ? 1 : 0;
+        ret                = nvme_Get_Log_Page(device, &getLogPage);
+        ++results->commands;
+        if (ret != SUCCESS)
+        {
+            break;
+        }
+        chunk = C_CAST(uint32_t, M_Min(C_CAST(uint64_t, chunk), remaining));
+        if (!options->chunkCallback(buffer, chunk, results->bytesRead, options->callbackContext))
+        {
+            ret = ABORTED;
+        }
+        results->bytesRead += chunk;
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues nvme_Read_Log_To_File(const tDevice* M_NONNULL              device,
+                                                          const nvmeLogReaderOptions* M_NONNULL options,
+                                                          secureFileInfo* M_NONNULL             file,
+                                                          nvmeLogReaderResults* M_NULLABLE      results)
+{
+    eReturnValues        ret = SUCCESS;
+    nvmeLogReaderOptions fileOptions;
+    nvmeLogFileContext   fileContext;
+    fileContext.file        = file;
+    fileContext.writeFailed = false;
+    safe_memcpy(&fileOptions, sizeof(nvmeLogReaderOptions), options, sizeof(nvmeLogReaderOptions));
+    fileOptions.chunkCallback   = write_NVMe_Log_Chunk_To_File;
+    fileOptions.callbackContext = &fileContext;
+    ret                         = nvme_Read_Log_Stream(device, &fileOptions, results);
+    if (ret == ABORTED && fileContext.writeFailed)
+    {
+        ret = FAILURE;
+    }
+    return ret;
+}
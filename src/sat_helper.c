@@ -25,6 +25,7 @@
 #include "type_conversion.h"
 
 #include "ata_helper_func.h"
+#include "command_stats.h"
 #include "platform_helper.h"
 #include "sat_helper.h"
 #include "sat_helper_func.h"
@@ -60,6 +61,345 @@
 #    pragma warning(disable : 4706)
 #endif
 
+#define SAT_ALL_OP_CODES_MAX_LENGTH (UINT32_C(4) * LEGACY_DRIVE_SEC_SIZE)
+// Device statistics pages 00h - 08h are the only ones the translator reads
+#define SAT_CACHED_DEVICE_STATS_PAGES (ATA_DEVICE_STATS_LOG_ZONED_DEVICE + 1)
+// Counters and temperatures change while the drive runs, so logs holding them are only reused for this long.
+#define SAT_TRANSLATOR_COUNTER_CACHE_NS (UINT64_C(5000000000))
+// UNMAP is split into as many TRIM commands as necessary, so the limits reported in the block limits VPD page are only
+// bounded by what fits in the UNMAP parameter list: (UINT16_MAX - 8 byte header) / 16 byte descriptors.
+#define SAT_UNMAP_MAX_BLOCK_DESCRIPTORS UINT32_C(4095)
+#define SAT_UNMAP_MAX_LBA_COUNT         UINT32_MAX
+
+typedef struct s_satCachedLogPage
+{
+    bool     valid;
+    uint8_t  padd[7];
+    seatimer readTime; // when the data was read from the drive. Used to expire counters.
+    uint8_t  data[LEGACY_DRIVE_SEC_SIZE];
+} satCachedLogPage;
+
+// Data the software translator would otherwise regenerate on every command. Everything in here is derived from the
+// identify data and flags read when the device was discovered, so it is all thrown out when the identify data changes.
+// Data read from the drive (identify, logs) is also thrown out after any translated command that can change it.
+// This must remain a single allocation with no pointers since it is freed by release_Device_Resources.
+struct s_satTranslatorCache
+{
+    uint8_t  identifySnapshot[LEGACY_DRIVE_SEC_SIZE]; // identify data at the time the cache was filled
+    uint32_t flagsSnapshot;                           // other discovery flags at the time the cache was filled
+    bool     identifyValid;        // identifySnapshot was read by the translator and can be returned for identify
+    bool     identifyPacketDevice; // identifySnapshot came from identify packet device
+    bool     logDirectoryValid;
+    bool     ncqTrimChecked;   // ncqTrimSupported has been read from the drive
+    bool     ncqTrimSupported; // cleared if a queued TRIM fails so that it is not tried again
+    uint8_t  padd[3];
+    uint8_t  logDirectory[ATA_LOG_PAGE_LEN_BYTES];
+
+    satCachedLogPage deviceStatistics[SAT_CACHED_DEVICE_STATS_PAGES]; // indexed by page number
+    satCachedLogPage smartData;
+
+    struct
+    {
+        bool     valid;
+        uint8_t  padd[3];
+        uint32_t length;
+        uint8_t  data[SAT_ALL_OP_CODES_MAX_LENGTH];
+    } allOpCodes[2]; // index 0 without command timeouts, 1 with command timeouts (RCTD)
+};
+
+M_PARAM_RO(1)
+static uint32_t get_SAT_Cache_Flags(const tDevice* M_NONNULL device)
+{
+    uint32_t flags = UINT32_C(0);
+    if (device->drive_info.softSATFlags.deferredDownloadSupported)
+    {
+        flags |= BIT0;
+    }
+    if (device->drive_info.softSATFlags.currentInternalStatusLogSupported)
+    {
+        flags |= BIT1;
+    }
+    if (device->drive_info.softSATFlags.savedInternalStatusLogSupported)
+    {
+        flags |= BIT2;
+    }
+    if (device->drive_info.softSATFlags.deviceStatsPages.dateAndTimeTimestampSupported)
+    {
+        flags |= BIT3;
+    }
+    if (device->drive_info.ata_Options.downloadMicrocodeDMASupported)
+    {
+        flags |= BIT4;
+    }
+    flags |= M_STATIC_CAST(uint32_t, device->drive_info.zonedType) << 8;
+    return flags;
+}
+
+// Returns the translator cache for this device, allocating it if this is the first use. If the identify data no longer
+// matches what the cache was filled from, everything in the cache is invalidated first.
+// Returns M_NULLPTR if the cache could not be allocated. Callers must work without it in that case.
+M_PARAM_RO(1)
+static ptrSatTranslatorCache get_SAT_Translator_Cache(const tDevice* M_NONNULL device)
+{
+    ptrSatTranslatorCache cache = device->drive_info.satCache;
+    uint32_t              flags = get_SAT_Cache_Flags(device);
+    if (cache == M_NULLPTR)
+    {
+        cache = M_REINTERPRET_CAST(ptrSatTranslatorCache, safe_calloc(1, sizeof(satTranslatorCache)));
+        if (cache == M_NULLPTR)
+        {
+            return M_NULLPTR;
+        }
+        M_CONST_CAST(tDevice*, device)->drive_info.satCache = cache;
+    }
+    else if (cache->flagsSnapshot == flags &&
+             memcmp(cache->identifySnapshot, &device->drive_info.IdentifyData.ata, LEGACY_DRIVE_SEC_SIZE) == 0)
+    {
+        return cache;
+    }
+    safe_memset(cache, sizeof(satTranslatorCache), 0, sizeof(satTranslatorCache));
+    if (0 != safe_memcpy(cache->identifySnapshot, LEGACY_DRIVE_SEC_SIZE, &device->drive_info.IdentifyData.ata,
+                         LEGACY_DRIVE_SEC_SIZE))
+        M_UNLIKELY
+        {
+            return M_NULLPTR;
+        }
+    cache->flagsSnapshot = flags;
+    return cache;
+}
+
+// Drops everything the translator read from the drive, but keeps what was generated from it (RSOC data) since that is
+// still checked against the identify data on each use.
+M_PARAM_RO(1)
+void sat_Invalidate_Translator_Cache(const tDevice* M_NONNULL device)
+{
+    ptrSatTranslatorCache cache = device->drive_info.satCache;
+    if (cache != M_NULLPTR)
+    {
+        cache->identifyValid        = false;
+        cache->identifyPacketDevice = false;
+        cache->logDirectoryValid    = false;
+        for (uint8_t page = UINT8_C(0); page < SAT_CACHED_DEVICE_STATS_PAGES; ++page)
+        {
+            cache->deviceStatistics[page].valid = false;
+        }
+        cache->smartData.valid = false;
+    }
+}
+
+// Commands that translate to SET FEATURES, format, sanitize, download microcode, or that pass through whatever the
+// caller wants, can change what has been cached from the drive.
+static bool does_SCSI_Command_Invalidate_SAT_Cache(uint8_t operationCode)
+{
+    bool invalidate = false;
+    switch (operationCode)
+    {
+    case MODE_SELECT_6_CMD:
+    case MODE_SELECT10:
+    case SCSI_FORMAT_UNIT_CMD:
+    case SANITIZE_CMD:
+    case WRITE_BUFFER_CMD:
+    case SECURITY_PROTOCOL_OUT:
+    case ATA_PASS_THROUGH_12:
+    case ATA_PASS_THROUGH_16:
+    case LOG_SELECT_CMD:
+    case SEND_DIAGNOSTIC_CMD:
+        invalidate = true;
+        break;
+    default:
+        break;
+    }
+    return invalidate;
+}
+
+static bool is_SAT_Cached_Log_Page_Current(satCachedLogPage* M_NONNULL page)
+{
+    bool current = false;
+    if (page->valid)
+    {
+        seatimer age = page->readTime;
+        stop_Timer(&age);
+        current = get_Nano_Seconds(age) < SAT_TRANSLATOR_COUNTER_CACHE_NS;
+    }
+    return current;
+}
+
+static void set_SAT_Cached_Log_Page(satCachedLogPage* M_NONNULL page, const uint8_t* M_NONNULL data)
+{
+    if (0 != safe_memcpy(page->data, LEGACY_DRIVE_SEC_SIZE, data, LEGACY_DRIVE_SEC_SIZE))
+        M_UNLIKELY
+        {
+            page->valid = false;
+            return;
+        }
+    safe_memset(&page->readTime, sizeof(seatimer), 0, sizeof(seatimer));
+    start_Timer(&page->readTime);
+    page->valid = true;
+}
+
+// Reads identify (or identify packet device when allowed and identify fails) unless the translator already has it.
+// Only successful reads are cached so that a checksum warning is still retried each time like before.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+static eReturnValues sat_Identify(const tDevice* M_NONNULL device,
+                                  uint8_t* M_NONNULL       identifyData,
+                                  bool                     allowPacketDevice,
+                                  bool* M_NULLABLE         packetDevice)
+{
+    eReturnValues         ret   = SUCCESS;
+    bool                  isPkt = false;
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    if (cache != M_NULLPTR && cache->identifyValid && (allowPacketDevice || !cache->identifyPacketDevice))
+    {
+        if (0 != safe_memcpy(identifyData, LEGACY_DRIVE_SEC_SIZE, cache->identifySnapshot, LEGACY_DRIVE_SEC_SIZE))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        isPkt = cache->identifyPacketDevice;
+    }
+    else
+    {
+        ret = ata_Identify(device, identifyData, LEGACY_DRIVE_SEC_SIZE);
+        if (ret != SUCCESS && allowPacketDevice)
+        {
+            ret = ata_Identify_Packet_Device(device, identifyData, LEGACY_DRIVE_SEC_SIZE);
+            isPkt = true;
+        }
+        if (ret == SUCCESS)
+        {
+            // both identify commands copy to the tDevice, so refreshing the cache snapshots the new data
+            cache = get_SAT_Translator_Cache(device);
+            if (cache != M_NULLPTR)
+            {
+                cache->identifyValid        = true;
+                cache->identifyPacketDevice = isPkt;
+            }
+        }
+    }
+    if (packetDevice != M_NULLPTR)
+    {
+        *packetDevice = isPkt;
+    }
+    return ret;
+}
+
+// Reads a device statistics page (512 bytes) through the cache. On failure, lastCommandRTFRs are from the failed read.
+M_PARAM_RO(1)
+M_PARAM_WO(3)
+static eReturnValues sat_Read_Device_Statistics_Page(const tDevice* M_NONNULL device,
+                                                     uint8_t                  page,
+                                                     uint8_t* M_NONNULL       logPage)
+{
+    eReturnValues         ret   = SUCCESS;
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    if (cache != M_NULLPTR && page < SAT_CACHED_DEVICE_STATS_PAGES &&
+        is_SAT_Cached_Log_Page_Current(&cache->deviceStatistics[page]))
+    {
+        if (0 != safe_memcpy(logPage, LEGACY_DRIVE_SEC_SIZE, cache->deviceStatistics[page].data, LEGACY_DRIVE_SEC_SIZE))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        return ret;
+    }
+    ret = ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, page, logPage, LEGACY_DRIVE_SEC_SIZE,
+                           device->drive_info.ata_Options.readLogWriteLogDMASupported, 0);
+    if (ret == SUCCESS && cache != M_NULLPTR && page < SAT_CACHED_DEVICE_STATS_PAGES)
+    {
+        set_SAT_Cached_Log_Page(&cache->deviceStatistics[page], logPage);
+    }
+    return ret;
+}
+
+// SMART read data is only used for self-test times by the translator. Request sense needs live self-test progress so
+// it does not use this.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+static eReturnValues sat_SMART_Read_Data(const tDevice* M_NONNULL device, uint8_t* M_NONNULL smartData)
+{
+    eReturnValues         ret   = SUCCESS;
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    if (cache != M_NULLPTR && is_SAT_Cached_Log_Page_Current(&cache->smartData))
+    {
+        if (0 != safe_memcpy(smartData, LEGACY_DRIVE_SEC_SIZE, cache->smartData.data, LEGACY_DRIVE_SEC_SIZE))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        return ret;
+    }
+    ret = ata_SMART_Read_Data(device, smartData, LEGACY_DRIVE_SEC_SIZE);
+    if (ret == SUCCESS && cache != M_NULLPTR)
+    {
+        set_SAT_Cached_Log_Page(&cache->smartData, smartData);
+    }
+    return ret;
+}
+
+// Queued TRIM support requires reading the NCQ send and receive log, so it is only checked once per identify snapshot.
+M_PARAM_RO(1)
+static bool sat_Is_NCQ_Trim_Supported(const tDevice* M_NONNULL device)
+{
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    if (cache == M_NULLPTR)
+    {
+        return false;
+    }
+    if (!cache->ncqTrimChecked)
+    {
+        bool supported = is_ATA_NCQ_Trim_Supported(device);
+        // reading the log may have issued commands that refreshed the tDevice, so get the cache again before saving
+        cache = get_SAT_Translator_Cache(device);
+        if (cache == M_NULLPTR)
+        {
+            return false;
+        }
+        cache->ncqTrimSupported = supported;
+        cache->ncqTrimChecked   = true;
+    }
+    return cache->ncqTrimSupported;
+}
+
+M_PARAM_RO(1)
+static void sat_Disable_NCQ_Trim(const tDevice* M_NONNULL device)
+{
+    ptrSatTranslatorCache cache = device->drive_info.satCache;
+    if (cache != M_NULLPTR)
+    {
+        cache->ncqTrimSupported = false;
+        cache->ncqTrimChecked   = true;
+    }
+}
+
+// The log directory only changes with firmware or feature changes, so it is not expired by time.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+static eReturnValues sat_Read_Log_Directory(const tDevice* M_NONNULL device, uint8_t* M_NONNULL logDirectory)
+{
+    eReturnValues         ret   = SUCCESS;
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    if (cache != M_NULLPTR && cache->logDirectoryValid)
+    {
+        if (0 != safe_memcpy(logDirectory, ATA_LOG_PAGE_LEN_BYTES, cache->logDirectory, ATA_LOG_PAGE_LEN_BYTES))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        return ret;
+    }
+    ret = ata_Read_Log_Ext(device, ATA_LOG_DIRECTORY, 0, logDirectory, ATA_LOG_PAGE_LEN_BYTES,
+                           device->drive_info.ata_Options.readLogWriteLogDMASupported, 0);
+    if (ret == SUCCESS && cache != M_NULLPTR)
+    {
+        if (0 == safe_memcpy(cache->logDirectory, ATA_LOG_PAGE_LEN_BYTES, logDirectory, ATA_LOG_PAGE_LEN_BYTES))
+        {
+            cache->logDirectoryValid = true;
+        }
+    }
+    return ret;
+}
+
 M_PARAM_RO(1)
 M_PARAM_WO(2)
 eReturnValues get_Return_TFRs_From_Passthrough_Results_Log(const tDevice* M_NONNULL device,
@@ -1828,6 +2168,13 @@ eReturnValues send_SAT_Passthrough_Command(const tDevice* M_NONNULL         devi
         // if the sense data says "NOT_SUPPORTED", it's highly likely that the SATL didn't like something in the
         // command. Local testing shows that sometimes a SATL likes the mode set to DMA instead of UDMA, so retry
         // the command with the protocol set to DMA.
+        if (is_Command_Stats_Enabled(device))
+        {
+            record_Command_Stats_Retry(device,
+                                       get_ATA_Command_Stats_Class(ataCommandOptions->tfr.CommandStatus,
+                                                                   get_bit_range_uint8(
+                                                                       ataCommandOptions->tfr.SectorCount48, 4, 0)));
+        }
         ataCommandOptions->commadProtocol = ATA_PROTOCOL_DMA;
         ret                               = send_SAT_Passthrough_Command(device, ataCommandOptions);
         if (ret == SUCCESS)
@@ -2728,6 +3075,7 @@ static eReturnValues translate_ATA_Information_VPD_Page_89h(const tDevice* devic
     eReturnValues ret              = SUCCESS;
     uint8_t       peripheralDevice = UINT8_C(0);
     uint8_t       commandCode      = ATA_IDENTIFY;
+    bool          packetDevice     = false;
     DECLARE_ZERO_INIT_ARRAY(uint8_t, identifyDriveData, 512);
 #define SAT_ATA_INFO_VPD_PAGE_LEN_SOFTSATL (572)
     DECLARE_ZERO_INIT_ARRAY(uint8_t, ataInformation, SAT_ATA_INFO_VPD_PAGE_LEN_SOFTSATL);
@@ -2738,7 +3086,7 @@ static eReturnValues translate_ATA_Information_VPD_Page_89h(const tDevice* devic
                                         identifyDriveData, LEGACY_DRIVE_SEC_SIZE,
                                         device->drive_info.ata_Options.readLogWriteLogDMASupported, 0))
         {
-            if (SUCCESS != ata_Identify(device, identifyDriveData, LEGACY_DRIVE_SEC_SIZE))
+            if (SUCCESS != sat_Identify(device, identifyDriveData, false, M_NULLPTR))
             {
                 return FAILURE;
             }
@@ -2757,14 +3105,13 @@ static eReturnValues translate_ATA_Information_VPD_Page_89h(const tDevice* devic
     }
     else
 #endif // SAT_SPEC_SUPPORTED
-        if (SUCCESS != ata_Identify(device, identifyDriveData, LEGACY_DRIVE_SEC_SIZE))
+        if (SUCCESS != sat_Identify(device, identifyDriveData, true, &packetDevice))
+        {
+            // neither identify nor identify packet device worked, so it's time to return a failure
+            return FAILURE;
+        }
+        else if (packetDevice)
         {
-            // that failed, so try an identify packet device
-            if (SUCCESS != ata_Identify_Packet_Device(device, identifyDriveData, LEGACY_DRIVE_SEC_SIZE))
-            {
-                // if we still didn't get anything, then it's time to return a failure
-                return FAILURE;
-            }
             peripheralDevice = 0x05;
             commandCode      = ATAPI_IDENTIFY;
         }
@@ -3469,30 +3816,11 @@ static eReturnValues translate_Block_Limits_VPD_Page_B0h(const tDevice* device,
         le16_to_host(device->drive_info.IdentifyData.ata.Word169) & BIT0 &&
         le16_to_host(device->drive_info.IdentifyData.ata.Word069) & BIT14)
     {
-        uint32_t maxBlocks = UINT32_C(1);
-        uint8_t  maxDescriptorsPerBlock;
-        uint64_t maxUnmapRangePerDescriptor;
-        uint64_t maxLBAsPerUnmap;
-        uint32_t unmapLBACount;
-        uint32_t unmapMaxBlockDescriptors;
-
-        if (is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word105)))
-        {
-            maxBlocks = le16_to_host(device->drive_info.IdentifyData.ata.Word105);
-        }
-#if defined(SAT_SPEC_SUPPORTED) && SAT_SPEC_SUPPORTED > 3
-        maxDescriptorsPerBlock = device->drive_info.softSATFlags.dataSetManagementXLSupported ? 32 : 64;
-        maxUnmapRangePerDescriptor =
-            device->drive_info.softSATFlags.dataSetManagementXLSupported ? UINT64_MAX : UINT16_MAX;
-        maxLBAsPerUnmap =
-            C_CAST(uint64_t, maxDescriptorsPerBlock) * C_CAST(uint64_t, maxBlocks) * maxUnmapRangePerDescriptor;
-        unmapLBACount            = maxLBAsPerUnmap > UINT32_MAX ? UINT32_MAX : C_CAST(uint32_t, maxLBAsPerUnmap);
-        unmapMaxBlockDescriptors = maxDescriptorsPerBlock * maxBlocks;
-#else  // SAT_SPEC_SUPPORTED <= 3
-        unmapLBACount            = 64 * maxBlocks * UINT16_MAX;
-        unmapMaxBlockDescriptors = 64 * maxBlocks;
-#endif // SAT_SPEC_SUPPORTED
-       // maximum unmap LBA count (unspecified....we decide)
+        // The translator sorts, merges, and splits the descriptors into as many data set management commands as the
+        // drive needs, so these are not limited by the size of a single TRIM command.
+        uint32_t unmapLBACount            = SAT_UNMAP_MAX_LBA_COUNT;
+        uint32_t unmapMaxBlockDescriptors = SAT_UNMAP_MAX_BLOCK_DESCRIPTORS;
+        // maximum unmap LBA count (unspecified....we decide)
         blockLimits[20] = M_Byte3(unmapLBACount);
         blockLimits[21] = M_Byte2(unmapLBACount);
         blockLimits[22] = M_Byte1(unmapLBACount);
@@ -3756,7 +4084,7 @@ static eReturnValues translate_Extended_Inquiry_Data_VPD_Page_86h(const tDevice*
         le16_to_host(device->drive_info.IdentifyData.ata.Word084) & BIT1) // smart enabled and self test supported
     {
         DECLARE_ZERO_INIT_ARRAY(uint8_t, smartData, LEGACY_DRIVE_SEC_SIZE);
-        if (SUCCESS == ata_SMART_Read_Data(device, smartData, LEGACY_DRIVE_SEC_SIZE))
+        if (SUCCESS == sat_SMART_Read_Data(device, smartData))
         {
             uint16_t extendedSelfTestCompletionTimeMinutes = UINT16_C(0);
             if (smartData[373] == 0xFF)
@@ -4045,16 +4373,17 @@ static eReturnValues translate_SCSI_Inquiry_Command(const tDevice* device, ScsiI
                                                senseKeySpecificDescriptor, 1);
                 return NOT_SUPPORTED;
             }
-            if (SUCCESS != ata_Identify(device, iddata, LEGACY_DRIVE_SEC_SIZE))
+            bool packetDevice = false;
+            if (SUCCESS != sat_Identify(device, iddata, true, &packetDevice))
+            {
+                // neither identify nor identify packet device worked
+                set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NOT_READY, 0x04,
+                                               0, device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR,
+                                               0);
+                return FAILURE;
+            }
+            else if (packetDevice)
             {
-                // that failed, so try an identify packet device
-                if (SUCCESS != ata_Identify_Packet_Device(device, iddata, LEGACY_DRIVE_SEC_SIZE))
-                {
-                    set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NOT_READY,
-                                                   0x04, 0, device->drive_info.softSATFlags.senseDataDescriptorFormat,
-                                                   M_NULLPTR, 0);
-                    return FAILURE;
-                }
                 peripheralDevice = 0x05;
             }
             set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NO_ERROR, 0, 0,
@@ -4337,7 +4666,7 @@ static eReturnValues translate_SCSI_Read_Capacity_Command(const tDevice* device,
     }
     // issue an identify command
     DECLARE_ZERO_INIT_ARRAY(uint8_t, identifyData, LEGACY_DRIVE_SEC_SIZE);
-    if (SUCCESS == ata_Identify(device, identifyData, LEGACY_DRIVE_SEC_SIZE))
+    if (SUCCESS == sat_Identify(device, identifyData, false, M_NULLPTR))
     {
         uint16_t* ident_word = M_CONST_CAST(uint16_t*, &device->drive_info.IdentifyData.ata);
         set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NO_ERROR, 0, 0,
@@ -8141,8 +8470,7 @@ static eReturnValues translate_SCSI_Read_Buffer_Command(const tDevice* device, S
                     }
                 }
                 // error history directory
-                if (SUCCESS == ata_Read_Log_Ext(device, ATA_LOG_DIRECTORY, 0, gplDirectory, ATA_LOG_PAGE_LEN_BYTES,
-                                                device->drive_info.ata_Options.readLogWriteLogDMASupported, 0))
+                if (SUCCESS == sat_Read_Log_Directory(device, gplDirectory))
                 {
                     uint32_t currentStatusLogSize =
                         get_ATA_Log_Size_From_Directory(gplDirectory, ATA_LOG_CURRENT_DEVICE_INTERNAL_STATUS_DATA_LOG);
@@ -8613,7 +8941,7 @@ static eReturnValues translate_SCSI_Send_Diagnostic_Command(const tDevice* devic
                         break;
                     case 6: // foreground extended self test
                         // first get the timeout value from SMART Read Data command
-                        if (SUCCESS == ata_SMART_Read_Data(device, smartReadData, LEGACY_DRIVE_SEC_SIZE))
+                        if (SUCCESS == sat_SMART_Read_Data(device, smartReadData))
                         {
                             timeout = smartReadData[373];
                             if (timeout == 0xFF)
@@ -10708,9 +11036,7 @@ static eReturnValues translate_Read_Error_Counters_Log_0x03(const tDevice* devic
     if (parameterPointer <= 0x0004 &&
         device->drive_info.softSATFlags.deviceStatsPages.rotatingMediaStatisticsPageSupported)
     {
-        if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_ROTATING_MEDIA, logPage,
-                                        LEGACY_DRIVE_SEC_SIZE,
-                                        device->drive_info.ata_Options.readLogWriteLogDMASupported, 0))
+        if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_ROTATING_MEDIA, logPage))
         {
             set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                     scsiIoCtx->senseDataSize);
@@ -10734,9 +11060,7 @@ static eReturnValues translate_Read_Error_Counters_Log_0x03(const tDevice* devic
     }
     if (parameterPointer <= 0x0006 && device->drive_info.softSATFlags.deviceStatsPages.generalErrorStatisticsSupported)
     {
-        if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_GEN_ERR, logPage,
-                                        LEGACY_DRIVE_SEC_SIZE,
-                                        device->drive_info.ata_Options.readLogWriteLogDMASupported, 0))
+        if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_GEN_ERR, logPage))
         {
             set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                     scsiIoCtx->senseDataSize);
@@ -10823,9 +11147,7 @@ static eReturnValues translate_Temperature_Log_0x0D(const tDevice* device, ScsiI
                                        senseKeySpecificDescriptor, 1);
         return ret;
     }
-    if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_TEMP, logPage,
-                                    LEGACY_DRIVE_SEC_SIZE, device->drive_info.ata_Options.readLogWriteLogDMASupported,
-                                    0))
+    if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_TEMP, logPage))
     {
         set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                 scsiIoCtx->senseDataSize);
@@ -10930,9 +11252,7 @@ static eReturnValues translate_Solid_State_Media_Log_0x11(const tDevice* device,
                                        senseKeySpecificDescriptor, 1);
         return ret;
     }
-    if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_SSD, logPage,
-                                    LEGACY_DRIVE_SEC_SIZE, device->drive_info.ata_Options.readLogWriteLogDMASupported,
-                                    0))
+    if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_SSD, logPage))
     {
         set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                 scsiIoCtx->senseDataSize);
@@ -11010,9 +11330,7 @@ static eReturnValues translate_Background_Scan_Results_Log_0x15(const tDevice* d
                                        senseKeySpecificDescriptor, 1);
         return ret;
     }
-    if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_GENERAL, logPage,
-                                    LEGACY_DRIVE_SEC_SIZE, device->drive_info.ata_Options.readLogWriteLogDMASupported,
-                                    0))
+    if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_GENERAL, logPage))
     {
         set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                 scsiIoCtx->senseDataSize);
@@ -11102,9 +11420,7 @@ static eReturnValues translate_General_Statistics_And_Performance_Log_0x19(const
                                        senseKeySpecificDescriptor, 1);
         return ret;
     }
-    if (SUCCESS != ata_Read_Log_Ext(device, ATA_LOG_DEVICE_STATISTICS, ATA_DEVICE_STATS_LOG_GENERAL, logPage,
-                                    LEGACY_DRIVE_SEC_SIZE, device->drive_info.ata_Options.readLogWriteLogDMASupported,
-                                    0))
+    if (SUCCESS != sat_Read_Device_Statistics_Page(device, ATA_DEVICE_STATS_LOG_GENERAL, logPage))
     {
         set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
                                 scsiIoCtx->senseDataSize);
@@ -12461,49 +12777,27 @@ static eReturnValues translate_SCSI_Unmap_Command(const tDevice* device, ScsiIoC
                 // avoid partial block descriptors-TJE
         if (unmapBlockDescriptorLength > 0)
         {
-            uint16_t trimBufferSize = UINT16_C(1);
+            uint16_t trimBufferSize = UINT16_C(1); // number of 512B blocks the drive accepts in a single command
             if (is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word105)))
             {
                 trimBufferSize = le16_to_host(device->drive_info.IdentifyData.ata.Word105);
             }
-            uint8_t* trimBuffer =
-                C_CAST(uint8_t*,
-                       safe_calloc_aligned(
-                           uint16_to_sizet(trimBufferSize) * LEGACY_DRIVE_SEC_SIZE, sizeof(uint8_t),
-                           get_Device_IO_Minimum_Alignment(device))); // allocate the max size the device
-                                                                      // supports...we'll fill in as much as we need to
 #if defined(SAT_SPEC_SUPPORTED) && SAT_SPEC_SUPPORTED > 3
-            bool     useXL                  = device->drive_info.softSATFlags.dataSetManagementXLSupported;
-            uint8_t  maxDescriptorsPerBlock = device->drive_info.softSATFlags.dataSetManagementXLSupported ? 32 : 64;
-            uint8_t  descriptorSize         = device->drive_info.softSATFlags.dataSetManagementXLSupported ? 16 : 8;
-            uint64_t maxUnmapRangePerDescriptor =
-                device->drive_info.softSATFlags.dataSetManagementXLSupported ? UINT64_MAX : UINT16_MAX;
+            bool useXL = device->drive_info.softSATFlags.dataSetManagementXLSupported;
 #else  // SAT_SPEC_SUPPORTED
-            bool useXL = false uint8_t maxDescriptorsPerBlock     = UINT8_C(64);
-            uint8_t                    descriptorSize             = UINT8_C(8);
-            uint64_t                   maxUnmapRangePerDescriptor = UINT16_MAX;
+            bool useXL = false;
 #endif // SAT_SPEC_SUPPORTED
-       // need to check to make sure there weren't any truncated block descriptors before we begin
+            uint32_t descriptorSize = useXL ? UINT32_C(16) : UINT32_C(8);
+            // need to check to make sure there weren't any truncated block descriptors before we begin
             uint16_t minBlockDescriptorLength =
                 C_CAST(uint16_t, M_Min(unmapBlockDescriptorLength + UINT16_C(8), parameterListLength));
-            uint16_t unmapBlockDescriptorIter = UINT16_C(8);
-            uint64_t numberOfLBAsToTRIM =
-                0; // this will be checked later to make sure it isn't greater than what we reported on the VPD pages
-            uint16_t numberOfBlockDescriptors =
-                0; // this will be checked later to make sure it isn't greater than what we reported on the VPD pages
-            uint16_t ataTrimOffset = UINT16_C(0);
-
-            if (is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word105)))
-            {
-                trimBufferSize = le16_to_host(device->drive_info.IdentifyData.ata.Word105);
-            }
-            trimBuffer = C_CAST(uint8_t*,
-                                calloc_aligned(uint16_to_sizet(trimBufferSize) * LEGACY_DRIVE_SEC_SIZE, sizeof(uint8_t),
-                                               get_Device_IO_Minimum_Alignment(
-                                                   device))); // allocate the max size the device supports...we'll
-                                                              // fill in as much as we need to
-
-            if (!trimBuffer)
+            uint32_t  numberOfBlockDescriptors = (minBlockDescriptorLength - UINT32_C(8)) / UINT32_C(16);
+            uint32_t  numberOfRanges           = UINT32_C(0);
+            uint64_t  numberOfLBAsToTRIM       = UINT64_C(0);
+            uint8_t*  trimBuffer               = M_NULLPTR;
+            lbaRange* ranges                   = M_REINTERPRET_CAST(
+                lbaRange*, safe_calloc(M_Max(numberOfBlockDescriptors, UINT32_C(1)), sizeof(lbaRange)));
+            if (ranges == M_NULLPTR)
             {
                 // lets just set this error for now...-TJE
                 fieldPointer = UINT16_C(7);
@@ -12515,31 +12809,28 @@ static eReturnValues translate_SCSI_Unmap_Command(const tDevice* device, ScsiIoC
                                                senseKeySpecificDescriptor, 1);
                 return MEMORY_FAILURE;
             }
-            // start building the buffer to transfer with data set management
-            for (; unmapBlockDescriptorIter < minBlockDescriptorLength;
-                 unmapBlockDescriptorIter += 16, numberOfBlockDescriptors++)
+            // First gather and validate all of the block descriptors. Nothing is sent to the drive until the whole
+            // list is known to be good, then it is sorted and merged so the fewest TRIM entries and commands are used.
+            for (uint32_t descriptorIter = UINT32_C(0); descriptorIter < numberOfBlockDescriptors; ++descriptorIter)
             {
-                bool     exitLoop                 = false;
+                uint16_t descriptorOffset         = C_CAST(uint16_t, UINT32_C(8) + (descriptorIter * UINT32_C(16)));
                 uint64_t unmapLogicalBlockAddress = M_BytesTo8ByteValue(
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 0], scsiIoCtx->pdata[unmapBlockDescriptorIter + 1],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 2], scsiIoCtx->pdata[unmapBlockDescriptorIter + 3],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 4], scsiIoCtx->pdata[unmapBlockDescriptorIter + 5],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 6], scsiIoCtx->pdata[unmapBlockDescriptorIter + 7]);
+                    scsiIoCtx->pdata[descriptorOffset + 0], scsiIoCtx->pdata[descriptorOffset + 1],
+                    scsiIoCtx->pdata[descriptorOffset + 2], scsiIoCtx->pdata[descriptorOffset + 3],
+                    scsiIoCtx->pdata[descriptorOffset + 4], scsiIoCtx->pdata[descriptorOffset + 5],
+                    scsiIoCtx->pdata[descriptorOffset + 6], scsiIoCtx->pdata[descriptorOffset + 7]);
                 uint32_t unmapNumberOfLogicalBlocks = M_BytesTo4ByteValue(
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 8], scsiIoCtx->pdata[unmapBlockDescriptorIter + 9],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 10], scsiIoCtx->pdata[unmapBlockDescriptorIter + 11]);
+                    scsiIoCtx->pdata[descriptorOffset + 8], scsiIoCtx->pdata[descriptorOffset + 9],
+                    scsiIoCtx->pdata[descriptorOffset + 10], scsiIoCtx->pdata[descriptorOffset + 11]);
                 if (unmapNumberOfLogicalBlocks == 0)
                 {
                     // nothing to unmap...
                     continue;
                 }
-                // increment this so we can check if we were given more to do than we support (to be checked after the
-                // loop)
-                numberOfLBAsToTRIM += unmapNumberOfLogicalBlocks;
                 // check we aren't trying to go over the end of the drive
                 if (unmapLogicalBlockAddress > return_Device_MaxLba(device))
                 {
-                    fieldPointer = unmapBlockDescriptorIter + 0;
+                    fieldPointer = descriptorOffset + 0;
                     bitPointer   = UINT8_C(7);
                     set_Sense_Key_Specific_Descriptor_Invalid_Field(senseKeySpecificDescriptor, false, true, bitPointer,
                                                                     fieldPointer);
@@ -12547,12 +12838,12 @@ static eReturnValues translate_SCSI_Unmap_Command(const tDevice* device, ScsiIoC
                     set_Sense_Data_For_Translation(
                         scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x21, 0,
                         device->drive_info.softSATFlags.senseDataDescriptorFormat, senseKeySpecificDescriptor, 1);
-                    exitLoop = true;
                     break;
                 }
-                else if (unmapLogicalBlockAddress + unmapNumberOfLogicalBlocks > return_Device_MaxLba(device))
+                else if (unmapNumberOfLogicalBlocks - UINT32_C(1) >
+                         return_Device_MaxLba(device) - unmapLogicalBlockAddress)
                 {
-                    fieldPointer = unmapBlockDescriptorIter + 8;
+                    fieldPointer = descriptorOffset + 8;
                     bitPointer   = UINT8_C(7);
                     set_Sense_Key_Specific_Descriptor_Invalid_Field(senseKeySpecificDescriptor, false, true, bitPointer,
                                                                     fieldPointer);
@@ -12560,127 +12851,98 @@ static eReturnValues translate_SCSI_Unmap_Command(const tDevice* device, ScsiIoC
                     set_Sense_Data_For_Translation(
                         scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x21, 0,
                         device->drive_info.softSATFlags.senseDataDescriptorFormat, senseKeySpecificDescriptor, 1);
-                    exitLoop = true;
                     break;
                 }
-                // check that we haven't had too many block descriptors yet
-                if (numberOfBlockDescriptors > (maxDescriptorsPerBlock * trimBufferSize))
+                numberOfLBAsToTRIM += unmapNumberOfLogicalBlocks;
+                ranges[numberOfRanges].lba    = unmapLogicalBlockAddress;
+                ranges[numberOfRanges].length = unmapNumberOfLogicalBlocks;
+                ++numberOfRanges;
+            }
+            // check that we were not given more than was reported in the block limits VPD page
+            if (ret == SUCCESS && (numberOfBlockDescriptors > SAT_UNMAP_MAX_BLOCK_DESCRIPTORS ||
+                                   numberOfLBAsToTRIM > SAT_UNMAP_MAX_LBA_COUNT))
+            {
+                // not setting sense key specific information because it's not clear in this condition what error we
+                // should point to
+                ret = FAILURE;
+                set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST,
+                                               0x26, 0, device->drive_info.softSATFlags.senseDataDescriptorFormat,
+                                               M_NULLPTR, 0);
+            }
+            if (ret == SUCCESS)
+            {
+                numberOfRanges = coalesce_LBA_Ranges(ranges, numberOfRanges);
+                // Only allocate what the merged ranges need, up to what the drive allows in one command
+                uint64_t entriesNeeded = UINT64_C(0);
+                for (uint32_t rangeIter = UINT32_C(0); rangeIter < numberOfRanges; ++rangeIter)
                 {
-                    // not setting sense key specific information because it's not clear in this condition what error we
-                    // should point to
-                    ret = FAILURE;
-                    set_Sense_Data_For_Translation(
-                        scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0,
-                        device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
-                    exitLoop = true;
-                    break;
+                    // XL entries hold a 64bit count, regular entries hold at most 0xFFFF logical blocks
+                    entriesNeeded +=
+                        useXL ? UINT64_C(1) : (ranges[rangeIter].length + UINT64_C(0xFFFE)) / UINT64_C(0xFFFF);
                 }
-                // check that we haven't been asked to TRIM more LBAs than we care to support in this code
-                if (numberOfLBAsToTRIM > (M_STATIC_CAST(uint64_t, maxDescriptorsPerBlock) *
-                                          M_STATIC_CAST(uint64_t, trimBufferSize) * maxUnmapRangePerDescriptor))
+                uint64_t blocksNeeded =
+                    ((entriesNeeded * descriptorSize) + LEGACY_DRIVE_SEC_SIZE - UINT64_C(1)) / LEGACY_DRIVE_SEC_SIZE;
+                if (blocksNeeded < trimBufferSize)
                 {
-                    // not setting sense key specific information because it's not clear in this condition what error we
-                    // should point to
-                    ret = FAILURE;
-                    set_Sense_Data_For_Translation(
-                        scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0,
-                        device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
-                    exitLoop = true;
-                    break;
+                    trimBufferSize = C_CAST(uint16_t, M_Max(blocksNeeded, UINT64_C(1)));
+                }
+                trimBuffer = M_REINTERPRET_CAST(
+                    uint8_t*, safe_calloc_aligned(uint16_to_sizet(trimBufferSize) * LEGACY_DRIVE_SEC_SIZE,
+                                                  sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+                if (trimBuffer == M_NULLPTR)
+                {
+                    safe_free(&ranges);
+                    set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize,
+                                                   SENSE_KEY_VENDOR_SPECIFIC, 0x44, 0,
+                                                   device->drive_info.softSATFlags.senseDataDescriptorFormat,
+                                                   M_NULLPTR, 0);
+                    return MEMORY_FAILURE;
                 }
-                // now that we've done all of our checks so far, start setting up the buffer
-                // break this block descriptor into multiple ATA entries if necessary
-                while (unmapNumberOfLogicalBlocks > 0)
-                {
-                    // lba
-                    trimBuffer[ataTrimOffset + 0] = M_Byte5(unmapLogicalBlockAddress);
-                    trimBuffer[ataTrimOffset + 1] = M_Byte4(unmapLogicalBlockAddress);
-                    trimBuffer[ataTrimOffset + 2] = M_Byte3(unmapLogicalBlockAddress);
-                    trimBuffer[ataTrimOffset + 3] = M_Byte2(unmapLogicalBlockAddress);
-                    trimBuffer[ataTrimOffset + 4] = M_Byte1(unmapLogicalBlockAddress);
-                    trimBuffer[ataTrimOffset + 5] = M_Byte0(unmapLogicalBlockAddress);
-                    // range (set for XL vs non-XL commands!)
-                    if (useXL)
+            }
+            if (ret == SUCCESS)
+            {
+                uint32_t rangeIndex  = UINT32_C(0);
+                uint64_t rangeOffset = UINT64_C(0);
+                // queued TRIM has no XL form in this translator, so only use it for the regular range entries
+                bool queued = !useXL && sat_Is_NCQ_Trim_Supported(device);
+                while (rangeIndex < numberOfRanges)
+                {
+                    uint32_t entries =
+                        fill_ATA_DSM_Trim_Buffer(ranges, numberOfRanges, &rangeIndex, &rangeOffset, trimBuffer,
+                                                 C_CAST(uint32_t, trimBufferSize) * LEGACY_DRIVE_SEC_SIZE, useXL);
+                    // only transfer the 512B blocks that hold entries rather than the full maximum the drive allows
+                    uint32_t transferLength = ((entries * descriptorSize) + LEGACY_DRIVE_SEC_SIZE - UINT32_C(1)) /
+                                              LEGACY_DRIVE_SEC_SIZE * LEGACY_DRIVE_SEC_SIZE;
+                    eReturnValues trimRet = FAILURE;
+                    if (entries == UINT32_C(0))
                     {
-                        trimBuffer[ataTrimOffset + 6]  = RESERVED;
-                        trimBuffer[ataTrimOffset + 7]  = RESERVED;
-                        trimBuffer[ataTrimOffset + 8]  = M_Byte7(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 9]  = M_Byte6(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 10] = M_Byte5(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 11] = M_Byte4(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 12] = M_Byte3(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 13] = M_Byte2(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 14] = M_Byte1(unmapNumberOfLogicalBlocks);
-                        trimBuffer[ataTrimOffset + 15] = M_Byte0(unmapNumberOfLogicalBlocks);
+                        break;
                     }
-                    else
+                    if (queued)
                     {
-                        if (unmapNumberOfLogicalBlocks > UINT16_MAX)
-                        {
-                            trimBuffer[ataTrimOffset + 6] = UINT8_MAX;
-                            trimBuffer[ataTrimOffset + 7] = UINT8_MAX;
-                            unmapNumberOfLogicalBlocks -= UINT16_MAX;
-                            unmapLogicalBlockAddress += UINT16_MAX;
-                        }
-                        else
+                        trimRet = ata_NCQ_Data_Set_Management(device, true, trimBuffer, transferLength, 0, 0);
+                        if (trimRet != SUCCESS)
                         {
-                            trimBuffer[ataTrimOffset + 6] = M_Byte1(unmapNumberOfLogicalBlocks);
-                            trimBuffer[ataTrimOffset + 7] = M_Byte0(unmapNumberOfLogicalBlocks);
+                            // Some drives or passthroughs do not handle this well. Fall back to the non-queued command
+                            // and do not try queued again.
+                            sat_Disable_NCQ_Trim(device);
+                            queued = false;
                         }
                     }
-                    // now increment the ataTrimOffset
-                    ataTrimOffset += descriptorSize;
-                    // check if the ATA Trim buffer is full...if it is and there are more or potentially more block
-                    // descriptors, send the command now
-                    if ((ataTrimOffset > (trimBufferSize * LEGACY_DRIVE_SEC_SIZE)) &&
-                        ((unmapBlockDescriptorIter + UINT16_C(16)) < minBlockDescriptorLength))
+                    if (!queued)
                     {
-                        if (SUCCESS == ata_Data_Set_Management(device, true, trimBuffer,
-                                                               trimBufferSize * LEGACY_DRIVE_SEC_SIZE, useXL))
-                        {
-                            // clear the buffer for reuse
-                            if (0 != safe_memset(trimBuffer, uint16_to_sizet(trimBufferSize) * LEGACY_DRIVE_SEC_SIZE, 0,
-                                                 uint16_to_sizet(trimBufferSize) * LEGACY_DRIVE_SEC_SIZE))
-                                M_UNLIKELY
-                                {
-                                    set_Sense_Data_For_Translation(
-                                        scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_VENDOR_SPECIFIC, 0x44, 0,
-                                        scsiIoCtx->device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR,
-                                        0);
-                                    safe_free_aligned(&trimBuffer);
-                                    perror("SATL Error clearing trim buffer before reusing for next command.");
-                                    return MEMORY_FAILURE;
-                                }
-                            // reset the ataTrimOffset
-                            ataTrimOffset = 0;
-                        }
-                        else
-                        {
-                            ret = FAILURE;
-                            set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
-                                                    scsiIoCtx->senseDataSize);
-                            exitLoop = true;
-                            break;
-                        }
+                        trimRet = ata_Data_Set_Management(device, true, trimBuffer, transferLength, useXL);
+                    }
+                    if (trimRet != SUCCESS)
+                    {
+                        ret = FAILURE;
+                        set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
+                                                scsiIoCtx->senseDataSize);
+                        break;
                     }
-                }
-                if (exitLoop)
-                {
-                    break;
-                }
-            }
-            if (ret == SUCCESS)
-            {
-                // send the data set management command with whatever is in the trim buffer at this point (all zeros is
-                // safe to send if we do get that)
-                if (SUCCESS !=
-                    ata_Data_Set_Management(device, true, trimBuffer, trimBufferSize * LEGACY_DRIVE_SEC_SIZE, useXL))
-                {
-                    ret = FAILURE;
-                    set_Sense_Data_By_RTFRs(device, &device->drive_info.lastCommandRTFRs, scsiIoCtx->psense,
-                                            scsiIoCtx->senseDataSize);
                 }
             }
+            safe_free(&ranges);
             safe_free_aligned(&trimBuffer);
         }
     }
@@ -12813,7 +13075,7 @@ static eReturnValues translate_Mode_Sense_Control_0Ah(const tDevice* device,
              le16_to_host(device->drive_info.IdentifyData.ata.Word085) & BIT0))
         {
             DECLARE_ZERO_INIT_ARRAY(uint8_t, smartData, LEGACY_DRIVE_SEC_SIZE);
-            if (SUCCESS == ata_SMART_Read_Data(device, smartData, LEGACY_DRIVE_SEC_SIZE))
+            if (SUCCESS == sat_SMART_Read_Data(device, smartData))
             {
                 if (smartData[373] != UINT8_MAX)
                 {
@@ -14120,7 +14382,7 @@ static eReturnValues translate_Mode_Sense_Caching_08h(const tDevice* device,
     else // saved, current, and default. TODO: Handle saving what the drive had when we started talking to it.
     {
         DECLARE_ZERO_INIT_ARRAY(uint8_t, iddata, LEGACY_DRIVE_SEC_SIZE);
-        ata_Identify(device, iddata, LEGACY_DRIVE_SEC_SIZE);
+        sat_Identify(device, iddata, false, M_NULLPTR);
         set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NO_ERROR, 0, 0,
                                        device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
         if (is_ATA_Identify_Word_Valid(le16_to_host(device->drive_info.IdentifyData.ata.Word085)) &&
@@ -19338,6 +19600,48 @@ static eReturnValues create_All_Supported_Op_Codes_Buffer(const tDevice* device,
     return ret;
 }
 
+// The full list only depends on the identify data and flags from discovery, so it is generated once and returned from
+// the translator cache after that. The returned pointer belongs to the cache and must not be freed.
+static eReturnValues get_All_Supported_Op_Codes_Buffer(const tDevice*  device,
+                                                       bool            rctd,
+                                                       const uint8_t** pdata,
+                                                       uint32_t*       dataLength)
+{
+    eReturnValues         ret   = SUCCESS;
+    ptrSatTranslatorCache cache = get_SAT_Translator_Cache(device);
+    uint8_t               index = rctd ? UINT8_C(1) : UINT8_C(0);
+    if (cache == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    if (!cache->allOpCodes[index].valid)
+    {
+        uint8_t* opCodes       = M_NULLPTR;
+        uint32_t opCodesLength = UINT32_C(0);
+        ret                    = create_All_Supported_Op_Codes_Buffer(device, rctd, &opCodes, &opCodesLength);
+        if (ret == SUCCESS)
+        {
+            if (0 == safe_memcpy(cache->allOpCodes[index].data, SAT_ALL_OP_CODES_MAX_LENGTH, opCodes,
+                                 M_Min(opCodesLength, SAT_ALL_OP_CODES_MAX_LENGTH)))
+            {
+                cache->allOpCodes[index].length = M_Min(opCodesLength, SAT_ALL_OP_CODES_MAX_LENGTH);
+                cache->allOpCodes[index].valid  = true;
+            }
+            else
+            {
+                ret = FAILURE;
+            }
+        }
+        safe_free(&opCodes);
+    }
+    if (ret == SUCCESS)
+    {
+        *pdata      = cache->allOpCodes[index].data;
+        *dataLength = cache->allOpCodes[index].length;
+    }
+    return ret;
+}
+
 static eReturnValues translate_SCSI_Report_Supported_Operation_Codes_Command(const tDevice* device,
                                                                              ScsiIoCtx*     scsiIoCtx)
 {
@@ -19348,8 +19652,9 @@ static eReturnValues translate_SCSI_Report_Supported_Operation_Codes_Command(con
     uint16_t      requestedServiceAction = M_BytesTo2ByteValue(scsiIoCtx->cdb[CDB_4], scsiIoCtx->cdb[CDB_5]);
     uint32_t      allocationLength =
         M_BytesTo4ByteValue(scsiIoCtx->cdb[CDB_6], scsiIoCtx->cdb[CDB_7], scsiIoCtx->cdb[CDB_8], scsiIoCtx->cdb[CDB_9]);
-    uint8_t* supportedOpData       = M_NULLPTR;
-    uint32_t supportedOpDataLength = UINT32_C(0);
+    uint8_t*       supportedOpData       = M_NULLPTR;
+    const uint8_t* cachedOpData          = M_NULLPTR; // owned by the translator cache. Do not free
+    uint32_t       supportedOpDataLength = UINT32_C(0);
     DECLARE_ZERO_INIT_ARRAY(uint8_t, senseKeySpecificDescriptor, 8);
     uint8_t  bitPointer   = UINT8_C(0);
     uint16_t fieldPointer = UINT16_C(0);
@@ -19390,7 +19695,7 @@ static eReturnValues translate_SCSI_Report_Supported_Operation_Codes_Command(con
     switch (reportingOptions)
     {
     case 0: // return all op codes (return not supported for now until we get the other methods working...)
-        ret = create_All_Supported_Op_Codes_Buffer(device, rctd, &supportedOpData, &supportedOpDataLength);
+        ret = get_All_Supported_Op_Codes_Buffer(device, rctd, &cachedOpData, &supportedOpDataLength);
         break;
     case 1: // check operation code, service action ignored
         // check op code func
@@ -19434,9 +19739,10 @@ static eReturnValues translate_SCSI_Report_Supported_Operation_Codes_Command(con
                                        0x00, device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
         break;
     }
-    if (supportedOpData && scsiIoCtx->pdata)
+    const uint8_t* returnOpData = supportedOpData != M_NULLPTR ? supportedOpData : cachedOpData;
+    if (returnOpData && scsiIoCtx->pdata)
     {
-        if (0 != safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, supportedOpData,
+        if (0 != safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, returnOpData,
                              M_Min(supportedOpDataLength, allocationLength)))
         {
             perror("SATL Error copying supported op codes to return data buffer");
@@ -19506,7 +19812,8 @@ M_PARAM_RW(2) eReturnValues translate_SCSI_Command(const tDevice* M_NONNULL devi
     set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NO_ERROR, 0, 0,
                                    device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
     // if the ataIdentify data is zero, send an identify at least once so we aren't sending that every time we do a read
-    // or write command...inquiry, read capacity will always do one though to get the most recent data
+    // or write command...inquiry, read capacity reuse the translator's cached identify until a command that may change
+    // it (mode select, format, sanitize, etc) is translated
     if (!deviceInfoAvailable)
     {
         DECLARE_ZERO_INIT_ARRAY(uint8_t, zeroData, LEGACY_DRIVE_SEC_SIZE);
@@ -19845,6 +20152,12 @@ M_PARAM_RW(2) eReturnValues translate_SCSI_Command(const tDevice* M_NONNULL devi
                                            senseKeySpecificDescriptor, 1);
             ret = NOT_SUPPORTED;
         }
+        if (!invalidFieldInCDB && !invalidOperationCode &&
+            does_SCSI_Command_Invalidate_SAT_Cache(scsiIoCtx->cdb[CDB_OPERATION_CODE]))
+        {
+            // identify data, logs, and counters may all be different now, even if the command failed part way through
+            sat_Invalidate_Translator_Cache(device);
+        }
     }
     return ret;
 }
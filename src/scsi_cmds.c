@@ -24,7 +24,11 @@
 #include "string_utils.h"
 #include "type_conversion.h"
 
+#include "command_capture.h"
+#include "command_stats.h"
 #include "common_public.h"
+#include "fault_injection.h"
+#include "flight_recorder.h"
 #include "platform_helper.h"
 #include "scsi_helper_func.h"
 
@@ -60,26 +64,176 @@ static M_INLINE bool did_SCSI_Command_Timeout(const ScsiIoCtx* M_NONNULL scsiIoC
     return timedOut;
 }
 
-// This is the private function so that it can be called by the ATA layer as well and make everything follow one single
-// code path instead of multiple. This will enhance debug output since it will consistently be in one place for SCSI
-// passthrough commands.
+// Opcodes that have a service action bitmap in the supported op code map. The index in this table is the index in
+// scsiOpCodeSupportMap.serviceActions
+static const uint8_t scsiOpCodeMapSAOpcodes[SCSI_OPCODE_MAP_SERVICE_ACTION_OPCODES] = {
+    SANITIZE_CMD,
+    PERSISTENT_RESERVE_IN_CMD,
+    PERSISTENT_RESERVE_OUT_CMD,
+    0x7F, // variable length CDBs (32B read/write/verify, etc)
+    0x83, // third party copy out
+    0x84, // third party copy in
+    ZONE_MANAGEMENT_OUT,
+    ZONE_MANAGEMENT_IN,
+    0x9E, // service action in (16)
+    0x9F, // service action out (16)
+    MAINTENANCE_IN_CMD,
+    MAINTENANCE_OUT_CMD,
+    0xA9, // service action out (12)
+    0xAB  // service action in (12)
+};
+
+static M_INLINE int get_SCSI_Op_Code_Map_SA_Index(uint8_t operationCode)
+{
+    int index = -1;
+    for (int iter = 0; iter < SCSI_OPCODE_MAP_SERVICE_ACTION_OPCODES; ++iter)
+    {
+        if (scsiOpCodeMapSAOpcodes[iter] == operationCode)
+        {
+            index = iter;
+            break;
+        }
+    }
+    return index;
+}
+
+M_PARAM_RO(1)
+OPENSEA_TRANSPORT_API eSCSICmdSupport get_SCSI_Op_Code_Support_From_Map(const tDevice* M_NONNULL device,
+                                                                        uint8_t                  operationCode,
+                                                                        bool                     serviceActionValid,
+                                                                        uint16_t                 serviceAction)
+{
+    eSCSICmdSupport cmdsupport = SCSI_CMD_SUPPORT_UNKNOWN;
+    if (device != M_NULLPTR && device->drive_info.scsiOpCodeSupport.validMap)
+    {
+        const scsiOpCodeSupportMap* map = &device->drive_info.scsiOpCodeSupport;
+        if (map->opcodes[operationCode / 8] & M_BitN8(operationCode % 8))
+        {
+            cmdsupport = operationCode >= 0xC0 ? SCSI_CMD_SUPPORT_SUPPORTED_VENDOR_SPECIFIC
+                                               : SCSI_CMD_SUPPORT_SUPPORTED_TO_SCSI_STANDARD;
+            if (serviceActionValid)
+            {
+                int saIndex = get_SCSI_Op_Code_Map_SA_Index(operationCode);
+                if (saIndex >= 0)
+                {
+                    if (serviceAction > SCSI_OPCODE_MAP_MAX_SERVICE_ACTION)
+                    {
+                        // not tracked, so cannot say one way or the other
+                        cmdsupport = SCSI_CMD_SUPPORT_UNKNOWN;
+                    }
+                    else if (!(map->serviceActions[saIndex] & M_BitN32(serviceAction)))
+                    {
+                        cmdsupport = SCSI_CMD_SUPPORT_NOT_SUPPORTED;
+                    }
+                }
+            }
+        }
+        else
+        {
+            cmdsupport = SCSI_CMD_SUPPORT_NOT_SUPPORTED;
+        }
+    }
+    return cmdsupport;
+}
+
+// Checks the CDB against the supported op code map to see if it can be failed without sending it to the device.
+// Commands required to identify the device, vendor unique commands, and ATA passthrough commands are never blocked
+// since some devices and translators leave these out of their reported list.
+M_PARAM_RO(1)
+static bool is_CDB_Unsupported_By_Op_Code_Map(const ScsiIoCtx* M_NONNULL scsiIoCtx)
+{
+    bool    unsupported   = false;
+    uint8_t operationCode = scsiIoCtx->cdb[CDB_OPERATION_CODE];
+    switch (operationCode)
+    {
+    case TEST_UNIT_READY_CMD:
+    case REQUEST_SENSE_CMD:
+    case INQUIRY_CMD:
+    case REPORT_LUNS_CMD:
+    case MAINTENANCE_IN_CMD:
+    case ATA_PASS_THROUGH_12:
+    case ATA_PASS_THROUGH_16:
+        break;
+    default:
+        if (operationCode < 0xC0)
+        {
+            bool     serviceActionValid = false;
+            uint16_t serviceAction      = UINT16_C(0);
+            if (get_SCSI_Op_Code_Map_SA_Index(operationCode) >= 0)
+            {
+                serviceActionValid = true;
+                if (operationCode == 0x7F)
+                {
+                    if (scsiIoCtx->cdbLength >= 10)
+                    {
+                        serviceAction = M_BytesTo2ByteValue(scsiIoCtx->cdb[8], scsiIoCtx->cdb[9]);
+                    }
+                    else
+                    {
+                        serviceActionValid = false;
+                    }
+                }
+                else
+                {
+                    serviceAction = get_bit_range_uint8(scsiIoCtx->cdb[1], 4, 0);
+                }
+            }
+            if (SCSI_CMD_SUPPORT_NOT_SUPPORTED == get_SCSI_Op_Code_Support_From_Map(scsiIoCtx->device, operationCode,
+                                                                                   serviceActionValid, serviceAction))
+            {
+                unsupported = true;
+            }
+        }
+        break;
+    }
+    return unsupported;
+}
+
+// Checks if a command can skip all sense data decoding: the OS reported no errors, the device did not return any sense
+// data, and there is no verbose output to generate. This is the case for nearly every command in a read or verify loop.
+// The last command sense data in the tDevice is still cleared, so anything that needs sense fields later can decode it.
+M_PARAM_RO(1)
+static M_INLINE bool is_SCSI_Fast_Completion(const ScsiIoCtx* M_NONNULL scsiIoCtx, eReturnValues sendIOret)
+{
+    bool fastCompletion = false;
+    if (sendIOret == SUCCESS && scsiIoCtx->device->deviceVerbosity < VERBOSITY_COMMAND_VERBOSE &&
+        (scsiIoCtx->psense == M_NULLPTR || scsiIoCtx->senseDataSize == UINT32_C(0) ||
+         (scsiIoCtx->psense[0] & 0x7F) == SCSI_SENSE_NO_SENSE_DATA) &&
+        !did_SCSI_Command_Timeout(scsiIoCtx))
+    {
+        fastCompletion = true;
+    }
+    return fastCompletion;
+}
+
+// Sense fields are only allocated when there is sense data to decode and the caller did not provide any.
 M_PARAM_RW(1)
 M_PARAM_WO(2)
-eReturnValues private_SCSI_Send_CDB(ScsiIoCtx* M_NONNULL scsiIoCtx, ptrSenseDataFields pSenseFields)
+static M_INLINE eReturnValues get_Sense_Fields_For_Decoding(ptrSenseDataFields* M_NONNULL pSenseFields,
+                                                            bool* M_NONNULL               localSenseFieldsAllocated)
 {
-    eReturnValues      ret                       = UNKNOWN;
-    bool               localSenseFieldsAllocated = false;
-    ptrSenseDataFields localSenseFields          = M_NULLPTR;
-    if (pSenseFields == M_NULLPTR)
+    *localSenseFieldsAllocated = false;
+    if (*pSenseFields == M_NULLPTR)
     {
-        localSenseFields = M_REINTERPRET_CAST(ptrSenseDataFields, safe_calloc(1, sizeof(senseDataFields)));
-        if (!localSenseFields)
+        *pSenseFields = M_REINTERPRET_CAST(ptrSenseDataFields, safe_calloc(1, sizeof(senseDataFields)));
+        if (*pSenseFields == M_NULLPTR)
         {
             return MEMORY_FAILURE;
         }
-        localSenseFieldsAllocated = true;
-        pSenseFields              = localSenseFields;
+        *localSenseFieldsAllocated = true;
     }
+    return SUCCESS;
+}
+
+// This is the private function so that it can be called by the ATA layer as well and make everything follow one single
+// code path instead of multiple. This will enhance debug output since it will consistently be in one place for SCSI
+// passthrough commands.
+M_PARAM_RW(1)
+M_PARAM_WO(2)
+eReturnValues private_SCSI_Send_CDB(ScsiIoCtx* M_NONNULL scsiIoCtx, ptrSenseDataFields pSenseFields)
+{
+    eReturnValues ret                       = UNKNOWN;
+    bool          localSenseFieldsAllocated = false;
     // clear the last command sense data every single time before we issue any commands
     M_INITIALIZE_STRUCTURE(M_CONST_CAST(uint8_t*, scsiIoCtx->device->drive_info.lastCommandSenseData), SPC3_SENSE_LEN);
     if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > 0 &&
@@ -89,6 +243,49 @@ eReturnValues private_SCSI_Send_CDB(ScsiIoCtx* M_NONNULL scsiIoCtx, ptrSenseData
         // set sense data to zero to make sure there is no extra data left over in this buffer
         explicit_zeroes(M_CONST_CAST(uint8_t*, scsiIoCtx->psense), scsiIoCtx->senseDataSize);
     }
+    if (scsiIoCtx->device->drive_info.scsiOpCodeSupport.validMap && is_CDB_Unsupported_By_Op_Code_Map(scsiIoCtx))
+    {
+        // The device already told us it does not support this command, so do not issue it. Set invalid operation
+        // code sense data the same as the device would so that all the existing fallbacks to other command sizes
+        // happen without a round trip to the device.
+        uint8_t* lastSense = M_CONST_CAST(uint8_t*, scsiIoCtx->device->drive_info.lastCommandSenseData);
+        if (SUCCESS != get_Sense_Fields_For_Decoding(&pSenseFields, &localSenseFieldsAllocated))
+        {
+            return MEMORY_FAILURE;
+        }
+        lastSense[0]       = SCSI_SENSE_CUR_INFO_FIXED;
+        lastSense[2]       = SENSE_KEY_ILLEGAL_REQUEST;
+        lastSense[7]       = UINT8_C(10); // additional sense length
+        lastSense[12]      = UINT8_C(0x20);
+        lastSense[13]      = UINT8_C(0x00);
+        if (scsiIoCtx->psense != M_NULLPTR && scsiIoCtx->senseDataSize > 0 &&
+            M_STATIC_CAST(uintptr_t, scsiIoCtx->psense) != M_STATIC_CAST(uintptr_t, lastSense))
+        {
+            if (0 != safe_memcpy(scsiIoCtx->psense, scsiIoCtx->senseDataSize, lastSense,
+                                 M_Min(SPC3_SENSE_LEN, scsiIoCtx->senseDataSize)))
+                M_UNLIKELY
+                {
+                    perror("Error copying sense data for unsupported operation code.");
+                }
+        }
+        set_tDevice_Last_Command_Completion_Time_NS(M_CONST_CAST(tDevice*, scsiIoCtx->device), UINT64_C(0));
+        print_tDevice_Verbose_String(scsiIoCtx->device, VERBOSITY_COMMAND_VERBOSE,
+                                     "\n  Skipping CDB. Operation code not in device's supported list\n");
+        get_Sense_Data_Fields(lastSense, SPC3_SENSE_LEN, pSenseFields);
+        scsiIoCtx->returnStatus.format   = SCSI_SENSE_CUR_INFO_FIXED;
+        scsiIoCtx->returnStatus.senseKey = SENSE_KEY_ILLEGAL_REQUEST;
+        scsiIoCtx->returnStatus.asc      = UINT8_C(0x20);
+        scsiIoCtx->returnStatus.ascq     = UINT8_C(0x00);
+        ret = check_Sense_Key_ASC_ASCQ_And_FRU(scsiIoCtx->device, pSenseFields->scsiStatusCodes.senseKey,
+                                               pSenseFields->scsiStatusCodes.asc, pSenseFields->scsiStatusCodes.ascq,
+                                               pSenseFields->scsiStatusCodes.fru);
+        print_Sense_Fields_Verbose(scsiIoCtx->device, VERBOSITY_COMMAND_VERBOSE, pSenseFields);
+        if (localSenseFieldsAllocated)
+        {
+            safe_free_sensefields(&pSenseFields);
+        }
+        return ret;
+    }
     print_tDevice_Verbose_String(scsiIoCtx->device, VERBOSITY_COMMAND_VERBOSE, "\n  CDB:\n");
     print_tDevice_Data_Buffer(scsiIoCtx->device, VERBOSITY_COMMAND_VERBOSE, scsiIoCtx->cdb, scsiIoCtx->cdbLength,
                               false);
@@ -107,7 +304,52 @@ eReturnValues private_SCSI_Send_CDB(ScsiIoCtx* M_NONNULL scsiIoCtx, ptrSenseData
         print_tDevice_Verbose_String(scsiIoCtx->device, VERBOSITY_BUFFERS, "\n");
     }
     // send the command
-    eReturnValues sendIOret = send_IO(scsiIoCtx);
+    if (is_Command_Stats_Enabled(scsiIoCtx->device))
+    {
+        begin_Command_Stats(scsiIoCtx->device);
+    }
+    eReturnValues sendIOret = UNKNOWN;
+    if (is_Fault_Injection_Active(scsiIoCtx->device) && inject_SCSI_Fault(scsiIoCtx, &sendIOret))
+    {
+        // completed by an injected fault instead of the OS
+    }
+    else if (is_Command_Capture_Or_Replay_Active(scsiIoCtx->device))
+    {
+        sendIOret = send_IO_With_Command_Capture(scsiIoCtx);
+    }
+    else
+    {
+        sendIOret = send_IO(scsiIoCtx);
+    }
+    if (is_Flight_Recorder_Enabled(scsiIoCtx->device))
+    {
+        record_SCSI_Flight_Recorder_Entry(scsiIoCtx, sendIOret);
+    }
+    if (is_SCSI_Fast_Completion(scsiIoCtx, sendIOret))
+    {
+        if (is_Command_Stats_Enabled(scsiIoCtx->device))
+        {
+            end_Command_Stats(scsiIoCtx->device,
+                              get_SCSI_Command_Stats_Class(scsiIoCtx->cdb, scsiIoCtx->cdbLength), SUCCESS);
+        }
+        // Good status and no sense data. There is nothing to look up or print, the last command sense data is already
+        // cleared, and the test unit ready workaround only runs after failures.
+        if (pSenseFields != M_NULLPTR)
+        {
+            M_INITIALIZE_STRUCTURE(pSenseFields, sizeof(senseDataFields));
+            pSenseFields->validStructure = true;
+        }
+        return SUCCESS;
+    }
+    if (SUCCESS != get_Sense_Fields_For_Decoding(&pSenseFields, &localSenseFieldsAllocated))
+    {
+        if (is_Command_Stats_Enabled(scsiIoCtx->device))
+        {
+            end_Command_Stats(scsiIoCtx->device,
+                              get_SCSI_Command_Stats_Class(scsiIoCtx->cdb, scsiIoCtx->cdbLength), sendIOret);
+        }
+        return MEMORY_FAILURE;
+    }
     if (scsiIoCtx->psense)
     {
         print_tDevice_Verbose_String(scsiIoCtx->device, VERBOSITY_COMMAND_VERBOSE, "\n  Sense Data Buffer:\n");
@@ -192,9 +434,15 @@ eReturnValues private_SCSI_Send_CDB(ScsiIoCtx* M_NONNULL scsiIoCtx, ptrSenseData
         }
     }
 
+    if (is_Command_Stats_Enabled(scsiIoCtx->device))
+    {
+        end_Command_Stats(scsiIoCtx->device, get_SCSI_Command_Stats_Class(scsiIoCtx->cdb, scsiIoCtx->cdbLength),
+                          ret);
+    }
+
     if (localSenseFieldsAllocated)
     {
-        safe_free_sensefields(&localSenseFields);
+        safe_free_sensefields(&pSenseFields);
     }
     return ret;
 }
@@ -633,7 +881,18 @@ OPENSEA_TRANSPORT_API eSCSICmdSupport is_SCSI_Operation_Code_Supported(const tDe
     if (device != M_NULLPTR && request != M_NULLPTR)
     {
         bool checkCmd = true;
-        if (device->drive_info.passThroughHacks.scsiHacks.noReportSupportedOperations &&
+        if (SCSI_CMD_SUPPORT_NOT_SUPPORTED ==
+            get_SCSI_Op_Code_Support_From_Map(device, request->operationCode, request->serviceActionValid,
+                                              request->serviceAction))
+        {
+            // Already known from the full list read during discovery. No need to ask again.
+            request->requestRetriedWithoutSA = false;
+            request->multipleLogicalUnits    = 0;
+            request->cdbUsageDataLength      = 0;
+            cmdsupport                       = SCSI_CMD_SUPPORT_NOT_SUPPORTED;
+            checkCmd                         = false;
+        }
+        else if (device->drive_info.passThroughHacks.scsiHacks.noReportSupportedOperations &&
             (device->drive_info.passThroughHacks.scsiHacks.cmdDTchecked &&
              !device->drive_info.passThroughHacks.scsiHacks.cmdDTSupported))
         {
@@ -671,6 +930,172 @@ OPENSEA_TRANSPORT_API eSCSICmdSupport is_SCSI_Operation_Code_Supported(const tDe
     return cmdsupport;
 }
 
+#define SCSI_OP_CODE_MAP_INITIAL_ALLOCATION UINT32_C(8192)
+
+static M_INLINE bool is_Op_Code_Set_In_Map(const scsiOpCodeSupportMap* M_NONNULL map, uint8_t operationCode)
+{
+    return (map->opcodes[operationCode / 8] & M_BitN8(operationCode % 8)) > 0;
+}
+
+// Sets the same command size hacks that would otherwise be learned one failed command at a time.
+M_PARAM_RW(1)
+static void set_SCSI_Hacks_From_Op_Code_Map(tDevice* M_NONNULL device)
+{
+    const scsiOpCodeSupportMap* map = &device->drive_info.scsiOpCodeSupport;
+    if (!device->drive_info.passThroughHacks.scsiHacks.readWrite.available)
+    {
+        device->drive_info.passThroughHacks.scsiHacks.readWrite.rw6 =
+            is_Op_Code_Set_In_Map(map, READ6) && is_Op_Code_Set_In_Map(map, WRITE6);
+        device->drive_info.passThroughHacks.scsiHacks.readWrite.rw10 =
+            is_Op_Code_Set_In_Map(map, READ10) && is_Op_Code_Set_In_Map(map, WRITE10);
+        device->drive_info.passThroughHacks.scsiHacks.readWrite.rw12 =
+            is_Op_Code_Set_In_Map(map, READ12) && is_Op_Code_Set_In_Map(map, WRITE12);
+        device->drive_info.passThroughHacks.scsiHacks.readWrite.rw16 =
+            is_Op_Code_Set_In_Map(map, READ16) && is_Op_Code_Set_In_Map(map, WRITE16);
+        device->drive_info.passThroughHacks.scsiHacks.readWrite.available =
+            device->drive_info.passThroughHacks.scsiHacks.readWrite.rw6 ||
+            device->drive_info.passThroughHacks.scsiHacks.readWrite.rw10 ||
+            device->drive_info.passThroughHacks.scsiHacks.readWrite.rw12 ||
+            device->drive_info.passThroughHacks.scsiHacks.readWrite.rw16;
+    }
+    if (device->drive_info.passThroughHacks.scsiHacks.writeSameCmdSize == INT8_C(0))
+    {
+        if (is_Op_Code_Set_In_Map(map, WRITE_SAME_16_CMD))
+        {
+            device->drive_info.passThroughHacks.scsiHacks.writeSameCmdSize = INT8_C(16);
+        }
+        else if (is_Op_Code_Set_In_Map(map, WRITE_SAME_10_CMD))
+        {
+            device->drive_info.passThroughHacks.scsiHacks.writeSameCmdSize         = INT8_C(10);
+            device->drive_info.passThroughHacks.scsiHacks.writeSameDataOutRequired = true;
+        }
+        else
+        {
+            device->drive_info.passThroughHacks.scsiHacks.writeSameCmdSize = INT8_C(-1);
+        }
+    }
+    if (device->drive_info.passThroughHacks.scsiHacks.syncCacheCmdSize == INT8_C(0) &&
+        !is_Op_Code_Set_In_Map(map, SYNCHRONIZE_CACHE_16_CMD) && !is_Op_Code_Set_In_Map(map, SYNCHRONIZE_CACHE_10))
+    {
+        device->drive_info.passThroughHacks.scsiHacks.syncCacheCmdSize = INT8_C(-1);
+    }
+    if (device->drive_info.passThroughHacks.scsiHacks.writeAndVerifyCmdSize == INT8_C(0) &&
+        !is_Op_Code_Set_In_Map(map, WRITE_AND_VERIFY_16) && !is_Op_Code_Set_In_Map(map, WRITE_AND_VERIFY_12) &&
+        !is_Op_Code_Set_In_Map(map, WRITE_AND_VERIFY_10))
+    {
+        device->drive_info.passThroughHacks.scsiHacks.writeAndVerifyCmdSize = INT8_C(-1);
+    }
+    if (!is_Op_Code_Set_In_Map(map, VERIFY16) && !is_Op_Code_Set_In_Map(map, VERIFY12) &&
+        !is_Op_Code_Set_In_Map(map, VERIFY10))
+    {
+        // compare uses verify with byte check, so no reason to try it
+        device->drive_info.passThroughHacks.scsiHacks.noCompareLogicalBlocks = true;
+    }
+}
+
+M_PARAM_RW(1)
+OPENSEA_TRANSPORT_API eReturnValues read_SCSI_Supported_Op_Code_Map(tDevice* M_NONNULL device)
+{
+    eReturnValues ret = NOT_SUPPORTED;
+    if (device == M_NULLPTR)
+    {
+        return BAD_PARAMETER;
+    }
+    M_INITIALIZE_STRUCTURE(&device->drive_info.scsiOpCodeSupport, sizeof(scsiOpCodeSupportMap));
+    // Devices in the hacks database only get this if it is known to work. Otherwise rely on SPC3 being reported since
+    // that is when this command became part of the standard.
+    if (device->drive_info.scsiVersion >= SCSI_VERSION_SPC_3 &&
+        !device->drive_info.passThroughHacks.scsiHacks.noReportSupportedOperations &&
+        (!device->drive_info.passThroughHacks.hacksSetByReportedID ||
+         device->drive_info.passThroughHacks.scsiHacks.reportAllOpCodes))
+    {
+        uint32_t allocationLength = SCSI_OP_CODE_MAP_INITIAL_ALLOCATION;
+        uint8_t  attempts         = UINT8_C(0);
+        if (device->drive_info.passThroughHacks.scsiHacks.maxTransferLength > 0)
+        {
+            allocationLength =
+                M_Min(allocationLength, device->drive_info.passThroughHacks.scsiHacks.maxTransferLength);
+        }
+        while (attempts < UINT8_C(2))
+        {
+            uint8_t* opList = M_REINTERPRET_CAST(
+                uint8_t*, safe_calloc_aligned(allocationLength, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+            if (opList == M_NULLPTR)
+            {
+                return MEMORY_FAILURE;
+            }
+            ++attempts;
+            ret = scsi_Report_Supported_Operation_Codes(device, false, REPORT_ALL, 0, 0, allocationLength, opList);
+            if (ret == SUCCESS)
+            {
+                uint32_t listLength = M_BytesTo4ByteValue(opList[0], opList[1], opList[2], opList[3]);
+                if (listLength > (allocationLength - UINT32_C(4)))
+                {
+                    // Need the whole list or the map cannot say something is not supported. Retry once with the
+                    // full length if the device can transfer that much.
+                    if (listLength <= (SCSI_REPORT_ALL_OPS_MAX_LENGTH - UINT32_C(4)) &&
+                        (device->drive_info.passThroughHacks.scsiHacks.maxTransferLength == 0 ||
+                         listLength + UINT32_C(4) <= device->drive_info.passThroughHacks.scsiHacks.maxTransferLength))
+                    {
+                        allocationLength = listLength + UINT32_C(4);
+                        safe_free_aligned(&opList);
+                        continue;
+                    }
+                    ret = NOT_SUPPORTED;
+                }
+                else
+                {
+                    scsiOpCodeSupportMap* map     = &device->drive_info.scsiOpCodeSupport;
+                    uint32_t              saNoSA  = UINT32_C(0); // opcodes in the SA table reported without an SA
+                    uint32_t              offset  = UINT32_C(4);
+                    uint32_t              listEnd = listLength + UINT32_C(4);
+                    for (; (offset + UINT32_C(8)) <= listEnd;
+                         offset += UINT32_C(8) + ((opList[offset + 5] & BIT1) ? UINT32_C(12) : UINT32_C(0)))
+                    {
+                        uint8_t  operationCode = opList[offset];
+                        uint16_t serviceAction = M_BytesTo2ByteValue(opList[offset + 2], opList[offset + 3]);
+                        int      saIndex       = get_SCSI_Op_Code_Map_SA_Index(operationCode);
+                        map->opcodes[operationCode / 8] |= M_BitN8(operationCode % 8);
+                        if (saIndex >= 0)
+                        {
+                            if (!(opList[offset + 5] & BIT0))
+                            {
+                                saNoSA |= M_BitN32(saIndex);
+                            }
+                            else if (serviceAction <= SCSI_OPCODE_MAP_MAX_SERVICE_ACTION)
+                            {
+                                map->serviceActions[saIndex] |= M_BitN32(serviceAction);
+                            }
+                        }
+                    }
+                    for (int iter = 0; iter < SCSI_OPCODE_MAP_SERVICE_ACTION_OPCODES; ++iter)
+                    {
+                        if (saNoSA & M_BitN32(iter))
+                        {
+                            // reported without a service action, so cannot filter on the service action
+                            map->serviceActions[iter] = UINT32_MAX;
+                        }
+                    }
+                    // Inquiry is mandatory. If it is missing the list cannot be trusted to be complete.
+                    if (is_Op_Code_Set_In_Map(map, INQUIRY_CMD))
+                    {
+                        map->validMap = true;
+                        set_SCSI_Hacks_From_Op_Code_Map(device);
+                    }
+                    else
+                    {
+                        M_INITIALIZE_STRUCTURE(map, sizeof(scsiOpCodeSupportMap));
+                        ret = NOT_SUPPORTED;
+                    }
+                }
+            }
+            safe_free_aligned(&opList);
+            break;
+        }
+    }
+    return ret;
+}
+
 OPENSEA_TRANSPORT_API eReturnValues scsi_Sanitize_Cmd(const tDevice* M_NONNULL device,
                                                       eScsiSanitizeFeature     sanitizeFeature,
                                                       bool                     immediate,
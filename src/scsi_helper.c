@@ -2341,7 +2341,8 @@ OPENSEA_TRANSPORT_API eReturnValues scsi_Read_Capacity_Cmd_Helper(const tDevice*
         return BAD_PARAMETER;
     }
 
-    if (device->drive_info.scsiVersion >= SCSI_VERSION_SPC_3)
+    if (device->drive_info.scsiVersion >= SCSI_VERSION_SPC_3 &&
+        SCSI_CMD_SUPPORT_NOT_SUPPORTED != get_SCSI_Op_Code_Support_From_Map(device, READ_CAPACITY_16, true, 0x10))
     {
         // 16B command added in SBC2. Not a better way to check, so using SPC3 version to decide at the moment since
         // that is the version referenced by SBC2
@@ -3094,6 +3095,9 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues fill_In_Device_Info(tDevice* d
     printf("%s: -->\n", __FUNCTION__);
 #endif
 
+    // clear this so that nothing is filtered by a previous map while rediscovering the device
+    M_INITIALIZE_STRUCTURE(&device->drive_info.scsiOpCodeSupport, sizeof(scsiOpCodeSupportMap));
+    M_INITIALIZE_STRUCTURE(&device->drive_info.scsiBlockLimits, sizeof(scsiBlockLimitsData));
     M_INITIALIZE_STRUCTURE(&turStatus, sizeof(scsiStatus));
     scsi_Test_Unit_Ready(device, &turStatus);
     if (turStatus.senseKey != SENSE_KEY_NO_ERROR)
@@ -4216,6 +4220,16 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues fill_In_Device_Info(tDevice* d
             }
         }
 
+        // Read the full list of supported commands once now so that read capacity and everything after it can skip
+        // commands the device does not support instead of retrying through fallbacks. USB bridges are skipped unless
+        // known to handle this since many do not report a complete list.
+        if (get_Device_DriveType(device) == SCSI_DRIVE &&
+            (get_Device_InterfaceType(device) != USB_INTERFACE ||
+             device->drive_info.passThroughHacks.scsiHacks.reportAllOpCodes))
+        {
+            read_SCSI_Supported_Op_Code_Map(device);
+        }
+
         if (readCapacity && !mediumNotPresent)
         {
             readCapacityData readCapData;
@@ -4373,6 +4387,12 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues fill_In_Device_Info(tDevice* d
                 break;
             }
         }
+        if (get_Device_DriveType(device) != SCSI_DRIVE)
+        {
+            // ATA and NVMe devices found behind a translator use passthrough commands that the translator may not
+            // list, so do not filter anything for them.
+            M_INITIALIZE_STRUCTURE(&device->drive_info.scsiOpCodeSupport, sizeof(scsiOpCodeSupportMap));
+        }
     }
     else
     {
@@ -5572,3 +5592,50 @@ OPENSEA_TRANSPORT_API bool is_HW_Error_No_Defect_Spare_Available(const uint8_t*
     senseToCheck check = {SENSE_MATCH_ASCQ, SENSE_KEY_HARDWARE_ERROR, 0x32, 0x00, 0x00};
     return check_Sense_For_Specific_Info(senseData, senseLen, check);
 }
+
+M_PARAM_RO(1)
+OPENSEA_TRANSPORT_API const scsiBlockLimitsData* get_SCSI_Block_Limits(const tDevice* M_NONNULL device)
+{
+    scsiBlockLimitsData* limits = M_CONST_CAST(scsiBlockLimitsData*, &device->drive_info.scsiBlockLimits);
+    if (!limits->read)
+    {
+        uint8_t* vpd = M_NULLPTR;
+        safe_memset(limits, sizeof(scsiBlockLimitsData), 0, sizeof(scsiBlockLimitsData));
+        limits->read = true;
+        if (device->drive_info.passThroughHacks.scsiHacks.noVPDPages)
+        {
+            return limits;
+        }
+        vpd = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(VPD_BLOCK_LIMITS_LEN, sizeof(uint8_t),
+                                                               get_Device_IO_Minimum_Alignment(device)));
+        if (vpd == M_NULLPTR)
+        {
+            // try again next time
+            limits->read = false;
+            return limits;
+        }
+        if (SUCCESS == scsi_Inquiry(device, vpd, VPD_BLOCK_LIMITS_LEN, BLOCK_LIMITS, true, false) &&
+            vpd[1] == BLOCK_LIMITS)
+        {
+            // older pages are shorter, so only use the fields the page length covers
+            uint16_t pageLength = M_BytesTo2ByteValue(vpd[2], vpd[3]);
+            limits->valid       = true;
+            if (pageLength >= UINT16_C(8))
+            {
+                limits->maximumTransferLength = M_BytesTo4ByteValue(vpd[8], vpd[9], vpd[10], vpd[11]);
+            }
+            if (pageLength >= UINT16_C(24))
+            {
+                limits->maximumUnmapLBACount        = M_BytesTo4ByteValue(vpd[20], vpd[21], vpd[22], vpd[23]);
+                limits->maximumUnmapDescriptorCount = M_BytesTo4ByteValue(vpd[24], vpd[25], vpd[26], vpd[27]);
+            }
+            if (pageLength >= UINT16_C(40))
+            {
+                limits->maximumWriteSameLength =
+                    M_BytesTo8ByteValue(vpd[36], vpd[37], vpd[38], vpd[39], vpd[40], vpd[41], vpd[42], vpd[43]);
+            }
+        }
+        safe_free_aligned(&vpd);
+    }
+    return limits;
+}
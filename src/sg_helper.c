@@ -40,6 +40,7 @@
 
 #include "ata_helper_func.h"
 #include "cmds.h"
+#include "emulated_target.h"
 #include "nix_mounts.h"
 #include "nvme_helper_func.h"
 #include "posix_common_lowlevel.h"
@@ -166,6 +167,75 @@ static void print_io_hdr(sg_io_hdr_t* pIo)
 }
 #endif //_DEBUG
 
+// Directory that /dev and /sys are found under, without a trailing slash. Empty for the running system. Set with
+// set_Linux_Device_Root to run discovery against a generated tree.
+static char linuxDeviceRoot[OPENSEA_PATH_MAX] = {0};
+
+// Skips the device root at the start of a handle so that checks on the handle name do not match the root's path
+static const char* skip_Linux_Device_Root(const char* handle)
+{
+    size_t rootLen = safe_strlen(linuxDeviceRoot);
+    if (handle != M_NULLPTR && rootLen > SIZE_T_C(0) && strncmp(handle, linuxDeviceRoot, rootLen) == 0)
+    {
+        return handle + rootLen;
+    }
+    return handle;
+}
+
+static M_INLINE bool is_Handle_Under_Linux_Device_Root(const char* handle)
+{
+    return skip_Linux_Device_Root(handle) != handle;
+}
+
+// Builds a path such as "/dev" or "/sys/class/" under the device root
+static bool get_Linux_Root_Path(char* path, size_t pathLen, const char* subPath)
+{
+    return snprintf_err_handle(path, pathLen, "%s%s", linuxDeviceRoot, subPath) >= 0;
+}
+
+// Links in /sys/class/<class>/ are relative to it: ../../devices/... This turns one into the full path under /sys
+static bool get_Linux_SysFS_Link_Path(const char* link, char* fullPath, size_t fullPathLen)
+{
+    const char* relative = link;
+    while (strncmp(relative, "../", 3) == 0)
+    {
+        relative += 3;
+    }
+    return snprintf_err_handle(fullPath, fullPathLen, "%s/sys/%s", linuxDeviceRoot, relative) >= 0;
+}
+
+M_NULL_TERM_STRING(1)
+OPENSEA_TRANSPORT_API eReturnValues set_Linux_Device_Root(const char* M_NULLABLE root)
+{
+    size_t rootLen = SIZE_T_C(0);
+    safe_memset(linuxDeviceRoot, OPENSEA_PATH_MAX, 0, OPENSEA_PATH_MAX);
+    if (root == M_NULLPTR || safe_strlen(root) == SIZE_T_C(0) || strcmp(root, "/") == 0)
+    {
+        return SUCCESS;
+    }
+    if (root[0] != '/')
+    {
+        return BAD_PARAMETER;
+    }
+    if (0 != safe_strcpy(linuxDeviceRoot, OPENSEA_PATH_MAX, root))
+    {
+        safe_memset(linuxDeviceRoot, OPENSEA_PATH_MAX, 0, OPENSEA_PATH_MAX);
+        return BAD_PARAMETER;
+    }
+    rootLen = safe_strlen(linuxDeviceRoot);
+    while (rootLen > SIZE_T_C(1) && linuxDeviceRoot[rootLen - 1] == '/')
+    {
+        --rootLen;
+        linuxDeviceRoot[rootLen] = '\0';
+    }
+    return SUCCESS;
+}
+
+OPENSEA_TRANSPORT_API const char* get_Linux_Device_Root(void)
+{
+    return linuxDeviceRoot;
+}
+
 static int sg_filter(const struct dirent* entry)
 {
     return !strncmp("sg", entry->d_name, 2);
@@ -209,9 +279,10 @@ static int sd_filter(const struct dirent* entry)
 //     return linkMappingSupported;
 // }
 
-static bool is_Block_Device_Handle(const char* handle)
+static bool is_Block_Device_Handle(const char* fullHandle)
 {
-    bool isBlockDevice = false;
+    bool        isBlockDevice = false;
+    const char* handle = skip_Linux_Device_Root(fullHandle);
     if (handle && safe_strlen(handle))
     {
         if (strstr(handle, "sd") || strstr(handle, "st") || strstr(handle, "sr") || strstr(handle, "scd"))
@@ -222,9 +293,10 @@ static bool is_Block_Device_Handle(const char* handle)
     return isBlockDevice;
 }
 
-static bool is_SCSI_Generic_Handle(const char* handle)
+static bool is_SCSI_Generic_Handle(const char* fullHandle)
 {
-    bool isGenericDevice = false;
+    bool        isGenericDevice = false;
+    const char* handle = skip_Linux_Device_Root(fullHandle);
     if (handle && safe_strlen(handle))
     {
         if (strstr(handle, "sg") && !strstr(handle, "bsg"))
@@ -235,9 +307,10 @@ static bool is_SCSI_Generic_Handle(const char* handle)
     return isGenericDevice;
 }
 
-static bool is_Block_SCSI_Generic_Handle(const char* handle)
+static bool is_Block_SCSI_Generic_Handle(const char* fullHandle)
 {
-    bool isBlockGenericDevice = false;
+    bool        isBlockGenericDevice = false;
+    const char* handle = skip_Linux_Device_Root(fullHandle);
     if (handle && safe_strlen(handle))
     {
         if (strstr(handle, "bsg"))
@@ -248,9 +321,10 @@ static bool is_Block_SCSI_Generic_Handle(const char* handle)
     return isBlockGenericDevice;
 }
 
-static bool is_NVMe_Handle(char* handle)
+static bool is_NVMe_Handle(const char* fullHandle)
 {
-    bool isNvmeDevice = false;
+    bool        isNvmeDevice = false;
+    const char* handle       = skip_Linux_Device_Root(fullHandle);
     if (handle && safe_strlen(handle))
     {
         if (strstr(handle, "nvme"))
@@ -427,32 +501,18 @@ static void get_Driver_Version_Info_From_Path(const char* driverPath, sysFSLowLe
     char* driverVersionFilePath = M_REINTERPRET_CAST(char*, safe_calloc(OPENSEA_PATH_MAX, sizeof(char)));
     if (driverVersionFilePath)
     {
-        if (snprintf_err_handle(driverVersionFilePath, OPENSEA_PATH_MAX, "%s/module/version", driverPath) < 0)
-        {
-            perror("Failure creating driver version file path in get_Driver_Version_Info_From_Path");
-            safe_free(&driverVersionFilePath);
-            return;
-        }
-        // printf("driver version file path = %s\n", driverVersionFilePath);
         // convert relative path to a full path. Basically replace ../'s with /sys/ since this will always be ../../bus
-        // and we need /sys/buf
-        char*  busPtr    = strstr(driverVersionFilePath, "/bus");
-        size_t busPtrLen = safe_strlen(busPtr);
-        // magic number 4 is for the length of the string "/sys" which is what is being set in the beginning of the
-        // path. This is a bit of a mess, but a simple call to realpath was not working, likely due to the current
-        // directory not being exactly what we want to start with to allow that function to correctly figure out the
-        // path.
-        if (0 != safe_memmove(&driverVersionFilePath[4], OPENSEA_PATH_MAX - 4, busPtr, busPtrLen))
+        // and we need /sys/bus. A simple call to realpath was not working, likely due to the current directory not
+        // being exactly what we want to start with to allow that function to correctly figure out the path.
+        const char* busPtr = strstr(driverPath, "/bus");
+        if (busPtr == M_NULLPTR ||
+            snprintf_err_handle(driverVersionFilePath, OPENSEA_PATH_MAX, "%s/sys%s/module/version", linuxDeviceRoot,
+                                busPtr) < 0)
         {
             perror("Failure adjusting driver version file path in get_Driver_Version_Info_From_Path");
             safe_free(&driverVersionFilePath);
             return;
         }
-        explicit_zeroes(&driverVersionFilePath[busPtrLen + 4], OPENSEA_PATH_MAX - (busPtrLen + 4));
-        driverVersionFilePath[0] = '/';
-        driverVersionFilePath[1] = 's';
-        driverVersionFilePath[2] = 'y';
-        driverVersionFilePath[3] = 's';
 
         FILE*   versionFile = M_NULLPTR;
         errno_t fileopenerr = safe_fopen(&versionFile, driverVersionFilePath, "r");
@@ -602,17 +662,7 @@ static void get_SYS_FS_ATA_Info(const char* inHandleLink, sysFSLowLevelDeviceInf
     sysFsInfo->drive_type     = ATA_DRIVE;
     // get vendor and product IDs of the controller attached to this device.
     DECLARE_ZERO_INIT_ARRAY(char, fullPciPath, PATH_MAX);
-    if (0 != safe_strcpy(fullPciPath, PATH_MAX, inHandleLink))
-    {
-        return;
-    }
-
-    fullPciPath[0] = '/';
-    fullPciPath[1] = 's';
-    fullPciPath[2] = 'y';
-    fullPciPath[3] = 's';
-    fullPciPath[4] = '/';
-    if (0 != safe_memmove(&fullPciPath[5], PATH_MAX - 5, &fullPciPath[6], safe_strlen(fullPciPath)))
+    if (!get_Linux_SysFS_Link_Path(inHandleLink, fullPciPath, PATH_MAX))
     {
         return;
     }
@@ -729,17 +779,7 @@ static void get_SYS_FS_USB_Info(const char* inHandleLink, sysFSLowLevelDeviceInf
     sysFsInfo->drive_type     = SCSI_DRIVE; // changed later depending on what passthrough the USB adapter supports
     // set the USB VID and PID. NOTE: There may be a better way to do this, but this seems to work for now.
     DECLARE_ZERO_INIT_ARRAY(char, fullPciPath, PATH_MAX);
-    if (0 != safe_strcpy(fullPciPath, PATH_MAX, inHandleLink))
-    {
-        return;
-    }
-
-    fullPciPath[0] = '/';
-    fullPciPath[1] = 's';
-    fullPciPath[2] = 'y';
-    fullPciPath[3] = 's';
-    fullPciPath[4] = '/';
-    if (0 != safe_memmove(&fullPciPath[5], PATH_MAX - 5, &fullPciPath[6], safe_strlen(fullPciPath)))
+    if (!get_Linux_SysFS_Link_Path(inHandleLink, fullPciPath, PATH_MAX))
     {
         return;
     }
@@ -944,17 +984,7 @@ static void get_SYS_FS_1394_Info(const char* inHandleLink, sysFSLowLevelDeviceIn
     sysFsInfo->interface_type = IEEE_1394_INTERFACE;
     sysFsInfo->drive_type     = SCSI_DRIVE; // changed later if detected as ATA
     DECLARE_ZERO_INIT_ARRAY(char, fullFWPath, PATH_MAX);
-    if (0 != safe_strcpy(fullFWPath, PATH_MAX, inHandleLink))
-    {
-        return;
-    }
-
-    fullFWPath[0] = '/';
-    fullFWPath[1] = 's';
-    fullFWPath[2] = 'y';
-    fullFWPath[3] = 's';
-    fullFWPath[4] = '/';
-    if (0 != safe_memmove(&fullFWPath[5], PATH_MAX - 5, &fullFWPath[6], safe_strlen(fullFWPath)))
+    if (!get_Linux_SysFS_Link_Path(inHandleLink, fullFWPath, PATH_MAX))
     {
         return;
     }
@@ -1032,17 +1062,7 @@ static void get_SYS_FS_SCSI_Info(const char* inHandleLink, sysFSLowLevelDeviceIn
     // get vendor and product IDs of the controller attached to this device.
 
     DECLARE_ZERO_INIT_ARRAY(char, fullPciPath, PATH_MAX);
-    if (0 != safe_strcpy(fullPciPath, PATH_MAX, inHandleLink))
-    {
-        return;
-    }
-
-    fullPciPath[0] = '/';
-    fullPciPath[1] = 's';
-    fullPciPath[2] = 'y';
-    fullPciPath[3] = 's';
-    fullPciPath[4] = '/';
-    if (0 != safe_memmove(&fullPciPath[5], PATH_MAX - 5, &fullPciPath[6], safe_strlen(fullPciPath)))
+    if (!get_Linux_SysFS_Link_Path(inHandleLink, fullPciPath, PATH_MAX))
     {
         return;
     }
@@ -1261,7 +1281,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
     // check if it's a block handle, bsg, or scsi_generic handle, then setup the path we need to read.
     if (handle && sysFsInfo)
     {
-        if (strstr(handle, "nvme") != M_NULLPTR)
+        if (strstr(skip_Linux_Device_Root(handle), "nvme") != M_NULLPTR)
         {
             sysFsInfo->interface_type = NVME_INTERFACE;
             sysFsInfo->drive_type     = NVME_DRIVE;
@@ -1277,7 +1297,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
             bool incomingBlock = false; // only set for SD!
             bool bsg           = false;
             DECLARE_ZERO_INIT_ARRAY(char, incomingHandleClassPath, PATH_MAX);
-            if (0 != safe_strcat(incomingHandleClassPath, PATH_MAX, "/sys/class/"))
+            if (!get_Linux_Root_Path(incomingHandleClassPath, PATH_MAX, "/sys/class/"))
             {
                 return;
             }
@@ -1371,7 +1391,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
                         if (bsg)
                         {
                             if (snprintf_err_handle(sysFsInfo->primaryHandleStr, OS_HANDLE_NAME_MAX_LENGTH,
-                                                    "/dev/bsg/%s", baseLink) < 0)
+                                                    "%s/dev/bsg/%s", linuxDeviceRoot, baseLink) < 0)
                             {
                                 safe_free(&duphandle);
                                 return;
@@ -1379,8 +1399,8 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
                         }
                         else
                         {
-                            if (snprintf_err_handle(sysFsInfo->primaryHandleStr, OS_HANDLE_NAME_MAX_LENGTH, "/dev/%s",
-                                                    baseLink) < 0)
+                            if (snprintf_err_handle(sysFsInfo->primaryHandleStr, OS_HANDLE_NAME_MAX_LENGTH,
+                                                    "%s/dev/%s", linuxDeviceRoot, baseLink) < 0)
                             {
                                 safe_free(&duphandle);
                                 return;
@@ -1406,7 +1426,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
                                 if (is_Block_SCSI_Generic_Handle(gen))
                                 {
                                     if (snprintf_err_handle(sysFsInfo->secondaryHandleStr, OS_SECOND_HANDLE_NAME_LENGTH,
-                                                            "/dev/bsg/%s", gen) < 0)
+                                                            "%s/dev/bsg/%s", linuxDeviceRoot, gen) < 0)
                                     {
                                         safe_free(&block);
                                         safe_free(&gen);
@@ -1416,7 +1436,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
                                 else
                                 {
                                     if (snprintf_err_handle(sysFsInfo->secondaryHandleStr, OS_SECOND_HANDLE_NAME_LENGTH,
-                                                            "/dev/%s", gen) < 0)
+                                                            "%s/dev/%s", linuxDeviceRoot, gen) < 0)
                                     {
                                         safe_free(&gen);
                                         return;
@@ -1428,7 +1448,7 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
                                 // generic handle was sent in
                                 // secondary handle will be a block handle
                                 if (snprintf_err_handle(sysFsInfo->secondaryHandleStr, OS_SECOND_HANDLE_NAME_LENGTH,
-                                                        "/dev/%s", block) < 0)
+                                                        "%s/dev/%s", linuxDeviceRoot, block) < 0)
                                 {
                                     safe_free(&block);
                                     return;
@@ -1467,6 +1487,48 @@ static void get_Linux_SYS_FS_Info(const char* handle, sysFSLowLevelDeviceInfo* s
     }
 }
 
+// Copies the adapter, driver, and handle names read from sysfs into the device structure
+M_PARAM_RO(1)
+M_PARAM_RW(2)
+static void set_Device_Names_From_SysFS_Info(const sysFSLowLevelDeviceInfo* M_NONNULL sysFsInfo,
+                                             tDevice* M_NONNULL                      device)
+{
+    M_IGNORE_SAFE_ERRNO_CALL(
+        safe_memcpy(&device->drive_info.adapter_info, sizeof(adapterInfo), &sysFsInfo->adapter_info,
+                    sizeof(adapterInfo)),
+        "Using exact same internal structure definition of adapterInfo so this should never fail");
+    M_IGNORE_SAFE_ERRNO_CALL(
+        safe_memcpy(&device->drive_info.driver_info, sizeof(driverInfo), &sysFsInfo->driver_info, sizeof(driverInfo)),
+        "Using exact same internal structure definition of driverInfo so this should never fail");
+    if (safe_strlen(sysFsInfo->primaryHandleStr) > 0)
+    {
+        char* dupHandle = M_NULLPTR;
+        if (0 != safe_strdup(&dupHandle, sysFsInfo->primaryHandleStr) || dupHandle == M_NULLPTR)
+        {
+            set_Device_Name_In_tDevice(device, sysFsInfo->primaryHandleStr, M_NULLPTR);
+        }
+        else
+        {
+            set_Device_Name_In_tDevice(device, sysFsInfo->primaryHandleStr, basename(dupHandle));
+        }
+        safe_free(&dupHandle);
+    }
+    if (safe_strlen(sysFsInfo->secondaryHandleStr) > 0)
+    {
+        char* dupSecond = M_NULLPTR;
+        if (0 != safe_strdup(&dupSecond, sysFsInfo->secondaryHandleStr) || dupSecond == M_NULLPTR)
+        {
+            set_Second_Device_Name_In_tDevice(device, sysFsInfo->secondaryHandleStr, M_NULLPTR);
+        }
+        else
+        {
+            set_Second_Device_Name_In_tDevice(device, sysFsInfo->secondaryHandleStr, basename(dupSecond));
+        }
+        safe_free(&dupSecond);
+        device->os_info.secondHandleValid = true;
+    }
+}
+
 M_NULL_TERM_STRING(1)
 M_PARAM_RO(1)
 M_PARAM_RW(2)
@@ -1484,41 +1546,7 @@ static void set_Device_Fields_From_Handle(const char* M_NONNULL handle, tDevice*
     {
         set_Device_DriveType(device, sysFsInfo.drive_type);
         device->drive_info.interface_type = sysFsInfo.interface_type;
-        M_IGNORE_SAFE_ERRNO_CALL(
-            safe_memcpy(&device->drive_info.adapter_info, sizeof(adapterInfo), &sysFsInfo.adapter_info,
-                        sizeof(adapterInfo)),
-            "Using exact same internal structure definition of adapterInfo so this should never fail");
-        M_IGNORE_SAFE_ERRNO_CALL(
-            safe_memcpy(&device->drive_info.driver_info, sizeof(driverInfo), &sysFsInfo.driver_info,
-                        sizeof(driverInfo)),
-            "Using exact same internal structure definition of driverInfo so this should never fail");
-        if (safe_strlen(sysFsInfo.primaryHandleStr) > 0)
-        {
-            char* dupHandle = M_NULLPTR;
-            if (0 != safe_strdup(&dupHandle, sysFsInfo.primaryHandleStr) || dupHandle == M_NULLPTR)
-            {
-                set_Device_Name_In_tDevice(device, sysFsInfo.primaryHandleStr, M_NULLPTR);
-            }
-            else
-            {
-                set_Device_Name_In_tDevice(device, sysFsInfo.primaryHandleStr, basename(dupHandle));
-            }
-            safe_free(&dupHandle);
-        }
-        if (safe_strlen(sysFsInfo.secondaryHandleStr) > 0)
-        {
-            char* dupSecond = M_NULLPTR;
-            if (0 != safe_strdup(&dupSecond, sysFsInfo.secondaryHandleStr) || dupSecond == M_NULLPTR)
-            {
-                set_Second_Device_Name_In_tDevice(device, sysFsInfo.secondaryHandleStr, M_NULLPTR);
-            }
-            else
-            {
-                set_Second_Device_Name_In_tDevice(device, sysFsInfo.secondaryHandleStr, basename(dupSecond));
-            }
-            safe_free(&dupSecond);
-            device->os_info.secondHandleValid = true;
-        }
+        set_Device_Names_From_SysFS_Info(&sysFsInfo, device);
     }
 }
 
@@ -1537,7 +1565,7 @@ eReturnValues map_Block_To_Generic_Handle(const char* M_NONNULL handle, char** g
     }
 
     // if the handle passed in contains "nvme" then we know it's a device on the nvme interface
-    if (strstr(handle, "nvme") != M_NULLPTR)
+    if (strstr(skip_Linux_Device_Root(handle), "nvme") != M_NULLPTR)
     {
         return NOT_SUPPORTED;
     }
@@ -1545,7 +1573,7 @@ eReturnValues map_Block_To_Generic_Handle(const char* M_NONNULL handle, char** g
     {
         bool incomingBlock = false; // only set for SD!
         DECLARE_ZERO_INIT_ARRAY(char, incomingHandleClassPath, PATH_MAX);
-        if (0 != safe_strcat(incomingHandleClassPath, PATH_MAX, "/sys/class/"))
+        if (!get_Linux_Root_Path(incomingHandleClassPath, PATH_MAX, "/sys/class/"))
         {
             perror("Failure setting /sys/class into incomingHandleClassPath in map_Block_To_Generic_Handle");
             return MEMORY_FAILURE;
@@ -1597,10 +1625,18 @@ eReturnValues map_Block_To_Generic_Handle(const char* M_NONNULL handle, char** g
             {
                 // printf("full in handleLink = %s\n", inHandleLink);
                 // now we need to map it to a generic handle (sg...if sg not available, bsg)
-                const char* scsiGenericClass = "/sys/class/scsi_generic/";
-                const char* bsgClass         = "/sys/class/bsg/";
-                const char* blockClass       = "/sys/class/block/";
+                DECLARE_ZERO_INIT_ARRAY(char, scsiGenericClass, PATH_MAX);
+                DECLARE_ZERO_INIT_ARRAY(char, bsgClass, PATH_MAX);
+                DECLARE_ZERO_INIT_ARRAY(char, blockClass, PATH_MAX);
                 struct stat mapStat;
+                if (!get_Linux_Root_Path(scsiGenericClass, PATH_MAX, "/sys/class/scsi_generic/") ||
+                    !get_Linux_Root_Path(bsgClass, PATH_MAX, "/sys/class/bsg/") ||
+                    !get_Linux_Root_Path(blockClass, PATH_MAX, "/sys/class/block/"))
+                {
+                    perror("Failure setting class paths in map_Block_To_Generic_Handle");
+                    safe_free(&dupHandle);
+                    return MEMORY_FAILURE;
+                }
                 DECLARE_ZERO_INIT_ARRAY(char, classPath, PATH_MAX);
                 bool bsg = false;
                 if (incomingBlock)
@@ -1870,7 +1906,8 @@ static eReturnValues resolve_Block_Handle_To_Generic_Handle(const char* filename
             // print_str("Changing filename to SG device....\n");
             if (is_SCSI_Generic_Handle(genHandle))
             {
-                if (snprintf_err_handle(*genericHandle, LIN_MAX_HANDLE_LENGTH, "/dev/%s", genHandle) < 0)
+                if (snprintf_err_handle(*genericHandle, LIN_MAX_HANDLE_LENGTH, "%s/dev/%s", linuxDeviceRoot,
+                                        genHandle) < 0)
                 {
                     perror("Failure setting generic handle name in resolve_Block_Handle_To_Generic_Handle");
                     safe_free(genericHandle);
@@ -1881,7 +1918,8 @@ static eReturnValues resolve_Block_Handle_To_Generic_Handle(const char* filename
             }
             else
             {
-                if (snprintf_err_handle(*genericHandle, LIN_MAX_HANDLE_LENGTH, "/dev/bsg/%s", genHandle) < 0)
+                if (snprintf_err_handle(*genericHandle, LIN_MAX_HANDLE_LENGTH, "%s/dev/bsg/%s", linuxDeviceRoot,
+                                        genHandle) < 0)
                 {
                     perror("Failure setting generic handle name in resolve_Block_Handle_To_Generic_Handle");
                     safe_free(genericHandle);
@@ -2026,6 +2064,68 @@ static eReturnValues linux_Get_SCSI_Device(tDevice* M_NONNULL device, const char
     return ret;
 }
 
+// Handles under a device root set with set_Linux_Device_Root are files that name the emulated target that answers for
+// them: "emulated:sas", "emulated:sata", or "emulated:nvme". sysfs under the root is still read for them so discovery
+// does the same work it does for real devices.
+M_NONNULL_PARAM_LIST(1, 2)
+M_NULL_TERM_STRING(1)
+M_PARAM_RO(1)
+M_PARAM_RW(2)
+static eReturnValues linux_Get_Emulated_Device(const char* handle, tDevice* M_NONNULL device)
+{
+    eReturnValues           ret        = SUCCESS;
+    FILE*                   handleFile = M_NULLPTR;
+    char*                   line       = M_NULLPTR;
+    rsize_t                 lineAlloc  = RSIZE_T_C(0);
+    rsize_t                 lineLen    = RSIZE_T_C(0);
+    eEmulatedTargetType     type       = EMULATED_TARGET_SAS_DISK;
+    emulatedTargetConfig    config;
+    sysFSLowLevelDeviceInfo sysFsInfo;
+    if (0 != safe_fopen(&handleFile, handle, "r") || handleFile == M_NULLPTR)
+    {
+        return DEVICE_INVALID;
+    }
+    if (0 != safe_getline(&line, &lineAlloc, &lineLen, handleFile) || line == M_NULLPTR)
+    {
+        close_sysfs_file(&handleFile);
+        safe_free(&line);
+        return DEVICE_INVALID;
+    }
+    close_sysfs_file(&handleFile);
+    trim_ctrl_from_line(line, lineLen);
+    if (strcmp(line, "emulated:sas") == 0)
+    {
+        type = EMULATED_TARGET_SAS_DISK;
+    }
+    else if (strcmp(line, "emulated:sata") == 0)
+    {
+        type = EMULATED_TARGET_SATA_DISK;
+    }
+    else if (strcmp(line, "emulated:nvme") == 0)
+    {
+        type = EMULATED_TARGET_NVME_CONTROLLER;
+    }
+    else
+    {
+        safe_free(&line);
+        return NOT_SUPPORTED;
+    }
+    safe_free(&line);
+    get_Default_Emulated_Target_Config(&config, type);
+    ret = open_Emulated_Device(device, &config);
+    if (ret != SUCCESS)
+    {
+        return ret;
+    }
+    device->os_info.osType = OS_LINUX;
+    device->os_info.fd     = -1;
+    device->os_info.fd2    = -1;
+    M_INITIALIZE_STRUCTURE(&sysFsInfo, sizeof(sysFSLowLevelDeviceInfo));
+    get_Linux_SYS_FS_Info(handle, &sysFsInfo);
+    set_Device_Names_From_SysFS_Info(&sysFsInfo, device);
+    return ret;
+}
+
 M_NONNULL_PARAM_LIST(1, 2)
 M_NULL_TERM_STRING(1)
 M_PARAM_RO(1)
@@ -2056,6 +2156,13 @@ static eReturnValues get_Lin_Device(const char* filename, tDevice* M_NONNULL dev
     // no longer need this handle since we now have what we want in genericHandle
     free_Posix_Resolved_Filename(&deviceHandle);
 
+    if (is_Handle_Under_Linux_Device_Root(genericHandle))
+    {
+        ret = linux_Get_Emulated_Device(genericHandle, device);
+        safe_free(&genericHandle);
+        return ret;
+    }
+
     ePosixHandleFlags handleFlags = POSIX_HANDLE_FLAGS_DEFAULT;
     if (device->dFlags & HANDLE_REQUIRE_EXCLUSIVE_ACCESS)
     {
@@ -2730,9 +2837,14 @@ static int host_filter(const struct dirent* entry)
 static void linux_Rescan_SCSI_Hosts(void)
 {
     struct dirent** hosts        = M_NULLPTR;
-    const char*     sysSCSIHosts = "/sys/class/scsi_host/";
     const char*     scsiHostScan = "scan";
-    int             hostscanres  = scandir(sysSCSIHosts, &hosts, host_filter, alphasort);
+    int             hostscanres  = -1;
+    DECLARE_ZERO_INIT_ARRAY(char, sysSCSIHosts, PATH_MAX);
+    if (!get_Linux_Root_Path(sysSCSIHosts, PATH_MAX, "/sys/class/scsi_host/"))
+    {
+        return;
+    }
+    hostscanres = scandir(sysSCSIHosts, &hosts, host_filter, alphasort);
     if (hostscanres >= 0)
     {
         for (int iter = 0; iter < hostscanres; ++iter)
@@ -2791,16 +2903,21 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_Count(uint32_t* M_NONNULL numberO
     struct dirent** namelist                                      = M_NULLPTR;
     struct dirent** nvmenamelist                                  = M_NULLPTR;
     int (*sortFunc)(const struct dirent**, const struct dirent**) = &alphasort;
+    DECLARE_ZERO_INIT_ARRAY(char, devDir, PATH_MAX);
 #if defined(_GNU_SOURCE)
     sortFunc = &versionsort; // use versionsort instead when available with _GNU_SOURCE
 #endif
+    if (!get_Linux_Root_Path(devDir, PATH_MAX, "/dev"))
+    {
+        return MEMORY_FAILURE;
+    }
 
     if (flags & BUS_RESCAN_ALLOWED)
     {
         linux_Rescan_SCSI_Hosts();
     }
 
-    scandirresult = scandir("/dev", &namelist, sg_filter, sortFunc);
+    scandirresult = scandir(devDir, &namelist, sg_filter, sortFunc);
     if (scandirresult >= 0)
     {
         num_devs = C_CAST(uint32_t, scandirresult);
@@ -2809,7 +2926,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_Count(uint32_t* M_NONNULL numberO
     {
         safe_free_dirent(M_REINTERPRET_CAST(struct dirent**, &namelist));
         // check for SD devices
-        scandirresult = scandir("/dev", &namelist, sd_filter, sortFunc);
+        scandirresult = scandir(devDir, &namelist, sd_filter, sortFunc);
         if (scandirresult >= 0)
         {
             num_devs = C_CAST(uint32_t, scandirresult);
@@ -2824,7 +2941,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_Count(uint32_t* M_NONNULL numberO
     // need to check if existing sg/sd handles are attached to hpsa or smartpqi drives in addition to /dev/cciss devices
     struct dirent** ccisslist;
     uint32_t        num_ccissdevs = UINT32_C(0);
-    scandirresult                 = scandir("/dev", &ccisslist, ciss_filter, sortFunc);
+    scandirresult                 = scandir(devDir, &ccisslist, ciss_filter, sortFunc);
     if (scandirresult >= 0)
     {
         num_ccissdevs = C_CAST(uint32_t, scandirresult);
@@ -2878,7 +2995,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_Count(uint32_t* M_NONNULL numberO
     }
     safe_free_dirent(M_REINTERPRET_CAST(struct dirent**, &namelist));
     // add nvme devices to the list
-    scandirresult = scandir("/dev", &nvmenamelist, nvme_filter, sortFunc);
+    scandirresult = scandir(devDir, &nvmenamelist, nvme_filter, sortFunc);
     if (scandirresult >= 0)
     {
         num_nvme_devs = C_CAST(uint32_t, scandirresult);
@@ -2980,11 +3097,16 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_List(tDevice* M_NONNULL const ptr
     }
 
     int (*sortFunc)(const struct dirent**, const struct dirent**) = &alphasort;
+    DECLARE_ZERO_INIT_ARRAY(char, devDir, PATH_MAX);
 #if defined(_GNU_SOURCE)
     sortFunc = &versionsort; // use versionsort instead when available with _GNU_SOURCE
 #endif                       // _GNU_SOURCE
+    if (!get_Linux_Root_Path(devDir, PATH_MAX, "/dev"))
+    {
+        return MEMORY_FAILURE;
+    }
 
-    scandirresult = scandir("/dev", &namelist, sg_filter, sortFunc);
+    scandirresult = scandir(devDir, &namelist, sg_filter, sortFunc);
     if (scandirresult >= 0)
     {
         num_sg_devs = C_CAST(uint32_t, scandirresult);
@@ -2993,14 +3115,14 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_List(tDevice* M_NONNULL const ptr
     {
         safe_free_dirent(M_REINTERPRET_CAST(struct dirent**, &namelist));
         // check for SD devices
-        scandirresult = scandir("/dev", &namelist, sd_filter, sortFunc);
+        scandirresult = scandir(devDir, &namelist, sd_filter, sortFunc);
         if (scandirresult >= 0)
         {
             num_sd_devs = C_CAST(uint32_t, scandirresult);
         }
     }
     // add nvme devices to the list
-    scandirresult = scandir("/dev", &nvmenamelist, nvme_filter, sortFunc);
+    scandirresult = scandir(devDir, &nvmenamelist, nvme_filter, sortFunc);
     if (scandirresult >= 0)
     {
         num_nvme_devs = C_CAST(uint32_t, scandirresult);
@@ -3013,9 +3135,9 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_List(tDevice* M_NONNULL const ptr
     // add sg/sd devices to the list
     for (; i < (num_sg_devs + num_sd_devs); i++)
     {
-        size_t handleSize = (safe_strlen("/dev/") + safe_strlen(namelist[i]->d_name) + 1) * sizeof(char);
+        size_t handleSize = (safe_strlen(devDir) + safe_strlen(namelist[i]->d_name) + 2) * sizeof(char);
         devs[i]           = M_REINTERPRET_CAST(char*, safe_malloc(handleSize));
-        if (0 > snprintf_err_handle(devs[i], handleSize, "/dev/%s", namelist[i]->d_name))
+        if (0 > snprintf_err_handle(devs[i], handleSize, "%s/%s", devDir, namelist[i]->d_name))
         {
             perror("Error setting device handle string");
             safe_free(&devs[i]);
@@ -3025,9 +3147,9 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_List(tDevice* M_NONNULL const ptr
     // add nvme devices to the list
     for (j = 0; i < totalDevs && j < num_nvme_devs; i++, j++)
     {
-        size_t handleSize = (safe_strlen("/dev/") + safe_strlen(nvmenamelist[j]->d_name) + 1) * sizeof(char);
+        size_t handleSize = (safe_strlen(devDir) + safe_strlen(nvmenamelist[j]->d_name) + 2) * sizeof(char);
         devs[i]           = M_REINTERPRET_CAST(char*, safe_malloc(handleSize));
-        if (0 > snprintf_err_handle(devs[i], handleSize, "/dev/%s", nvmenamelist[j]->d_name))
+        if (0 > snprintf_err_handle(devs[i], handleSize, "%s/%s", devDir, nvmenamelist[j]->d_name))
         {
             perror("Error setting NVMe device handle string");
             safe_free(&devs[i]);
@@ -3039,7 +3161,7 @@ OPENSEA_TRANSPORT_API eReturnValues get_Device_List(tDevice* M_NONNULL const ptr
     safe_free_dirent(M_REINTERPRET_CAST(struct dirent**, &nvmenamelist));
 
     struct dirent** ccisslist;
-    int             num_ccissdevs = scandir("/dev", &ccisslist, ciss_filter, sortFunc);
+    int             num_ccissdevs = scandir(devDir, &ccisslist, ciss_filter, sortFunc);
     if (num_ccissdevs > 0)
     {
         raidHint.cissRAID = true; // true as all the following will be CISS devices
@@ -3234,6 +3356,12 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
 
     if (dev != M_NULLPTR)
     {
+        if (is_Emulated_Device(dev))
+        {
+            // opened from a handle under the device root
+            return close_Emulated_Device(dev);
+        }
+        release_Device_Resources(dev);
         if (dev->os_info.cissDeviceData)
         {
             close_CISS_RAID_Device(dev);
@@ -3290,6 +3418,17 @@ M_PARAM_RW(1) eReturnValues send_NVMe_IO(nvmeCmdCtx* M_NONNULL nvmeIoCtx)
         return BAD_PARAMETER;
     }
 
+    if (get_Device_InterfaceType(nvmeIoCtx->device) == RAID_INTERFACE)
+    {
+        if (nvmeIoCtx->device->issue_nvme_io != M_NULLPTR)
+        {
+            return nvmeIoCtx->device->issue_nvme_io(nvmeIoCtx);
+        }
+        print_tDevice_Verbose_String(nvmeIoCtx->device, VERBOSITY_QUIET,
+                                     "No Raid PassThrough IO Routine present for this device - NVMe\n");
+        return NOT_SUPPORTED;
+    }
+
     switch (nvmeIoCtx->commandType)
     {
     case NVM_ADMIN_CMD:
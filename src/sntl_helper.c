@@ -72,6 +72,295 @@
 #define SNTL_SENSE_KEY_SPECIFIC_DESCRIPTOR_LENGTH 8
 #define SNTL_INFORMATION_SENSE_DESCRIPTOR_LENGTH  12
 
+#define SNTL_ALL_OP_CODES_MAX_LENGTH (UINT32_C(4) * LEGACY_DRIVE_SEC_SIZE)
+#define SNTL_CACHED_LOG_MAX_LENGTH   UINT32_C(1024)
+// Health and rotating media logs hold counters and temperatures, so they are only reused for this long.
+#define SNTL_TRANSLATOR_COUNTER_CACHE_NS (UINT64_C(5000000000))
+// UNMAP is split into as many dataset management commands as necessary, so the limits reported in the block limits VPD
+// page are only bounded by what fits in the UNMAP parameter list: (UINT16_MAX - 8 byte header) / 16 byte descriptors.
+#define SNTL_UNMAP_MAX_BLOCK_DESCRIPTORS UINT32_C(4095)
+#define SNTL_UNMAP_MAX_LBA_COUNT         UINT32_MAX
+
+typedef enum eSNTLCachedLogEnum
+{
+    SNTL_CACHED_LOG_SUPPORTED_PAGES,
+    SNTL_CACHED_LOG_SMART_HEALTH,
+    SNTL_CACHED_LOG_ROTATIONAL_MEDIA,
+    SNTL_CACHED_LOG_COUNT
+} eSNTLCachedLog;
+
+typedef struct s_sntlCachedLogPage
+{
+    bool     valid;
+    uint8_t  padd[3];
+    uint32_t nsid;
+    uint32_t length;
+    uint8_t  padd2[4];
+    seatimer readTime; // when the data was read from the drive. Used to expire counters.
+    uint8_t  data[SNTL_CACHED_LOG_MAX_LENGTH];
+} sntlCachedLogPage;
+
+// Data the translator would otherwise regenerate on every command. Everything in here is derived from the identify
+// controller and namespace data, so it is all thrown out when that data is reread.
+// Format, sanitize, namespace management/attachment and firmware activation mark the identify data stale and drop
+// anything else read from the drive. See sntl_Invalidate_Translator_Cache. fill_In_NVMe_Device_Info frees the cache.
+// This must remain a single allocation with no pointers since it is freed by release_Device_Resources.
+struct s_sntlTranslatorCache
+{
+    bool    ctrlIdentifyStale;
+    bool    nsIdentifyStale;
+    bool    activeNamespacesValid;
+    bool    lbaFormatValid;
+    bool    dsmLimitsValid;
+    uint8_t padd[3];
+    struct
+    {
+        uint64_t maxLBA;
+        uint32_t logicalBlockSize;
+        uint8_t  padd[4];
+    } lbaFormat; // decoded current LBA format of the namespace
+    struct
+    {
+        uint32_t maxRanges;
+        uint32_t maxLBAsPerRange;
+    } dsmLimits; // DMRL and DMRSL from the NVM command set identify controller data
+    uint8_t           activeNamespaces[NVME_IDENTIFY_DATA_LEN];
+    sntlCachedLogPage logs[SNTL_CACHED_LOG_COUNT];
+    struct
+    {
+        bool     valid;
+        uint8_t  padd[3];
+        uint32_t length;
+        uint8_t  data[SNTL_ALL_OP_CODES_MAX_LENGTH];
+    } allOpCodes[2]; // index 0 without command timeouts, 1 with command timeouts (RCTD)
+};
+
+// Returns the translator cache for this device, allocating it if this is the first use.
+// Returns M_NULLPTR if the cache could not be allocated. Callers must work without it in that case.
+M_PARAM_RO(1)
+static ptrSntlTranslatorCache sntl_Get_Translator_Cache(const tDevice* M_NONNULL device)
+{
+    ptrSntlTranslatorCache cache = device->drive_info.sntlCache;
+    if (cache == M_NULLPTR)
+    {
+        cache = M_REINTERPRET_CAST(ptrSntlTranslatorCache, safe_calloc(1, sizeof(sntlTranslatorCache)));
+        if (cache != M_NULLPTR)
+        {
+            M_CONST_CAST(tDevice*, device)->drive_info.sntlCache = cache;
+        }
+    }
+    return cache;
+}
+
+// Drops everything decoded from the identify data once it has been reread
+static void sntl_Drop_Identify_Derived_Data(ptrSntlTranslatorCache cache)
+{
+    cache->activeNamespacesValid = false;
+    cache->lbaFormatValid        = false;
+    cache->dsmLimitsValid        = false;
+    cache->allOpCodes[0].valid   = false;
+    cache->allOpCodes[1].valid   = false;
+}
+
+M_PARAM_RO(1)
+void sntl_Invalidate_Translator_Cache(const tDevice* M_NONNULL device)
+{
+    ptrSntlTranslatorCache cache = device->drive_info.sntlCache;
+    if (cache != M_NULLPTR)
+    {
+        cache->ctrlIdentifyStale = true;
+        cache->nsIdentifyStale   = true;
+        sntl_Drop_Identify_Derived_Data(cache);
+        for (uint8_t logIter = UINT8_C(0); logIter < SNTL_CACHED_LOG_COUNT; ++logIter)
+        {
+            cache->logs[logIter].valid = false;
+        }
+    }
+}
+
+// Rereads identify controller and namespace data into the device structure after something marked it stale. Anything
+// decoded from the old data is dropped and rebuilt from the new data on demand.
+// If a read fails the old data is kept and it is retried on the next translated command.
+M_PARAM_RO(1)
+static void sntl_Refresh_Stale_Identify_Data(const tDevice* M_NONNULL device)
+{
+    eReturnValues          ret   = SUCCESS;
+    ptrSntlTranslatorCache cache = device->drive_info.sntlCache;
+    if (cache != M_NULLPTR)
+    {
+        if (cache->ctrlIdentifyStale)
+        {
+            ret = nvme_Identify(device, M_CONST_CAST(uint8_t*, &device->drive_info.IdentifyData.nvme.ctrl), 0,
+                                NVME_IDENTIFY_CTRL);
+            if (ret == SUCCESS)
+            {
+                cache->ctrlIdentifyStale = false;
+                sntl_Drop_Identify_Derived_Data(cache);
+            }
+        }
+        if (ret == SUCCESS && cache->nsIdentifyStale)
+        {
+            ret = nvme_Identify(device, M_CONST_CAST(uint8_t*, &device->drive_info.IdentifyData.nvme.ns),
+                                device->drive_info.namespaceID, NVME_IDENTIFY_NS);
+            if (ret == SUCCESS)
+            {
+                cache->nsIdentifyStale = false;
+                sntl_Drop_Identify_Derived_Data(cache);
+            }
+        }
+    }
+}
+
+// Decodes the current LBA format from the identify namespace data once instead of on each translated command.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+M_PARAM_WO(3)
+static void sntl_Get_Current_LBA_Format(const tDevice* M_NONNULL device,
+                                        uint64_t* M_NONNULL      maxLBA,
+                                        uint32_t* M_NONNULL      logicalBlockSize)
+{
+    ptrSntlTranslatorCache cache = sntl_Get_Translator_Cache(device);
+    if (cache == M_NULLPTR || !cache->lbaFormatValid)
+    {
+        uint8_t flbas = get_bit_range_uint8(device->drive_info.IdentifyData.nvme.ns.flbas, 3, 0);
+        if (NVME_0_BASED(device->drive_info.IdentifyData.nvme.ns.nlbaf) > 16)
+        {
+            // need to append 2 more bits to interpret this correctly since number of formats > 16
+            flbas |= get_bit_range_uint8(device->drive_info.IdentifyData.nvme.ns.flbas, 6, 5) << 4;
+        }
+        *maxLBA = le64_to_host(device->drive_info.IdentifyData.nvme.ns.nsze) - UINT64_C(1);
+        *logicalBlockSize =
+            C_CAST(uint32_t, power_Of_Two(device->drive_info.IdentifyData.nvme.ns.lbaf[flbas].lbaDS));
+        if (cache != M_NULLPTR)
+        {
+            cache->lbaFormat.maxLBA           = *maxLBA;
+            cache->lbaFormat.logicalBlockSize = *logicalBlockSize;
+            cache->lbaFormatValid             = true;
+        }
+    }
+    else
+    {
+        *maxLBA           = cache->lbaFormat.maxLBA;
+        *logicalBlockSize = cache->lbaFormat.logicalBlockSize;
+    }
+}
+
+// Reads the identify active namespace ID list (CNS 2). It only changes with namespace management or attachment.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+static eReturnValues sntl_Get_Active_Namespace_List(const tDevice* M_NONNULL device,
+                                                    uint8_t* M_NONNULL       activeNamespaces)
+{
+    eReturnValues          ret   = SUCCESS;
+    ptrSntlTranslatorCache cache = sntl_Get_Translator_Cache(device);
+    if (cache != M_NULLPTR && cache->activeNamespacesValid)
+    {
+        if (0 != safe_memcpy(activeNamespaces, NVME_IDENTIFY_DATA_LEN, cache->activeNamespaces, NVME_IDENTIFY_DATA_LEN))
+            M_UNLIKELY
+            {
+                return FAILURE;
+            }
+        return ret;
+    }
+    ret = nvme_Identify(device, activeNamespaces, 0, NVME_IDENTIFY_ALL_ACTIVE_NS);
+    if (ret == SUCCESS && cache != M_NULLPTR)
+    {
+        if (0 == safe_memcpy(cache->activeNamespaces, NVME_IDENTIFY_DATA_LEN, activeNamespaces, NVME_IDENTIFY_DATA_LEN))
+        {
+            cache->activeNamespacesValid = true;
+        }
+    }
+    return ret;
+}
+
+// Dataset management limits require an extra identify on NVMe 2.0 and later, so they are only read once.
+M_PARAM_RO(1)
+M_PARAM_WO(2)
+M_PARAM_WO(3)
+static void sntl_Get_DSM_Limits(const tDevice* M_NONNULL device,
+                                uint32_t* M_NONNULL      maxRanges,
+                                uint32_t* M_NONNULL      maxLBAsPerRange)
+{
+    ptrSntlTranslatorCache cache = sntl_Get_Translator_Cache(device);
+    if (cache != M_NULLPTR && cache->dsmLimitsValid)
+    {
+        *maxRanges       = cache->dsmLimits.maxRanges;
+        *maxLBAsPerRange = cache->dsmLimits.maxLBAsPerRange;
+        return;
+    }
+    // when the limits cannot be read, this still returns the defaults from the base specification which are always
+    // safe to use, so there is no reason to read them again
+    get_NVMe_DSM_Limits(device, maxRanges, maxLBAsPerRange);
+    if (cache != M_NULLPTR)
+    {
+        cache->dsmLimits.maxRanges       = *maxRanges;
+        cache->dsmLimits.maxLBAsPerRange = *maxLBAsPerRange;
+        cache->dsmLimitsValid            = true;
+    }
+}
+
+// Get log page through the translator cache. Only the supported logs, SMART/health and rotational media logs are
+// cached, and only when read from offset zero with no log specific field. Everything else goes to the drive.
+M_PARAM_RO(1)
+M_PARAM_RW(2)
+static eReturnValues sntl_Get_Log_Page(const tDevice* M_NONNULL device, nvmeGetLogPageCmdOpts* M_NONNULL getLogOpts)
+{
+    eReturnValues      ret       = SUCCESS;
+    sntlCachedLogPage* cachedLog = M_NULLPTR;
+    bool               expires   = true;
+    if (getLogOpts->offset == 0 && getLogOpts->lsp == 0 && getLogOpts->dataLen <= SNTL_CACHED_LOG_MAX_LENGTH)
+    {
+        ptrSntlTranslatorCache cache = sntl_Get_Translator_Cache(device);
+        if (cache != M_NULLPTR)
+        {
+            switch (getLogOpts->lid)
+            {
+            case NVME_LOG_SUPPORTED_PAGES_ID:
+                cachedLog = &cache->logs[SNTL_CACHED_LOG_SUPPORTED_PAGES];
+                expires   = false;
+                break;
+            case NVME_LOG_SMART_ID:
+                cachedLog = &cache->logs[SNTL_CACHED_LOG_SMART_HEALTH];
+                break;
+            case NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID:
+                cachedLog = &cache->logs[SNTL_CACHED_LOG_ROTATIONAL_MEDIA];
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    if (cachedLog != M_NULLPTR && cachedLog->valid && cachedLog->nsid == getLogOpts->nsid &&
+        cachedLog->length >= getLogOpts->dataLen)
+    {
+        seatimer age = cachedLog->readTime;
+        stop_Timer(&age);
+        if (!expires || get_Nano_Seconds(age) < SNTL_TRANSLATOR_COUNTER_CACHE_NS)
+        {
+            if (0 != safe_memcpy(getLogOpts->addr, getLogOpts->dataLen, cachedLog->data, getLogOpts->dataLen))
+                M_UNLIKELY
+                {
+                    return FAILURE;
+                }
+            return ret;
+        }
+    }
+    ret = nvme_Get_Log_Page(device, getLogOpts);
+    if (ret == SUCCESS && cachedLog != M_NULLPTR)
+    {
+        cachedLog->valid = false;
+        if (0 == safe_memcpy(cachedLog->data, SNTL_CACHED_LOG_MAX_LENGTH, getLogOpts->addr, getLogOpts->dataLen))
+        {
+            cachedLog->nsid   = getLogOpts->nsid;
+            cachedLog->length = getLogOpts->dataLen;
+            safe_memset(&cachedLog->readTime, sizeof(seatimer), 0, sizeof(seatimer));
+            start_Timer(&cachedLog->readTime);
+            cachedLog->valid = true;
+        }
+    }
+    return ret;
+}
+
 static void sntl_Set_Sense_Key_Specific_Descriptor_Invalid_Field(
     uint8_t  data[SNTL_SENSE_KEY_SPECIFIC_DESCRIPTOR_LENGTH],
     bool     cd,
@@ -1765,8 +2054,10 @@ static eReturnValues sntl_Translate_Block_Limits_VPD_Page_B0h(const tDevice* dev
     // unmap stuff
     if (le16_to_host(device->drive_info.IdentifyData.nvme.ctrl.oncs) & BIT2)
     {
-        uint32_t unmapLBACount            = UINT32_MAX;
-        uint32_t unmapMaxBlockDescriptors = UINT32_C(256);
+        // The translator sorts, merges, and splits the descriptors into as many dataset management commands as the
+        // controller needs, so these are not limited by the ranges in a single command.
+        uint32_t unmapLBACount            = SNTL_UNMAP_MAX_LBA_COUNT;
+        uint32_t unmapMaxBlockDescriptors = SNTL_UNMAP_MAX_BLOCK_DESCRIPTORS;
         // maximum unmap LBA count (unspecified....we decide)
         blockLimits[20] = M_Byte3(unmapLBACount);
         blockLimits[21] = M_Byte2(unmapLBACount);
@@ -1839,7 +2130,7 @@ static eReturnValues sntl_Translate_Block_Device_Characteristics_VPD_Page_B1h(Sc
             supLogs.addr    = supportedLogs;
             supLogs.dataLen = 1024;
             supLogs.lid     = NVME_LOG_SUPPORTED_PAGES_ID;
-            if (SUCCESS == nvme_Get_Log_Page(scsiIoCtx->device, &supLogs))
+            if (SUCCESS == sntl_Get_Log_Page(scsiIoCtx->device, &supLogs))
             {
                 uint32_t rotMediaOffset = NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID * 4;
                 uint32_t rotMediaSup =
@@ -1854,7 +2145,7 @@ static eReturnValues sntl_Translate_Block_Device_Characteristics_VPD_Page_B1h(Sc
                     rotationMediaLog.addr    = rotMediaInfo;
                     rotationMediaLog.dataLen = 512;
                     rotationMediaLog.lid     = NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID;
-                    if (SUCCESS == nvme_Get_Log_Page(scsiIoCtx->device, &rotationMediaLog))
+                    if (SUCCESS == sntl_Get_Log_Page(scsiIoCtx->device, &rotationMediaLog))
                     {
                         blockDeviceCharacteriticsPage[4] = rotMediaInfo[5];
                         blockDeviceCharacteriticsPage[5] = rotMediaInfo[4];
@@ -2254,15 +2545,9 @@ static eReturnValues sntl_Translate_SCSI_Read_Capacity_Command(const tDevice* de
     }
     if (scsiIoCtx->pdata)
     {
-        uint64_t maxLBA = le64_to_host(device->drive_info.IdentifyData.nvme.ns.nsze) - UINT64_C(1);
-        uint8_t  flbas  = get_bit_range_uint8(device->drive_info.IdentifyData.nvme.ns.flbas, 3, 0);
-        if (NVME_0_BASED(device->drive_info.IdentifyData.nvme.ns.nlbaf) > 16)
-        {
-            // need to append 2 more bits to interpret this correctly since number of formats > 16
-            flbas |= get_bit_range_uint8(device->drive_info.IdentifyData.nvme.ns.flbas, 6, 5) << 4;
-        }
-        uint32_t logicalSectorSize =
-            C_CAST(uint32_t, power_Of_Two(device->drive_info.IdentifyData.nvme.ns.lbaf[flbas].lbaDS));
+        uint64_t maxLBA            = UINT64_C(0);
+        uint32_t logicalSectorSize = UINT32_C(0);
+        sntl_Get_Current_LBA_Format(device, &maxLBA, &logicalSectorSize);
         // set the data in the buffer
         if (readCapacity16)
         {
@@ -2391,7 +2676,7 @@ static eReturnValues sntl_Translate_Supported_Log_Pages(const tDevice* device, S
             supLogs.addr    = supportedLogs;
             supLogs.dataLen = 1024;
             supLogs.lid     = NVME_LOG_SUPPORTED_PAGES_ID;
-            if (SUCCESS == nvme_Get_Log_Page(scsiIoCtx->device, &supLogs))
+            if (SUCCESS == sntl_Get_Log_Page(scsiIoCtx->device, &supLogs))
             {
                 uint32_t rotMediaOffset = NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID * 4;
                 uint32_t rotMediaSup =
@@ -2484,7 +2769,7 @@ static eReturnValues sntl_Translate_Temperature_Log_0x0D(const tDevice* device,
     temperatureLog[1] = 0x00;
     if (parameterPointer <= 0)
     {
-        if (SUCCESS != nvme_Get_Log_Page(device, &getSMARTHealthData))
+        if (SUCCESS != sntl_Get_Log_Page(device, &getSMARTHealthData))
         {
             set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
                                           scsiIoCtx->senseDataSize);
@@ -2585,7 +2870,7 @@ static eReturnValues sntl_Translate_Solid_State_Media_Log_0x11(const tDevice* de
     if (parameterPointer <= 1)
     {
         // endurance
-        if (SUCCESS != nvme_Get_Log_Page(device, &getSMARTHealthData))
+        if (SUCCESS != sntl_Get_Log_Page(device, &getSMARTHealthData))
         {
             set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
                                           scsiIoCtx->senseDataSize);
@@ -2636,7 +2921,7 @@ static eReturnValues sntl_Translate_Informational_Exceptions_Log_Page_2F(const t
         // request for controller wide data
         getSMARTHealthData.nsid = UINT32_MAX; // or zero?
     }
-    if (SUCCESS != nvme_Get_Log_Page(device, &getSMARTHealthData))
+    if (SUCCESS != sntl_Get_Log_Page(device, &getSMARTHealthData))
     {
         set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
                                       scsiIoCtx->senseDataSize);
@@ -2717,7 +3002,7 @@ static eReturnValues sntl_Translate_Background_Scan_Results_Log_0x15(const tDevi
         // request for controller wide data
         readSmartLog.nsid = UINT32_MAX; // or zero?
     }
-    if (SUCCESS != nvme_Get_Log_Page(device, &readSmartLog))
+    if (SUCCESS != sntl_Get_Log_Page(device, &readSmartLog))
     {
         set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
                                       scsiIoCtx->senseDataSize);
@@ -2805,7 +3090,7 @@ static eReturnValues sntl_Translate_General_Statistics_And_Performance_Log_0x19(
         // request for controller wide data
         readSmartLog.nsid = UINT32_MAX; // or zero?
     }
-    if (SUCCESS != nvme_Get_Log_Page(device, &readSmartLog))
+    if (SUCCESS != sntl_Get_Log_Page(device, &readSmartLog))
     {
         set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
                                       scsiIoCtx->senseDataSize);
@@ -2974,7 +3259,7 @@ static eReturnValues sntl_Translate_Start_Stop_Cycle_Log_0x0E(const tDevice* dev
             supLogs.addr    = supportedLogs;
             supLogs.dataLen = 1024;
             supLogs.lid     = NVME_LOG_SUPPORTED_PAGES_ID;
-            if (SUCCESS == nvme_Get_Log_Page(scsiIoCtx->device, &supLogs))
+            if (SUCCESS == sntl_Get_Log_Page(scsiIoCtx->device, &supLogs))
             {
                 uint32_t rotMediaOffset = NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID * 4;
                 uint32_t rotMediaSup =
@@ -2989,7 +3274,7 @@ static eReturnValues sntl_Translate_Start_Stop_Cycle_Log_0x0E(const tDevice* dev
                     rotationMediaLog.addr    = rotMediaInfo;
                     rotationMediaLog.dataLen = 512;
                     rotationMediaLog.lid     = NVME_LOG_ROTATIONAL_MEDIA_INFORMATION_ID;
-                    if (SUCCESS == nvme_Get_Log_Page(scsiIoCtx->device, &rotationMediaLog))
+                    if (SUCCESS == sntl_Get_Log_Page(scsiIoCtx->device, &rotationMediaLog))
                     {
                         uint32_t offset = UINT32_C(4); // increments each time we add a parameter
                         if (parameterPointer <= 4)
@@ -6237,7 +6522,7 @@ static eReturnValues sntl_Translate_SCSI_Report_Luns_Command(const tDevice* M_NO
                 uint8_t*, safe_calloc_aligned(4096, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
             if (activeNamespaces)
             {
-                if (SUCCESS == nvme_Identify(device, activeNamespaces, 0, 2))
+                if (SUCCESS == sntl_Get_Active_Namespace_List(device, activeNamespaces))
                 {
                     // allocate based on maximum number of namespaces
                     reportLunsDataLength += UINT32_C(8) * le32_to_host(device->drive_info.IdentifyData.nvme.ctrl.nn);
@@ -7349,22 +7634,16 @@ static eReturnValues sntl_Translate_SCSI_Unmap_Command(const tDevice* device, Sc
                           // 16 to avoid partial block descriptors-TJE
         if (unmapBlockDescriptorLength > UINT16_C(0))
         {
-            uint8_t* dsmBuffer =
-                C_CAST(uint8_t*, safe_calloc_aligned(4096, sizeof(uint8_t),
-                                                     get_Device_IO_Minimum_Alignment(
-                                                         device))); // allocate the max size the device supports...we'll
-                                                                    // fill in as much as we need to
             // need to check to make sure there weren't any truncated block descriptors before we begin
             uint16_t minBlockDescriptorLength =
-                C_CAST(uint16_t, M_Min(unmapBlockDescriptorLength + 8, parameterListLength));
-            uint16_t unmapBlockDescriptorIter = UINT16_C(8);
-            uint64_t numberOfLBAsToDeallocate = UINT64_C(
-                0); // this will be checked later to make sure it isn't greater than what we reported on the VPD pages
-            uint16_t numberOfBlockDescriptors = UINT16_C(
-                0); // this will be checked later to make sure it isn't greater than what we reported on the VPD pages
-            uint16_t nvmeDSMOffset  = UINT16_C(0);
-            uint8_t  numberOfRanges = UINT8_C(0);
-            if (!dsmBuffer)
+                C_CAST(uint16_t, M_Min(unmapBlockDescriptorLength + UINT16_C(8), parameterListLength));
+            uint32_t  numberOfBlockDescriptors = (minBlockDescriptorLength - UINT32_C(8)) / UINT32_C(16);
+            uint32_t  numberOfRanges           = UINT32_C(0);
+            uint64_t  numberOfLBAsToDeallocate = UINT64_C(0);
+            uint8_t*  dsmBuffer                = M_NULLPTR;
+            lbaRange* ranges                   = M_REINTERPRET_CAST(
+                lbaRange*, safe_calloc(M_Max(numberOfBlockDescriptors, UINT32_C(1)), sizeof(lbaRange)));
+            if (ranges == M_NULLPTR)
             {
                 // lets just set this error for now...-TJE
                 fieldPointer = UINT16_C(7);
@@ -7376,31 +7655,28 @@ static eReturnValues sntl_Translate_SCSI_Unmap_Command(const tDevice* device, Sc
                     device->drive_info.softSATFlags.senseDataDescriptorFormat, senseKeySpecificDescriptor, 1);
                 return MEMORY_FAILURE;
             }
-            // start building the buffer to transfer with data set management
-            for (; unmapBlockDescriptorIter < minBlockDescriptorLength;
-                 unmapBlockDescriptorIter += UINT16_C(16), numberOfBlockDescriptors++)
+            // First gather and validate all of the block descriptors. Nothing is sent to the drive until the whole
+            // list is known to be good, then it is sorted and merged so the fewest ranges and commands are used.
+            for (uint32_t descriptorIter = UINT32_C(0); descriptorIter < numberOfBlockDescriptors; ++descriptorIter)
             {
-                bool     exitLoop                 = false; // to exit for from while loop below
+                uint16_t descriptorOffset         = C_CAST(uint16_t, UINT32_C(8) + (descriptorIter * UINT32_C(16)));
                 uint64_t unmapLogicalBlockAddress = M_BytesTo8ByteValue(
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 0], scsiIoCtx->pdata[unmapBlockDescriptorIter + 1],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 2], scsiIoCtx->pdata[unmapBlockDescriptorIter + 3],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 4], scsiIoCtx->pdata[unmapBlockDescriptorIter + 5],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 6], scsiIoCtx->pdata[unmapBlockDescriptorIter + 7]);
+                    scsiIoCtx->pdata[descriptorOffset + 0], scsiIoCtx->pdata[descriptorOffset + 1],
+                    scsiIoCtx->pdata[descriptorOffset + 2], scsiIoCtx->pdata[descriptorOffset + 3],
+                    scsiIoCtx->pdata[descriptorOffset + 4], scsiIoCtx->pdata[descriptorOffset + 5],
+                    scsiIoCtx->pdata[descriptorOffset + 6], scsiIoCtx->pdata[descriptorOffset + 7]);
                 uint32_t unmapNumberOfLogicalBlocks = M_BytesTo4ByteValue(
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 8], scsiIoCtx->pdata[unmapBlockDescriptorIter + 9],
-                    scsiIoCtx->pdata[unmapBlockDescriptorIter + 10], scsiIoCtx->pdata[unmapBlockDescriptorIter + 11]);
+                    scsiIoCtx->pdata[descriptorOffset + 8], scsiIoCtx->pdata[descriptorOffset + 9],
+                    scsiIoCtx->pdata[descriptorOffset + 10], scsiIoCtx->pdata[descriptorOffset + 11]);
                 if (unmapNumberOfLogicalBlocks == 0)
                 {
                     // nothing to unmap...
                     continue;
                 }
-                // increment this so we can check if we were given more to do than we support (to be checked after the
-                // loop)
-                numberOfLBAsToDeallocate += unmapNumberOfLogicalBlocks;
                 // check we aren't trying to go over the end of the drive
                 if (unmapLogicalBlockAddress > return_Device_MaxLba(device))
                 {
-                    fieldPointer = unmapBlockDescriptorIter + 0;
+                    fieldPointer = descriptorOffset + 0;
                     bitPointer   = UINT8_C(7);
                     sntl_Set_Sense_Key_Specific_Descriptor_Invalid_Field(senseKeySpecificDescriptor, false, true,
                                                                          bitPointer, fieldPointer);
@@ -7410,9 +7686,10 @@ static eReturnValues sntl_Translate_SCSI_Unmap_Command(const tDevice* device, Sc
                         device->drive_info.softSATFlags.senseDataDescriptorFormat, senseKeySpecificDescriptor, 1);
                     break;
                 }
-                else if (unmapLogicalBlockAddress + unmapNumberOfLogicalBlocks > return_Device_MaxLba(device))
+                else if (unmapNumberOfLogicalBlocks - UINT32_C(1) >
+                         return_Device_MaxLba(device) - unmapLogicalBlockAddress)
                 {
-                    fieldPointer = unmapBlockDescriptorIter + 8;
+                    fieldPointer = descriptorOffset + 8;
                     bitPointer   = UINT8_C(7);
                     sntl_Set_Sense_Key_Specific_Descriptor_Invalid_Field(senseKeySpecificDescriptor, false, true,
                                                                          bitPointer, fieldPointer);
@@ -7422,95 +7699,63 @@ static eReturnValues sntl_Translate_SCSI_Unmap_Command(const tDevice* device, Sc
                         device->drive_info.softSATFlags.senseDataDescriptorFormat, senseKeySpecificDescriptor, 1);
                     break;
                 }
-                // check that we haven't had too many block descriptors yet
-                if (numberOfBlockDescriptors > (255)) // max of 255 ranges
-                {
-                    // not setting sense key specific information because it's not clear in this condition what error we
-                    // should point to
-                    ret = FAILURE;
-                    sntl_Set_Sense_Data_For_Translation(
-                        scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0,
-                        device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
-                    break;
-                }
-                // check that we haven't been asked to TRIM more LBAs than we care to support in this code
-                if (numberOfLBAsToDeallocate >
-                    (UINT64_C(255) * UINT32_MAX)) // max of 255 ranges * UINT32_MAX for number LBAs in each range
+                numberOfLBAsToDeallocate += unmapNumberOfLogicalBlocks;
+                ranges[numberOfRanges].lba    = unmapLogicalBlockAddress;
+                ranges[numberOfRanges].length = unmapNumberOfLogicalBlocks;
+                ++numberOfRanges;
+            }
+            // check that we were not given more than was reported in the block limits VPD page
+            if (ret == SUCCESS && (numberOfBlockDescriptors > SNTL_UNMAP_MAX_BLOCK_DESCRIPTORS ||
+                                   numberOfLBAsToDeallocate > SNTL_UNMAP_MAX_LBA_COUNT))
+            {
+                // not setting sense key specific information because it's not clear in this condition what error we
+                // should point to
+                ret = FAILURE;
+                sntl_Set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize,
+                                                    SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0,
+                                                    device->drive_info.softSATFlags.senseDataDescriptorFormat,
+                                                    M_NULLPTR, 0);
+            }
+            if (ret == SUCCESS && numberOfRanges > UINT32_C(0))
+            {
+                uint32_t maxRanges       = NVME_DSM_MAX_RANGES;
+                uint32_t maxLBAsPerRange = UINT32_MAX;
+                uint32_t rangeIndex      = UINT32_C(0);
+                uint64_t rangeOffset     = UINT64_C(0);
+                numberOfRanges           = coalesce_LBA_Ranges(ranges, numberOfRanges);
+                sntl_Get_DSM_Limits(device, &maxRanges, &maxLBAsPerRange);
+                dsmBuffer = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(NVME_DSM_MAX_BUFFER_SIZE, sizeof(uint8_t),
+                                                                            get_Device_IO_Minimum_Alignment(device)));
+                if (dsmBuffer == M_NULLPTR)
                 {
-                    // not setting sense key specific information because it's not clear in this condition what error we
-                    // should point to
-                    ret = FAILURE;
-                    sntl_Set_Sense_Data_For_Translation(
-                        scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_ILLEGAL_REQUEST, 0x26, 0,
-                        device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
-                    break;
+                    safe_free(&ranges);
+                    sntl_Set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize,
+                                                        SENSE_KEY_VENDOR_SPECIFIC, 0x44, 0,
+                                                        device->drive_info.softSATFlags.senseDataDescriptorFormat,
+                                                        M_NULLPTR, 0);
+                    return MEMORY_FAILURE;
                 }
-                // now that we've done all of our checks so far, start setting up the buffer
-                // break this block descriptor into multiple ATA entries if necessary
-                while (unmapNumberOfLogicalBlocks > 0)
+                while (rangeIndex < numberOfRanges)
                 {
-                    // range
-                    dsmBuffer[nvmeDSMOffset + 4] = M_Byte3(unmapNumberOfLogicalBlocks);
-                    dsmBuffer[nvmeDSMOffset + 5] = M_Byte2(unmapNumberOfLogicalBlocks);
-                    dsmBuffer[nvmeDSMOffset + 6] = M_Byte1(unmapNumberOfLogicalBlocks);
-                    dsmBuffer[nvmeDSMOffset + 7] = M_Byte0(unmapNumberOfLogicalBlocks);
-                    ++numberOfRanges;
-                    // lba
-                    dsmBuffer[nvmeDSMOffset + 8]  = M_Byte7(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 9]  = M_Byte6(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 10] = M_Byte5(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 11] = M_Byte4(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 12] = M_Byte3(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 13] = M_Byte2(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 14] = M_Byte1(unmapLogicalBlockAddress);
-                    dsmBuffer[nvmeDSMOffset + 15] = M_Byte0(unmapLogicalBlockAddress);
-
-                    // now increment the nvmeDSMOffset
-                    nvmeDSMOffset += 16;
-                    // check if the NVMe DSM buffer is full...if it is and there are more or potentially more block
-                    // descriptors, send the command now
-                    if ((nvmeDSMOffset > 4096) && ((unmapBlockDescriptorIter + 16) < minBlockDescriptorLength))
+                    // limiting the buffer size limits the ranges placed in each command to what the controller allows
+                    uint32_t entries = fill_NVMe_DSM_Range_Buffer(ranges, numberOfRanges, &rangeIndex, &rangeOffset,
+                                                                  dsmBuffer, maxRanges * NVME_DSM_RANGE_SIZE,
+                                                                  maxLBAsPerRange);
+                    if (entries == UINT32_C(0))
                     {
-                        if (SUCCESS == nvme_Dataset_Management(device, NVME_0_BASED_ADJUST(numberOfRanges), true, false,
-                                                               false, dsmBuffer, 4096))
-                        {
-                            // clear the buffer for reuse
-                            if (0 != safe_memset(dsmBuffer, 4096, 0, 4096))
-                                M_UNLIKELY
-                                {
-                                    perror("Error clearing DSM buffer");
-                                }
-                            // reset the ataTrimOffset
-                            nvmeDSMOffset  = 0;
-                            numberOfRanges = 0;
-                        }
-                        else
-                        {
-                            ret = FAILURE;
-                            set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus,
-                                                          scsiIoCtx->psense, scsiIoCtx->senseDataSize);
-                            exitLoop = true;
-                            break;
-                        }
+                        break;
+                    }
+                    if (SUCCESS != nvme_Dataset_Management(device, C_CAST(uint8_t, NVME_0_BASED_ADJUST(entries)), true,
+                                                           false, false, dsmBuffer, NVME_DSM_MAX_BUFFER_SIZE))
+                    {
+                        ret = FAILURE;
+                        set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus,
+                                                      scsiIoCtx->psense, scsiIoCtx->senseDataSize);
+                        break;
                     }
-                }
-                if (exitLoop)
-                {
-                    break;
-                }
-            }
-            if (ret == SUCCESS)
-            {
-                // send the data set management command with whatever is in the trim buffer at this point (all zeros is
-                // safe to send if we do get that)
-                if (SUCCESS != nvme_Dataset_Management(device, NVME_0_BASED_ADJUST(numberOfRanges), true, false, false,
-                                                       dsmBuffer, 4096))
-                {
-                    ret = FAILURE;
-                    set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus,
-                                                  scsiIoCtx->psense, scsiIoCtx->senseDataSize);
                 }
             }
+            safe_free(&ranges);
             safe_free_aligned(&dsmBuffer);
         }
     }
@@ -7862,15 +8107,9 @@ static eReturnValues sntl_Translate_Persistent_Reserve_In(const tDevice* device,
     break;
     case 2: // report capabilities
     {
-        // send NVMe identify command, CNS set to 0, current namespace being queried.
-        if (SUCCESS != nvme_Identify(device, M_CONST_CAST(uint8_t*, &device->drive_info.IdentifyData.nvme.ns),
-                                     device->drive_info.namespaceID, 0))
-        {
-            set_Sense_Data_By_NVMe_Status(device, device->drive_info.lastNVMeResult.lastNVMeStatus, scsiIoCtx->psense,
-                                          scsiIoCtx->senseDataSize);
-            return ret;
-        }
-        // then do a get features with FID set to 83h (reservation persistence)
+        // The namespace identify data is refreshed by sntl_Translate_SCSI_Command whenever something could have
+        // changed it, so it does not need to be read again here.
+        // do a get features with FID set to 83h (reservation persistence)
         nvmeFeaturesCmdOpt getReservationPersistence;
         M_INITIALIZE_STRUCTURE(&getReservationPersistence, sizeof(nvmeFeaturesCmdOpt));
         getReservationPersistence.fid = 0x83;
@@ -10987,6 +11226,48 @@ static eReturnValues sntl_Create_All_Supported_Op_Codes_Buffer(const tDevice* de
     return ret;
 }
 
+// The full list only depends on the identify data, so it is generated once and returned from the translator cache
+// after that. The returned pointer belongs to the cache and must not be freed.
+static eReturnValues sntl_Get_All_Supported_Op_Codes_Buffer(const tDevice*  device,
+                                                            bool            rctd,
+                                                            const uint8_t** pdata,
+                                                            uint32_t*       dataLength)
+{
+    eReturnValues          ret   = SUCCESS;
+    ptrSntlTranslatorCache cache = sntl_Get_Translator_Cache(device);
+    uint8_t                index = rctd ? UINT8_C(1) : UINT8_C(0);
+    if (cache == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    if (!cache->allOpCodes[index].valid)
+    {
+        uint8_t* opCodes       = M_NULLPTR;
+        uint32_t opCodesLength = UINT32_C(0);
+        ret                    = sntl_Create_All_Supported_Op_Codes_Buffer(device, rctd, &opCodes, &opCodesLength);
+        if (ret == SUCCESS)
+        {
+            if (0 == safe_memcpy(cache->allOpCodes[index].data, SNTL_ALL_OP_CODES_MAX_LENGTH, opCodes,
+                                 M_Min(opCodesLength, SNTL_ALL_OP_CODES_MAX_LENGTH)))
+            {
+                cache->allOpCodes[index].length = M_Min(opCodesLength, SNTL_ALL_OP_CODES_MAX_LENGTH);
+                cache->allOpCodes[index].valid  = true;
+            }
+            else
+            {
+                ret = FAILURE;
+            }
+        }
+        safe_free(&opCodes);
+    }
+    if (ret == SUCCESS)
+    {
+        *pdata      = cache->allOpCodes[index].data;
+        *dataLength = cache->allOpCodes[index].length;
+    }
+    return ret;
+}
+
 static eReturnValues sntl_Translate_SCSI_Report_Supported_Operation_Codes_Command(const tDevice* device,
                                                                                   ScsiIoCtx*     scsiIoCtx)
 {
@@ -10997,8 +11278,9 @@ static eReturnValues sntl_Translate_SCSI_Report_Supported_Operation_Codes_Comman
     uint16_t      requestedServiceAction = M_BytesTo2ByteValue(scsiIoCtx->cdb[CDB_4], scsiIoCtx->cdb[CDB_5]);
     uint32_t      allocationLength =
         M_BytesTo4ByteValue(scsiIoCtx->cdb[CDB_6], scsiIoCtx->cdb[CDB_7], scsiIoCtx->cdb[CDB_8], scsiIoCtx->cdb[CDB_9]);
-    uint8_t* supportedOpData       = M_NULLPTR;
-    uint32_t supportedOpDataLength = UINT32_C(0);
+    uint8_t*       supportedOpData       = M_NULLPTR;
+    const uint8_t* cachedOpData          = M_NULLPTR; // owned by the translator cache. Do not free
+    uint32_t       supportedOpDataLength = UINT32_C(0);
     DECLARE_ZERO_INIT_ARRAY(uint8_t, senseKeySpecificDescriptor, SNTL_SENSE_KEY_SPECIFIC_DESCRIPTOR_LENGTH);
     uint8_t  bitPointer   = UINT8_C(0);
     uint16_t fieldPointer = UINT16_C(0);
@@ -11039,7 +11321,7 @@ static eReturnValues sntl_Translate_SCSI_Report_Supported_Operation_Codes_Comman
     switch (reportingOptions)
     {
     case 0: // return all op codes (return not supported for now until we get the other methods working...)
-        ret = sntl_Create_All_Supported_Op_Codes_Buffer(device, rctd, &supportedOpData, &supportedOpDataLength);
+        ret = sntl_Get_All_Supported_Op_Codes_Buffer(device, rctd, &cachedOpData, &supportedOpDataLength);
         break;
     case 1: // check operation code, service action ignored
         // check op code func
@@ -11084,9 +11366,10 @@ static eReturnValues sntl_Translate_SCSI_Report_Supported_Operation_Codes_Comman
                                             M_NULLPTR, 0);
         break;
     }
-    if (supportedOpData && scsiIoCtx->pdata)
+    const uint8_t* returnOpData = supportedOpData != M_NULLPTR ? supportedOpData : cachedOpData;
+    if (returnOpData && scsiIoCtx->pdata)
     {
-        if (0 != safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, supportedOpData,
+        if (0 != safe_memcpy(scsiIoCtx->pdata, scsiIoCtx->dataLength, returnOpData,
                              M_Min(supportedOpDataLength, allocationLength)))
             M_UNLIKELY
             {
@@ -11154,7 +11437,7 @@ eReturnValues sntl_Translate_SCSI_Command(const tDevice* M_NONNULL device, ScsiI
     sntl_Set_Sense_Data_For_Translation(scsiIoCtx->psense, scsiIoCtx->senseDataSize, SENSE_KEY_NO_ERROR, 0, 0,
                                         device->drive_info.softSATFlags.senseDataDescriptorFormat, M_NULLPTR, 0);
     // if the ataIdentify data is zero, send an identify at least once so we aren't sending that every time we do a read
-    // or write command...inquiry, read capacity will always do one though to get the most recent data
+    // or write command...after that it is only reread once a format, firmware activation, etc marks it stale
     if (!deviceInfoAvailable)
     {
         DECLARE_ZERO_INIT_ARRAY(uint8_t, zeroData, NVME_IDENTIFY_DATA_LEN);
@@ -11175,6 +11458,7 @@ eReturnValues sntl_Translate_SCSI_Command(const tDevice* M_NONNULL device, ScsiI
             deviceInfoAvailable = true;
         }
     }
+    sntl_Refresh_Stale_Identify_Data(device);
     // start checking the scsi command and call the function to translate it
     // All functions within this switch-case should dummy up their own sense data specific to the translation!
     switch (scsiIoCtx->cdb[CDB_OPERATION_CODE])
@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file surface_scan.c
+// \brief Implements a full or partial media scan that reads or verifies a range of LBAs with the largest commands the
+// device accepts and reports each bad range found without stopping the scan
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "cmds.h"
+#include "nvme_helper.h"
+#include "nvme_helper_func.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "surface_scan.h"
+
+// nvme_Verify_LBA takes fewer than 65534 blocks, so stay on a power of 2 below that
+#define SURFACE_SCAN_NVME_MAX_BLOCKS UINT32_C(32768)
+
+typedef struct s_surfaceScanState
+{
+    const tDevice*            device;
+    const surfaceScanOptions* options;
+    surfaceScanResults*       results;
+    uint32_t                  blockSize;
+    uint8_t*                  buffer; // read scans only
+    uint32_t                  bufferSize;
+    bool                      pendingBadRange; // badRange holds bad LBAs not reported yet
+    surfaceScanBadRange       badRange;
+    bool                      stopped; // by the callback or maxBadRanges
+    bool                      stoppedByCallback;
+} surfaceScanState;
+
+static M_INLINE uint32_t min_Nonzero_Blocks(uint32_t blocks, uint32_t limitBytes, uint32_t blockSize)
+{
+    if (limitBytes > UINT32_C(0))
+    {
+        blocks = M_Min(blocks, limitBytes / blockSize);
+    }
+    return blocks;
+}
+
+static bool is_NVMe_Verify_Supported(const tDevice* device)
+{
+    return (le16_to_host(device->drive_info.IdentifyData.nvme.ctrl.oncs) & BIT7) > 0;
+}
+
+static eSurfaceScanMode get_Surface_Scan_Mode(const tDevice* device, eSurfaceScanMode requested)
+{
+    if (requested == SURFACE_SCAN_VERIFY && get_Device_DriveType(device) == NVME_DRIVE &&
+        !is_NVMe_Verify_Supported(device))
+    {
+        // nvme_Verify_LBA would read with FUA anyway, allocating a buffer for every command
+        return SURFACE_SCAN_READ;
+    }
+    return requested;
+}
+
+OPENSEA_TRANSPORT_API uint32_t get_Surface_Scan_Blocks_Per_Command(const tDevice* M_NONNULL device,
+                                                                   eSurfaceScanMode         mode)
+{
+    uint32_t blockSize = get_Device_BlockSize(device);
+    uint32_t blocks    = UINT32_C(0);
+    mode               = get_Surface_Scan_Mode(device, mode);
+    if (blockSize == UINT32_C(0))
+    {
+        blockSize = LEGACY_DRIVE_SEC_SIZE;
+    }
+    blocks = (mode == SURFACE_SCAN_VERIFY ? SURFACE_SCAN_MAX_VERIFY_BYTES : SURFACE_SCAN_MAX_READ_BYTES) / blockSize;
+    if (get_Device_DriveType(device) == NVME_DRIVE)
+    {
+        blocks = M_Min(blocks, SURFACE_SCAN_NVME_MAX_BLOCKS);
+        // MDTS limits data transfers only. Verify has no data.
+        if (mode != SURFACE_SCAN_VERIFY)
+        {
+            blocks = min_Nonzero_Blocks(blocks, get_NVMe_MDTS_Bytes(device), blockSize);
+            blocks = min_Nonzero_Blocks(blocks, device->drive_info.passThroughHacks.nvmePTHacks.maxTransferLength,
+                                        blockSize);
+        }
+    }
+    else
+    {
+        if (get_Device_DriveType(device) == ATA_DRIVE)
+        {
+            blocks = M_Min(blocks, device->drive_info.ata_Options.fourtyEightBitAddressFeatureSetSupported
+                                       ? ATA_MAX_READ_WRITE_EXT_XFER_LEN
+                                       : ATA_MAX_READ_WRITE_XFER_LEN);
+            if (mode != SURFACE_SCAN_VERIFY)
+            {
+                blocks = min_Nonzero_Blocks(blocks, device->drive_info.passThroughHacks.ataPTHacks.maxTransferLength,
+                                            blockSize);
+            }
+        }
+        if (get_Device_InterfaceType(device) != IDE_INTERFACE)
+        {
+            // SCSI, or a SAT translator in front of an ATA drive. Block limits apply to verify too.
+            uint32_t maxTransfer = get_SCSI_Block_Limits(device)->maximumTransferLength;
+            if (maxTransfer > UINT32_C(0))
+            {
+                blocks = M_Min(blocks, maxTransfer);
+            }
+            if (mode != SURFACE_SCAN_VERIFY)
+            {
+                blocks = min_Nonzero_Blocks(blocks, device->drive_info.passThroughHacks.scsiHacks.maxTransferLength,
+                                            blockSize);
+            }
+            if (device->drive_info.passThroughHacks.scsiHacks.readWrite.available &&
+                !device->drive_info.passThroughHacks.scsiHacks.readWrite.rw16 &&
+                !device->drive_info.passThroughHacks.scsiHacks.readWrite.rw12)
+            {
+                // only 10 byte commands work, which have a 16 bit transfer length
+                blocks = M_Min(blocks, C_CAST(uint32_t, UINT16_MAX));
+            }
+        }
+    }
+    return M_Max(blocks, UINT32_C(1));
+}
+
+// True when the device completed the command with an error for some of its LBAs, so a smaller range may succeed. Any
+// other failure means the command did not reach the media at all.
+static bool is_Surface_Scan_Media_Error(const tDevice* device, eReturnValues ret)
+{
+    if (ret != FAILURE && ret != COMMAND_FAILURE)
+    {
+        return false;
+    }
+    if (get_Device_DriveType(device) == NVME_DRIVE)
+    {
+        uint32_t status = device->drive_info.lastNVMeResult.lastNVMeStatus;
+        // Not every OS returns the completion. Without it there is no telling a media error from a lost path or a
+        // reset, so the scan stops rather than reporting the whole range as bad.
+        return status != UINT32_C(0) &&
+               get_8bit_range_uint32(status, 27, 25) == C_CAST(uint8_t, NVME_SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS);
+    }
+    else
+    {
+        uint8_t senseKey = UINT8_C(0);
+        uint8_t asc      = UINT8_C(0);
+        uint8_t ascq     = UINT8_C(0);
+        uint8_t fru      = UINT8_C(0);
+        get_Sense_Key_ASC_ASCQ_FRU(device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN, &senseKey, &asc, &ascq,
+                                   &fru);
+        if (senseKey == SENSE_KEY_MEDIUM_ERROR)
+        {
+            return true;
+        }
+        return get_Device_DriveType(device) == ATA_DRIVE &&
+               (device->drive_info.lastCommandRTFRs.error &
+                (ATA_ERROR_BIT_UNCORRECTABLE_DATA | ATA_ERROR_BIT_ID_NOT_FOUND)) > 0;
+    }
+}
+
+static eReturnValues send_Surface_Scan_Command(surfaceScanState* state, uint64_t lba, uint32_t count)
+{
+    ++state->results->commands;
+    if (state->results->modeUsed == SURFACE_SCAN_READ)
+    {
+        return read_LBA(state->device, lba, false, state->buffer, count * state->blockSize);
+    }
+    else
+    {
+        return verify_LBA(state->device, lba, count);
+    }
+}
+
+// Reports the pending bad range, if there is one
+static void report_Surface_Scan_Bad_Range(surfaceScanState* state)
+{
+    if (!state->pendingBadRange)
+    {
+        return;
+    }
+    state->pendingBadRange = false;
+    ++state->results->badRanges;
+    if (state->options->badRangeCallback != M_NULLPTR &&
+        !state->options->badRangeCallback(&state->badRange, state->options->callbackContext))
+    {
+        state->stopped           = true;
+        state->stoppedByCallback = true;
+    }
+    else if (state->options->maxBadRanges > UINT32_C(0) && state->results->badRanges >= state->options->maxBadRanges)
+    {
+        state->stopped = true;
+    }
+}
+
+static void add_Surface_Scan_Bad_LBA(surfaceScanState* state, uint64_t lba, eReturnValues ret)
+{
+    if (state->pendingBadRange && state->badRange.lba + state->badRange.length == lba)
+    {
+        ++state->badRange.length;
+    }
+    else
+    {
+        report_Surface_Scan_Bad_Range(state);
+        if (state->stopped)
+        {
+            return;
+        }
+        safe_memset(&state->badRange, sizeof(surfaceScanBadRange), 0, sizeof(surfaceScanBadRange));
+        state->badRange.lba    = lba;
+        state->badRange.length = UINT64_C(1);
+        state->badRange.result = ret;
+        if (get_Device_DriveType(state->device) == NVME_DRIVE)
+        {
+            state->badRange.nvmeStatus = state->device->drive_info.lastNVMeResult.lastNVMeStatus;
+        }
+        else
+        {
+            uint8_t fru = UINT8_C(0);
+            get_Sense_Key_ASC_ASCQ_FRU(state->device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN,
+                                       &state->badRange.senseKey, &state->badRange.asc, &state->badRange.ascq, &fru);
+            state->badRange.ataError = state->device->drive_info.lastCommandRTFRs.error;
+        }
+        state->pendingBadRange = true;
+    }
+    ++state->results->badLBAs;
+}
+
+// Scans count LBAs with one command. On a media error, splits the range in half and scans each half the same way
+// until the bad LBAs are found. Returns SUCCESS when the range was scanned, even with bad LBAs, or when the scan was
+// stopped (see state->stopped), and otherwise the error that must stop the scan.
+static eReturnValues scan_Surface_Range(surfaceScanState* state, uint64_t lba, uint32_t count)
+{
+    eReturnValues ret  = send_Surface_Scan_Command(state, lba, count);
+    uint32_t      half = UINT32_C(0);
+    if (ret == SUCCESS)
+    {
+        state->results->lbasScanned += count;
+        state->results->nextLBA = lba + count;
+        report_Surface_Scan_Bad_Range(state);
+        return SUCCESS;
+    }
+    if (!is_Surface_Scan_Media_Error(state->device, ret))
+    {
+        return ret;
+    }
+    if (count == UINT32_C(1))
+    {
+        add_Surface_Scan_Bad_LBA(state, lba, ret);
+        if (!state->stopped)
+        {
+            state->results->lbasScanned += 1;
+            state->results->nextLBA = lba + 1;
+        }
+        return SUCCESS;
+    }
+    half = count / UINT32_C(2);
+    ret  = scan_Surface_Range(state, lba, half);
+    if (ret != SUCCESS || state->stopped)
+    {
+        return ret;
+    }
+    return scan_Surface_Range(state, lba + half, count - half);
+}
+
+OPENSEA_TRANSPORT_API eReturnValues surface_Scan(const tDevice* M_NONNULL            device,
+                                                 const surfaceScanOptions* M_NONNULL options,
+                                                 surfaceScanResults* M_NULLABLE      results)
+{
+    eReturnValues      ret    = SUCCESS;
+    uint64_t           maxLBA = device->drive_info.deviceMaxLba;
+    uint64_t           endLBA = UINT64_C(0); // exclusive
+    uint64_t           lba    = options->startLBA;
+    surfaceScanResults localResults;
+    surfaceScanState   state;
+    safe_memset(&state, sizeof(surfaceScanState), 0, sizeof(surfaceScanState));
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(surfaceScanResults), 0, sizeof(surfaceScanResults));
+    results->nextLBA = options->startLBA;
+    if (options->mode == SURFACE_SCAN_WRITE || options->startLBA > maxLBA ||
+        (options->length > UINT64_C(0) && options->length - 1 > maxLBA - lba))
+    {
+        return BAD_PARAMETER;
+    }
+    endLBA = options->length > UINT64_C(0) ? lba + options->length : maxLBA + 1;
+    state.device    = device;
+    state.options   = options;
+    state.results   = results;
+    state.blockSize = get_Device_BlockSize(device);
+    if (state.blockSize == UINT32_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    results->modeUsed         = get_Surface_Scan_Mode(device, options->mode);
+    results->blocksPerCommand = get_Surface_Scan_Blocks_Per_Command(device, results->modeUsed);
+    if (options->blocksPerCommand > UINT32_C(0))
+    {
+        // anything larger is more than the device or passthrough accept, and could wrap the read buffer size
+        if (options->blocksPerCommand > results->blocksPerCommand)
+        {
+            return BAD_PARAMETER;
+        }
+        results->blocksPerCommand = options->blocksPerCommand;
+    }
+    if (results->modeUsed == SURFACE_SCAN_READ)
+    {
+        // one buffer for the whole scan
+        state.bufferSize = results->blocksPerCommand * state.blockSize;
+        state.buffer     = M_REINTERPRET_CAST(
+            uint8_t*, safe_calloc_aligned(state.bufferSize, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+        if (state.buffer == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+    }
+    while (lba < endLBA && ret == SUCCESS && !state.stopped)
+    {
+        uint32_t count = C_CAST(uint32_t, M_Min(C_CAST(uint64_t, results->blocksPerCommand), endLBA - lba));
+        ret            = scan_Surface_Range(&state, lba, count);
+        lba += count;
+    }
+    if (ret == SUCCESS)
+    {
+        report_Surface_Scan_Bad_Range(&state);
+        if (state.stoppedByCallback)
+        {
+            ret = ABORTED;
+        }
+        else if (results->badLBAs > UINT64_C(0))
+        {
+            ret = FAILURE;
+        }
+    }
+    safe_free_aligned(&state.buffer);
+    return ret;
+}
@@ -2282,6 +2282,7 @@ M_PARAM_RO(1) eReturnValues os_nvme_Subsystem_Reset(const tDevice* M_NONNULL dev
 
 M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* M_NONNULL device)
 {
+    release_Device_Resources(device);
     return NOT_SUPPORTED;
 }
 
@@ -381,6 +381,7 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* M_NONNUL
     int retValue = 0;
     if (device)
     {
+        release_Device_Resources(device);
         retValue = close(device->os_info.fd);
         set_Device_Last_Error(device, errno);
         if (retValue == 0)
@@ -1256,6 +1256,8 @@ static eReturnValues print_sg_io_driver_status(const tDevice* device, sg_io_hdr_
         bool  isNVMe   = false;
         char* nvmeDevName;
 
+        release_Device_Resources(dev);
+
         /**
          * In VMWare NVMe device the drivename (for NDDK)
          * always starts with "vmhba" (e.g. vmhba1)
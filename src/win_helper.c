@@ -4447,6 +4447,7 @@ M_PARAM_RW(1) OPENSEA_TRANSPORT_API eReturnValues close_Device(tDevice* dev)
 
     if (dev != M_NULLPTR)
     {
+        release_Device_Resources(dev);
 #if defined(ENABLE_CSMI)
         if (is_CSMI_Handle(dev->os_info.name))
         {
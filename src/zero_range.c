@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file zero_range.c
+// \brief Implements zeroing a range of LBAs with the fastest zeroing command the device supports
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "ata_helper_func.h"
+#include "cmds.h"
+#include "nvme_helper.h"
+#include "nvme_helper_func.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "surface_scan.h"
+#include "zero_range.h"
+
+// Write Zeroes has a 0's based 16 bit number of logical blocks
+#define ZERO_RANGE_NVME_MAX_BLOCKS UINT64_C(65536)
+// ZEROS EXT treats a count of zero differently between standards, so it is never sent
+#define ZERO_RANGE_ATA_ZEROS_EXT_MAX_BLOCKS C_CAST(uint64_t, UINT16_MAX)
+// SCT Write Same takes any length, but is split so each command finishes in a reasonable time and the progress in the
+// results stays meaningful when one fails
+#define ZERO_RANGE_ATA_SCT_MAX_BYTES UINT64_C(1073741824)
+// Used when the block limits VPD page does not report a maximum write same length
+#define ZERO_RANGE_SCSI_DEFAULT_WRITE_SAME_BLOCKS C_CAST(uint64_t, UINT16_MAX)
+
+typedef struct s_zeroRangeSCSIProvisioning
+{
+    uint64_t maxWriteSameBlocks; // 0 when not reported
+    bool     unmapWriteSame;     // LBPWS: WRITE SAME(16) may unmap
+    bool     unmappedReadZeros;  // LBPRZ: unmapped LBAs read as zeros
+} zeroRangeSCSIProvisioning;
+
+static void add_Zero_Range_Method(zeroRangeCapabilities* capabilities, eZeroRangeMethod method, uint64_t maxBlocks)
+{
+    if (capabilities->numberOfMethods < ZERO_RANGE_MAX_METHODS)
+    {
+        capabilities->methods[capabilities->numberOfMethods].method    = method;
+        capabilities->methods[capabilities->numberOfMethods].maxBlocks = M_Max(maxBlocks, UINT64_C(1));
+        capabilities->methods[capabilities->numberOfMethods].confirmed = false;
+        ++capabilities->numberOfMethods;
+    }
+}
+
+static void get_Zero_Range_SCSI_Provisioning(const tDevice* device, zeroRangeSCSIProvisioning* provisioning)
+{
+    uint8_t* vpd = M_NULLPTR;
+    safe_memset(provisioning, sizeof(zeroRangeSCSIProvisioning), 0, sizeof(zeroRangeSCSIProvisioning));
+    provisioning->maxWriteSameBlocks = get_SCSI_Block_Limits(device)->maximumWriteSameLength;
+    if (device->drive_info.passThroughHacks.scsiHacks.noVPDPages)
+    {
+        return;
+    }
+    vpd = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(VPD_LOGICAL_BLOCK_PROVISIONING_LEN, sizeof(uint8_t),
+                                                           get_Device_IO_Minimum_Alignment(device)));
+    if (vpd == M_NULLPTR)
+    {
+        return;
+    }
+    if (SUCCESS ==
+            scsi_Inquiry(device, vpd, VPD_LOGICAL_BLOCK_PROVISIONING_LEN, LOGICAL_BLOCK_PROVISIONING, true, false) &&
+        vpd[1] == LOGICAL_BLOCK_PROVISIONING)
+    {
+        provisioning->unmapWriteSame    = vpd[5] & BIT6;
+        provisioning->unmappedReadZeros = get_bit_range_uint8(vpd[5], 4, 2) == UINT8_C(1);
+    }
+    safe_free_aligned(&vpd);
+}
+
+OPENSEA_TRANSPORT_API eReturnValues get_Zero_Range_Capabilities(const tDevice* M_NONNULL         device,
+                                                                zeroRangeCapabilities* M_NONNULL capabilities)
+{
+    safe_memset(capabilities, sizeof(zeroRangeCapabilities), 0, sizeof(zeroRangeCapabilities));
+    capabilities->blockSize = get_Device_BlockSize(device);
+    if (capabilities->blockSize == UINT32_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    if (get_Device_DriveType(device) == NVME_DRIVE)
+    {
+        if (le16_to_host(device->drive_info.IdentifyData.nvme.ctrl.oncs) & BIT3)
+        {
+            uint8_t dlfeat = device->drive_info.IdentifyData.nvme.ns.dlfeat;
+            // Deallocate in Write Zeroes is supported and deallocated blocks read as zeros
+            if ((dlfeat & BIT3) && get_bit_range_uint8(dlfeat, 2, 0) == UINT8_C(1))
+            {
+                add_Zero_Range_Method(capabilities, ZERO_RANGE_NVME_WRITE_ZEROES_DEALLOCATE,
+                                      ZERO_RANGE_NVME_MAX_BLOCKS);
+            }
+            add_Zero_Range_Method(capabilities, ZERO_RANGE_NVME_WRITE_ZEROES, ZERO_RANGE_NVME_MAX_BLOCKS);
+        }
+    }
+    else if (get_Device_DriveType(device) == ATA_DRIVE)
+    {
+        uint16_t word069 = le16_to_host(device->drive_info.IdentifyData.ata.Word069);
+        uint16_t word169 = le16_to_host(device->drive_info.IdentifyData.ata.Word169);
+        uint16_t word206 = le16_to_host(device->drive_info.IdentifyData.ata.Word206);
+        if (device->drive_info.softSATFlags.zeroExtSupported)
+        {
+            // TRIM, deterministic read after TRIM (DRAT) and read zeros after TRIM (RZAT)
+            if (is_ATA_Identify_Word_Valid(word169) && (word169 & BIT0) && is_ATA_Identify_Word_Valid(word069) &&
+                (word069 & BIT14) && (word069 & BIT5))
+            {
+                add_Zero_Range_Method(capabilities, ZERO_RANGE_ATA_ZEROS_EXT_TRIM, ZERO_RANGE_ATA_ZEROS_EXT_MAX_BLOCKS);
+            }
+            add_Zero_Range_Method(capabilities, ZERO_RANGE_ATA_ZEROS_EXT, ZERO_RANGE_ATA_ZEROS_EXT_MAX_BLOCKS);
+        }
+        if (is_ATA_Identify_Word_Valid(word206) && (word206 & BIT0) && (word206 & BIT2))
+        {
+            add_Zero_Range_Method(capabilities, ZERO_RANGE_ATA_SCT_WRITE_SAME,
+                                  ZERO_RANGE_ATA_SCT_MAX_BYTES / capabilities->blockSize);
+        }
+    }
+    else
+    {
+        zeroRangeSCSIProvisioning provisioning;
+        uint64_t                  maxWriteSame = ZERO_RANGE_SCSI_DEFAULT_WRITE_SAME_BLOCKS;
+        get_Zero_Range_SCSI_Provisioning(device, &provisioning);
+        if (provisioning.maxWriteSameBlocks > UINT64_C(0))
+        {
+            // WRITE SAME(16) has a 32 bit number of logical blocks
+            maxWriteSame = M_Min(provisioning.maxWriteSameBlocks, C_CAST(uint64_t, UINT32_MAX));
+        }
+        if (provisioning.unmapWriteSame && provisioning.unmappedReadZeros)
+        {
+            add_Zero_Range_Method(capabilities, ZERO_RANGE_SCSI_WRITE_SAME_UNMAP, maxWriteSame);
+        }
+        add_Zero_Range_Method(capabilities, ZERO_RANGE_SCSI_WRITE_SAME, maxWriteSame);
+    }
+    add_Zero_Range_Method(capabilities, ZERO_RANGE_WRITE,
+                          get_Surface_Scan_Blocks_Per_Command(device, SURFACE_SCAN_WRITE));
+    return SUCCESS;
+}
+
+// SCT write same with a zero pattern in the foreground, so the command does not complete until the LBAs are written.
+// This is the same key page send_ATA_SCT_Write_Same sends, but the write log command carries its own timeout since
+// a large range takes far longer than the device default.
+static eReturnValues send_Zero_Range_SCT_Write_Same(const tDevice* device, uint64_t lba, uint64_t count)
+{
+    eReturnValues ret     = UNKNOWN;
+    uint32_t      timeout = os_Is_Infinite_Timeout_Supported() ? INFINITE_TIMEOUT_VALUE : MAX_CMD_TIMEOUT_SECONDS;
+    uint8_t*      keyPage = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(LEGACY_DRIVE_SEC_SIZE, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    if (keyPage == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    keyPage[0]  = M_Byte0(SCT_WRITE_SAME);
+    keyPage[1]  = M_Byte1(SCT_WRITE_SAME);
+    keyPage[2]  = M_Byte0(C_CAST(uint16_t, WRITE_SAME_FOREGROUND_USE_PATTERN_FIELD));
+    keyPage[3]  = M_Byte1(C_CAST(uint16_t, WRITE_SAME_FOREGROUND_USE_PATTERN_FIELD));
+    keyPage[4]  = M_Byte0(lba);
+    keyPage[5]  = M_Byte1(lba);
+    keyPage[6]  = M_Byte2(lba);
+    keyPage[7]  = M_Byte3(lba);
+    keyPage[8]  = M_Byte4(lba);
+    keyPage[9]  = M_Byte5(lba);
+    keyPage[12] = M_Byte0(count);
+    keyPage[13] = M_Byte1(count);
+    keyPage[14] = M_Byte2(count);
+    keyPage[15] = M_Byte3(count);
+    keyPage[16] = M_Byte4(count);
+    keyPage[17] = M_Byte5(count);
+    keyPage[18] = M_Byte6(count);
+    keyPage[19] = M_Byte7(count);
+    // the pattern in bytes 20-23 stays zero
+    if (device->drive_info.ata_Options.generalPurposeLoggingSupported &&
+        !device->drive_info.passThroughHacks.ataPTHacks.smartCommandTransportWithSMARTLogCommandsOnly)
+    {
+        ataPassthroughCommand writeLog = create_ata_pio_out_cmd(device, ATA_WRITE_LOG_EXT_CMD,
+                                                                ATA_CMD_TYPE_EXTENDED_TASKFILE, UINT16_C(1), keyPage,
+                                                                LEGACY_DRIVE_SEC_SIZE);
+        writeLog.tfr.LbaLow = ATA_SCT_COMMAND_STATUS;
+        writeLog.timeout    = timeout;
+        ret                 = ata_Passthrough_Command(device, &writeLog);
+    }
+    else
+    {
+        ret = ata_SMART_Command(device, ATA_SMART_WRITE_LOG, ATA_SCT_COMMAND_STATUS, keyPage, LEGACY_DRIVE_SEC_SIZE,
+                                timeout, false, RESERVED);
+    }
+    safe_free_aligned(&keyPage);
+    return ret;
+}
+
+// True when the device rejected the command itself: an invalid operation code or field, or an ATA abort with no other
+// error. Anything else (a timeout, a transport or device error) may leave the command still running or partly done, so
+// the range must not be sent again with another method.
+static bool is_Zero_Range_Method_Rejected(const tDevice* device, eReturnValues ret)
+{
+    if (ret == NOT_SUPPORTED)
+    {
+        // also what NVMe invalid opcode and invalid field statuses are returned as
+        return true;
+    }
+    if (ret != FAILURE && ret != COMMAND_FAILURE)
+    {
+        return false;
+    }
+    if (is_Invalid_Opcode(device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN) ||
+        is_Invalid_Field_In_CDB(device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN) ||
+        is_Invalid_Field_In_Parameter(device->drive_info.lastCommandSenseData, SPC3_SENSE_LEN))
+    {
+        return true;
+    }
+    return get_Device_DriveType(device) == ATA_DRIVE &&
+           device->drive_info.lastCommandRTFRs.error == ATA_ERROR_BIT_ABORT;
+}
+
+static eReturnValues send_Zero_Range_Command(const tDevice*   device,
+                                             eZeroRangeMethod method,
+                                             uint64_t         lba,
+                                             uint64_t         count,
+                                             uint8_t*         zeroBuffer,
+                                             uint32_t         blockSize)
+{
+    eReturnValues ret = NOT_SUPPORTED;
+    switch (method)
+    {
+    case ZERO_RANGE_NVME_WRITE_ZEROES_DEALLOCATE:
+    case ZERO_RANGE_NVME_WRITE_ZEROES:
+        ret = nvme_Write_Zeroes(device, lba, C_CAST(uint16_t, count - 1), false, false,
+                                method == ZERO_RANGE_NVME_WRITE_ZEROES_DEALLOCATE);
+        break;
+    case ZERO_RANGE_SCSI_WRITE_SAME_UNMAP:
+    case ZERO_RANGE_SCSI_WRITE_SAME:
+        // one block of zeros instead of the NDOB bit, which many devices do not support
+        ret = scsi_Write_Same_16(device, 0, false, method == ZERO_RANGE_SCSI_WRITE_SAME_UNMAP, false, lba, 0,
+                                 C_CAST(uint32_t, count), zeroBuffer, blockSize);
+        break;
+    case ZERO_RANGE_ATA_ZEROS_EXT_TRIM:
+    case ZERO_RANGE_ATA_ZEROS_EXT:
+        ret = ata_Zeros_Ext(device, C_CAST(uint16_t, count), lba, method == ZERO_RANGE_ATA_ZEROS_EXT_TRIM);
+        break;
+    case ZERO_RANGE_ATA_SCT_WRITE_SAME:
+        ret = send_Zero_Range_SCT_Write_Same(device, lba, count);
+        break;
+    case ZERO_RANGE_WRITE:
+        ret = write_LBA(device, lba, false, zeroBuffer, C_CAST(uint32_t, count) * blockSize);
+        break;
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues zero_Range(const tDevice* M_NONNULL           device,
+                                               zeroRangeCapabilities* M_NULLABLE capabilities,
+                                               uint64_t                          lba,
+                                               uint64_t                          length,
+                                               zeroRangeResults* M_NULLABLE      results)
+{
+    eReturnValues         ret        = SUCCESS;
+    uint64_t              maxLBA     = device->drive_info.deviceMaxLba;
+    uint64_t              offset     = UINT64_C(0);
+    uint8_t*              zeroBuffer = M_NULLPTR;
+    size_t                zeroSize   = SIZE_T_C(0);
+    zeroRangeCapabilities localCapabilities;
+    zeroRangeResults      localResults;
+    if (results == M_NULLPTR)
+    {
+        results = &localResults;
+    }
+    safe_memset(results, sizeof(zeroRangeResults), 0, sizeof(zeroRangeResults));
+    results->nextLBA = lba;
+    if (capabilities == M_NULLPTR)
+    {
+        capabilities = &localCapabilities;
+        ret          = get_Zero_Range_Capabilities(device, capabilities);
+        if (ret != SUCCESS)
+        {
+            return ret;
+        }
+    }
+    if (capabilities->blockSize == UINT32_C(0) || capabilities->numberOfMethods == UINT8_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    if (length == UINT64_C(0))
+    {
+        return SUCCESS;
+    }
+    if (lba > maxLBA || length - 1 > maxLBA - lba)
+    {
+        return BAD_PARAMETER;
+    }
+    // One buffer serves every command: a single block for WRITE SAME, or the largest write
+    for (uint8_t iter = UINT8_C(0); iter < capabilities->numberOfMethods; ++iter)
+    {
+        if (capabilities->methods[iter].method == ZERO_RANGE_WRITE)
+        {
+            zeroSize = M_Max(zeroSize, C_CAST(size_t, capabilities->methods[iter].maxBlocks) * capabilities->blockSize);
+        }
+        else if (capabilities->methods[iter].method == ZERO_RANGE_SCSI_WRITE_SAME_UNMAP ||
+                 capabilities->methods[iter].method == ZERO_RANGE_SCSI_WRITE_SAME)
+        {
+            zeroSize = M_Max(zeroSize, C_CAST(size_t, capabilities->blockSize));
+        }
+    }
+    if (zeroSize > SIZE_T_C(0))
+    {
+        zeroBuffer = M_REINTERPRET_CAST(
+            uint8_t*, safe_calloc_aligned(zeroSize, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+        if (zeroBuffer == M_NULLPTR)
+        {
+            return MEMORY_FAILURE;
+        }
+    }
+    while (offset < length && capabilities->numberOfMethods > UINT8_C(0))
+    {
+        zeroRangeMethodInfo* current = &capabilities->methods[0];
+        uint64_t             count   = M_Min(length - offset, current->maxBlocks);
+        ++results->commands;
+        results->methodUsed = current->method;
+        ret =
+            send_Zero_Range_Command(device, current->method, lba + offset, count, zeroBuffer, capabilities->blockSize);
+        if (ret == SUCCESS)
+        {
+            current->confirmed = true;
+            offset += count;
+            results->lbasZeroed += count;
+        }
+        else if (!current->confirmed && current->method != ZERO_RANGE_WRITE &&
+                 is_Zero_Range_Method_Rejected(device, ret))
+        {
+            // Never worked on this device and the device rejected it. Drop it and retry with the next method.
+            --capabilities->numberOfMethods;
+            safe_memmove(&capabilities->methods[0], sizeof(zeroRangeMethodInfo) * ZERO_RANGE_MAX_METHODS,
+                         &capabilities->methods[1], sizeof(zeroRangeMethodInfo) * capabilities->numberOfMethods);
+        }
+        else
+        {
+            break;
+        }
+    }
+    results->nextLBA = lba + offset;
+    safe_free_aligned(&zeroBuffer);
+    return ret;
+}
@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file zone_cache.c
+// \brief Implements a write pointer cache for zoned devices that is kept up to date locally as writes and zone
+// management commands succeed, and a helper that appends to a zone at its cached write pointer
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "ata_helper.h"
+#include "ata_helper_func.h"
+#include "cmds.h"
+#include "scsi_helper.h"
+#include "scsi_helper_func.h"
+#include "zone_cache.h"
+
+#define ZONE_CACHE_NO_ZONE UINT32_MAX
+
+// Reads the maximum number of open sequential write required zones. UINT32_MAX when not reported or not limited.
+static uint32_t get_Max_Open_Zones(const tDevice* device)
+{
+    uint32_t maxOpenZones = UINT32_MAX;
+    if (get_Device_DriveType(device) == SCSI_DRIVE)
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, zonedCharacteristics, VPD_ZONED_BLOCK_DEVICE_CHARACTERISTICS_LEN);
+        if (SUCCESS == scsi_Inquiry(device, zonedCharacteristics, VPD_ZONED_BLOCK_DEVICE_CHARACTERISTICS_LEN,
+                                    ZONED_BLOCK_DEVICE_CHARACTERISTICS, true, false) &&
+            zonedCharacteristics[1] == ZONED_BLOCK_DEVICE_CHARACTERISTICS)
+        {
+            maxOpenZones = M_BytesTo4ByteValue(zonedCharacteristics[16], zonedCharacteristics[17],
+                                               zonedCharacteristics[18], zonedCharacteristics[19]);
+        }
+    }
+    else if (get_Device_DriveType(device) == ATA_DRIVE)
+    {
+        DECLARE_ZERO_INIT_ARRAY(uint8_t, zonedDeviceInformation, LEGACY_DRIVE_SEC_SIZE);
+        if (SUCCESS == ata_Read_Log_Ext(device, ATA_LOG_IDENTIFY_DEVICE_DATA, ATA_ID_DATA_LOG_ZONED_DEVICE_INFORMATION,
+                                        zonedDeviceInformation, LEGACY_DRIVE_SEC_SIZE,
+                                        device->drive_info.ata_Options.readLogWriteLogDMASupported, 0))
+        {
+            uint64_t zonedQword = M_BytesTo8ByteValue(zonedDeviceInformation[7], zonedDeviceInformation[6],
+                                                      zonedDeviceInformation[5], zonedDeviceInformation[4],
+                                                      zonedDeviceInformation[3], zonedDeviceInformation[2],
+                                                      zonedDeviceInformation[1], zonedDeviceInformation[0]);
+            if (zonedQword & ATA_ID_DATA_QWORD_VALID_BIT &&
+                M_Byte2(zonedQword) == ATA_ID_DATA_LOG_ZONED_DEVICE_INFORMATION)
+            {
+                uint64_t maxOpenQword = M_BytesTo8ByteValue(
+                    zonedDeviceInformation[39], zonedDeviceInformation[38], zonedDeviceInformation[37],
+                    zonedDeviceInformation[36], zonedDeviceInformation[35], zonedDeviceInformation[34],
+                    zonedDeviceInformation[33], zonedDeviceInformation[32]);
+                // an unreported field is left as no limit
+                if (maxOpenQword & ATA_ID_DATA_QWORD_VALID_BIT)
+                {
+                    maxOpenZones = M_DoubleWord0(maxOpenQword);
+                }
+            }
+        }
+    }
+    if (maxOpenZones == UINT32_C(0))
+    {
+        maxOpenZones = UINT32_MAX;
+    }
+    return maxOpenZones;
+}
+
+static M_INLINE bool is_Write_Pointer_Zone(const zoneInfo* zone)
+{
+    return zone->type == ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED || zone->type == ZONE_TYPE_SEQUENTIAL_WRITE_PREFERRED ||
+           zone->type == ZONE_TYPE_SEQUENTIAL_OR_BEFORE_REQUIRED;
+}
+
+static M_INLINE bool is_Open_Zone(const zoneInfo* zone)
+{
+    return zone->condition == ZONE_CONDITION_IMPLICITLY_OPENED || zone->condition == ZONE_CONDITION_EXPLICITLY_OPENED;
+}
+
+// Zones that can still be written: the ones a write or zone management command moves between conditions
+static M_INLINE bool is_Active_Zone(const zoneInfo* zone)
+{
+    return is_Write_Pointer_Zone(zone) && (zone->condition == ZONE_CONDITION_EMPTY || is_Open_Zone(zone) ||
+                                           zone->condition == ZONE_CONDITION_CLOSED);
+}
+
+// Only open sequential write required zones count against the device's limit
+static M_INLINE bool counts_As_Open(const zoneInfo* zone)
+{
+    return zone->type == ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED && is_Open_Zone(zone);
+}
+
+static void set_Zone_Condition(zoneCache* cache, zoneInfo* zone, uint8_t condition)
+{
+    bool wasOpen    = counts_As_Open(zone);
+    zone->condition = condition;
+    if (wasOpen && !counts_As_Open(zone) && cache->openZones > UINT32_C(0))
+    {
+        --cache->openZones;
+    }
+    else if (!wasOpen && counts_As_Open(zone))
+    {
+        ++cache->openZones;
+    }
+}
+
+static void count_Open_Zones(zoneCache* cache)
+{
+    cache->openZones = UINT32_C(0);
+    for (uint32_t iter = UINT32_C(0); iter < cache->table.numberOfZones; ++iter)
+    {
+        if (counts_As_Open(&cache->table.zones[iter]))
+        {
+            ++cache->openZones;
+        }
+    }
+}
+
+static uint32_t find_Zone_Index(const zoneCache* cache, uint64_t lba)
+{
+    uint32_t low  = UINT32_C(0);
+    uint32_t high = cache->table.numberOfZones;
+    while (low < high)
+    {
+        uint32_t        middle = low + (high - low) / UINT32_C(2);
+        const zoneInfo* zone   = &cache->table.zones[middle];
+        if (lba < zone->startLBA)
+        {
+            high = middle;
+        }
+        else if (lba >= zone->startLBA + zone->length)
+        {
+            low = middle + UINT32_C(1);
+        }
+        else
+        {
+            return middle;
+        }
+    }
+    return ZONE_CACHE_NO_ZONE;
+}
+
+// A command failed part way, so read the zones it touched back from the device
+static void resync_Zones(zoneCache* cache, uint32_t firstZone, uint32_t lastZone)
+{
+    for (uint32_t iter = firstZone; iter <= lastZone && iter < cache->table.numberOfZones; ++iter)
+    {
+        zoneInfo zone;
+        if (SUCCESS == get_Zone_Info(cache->device, cache->table.zones[iter].startLBA, &zone) &&
+            zone.startLBA == cache->table.zones[iter].startLBA)
+        {
+            cache->table.zones[iter] = zone;
+        }
+        ++cache->resyncs;
+    }
+    count_Open_Zones(cache);
+}
+
+// Makes sure opening this zone does not go over the open zone limit. At the limit, the device would close an
+// implicitly opened zone of its own choosing, so close one here instead and keep the cache right.
+static eReturnValues make_Room_To_Open(zoneCache* cache, const zoneInfo* zone)
+{
+    if (zone->type != ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED || is_Open_Zone(zone) ||
+        cache->openZones < cache->maxOpenZones)
+    {
+        return SUCCESS;
+    }
+    for (uint32_t iter = UINT32_C(0); iter < cache->table.numberOfZones; ++iter)
+    {
+        zoneInfo* candidate = &cache->table.zones[iter];
+        if (candidate->type == ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED &&
+            candidate->condition == ZONE_CONDITION_IMPLICITLY_OPENED)
+        {
+            eReturnValues ret = close_Zone(cache->device, false, candidate->startLBA, UINT16_C(1));
+            if (ret != SUCCESS)
+            {
+                resync_Zones(cache, iter, iter);
+                return ret;
+            }
+            set_Zone_Condition(cache, candidate,
+                               candidate->writePointer == candidate->startLBA ? ZONE_CONDITION_EMPTY
+                                                                              : ZONE_CONDITION_CLOSED);
+            return SUCCESS;
+        }
+    }
+    // every open zone was opened explicitly. Those are only closed by the caller.
+    return FAILURE;
+}
+
+// Moves a zone to the condition the device puts it in after a successful zone management command
+static void apply_Zone_Action(zoneCache* cache, zoneInfo* zone, eZMAction action, bool all)
+{
+    if (!is_Active_Zone(zone) && !(action == ZM_ACTION_RESET_WRITE_POINTERS && is_Write_Pointer_Zone(zone) &&
+                                   zone->condition == ZONE_CONDITION_FULL))
+    {
+        return;
+    }
+    switch (action)
+    {
+    case ZM_ACTION_OPEN_ZONE:
+        // open all only opens closed zones
+        if (!all || zone->condition == ZONE_CONDITION_CLOSED)
+        {
+            set_Zone_Condition(cache, zone, ZONE_CONDITION_EXPLICITLY_OPENED);
+        }
+        break;
+    case ZM_ACTION_CLOSE_ZONE:
+        if (is_Open_Zone(zone))
+        {
+            set_Zone_Condition(cache, zone,
+                               zone->writePointer == zone->startLBA ? ZONE_CONDITION_EMPTY : ZONE_CONDITION_CLOSED);
+        }
+        break;
+    case ZM_ACTION_FINISH_ZONE:
+        // finish all only finishes open and closed zones
+        if (!all || zone->condition != ZONE_CONDITION_EMPTY)
+        {
+            zone->writePointer = zone->startLBA + zone->length;
+            set_Zone_Condition(cache, zone, ZONE_CONDITION_FULL);
+        }
+        break;
+    case ZM_ACTION_RESET_WRITE_POINTERS:
+        zone->writePointer     = zone->startLBA;
+        zone->resetRecommended = false;
+        set_Zone_Condition(cache, zone, ZONE_CONDITION_EMPTY);
+        break;
+    default:
+        break;
+    }
+}
+
+OPENSEA_TRANSPORT_API eReturnValues init_Zone_Cache(const tDevice* M_NONNULL device, zoneCache* M_NONNULL cache)
+{
+    safe_memset(cache, sizeof(zoneCache), 0, sizeof(zoneCache));
+    cache->device       = device;
+    cache->maxOpenZones = get_Max_Open_Zones(device);
+    return refresh_Zone_Cache(cache);
+}
+
+OPENSEA_TRANSPORT_API eReturnValues refresh_Zone_Cache(zoneCache* M_NONNULL cache)
+{
+    eReturnValues ret = SUCCESS;
+    free_Zone_Table(&cache->table);
+    ret = get_Zone_Table(cache->device, ZONE_REPORT_LIST_ALL_ZONES, UINT64_C(0), UINT32_C(0), &cache->table);
+    count_Open_Zones(cache);
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API void free_Zone_Cache(zoneCache* M_NULLABLE cache)
+{
+    if (cache != M_NULLPTR)
+    {
+        free_Zone_Table(&cache->table);
+        safe_memset(cache, sizeof(zoneCache), 0, sizeof(zoneCache));
+    }
+}
+
+OPENSEA_TRANSPORT_API const zoneInfo* get_Zone_Cache_Zone(const zoneCache* M_NONNULL cache, uint64_t lba)
+{
+    uint32_t index = find_Zone_Index(cache, lba);
+    if (index == ZONE_CACHE_NO_ZONE)
+    {
+        return M_NULLPTR;
+    }
+    return &cache->table.zones[index];
+}
+
+OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Write(zoneCache* M_NONNULL cache,
+                                                     uint64_t             lba,
+                                                     uint8_t* M_NONNULL   ptrData,
+                                                     uint32_t             dataSize)
+{
+    eReturnValues ret       = SUCCESS;
+    uint32_t      blockSize = get_Device_BlockSize(cache->device);
+    uint64_t      endLBA    = UINT64_C(0);
+    uint32_t      firstZone = ZONE_CACHE_NO_ZONE;
+    uint32_t      lastZone  = ZONE_CACHE_NO_ZONE;
+    if (blockSize == UINT32_C(0) || dataSize == UINT32_C(0) || dataSize % blockSize != UINT32_C(0))
+    {
+        return BAD_PARAMETER;
+    }
+    endLBA    = lba + dataSize / blockSize; // first LBA after the write
+    firstZone = find_Zone_Index(cache, lba);
+    lastZone  = find_Zone_Index(cache, endLBA - UINT64_C(1));
+    if (firstZone == ZONE_CACHE_NO_ZONE || lastZone == ZONE_CACHE_NO_ZONE)
+    {
+        return BAD_PARAMETER;
+    }
+    // Only the zone the write ends in can be left open. Zones before it are written to the end and become full.
+    if (is_Active_Zone(&cache->table.zones[lastZone]) &&
+        endLBA < cache->table.zones[lastZone].startLBA + cache->table.zones[lastZone].length)
+    {
+        ret = make_Room_To_Open(cache, &cache->table.zones[lastZone]);
+        if (ret != SUCCESS)
+        {
+            return ret;
+        }
+    }
+    ret = write_LBA(cache->device, lba, false, ptrData, dataSize);
+    if (ret != SUCCESS)
+    {
+        resync_Zones(cache, firstZone, lastZone);
+        return ret;
+    }
+    for (uint32_t iter = firstZone; iter <= lastZone; ++iter)
+    {
+        zoneInfo* zone    = &cache->table.zones[iter];
+        uint64_t  zoneEnd = zone->startLBA + zone->length;
+        if (!is_Active_Zone(zone))
+        {
+            continue;
+        }
+        zone->writePointer = M_Max(zone->writePointer, M_Min(endLBA, zoneEnd));
+        if (zone->writePointer == zoneEnd)
+        {
+            set_Zone_Condition(cache, zone, ZONE_CONDITION_FULL);
+        }
+        else if (zone->condition == ZONE_CONDITION_EMPTY || zone->condition == ZONE_CONDITION_CLOSED)
+        {
+            set_Zone_Condition(cache, zone, ZONE_CONDITION_IMPLICITLY_OPENED);
+        }
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Management(zoneCache* M_NONNULL cache,
+                                                          eZMAction            action,
+                                                          bool                 all,
+                                                          uint64_t             zoneID)
+{
+    eReturnValues ret       = SUCCESS;
+    uint32_t      zoneIndex = ZONE_CACHE_NO_ZONE;
+    uint16_t      zoneCount = all ? UINT16_C(0) : UINT16_C(1);
+    if (all)
+    {
+        zoneID = UINT64_C(0);
+    }
+    else
+    {
+        zoneIndex = find_Zone_Index(cache, zoneID);
+        if (zoneIndex == ZONE_CACHE_NO_ZONE || cache->table.zones[zoneIndex].startLBA != zoneID)
+        {
+            return BAD_PARAMETER;
+        }
+    }
+    switch (action)
+    {
+    case ZM_ACTION_OPEN_ZONE:
+        if (!all)
+        {
+            ret = make_Room_To_Open(cache, &cache->table.zones[zoneIndex]);
+            if (ret != SUCCESS)
+            {
+                return ret;
+            }
+        }
+        ret = open_Zone(cache->device, all, zoneID, zoneCount);
+        break;
+    case ZM_ACTION_CLOSE_ZONE:
+        ret = close_Zone(cache->device, all, zoneID, zoneCount);
+        break;
+    case ZM_ACTION_FINISH_ZONE:
+        ret = finish_Zone(cache->device, all, zoneID, zoneCount);
+        break;
+    case ZM_ACTION_RESET_WRITE_POINTERS:
+        ret = reset_Write_Pointer(cache->device, all, zoneID, zoneCount);
+        break;
+    default:
+        return BAD_PARAMETER;
+    }
+    if (ret != SUCCESS)
+    {
+        if (all)
+        {
+            // any number of zones may have changed before the error
+            cache->resyncs += cache->table.numberOfZones;
+            M_STATIC_CAST(void, refresh_Zone_Cache(cache));
+        }
+        else
+        {
+            resync_Zones(cache, zoneIndex, zoneIndex);
+        }
+        return ret;
+    }
+    if (all)
+    {
+        for (uint32_t iter = UINT32_C(0); iter < cache->table.numberOfZones; ++iter)
+        {
+            apply_Zone_Action(cache, &cache->table.zones[iter], action, true);
+        }
+    }
+    else
+    {
+        apply_Zone_Action(cache, &cache->table.zones[zoneIndex], action, false);
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues zone_Cache_Append(zoneCache* M_NONNULL  cache,
+                                                      uint64_t              zoneID,
+                                                      uint8_t* M_NONNULL    ptrData,
+                                                      uint32_t              dataSize,
+                                                      uint64_t* M_NULLABLE lbaWritten)
+{
+    eReturnValues   ret       = SUCCESS;
+    uint32_t        blockSize = get_Device_BlockSize(cache->device);
+    uint64_t        lba       = UINT64_C(0);
+    const zoneInfo* zone      = get_Zone_Cache_Zone(cache, zoneID);
+    if (zone == M_NULLPTR || !is_Active_Zone(zone) || blockSize == UINT32_C(0) ||
+        dataSize / blockSize > zone->startLBA + zone->length - zone->writePointer)
+    {
+        return BAD_PARAMETER;
+    }
+    lba = zone->writePointer;
+    ret = zone_Cache_Write(cache, lba, ptrData, dataSize);
+    if (ret == SUCCESS && lbaWritten != M_NULLPTR)
+    {
+        *lbaWritten = lba;
+    }
+    return ret;
+}
@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: MPL-2.0
+//
+// Do NOT modify or remove this copyright and license
+//
+// Copyright (c) 2012-2026 Seagate Technology LLC and/or its Affiliates, All Rights Reserved
+//
+// This software is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// ******************************************************************************************
+//
+// \file zone_report.c
+// \brief Implements reading the zones of a zoned device through an iterator that pages through REPORT ZONES and parses
+// the zone descriptors into a compact zone table
+
+#include "bit_manip.h"
+#include "code_attributes.h"
+#include "common_types.h"
+#include "math_utils.h"
+#include "memory_safety.h"
+#include "type_conversion.h"
+
+#include "cmds.h"
+#include "surface_scan.h"
+#include "zone_report.h"
+
+// The report header and each zone descriptor are both 64 bytes
+#define ZONE_REPORT_DESCRIPTOR_LEN UINT32_C(64)
+// Starting size of a zone table. It doubles as needed.
+#define ZONE_TABLE_INITIAL_ZONES UINT32_C(1024)
+
+static uint64_t get_Zone_Report_Field(const uint8_t* field, uint8_t length, bool bigEndian)
+{
+    uint64_t value = UINT64_C(0);
+    for (uint8_t iter = UINT8_C(0); iter < length; ++iter)
+    {
+        value = (value << 8) | field[bigEndian ? iter : (length - 1 - iter)];
+    }
+    return value;
+}
+
+static void parse_Zone_Descriptor(const uint8_t* descriptor, bool bigEndian, zoneInfo* zone)
+{
+    zone->type                         = get_bit_range_uint8(descriptor[0], 3, 0);
+    zone->condition                    = M_Nibble1(descriptor[1]);
+    zone->nonSequentialResourcesActive = descriptor[1] & BIT1;
+    zone->resetRecommended             = descriptor[1] & BIT0;
+    zone->length                       = get_Zone_Report_Field(&descriptor[8], 8, bigEndian);
+    zone->startLBA                     = get_Zone_Report_Field(&descriptor[16], 8, bigEndian);
+    zone->writePointer                 = get_Zone_Report_Field(&descriptor[24], 8, bigEndian);
+}
+
+// Sends the next report and works out how many descriptors it holds and where the one after it starts
+static eReturnValues read_Next_Zone_Report(zoneReportIterator* iterator)
+{
+    eReturnValues ret      = SUCCESS;
+    uint32_t      fitting  = (iterator->bufferSize - ZONE_REPORT_DESCRIPTOR_LEN) / ZONE_REPORT_DESCRIPTOR_LEN;
+    uint32_t      returned = UINT32_C(0);
+    iterator->descriptorsInBuffer = UINT32_C(0);
+    iterator->nextDescriptor      = UINT32_C(0);
+    ret = report_Zones(iterator->device, iterator->reportingOptions, true, iterator->nextZoneLocator, iterator->buffer,
+                       iterator->bufferSize);
+    if (ret != SUCCESS)
+    {
+        return ret;
+    }
+    returned = C_CAST(uint32_t, M_Min(get_Zone_Report_Field(&iterator->buffer[0], 4, iterator->bigEndian) /
+                                          ZONE_REPORT_DESCRIPTOR_LEN,
+                                      C_CAST(uint64_t, fitting)));
+    if (get_Zone_Report_Field(&iterator->buffer[8], 8, iterator->bigEndian) > UINT64_C(0))
+    {
+        iterator->maxLBA = get_Zone_Report_Field(&iterator->buffer[8], 8, iterator->bigEndian);
+    }
+    iterator->descriptorsInBuffer = returned;
+    iterator->lastPage            = returned < fitting;
+    if (returned > UINT32_C(0))
+    {
+        zoneInfo last;
+        parse_Zone_Descriptor(&iterator->buffer[C_CAST(size_t, returned) * ZONE_REPORT_DESCRIPTOR_LEN],
+                              iterator->bigEndian, &last);
+        if (last.startLBA + last.length <= iterator->nextZoneLocator || last.length == UINT64_C(0) ||
+            last.startLBA + last.length > iterator->maxLBA)
+        {
+            // at the end of the device, or the report did not move forward
+            iterator->lastPage = true;
+        }
+        else
+        {
+            iterator->nextZoneLocator = last.startLBA + last.length;
+        }
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues init_Zone_Report_Iterator(const tDevice* M_NONNULL      device,
+                                                              eZoneReportingOptions         reportingOptions,
+                                                              uint64_t                      startLBA,
+                                                              zoneReportIterator* M_NONNULL iterator)
+{
+    uint32_t blockSize = get_Device_BlockSize(device);
+    safe_memset(iterator, sizeof(zoneReportIterator), 0, sizeof(zoneReportIterator));
+    if (get_Device_DriveType(device) != ATA_DRIVE && get_Device_DriveType(device) != SCSI_DRIVE)
+    {
+        return NOT_SUPPORTED;
+    }
+    if (blockSize == UINT32_C(0))
+    {
+        blockSize = LEGACY_DRIVE_SEC_SIZE;
+    }
+    iterator->device           = device;
+    iterator->reportingOptions = reportingOptions;
+    iterator->nextZoneLocator  = startLBA;
+    iterator->maxLBA           = device->drive_info.deviceMaxLba;
+    iterator->bigEndian        = get_Device_DriveType(device) == SCSI_DRIVE;
+    // The largest read transfer is also the largest report. ZAC reports are in 512B pages.
+    iterator->bufferSize =
+        get_Surface_Scan_Blocks_Per_Command(device, SURFACE_SCAN_READ) * blockSize / LEGACY_DRIVE_SEC_SIZE *
+        LEGACY_DRIVE_SEC_SIZE;
+    iterator->bufferSize = M_Max(iterator->bufferSize, LEGACY_DRIVE_SEC_SIZE);
+    iterator->buffer     = M_REINTERPRET_CAST(uint8_t*, safe_calloc_aligned(iterator->bufferSize, sizeof(uint8_t),
+                                                                        get_Device_IO_Minimum_Alignment(device)));
+    if (iterator->buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    return SUCCESS;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues get_Next_Zones(zoneReportIterator* M_NONNULL iterator,
+                                                   zoneInfo* M_NONNULL           zones,
+                                                   uint32_t                      maxZones,
+                                                   uint32_t* M_NONNULL           zonesReturned)
+{
+    eReturnValues ret = SUCCESS;
+    *zonesReturned    = UINT32_C(0);
+    if (iterator->buffer == M_NULLPTR || (zones == M_NULLPTR && maxZones > UINT32_C(0)))
+    {
+        return BAD_PARAMETER;
+    }
+    while (*zonesReturned < maxZones)
+    {
+        if (iterator->nextDescriptor >= iterator->descriptorsInBuffer)
+        {
+            // the first call reads the first report. After that, only read another one if there is more to read.
+            if (iterator->lastPage)
+            {
+                break;
+            }
+            ret = read_Next_Zone_Report(iterator);
+            if (ret != SUCCESS || iterator->descriptorsInBuffer == UINT32_C(0))
+            {
+                iterator->lastPage = true;
+                break;
+            }
+        }
+        // descriptors start after the 64 byte header
+        parse_Zone_Descriptor(
+            &iterator->buffer[(C_CAST(size_t, iterator->nextDescriptor) + 1) * ZONE_REPORT_DESCRIPTOR_LEN],
+            iterator->bigEndian, &zones[*zonesReturned]);
+        ++iterator->nextDescriptor;
+        ++(*zonesReturned);
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API void free_Zone_Report_Iterator(zoneReportIterator* M_NULLABLE iterator)
+{
+    if (iterator != M_NULLPTR)
+    {
+        safe_free_aligned(&iterator->buffer);
+        safe_memset(iterator, sizeof(zoneReportIterator), 0, sizeof(zoneReportIterator));
+    }
+}
+
+OPENSEA_TRANSPORT_API eReturnValues get_Zone_Info(const tDevice* M_NONNULL device,
+                                                  uint64_t                 lba,
+                                                  zoneInfo* M_NONNULL      zone)
+{
+    eReturnValues ret = NOT_SUPPORTED;
+    // the header and the one descriptor needed fit in the smallest report
+    uint8_t* buffer = M_REINTERPRET_CAST(
+        uint8_t*, safe_calloc_aligned(LEGACY_DRIVE_SEC_SIZE, sizeof(uint8_t), get_Device_IO_Minimum_Alignment(device)));
+    bool bigEndian = get_Device_DriveType(device) == SCSI_DRIVE;
+    safe_memset(zone, sizeof(zoneInfo), 0, sizeof(zoneInfo));
+    if (buffer == M_NULLPTR)
+    {
+        return MEMORY_FAILURE;
+    }
+    ret = report_Zones(device, ZONE_REPORT_LIST_ALL_ZONES, true, lba, buffer, LEGACY_DRIVE_SEC_SIZE);
+    if (ret == SUCCESS)
+    {
+        if (get_Zone_Report_Field(&buffer[0], 4, bigEndian) < ZONE_REPORT_DESCRIPTOR_LEN)
+        {
+            ret = FAILURE;
+        }
+        else
+        {
+            parse_Zone_Descriptor(&buffer[ZONE_REPORT_DESCRIPTOR_LEN], bigEndian, zone);
+        }
+    }
+    safe_free_aligned(&buffer);
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API eReturnValues get_Zone_Table(const tDevice* M_NONNULL device,
+                                                   eZoneReportingOptions    reportingOptions,
+                                                   uint64_t                 startLBA,
+                                                   uint32_t                 maxZones,
+                                                   zoneTable* M_NONNULL     table)
+{
+    eReturnValues      ret      = SUCCESS;
+    uint32_t           capacity = UINT32_C(0);
+    zoneReportIterator iterator;
+    safe_memset(table, sizeof(zoneTable), 0, sizeof(zoneTable));
+    if (maxZones == UINT32_C(0))
+    {
+        maxZones = UINT32_MAX;
+    }
+    ret = init_Zone_Report_Iterator(device, reportingOptions, startLBA, &iterator);
+    if (ret != SUCCESS)
+    {
+        return ret;
+    }
+    while (ret == SUCCESS && table->numberOfZones < maxZones)
+    {
+        uint32_t zonesReturned = UINT32_C(0);
+        if (table->numberOfZones == capacity)
+        {
+            uint32_t  newCapacity = capacity == UINT32_C(0) ? M_Min(ZONE_TABLE_INITIAL_ZONES, maxZones)
+                                                            : M_Min(capacity, maxZones - capacity) + capacity;
+            zoneInfo* temp        = M_REINTERPRET_CAST(
+                zoneInfo*, safe_realloc(table->zones, C_CAST(size_t, newCapacity) * sizeof(zoneInfo)));
+            if (temp == M_NULLPTR)
+            {
+                ret = MEMORY_FAILURE;
+                break;
+            }
+            table->zones = temp;
+            capacity     = newCapacity;
+        }
+        ret = get_Next_Zones(&iterator, &table->zones[table->numberOfZones], capacity - table->numberOfZones,
+                             &zonesReturned);
+        if (zonesReturned == UINT32_C(0))
+        {
+            break;
+        }
+        table->numberOfZones += zonesReturned;
+    }
+    free_Zone_Report_Iterator(&iterator);
+    if (ret != SUCCESS)
+    {
+        free_Zone_Table(table);
+    }
+    return ret;
+}
+
+OPENSEA_TRANSPORT_API void free_Zone_Table(zoneTable* M_NULLABLE table)
+{
+    if (table != M_NULLPTR)
+    {
+        safe_free_core(M_REINTERPRET_CAST(void**, &table->zones));
+        table->numberOfZones = UINT32_C(0);
+    }
+}